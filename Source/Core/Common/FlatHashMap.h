@@ -0,0 +1,191 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+// An open-addressed hash map with linear probing for integer keys.
+//
+// All entries live in a single contiguous array, so lookups touch one or two cache lines instead
+// of chasing tree or bucket nodes. Erasing uses backward-shift deletion, which keeps probe
+// sequences short without tombstones.
+//
+// Inserting may rehash, which invalidates all pointers and references to values. Erasing may
+// move other entries, which invalidates pointers and references to them as well.
+template <typename Key, typename Value>
+class FlatHashMap
+{
+  static_assert(std::is_integral_v<Key>, "FlatHashMap only supports integral keys");
+
+public:
+  FlatHashMap() = default;
+
+  size_t Size() const { return m_size; }
+  bool Empty() const { return m_size == 0; }
+  size_t Capacity() const { return m_slots.size(); }
+
+  Value* Find(Key key)
+  {
+    if (m_slots.empty())
+      return nullptr;
+
+    for (size_t i = HomeSlot(key);; i = (i + 1) & m_mask)
+    {
+      Slot& slot = m_slots[i];
+      if (!slot.used)
+        return nullptr;
+      if (slot.key == key)
+        return &slot.value;
+    }
+  }
+
+  const Value* Find(Key key) const { return const_cast<FlatHashMap*>(this)->Find(key); }
+
+  bool Contains(Key key) const { return Find(key) != nullptr; }
+
+  // Returns the value for the given key, default-constructing it if necessary.
+  Value& operator[](Key key)
+  {
+    if ((m_size + 1) * 2 > m_slots.size())
+      Rehash(m_slots.empty() ? MIN_CAPACITY : m_slots.size() * 2);
+
+    for (size_t i = HomeSlot(key);; i = (i + 1) & m_mask)
+    {
+      Slot& slot = m_slots[i];
+      if (!slot.used)
+      {
+        slot.used = true;
+        slot.key = key;
+        slot.value = Value{};
+        ++m_size;
+        return slot.value;
+      }
+      if (slot.key == key)
+        return slot.value;
+    }
+  }
+
+  bool Erase(Key key)
+  {
+    if (m_slots.empty())
+      return false;
+
+    size_t hole = HomeSlot(key);
+    while (true)
+    {
+      const Slot& slot = m_slots[hole];
+      if (!slot.used)
+        return false;
+      if (slot.key == key)
+        break;
+      hole = (hole + 1) & m_mask;
+    }
+
+    // Shift back every following entry of the cluster which may legally live in the hole.
+    for (size_t i = (hole + 1) & m_mask; m_slots[i].used; i = (i + 1) & m_mask)
+    {
+      const size_t home = HomeSlot(m_slots[i].key);
+      if (((i - home) & m_mask) >= ((i - hole) & m_mask))
+      {
+        m_slots[hole].key = m_slots[i].key;
+        m_slots[hole].value = std::move(m_slots[i].value);
+        hole = i;
+      }
+    }
+
+    m_slots[hole].used = false;
+    m_slots[hole].value = Value{};
+    --m_size;
+    return true;
+  }
+
+  // Removes all entries, but keeps the allocated storage around.
+  void Clear()
+  {
+    for (Slot& slot : m_slots)
+    {
+      if (slot.used)
+      {
+        slot.used = false;
+        slot.value = Value{};
+      }
+    }
+    m_size = 0;
+  }
+
+  // Calls f(key, value) for every entry, in unspecified order. The map must not be modified
+  // from within f.
+  template <typename F>
+  void ForEach(F f)
+  {
+    for (Slot& slot : m_slots)
+    {
+      if (slot.used)
+        f(slot.key, slot.value);
+    }
+  }
+
+  template <typename F>
+  void ForEach(F f) const
+  {
+    for (const Slot& slot : m_slots)
+    {
+      if (slot.used)
+        f(slot.key, slot.value);
+    }
+  }
+
+private:
+  static constexpr size_t MIN_CAPACITY = 64;
+
+  struct Slot
+  {
+    Key key{};
+    bool used = false;
+    Value value{};
+  };
+
+  size_t HomeSlot(Key key) const
+  {
+    // Fibonacci hashing: spreads consecutive (and aligned) addresses over the whole table.
+    return static_cast<size_t>((static_cast<u64>(key) * 0x9E3779B97F4A7C15ULL) >> m_shift);
+  }
+
+  void Rehash(size_t new_capacity)
+  {
+    std::vector<Slot> old_slots(new_capacity);
+    std::swap(old_slots, m_slots);
+    m_mask = new_capacity - 1;
+    m_shift = 64;
+    for (size_t c = new_capacity; c > 1; c >>= 1)
+      --m_shift;
+
+    for (Slot& old_slot : old_slots)
+    {
+      if (!old_slot.used)
+        continue;
+
+      size_t i = HomeSlot(old_slot.key);
+      while (m_slots[i].used)
+        i = (i + 1) & m_mask;
+      m_slots[i].used = true;
+      m_slots[i].key = old_slot.key;
+      m_slots[i].value = std::move(old_slot.value);
+    }
+  }
+
+  std::vector<Slot> m_slots;
+  size_t m_size = 0;
+  size_t m_mask = 0;
+  u32 m_shift = 64;
+};
+}  // namespace Common
@@ -5,20 +5,13 @@
 #include "Common/Hash.h"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
-#include "Common/BitUtils.h"
+
 #include "Common/CPUDetect.h"
-#include "Common/CommonFuncs.h"
+#include "Common/Inline.h"
 #include "Common/Intrinsics.h"
 
-#ifdef _M_ARM_64
-#ifdef _MSC_VER
-#include <intrin.h>
-#else
-#include <arm_acle.h>
-#endif
-#endif
-
 namespace Common
 {
 static u64 (*ptrHashFunction)(const u8* src, u32 len, u32 samples) = nullptr;
@@ -108,426 +101,305 @@ u32 HashEctor(const u8* ptr, size_t length)
   return (crc);
 }
 
-#if _ARCH_64
-
-//-----------------------------------------------------------------------------
-// Block read - if your platform needs to do endian-swapping or can only
-// handle aligned reads, do the conversion here
-
-static u64 getblock(const u64* p, int i)
+// A hash in the style of XXH3. The input is processed in stripes of 64 bytes, where every 64-bit
+// lane is mixed into one of eight accumulators with a single 32x32->64-bit multiplication. The
+// lanes are independent, so the stripes map directly onto SSE2 and AVX2 vectors, and all variants
+// produce the same hash.
+//
+// When sampling, whole stripes are hashed instead of single words, so a sample costs about one
+// cache line, as before, but covers all the data on it. The last 64 bytes are always included.
+namespace
 {
-  return p[i];
-}
-
-//----------
-// Block mix - combine the key bits with the hash bits and scramble everything
-
-static void bmix64(u64& h1, u64& h2, u64& k1, u64& k2, u64& c1, u64& c2)
+constexpr u64 PRIME32_1 = 0x9E3779B1;
+constexpr u64 PRIME32_2 = 0x85EBCA77;
+constexpr u64 PRIME32_3 = 0xC2B2AE3D;
+constexpr u64 PRIME64_1 = 0x9E3779B185EBCA87;
+constexpr u64 PRIME64_2 = 0xC2B2AE3D27D4EB4F;
+constexpr u64 PRIME64_3 = 0x165667B19E3779F9;
+constexpr u64 PRIME64_4 = 0x85EBCA77C2B2AE63;
+constexpr u64 PRIME64_5 = 0x27D4EB2F165667C5;
+
+constexpr u32 STRIPE_LANES = 8;
+constexpr u32 STRIPE_SIZE = STRIPE_LANES * sizeof(u64);
+// Every stripe of a block uses the key starting one lane further into the secret, and the
+// accumulators are scrambled at the end of each block with the last lanes of the secret.
+constexpr u32 STRIPES_PER_BLOCK = 16;
+constexpr u32 SECRET_LANES = STRIPES_PER_BLOCK + STRIPE_LANES;
+
+constexpr std::array<u64, SECRET_LANES> GenerateSecret()
 {
-  k1 *= c1;
-  k1 = Common::RotateLeft(k1, 23);
-  k1 *= c2;
-  h1 ^= k1;
-  h1 += h2;
-
-  h2 = Common::RotateLeft(h2, 41);
+  // splitmix64
+  std::array<u64, SECRET_LANES> secret{};
+  u64 state = PRIME64_3;
+  for (u64& lane : secret)
+  {
+    state += 0x9E3779B97F4A7C15;
+    u64 z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    lane = z ^ (z >> 31);
+  }
+  return secret;
+}
 
-  k2 *= c2;
-  k2 = Common::RotateLeft(k2, 23);
-  k2 *= c1;
-  h2 ^= k2;
-  h2 += h1;
+alignas(32) constexpr std::array<u64, SECRET_LANES> s_secret = GenerateSecret();
+constexpr const u64* SCRAMBLE_KEY = &s_secret[STRIPES_PER_BLOCK];
+constexpr const u64* LAST_STRIPE_KEY = &s_secret[STRIPES_PER_BLOCK - 1];
+constexpr const u64* MERGE_KEY = &s_secret[3];
 
-  h1 = h1 * 3 + 0x52dce729;
-  h2 = h2 * 3 + 0x38495ab5;
+constexpr std::array<u64, STRIPE_LANES> INITIAL_ACCUMULATORS = {
+    PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1};
 
-  c1 = c1 * 5 + 0x7b7d159c;
-  c2 = c2 * 5 + 0x6bce6396;
+u64 Read64(const u8* ptr)
+{
+  u64 value;
+  std::memcpy(&value, ptr, sizeof(value));
+  return value;
 }
 
-//----------
-// Finalization mix - avalanches all bits to within 0.05% bias
-
-static u64 fmix64(u64 k)
+u64 Multiply128Fold64(u64 a, u64 b)
 {
-  k ^= k >> 33;
-  k *= 0xff51afd7ed558ccd;
-  k ^= k >> 33;
-  k *= 0xc4ceb9fe1a85ec53;
-  k ^= k >> 33;
-
-  return k;
+  const u64 lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+  const u64 hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+  const u64 lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+  const u64 hi_hi = (a >> 32) * (b >> 32);
+  const u64 cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+  const u64 upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+  const u64 lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+  return lower ^ upper;
 }
 
-static u64 GetMurmurHash3(const u8* src, u32 len, u32 samples)
+u64 Avalanche(u64 value)
 {
-  const u8* data = (const u8*)src;
-  const int nblocks = len / 16;
-  u32 Step = (len / 8);
-  if (samples == 0)
-    samples = std::max(Step, 1u);
-  Step = Step / samples;
-  if (Step < 1)
-    Step = 1;
-
-  u64 h1 = 0x9368e53c2f6af274;
-  u64 h2 = 0x586dcd208f7cd3fd;
-
-  u64 c1 = 0x87c37b91114253d5;
-  u64 c2 = 0x4cf5ad432745937f;
-
-  //----------
-  // body
-
-  const u64* blocks = (const u64*)(data);
-
-  for (int i = 0; i < nblocks; i += Step)
-  {
-    u64 k1 = getblock(blocks, i * 2 + 0);
-    u64 k2 = getblock(blocks, i * 2 + 1);
-
-    bmix64(h1, h2, k1, k2, c1, c2);
-  }
-
-  //----------
-  // tail
-
-  const u8* tail = (const u8*)(data + nblocks * 16);
-
-  u64 k1 = 0;
-  u64 k2 = 0;
-
-  switch (len & 15)
-  {
-  case 15:
-    k2 ^= u64(tail[14]) << 48;
-  case 14:
-    k2 ^= u64(tail[13]) << 40;
-  case 13:
-    k2 ^= u64(tail[12]) << 32;
-  case 12:
-    k2 ^= u64(tail[11]) << 24;
-  case 11:
-    k2 ^= u64(tail[10]) << 16;
-  case 10:
-    k2 ^= u64(tail[9]) << 8;
-  case 9:
-    k2 ^= u64(tail[8]) << 0;
-
-  case 8:
-    k1 ^= u64(tail[7]) << 56;
-  case 7:
-    k1 ^= u64(tail[6]) << 48;
-  case 6:
-    k1 ^= u64(tail[5]) << 40;
-  case 5:
-    k1 ^= u64(tail[4]) << 32;
-  case 4:
-    k1 ^= u64(tail[3]) << 24;
-  case 3:
-    k1 ^= u64(tail[2]) << 16;
-  case 2:
-    k1 ^= u64(tail[1]) << 8;
-  case 1:
-    k1 ^= u64(tail[0]) << 0;
-    bmix64(h1, h2, k1, k2, c1, c2);
-  };
-
-  //----------
-  // finalization
-
-  h2 ^= len;
-
-  h1 += h2;
-  h2 += h1;
-
-  h1 = fmix64(h1);
-  h2 = fmix64(h2);
-
-  h1 += h2;
-
-  return h1;
+  value ^= value >> 37;
+  value *= 0x165667919E3779F9;
+  value ^= value >> 32;
+  return value;
 }
 
-// CRC32 hash using the SSE4.2 instruction
-#if defined(_M_X86_64)
+u64 MergeAccumulators(const u64* acc, u32 len)
+{
+  u64 result = len * PRIME64_1;
+  for (u32 i = 0; i < STRIPE_LANES; i += 2)
+    result += Multiply128Fold64(acc[i] ^ MERGE_KEY[i], acc[i + 1] ^ MERGE_KEY[i + 1]);
+  return Avalanche(result);
+}
 
-FUNCTION_TARGET_SSE42
-static u64 GetCRC32(const u8* src, u32 len, u32 samples)
+// Inputs shorter than a stripe, like small palettes, are too short for the accumulators to pay off
+// and are mixed directly instead, 16 bytes at a time.
+u64 GetShortHash(const u8* src, u32 len)
 {
-  u64 h[4] = {len, 0, 0, 0};
-  u32 Step = (len / 8);
-  const u64* data = (const u64*)src;
-  const u64* end = data + Step;
-  if (samples == 0)
-    samples = std::max(Step, 1u);
-  Step = Step / samples;
-  if (Step < 1)
-    Step = 1;
-
-  while (data < end - Step * 3)
+  u64 result = len * PRIME64_1;
+  if (len > 16)
   {
-    h[0] = _mm_crc32_u64(h[0], data[Step * 0]);
-    h[1] = _mm_crc32_u64(h[1], data[Step * 1]);
-    h[2] = _mm_crc32_u64(h[2], data[Step * 2]);
-    h[3] = _mm_crc32_u64(h[3], data[Step * 3]);
-    data += Step * 4;
+    for (u32 i = 0; i < len - 16; i += 16)
+    {
+      result += Multiply128Fold64(Read64(src + i) ^ s_secret[i / 8],
+                                  Read64(src + i + 8) ^ s_secret[i / 8 + 1]);
+    }
+    result += Multiply128Fold64(Read64(src + len - 16) ^ s_secret[6],
+                                Read64(src + len - 8) ^ s_secret[7]);
   }
-  if (data < end - Step * 0)
-    h[0] = _mm_crc32_u64(h[0], data[Step * 0]);
-  if (data < end - Step * 1)
-    h[1] = _mm_crc32_u64(h[1], data[Step * 1]);
-  if (data < end - Step * 2)
-    h[2] = _mm_crc32_u64(h[2], data[Step * 2]);
-
-  if (len & 7)
+  else if (len >= 8)
   {
-    u64 temp = 0;
-    memcpy(&temp, end, len & 7);
-    h[0] = _mm_crc32_u64(h[0], temp);
+    result += Multiply128Fold64(Read64(src) ^ s_secret[0], Read64(src + len - 8) ^ s_secret[1]);
   }
-
-  // FIXME: is there a better way to combine these partial hashes?
-  return h[0] + (h[1] << 10) + (h[2] << 21) + (h[3] << 32);
-}
-
-#elif defined(_M_ARM_64)
-
-static u64 GetCRC32(const u8* src, u32 len, u32 samples)
-{
-  u64 h[4] = {len, 0, 0, 0};
-  u32 Step = (len / 8);
-  const u64* data = (const u64*)src;
-  const u64* end = data + Step;
-  if (samples == 0)
-    samples = std::max(Step, 1u);
-  Step = Step / samples;
-  if (Step < 1)
-    Step = 1;
-
-  while (data < end - Step * 3)
+  else if (len >= 4)
   {
-    h[0] = __crc32d(h[0], data[Step * 0]);
-    h[1] = __crc32d(h[1], data[Step * 1]);
-    h[2] = __crc32d(h[2], data[Step * 2]);
-    h[3] = __crc32d(h[3], data[Step * 3]);
-    data += Step * 4;
+    u32 first, last;
+    std::memcpy(&first, src, sizeof(first));
+    std::memcpy(&last, src + len - 4, sizeof(last));
+    result += Multiply128Fold64(first ^ s_secret[0], last ^ s_secret[1]);
   }
-  if (data < end - Step * 0)
-    h[0] = __crc32d(h[0], data[Step * 0]);
-  if (data < end - Step * 1)
-    h[1] = __crc32d(h[1], data[Step * 1]);
-  if (data < end - Step * 2)
-    h[2] = __crc32d(h[2], data[Step * 2]);
-
-  if (len & 7)
+  else if (len != 0)
   {
-    u64 temp = 0;
-    memcpy(&temp, end, len & 7);
-    h[0] = __crc32d(h[0], temp);
+    const u32 combined = src[0] | (src[len / 2] << 8) | (src[len - 1] << 16);
+    result += Multiply128Fold64(combined ^ s_secret[0], s_secret[1]);
   }
-
-  // FIXME: is there a better way to combine these partial hashes?
-  return h[0] + (h[1] << 10) + (h[2] << 21) + (h[3] << 32);
+  return Avalanche(result);
 }
 
-#else
-
-static u64 GetCRC32(const u8* src, u32 len, u32 samples)
-{
-  return 0;
-}
-
-#endif
-
-#else
-
-// CRC32 hash using the SSE4.2 instruction
-#if defined(_M_X86)
-
-FUNCTION_TARGET_SSE42
-static u64 GetCRC32(const u8* src, u32 len, u32 samples)
+// Calls accumulate(stripe, key) for the stripes to hash and scramble() after each block. This is
+// always inlined, so that the callbacks can be inlined into the AVX2 variant too.
+template <typename Accumulate, typename Scramble>
+DOLPHIN_FORCE_INLINE void ProcessStripes(const u8* src, u32 len, u32 samples,
+                                         Accumulate accumulate, Scramble scramble)
 {
-  u32 h = len;
-  u32 Step = (len / 4);
-  const u32* data = (const u32*)src;
-  const u32* end = data + Step;
-  if (samples == 0)
-    samples = std::max(Step, 1u);
-  Step = Step / samples;
-  if (Step < 1)
-    Step = 1;
-  while (data < end)
+  // The last stripe is always hashed separately, and may overlap the one before it.
+  const u32 num_stripes = (len - 1) / STRIPE_SIZE;
+  u32 step = 1;
+  if (samples != 0)
+    step = std::max(num_stripes / samples, 1u);
+
+  u32 stripe_in_block = 0;
+  for (u32 stripe = 0; stripe < num_stripes; stripe += step)
   {
-    h = _mm_crc32_u32(h, data[0]);
-    data += Step;
+    accumulate(src + stripe * STRIPE_SIZE, &s_secret[stripe_in_block]);
+    if (++stripe_in_block == STRIPES_PER_BLOCK)
+    {
+      scramble();
+      stripe_in_block = 0;
+    }
   }
 
-  const u8* data2 = (const u8*)end;
-  return (u64)_mm_crc32_u32(h, u32(data2[0]));
+  accumulate(src + len - STRIPE_SIZE, LAST_STRIPE_KEY);
 }
 
-#else
-
-static u64 GetCRC32(const u8* src, u32 len, u32 samples)
+u64 GetXXH3Generic(const u8* src, u32 len, u32 samples)
 {
-  return 0;
+  if (len < STRIPE_SIZE)
+    return GetShortHash(src, len);
+
+  std::array<u64, STRIPE_LANES> acc = INITIAL_ACCUMULATORS;
+  ProcessStripes(
+      src, len, samples,
+      [&acc](const u8* stripe, const u64* key) {
+        for (u32 i = 0; i < STRIPE_LANES; ++i)
+        {
+          const u64 data = Read64(stripe + i * sizeof(u64));
+          const u64 data_key = data ^ key[i];
+          acc[i ^ 1] += data;
+          acc[i] += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+        }
+      },
+      [&acc] {
+        for (u32 i = 0; i < STRIPE_LANES; ++i)
+        {
+          acc[i] ^= acc[i] >> 47;
+          acc[i] ^= SCRAMBLE_KEY[i];
+          acc[i] *= PRIME32_1;
+        }
+      });
+
+  return MergeAccumulators(acc.data(), len);
 }
 
-#endif
-
-//-----------------------------------------------------------------------------
-// Block read - if your platform needs to do endian-swapping or can only
-// handle aligned reads, do the conversion here
+#ifdef _M_X86
 
-static u32 getblock(const u32* p, int i)
+u64 GetXXH3SSE2(const u8* src, u32 len, u32 samples)
 {
-  return p[i];
+  if (len < STRIPE_SIZE)
+    return GetShortHash(src, len);
+
+  constexpr u32 VECTORS = STRIPE_SIZE / sizeof(__m128i);
+  __m128i acc[VECTORS];
+  for (u32 i = 0; i < VECTORS; ++i)
+    acc[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&INITIAL_ACCUMULATORS[i * 2]));
+
+  ProcessStripes(
+      src, len, samples,
+      [&acc](const u8* stripe, const u64* key) {
+        for (u32 i = 0; i < VECTORS; ++i)
+        {
+          const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe) + i);
+          const __m128i data_key =
+              _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(key) + i));
+          const __m128i product =
+              _mm_mul_epu32(data_key, _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+          const __m128i data_swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+          acc[i] = _mm_add_epi64(acc[i], _mm_add_epi64(product, data_swapped));
+        }
+      },
+      [&acc] {
+        const __m128i prime = _mm_set1_epi32(static_cast<u32>(PRIME32_1));
+        for (u32 i = 0; i < VECTORS; ++i)
+        {
+          __m128i value = _mm_xor_si128(acc[i], _mm_srli_epi64(acc[i], 47));
+          value = _mm_xor_si128(
+              value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(SCRAMBLE_KEY) + i));
+          const __m128i product_lo = _mm_mul_epu32(value, prime);
+          const __m128i product_hi = _mm_mul_epu32(_mm_srli_epi64(value, 32), prime);
+          acc[i] = _mm_add_epi64(product_lo, _mm_slli_epi64(product_hi, 32));
+        }
+      });
+
+  alignas(16) u64 result[STRIPE_LANES];
+  for (u32 i = 0; i < VECTORS; ++i)
+    _mm_store_si128(reinterpret_cast<__m128i*>(result) + i, acc[i]);
+  return MergeAccumulators(result, len);
 }
 
-//----------
-// Finalization mix - force all bits of a hash block to avalanche
-
-// avalanches all bits to within 0.25% bias
-
-static u32 fmix32(u32 h)
+// Lambdas don't inherit the target attribute of the function they are declared in, so the AVX2
+// variant uses function objects with their own attributes instead.
+struct AccumulateAVX2
 {
-  h ^= h >> 16;
-  h *= 0x85ebca6b;
-  h ^= h >> 13;
-  h *= 0xc2b2ae35;
-  h ^= h >> 16;
-
-  return h;
-}
-
-static void bmix32(u32& h1, u32& h2, u32& k1, u32& k2, u32& c1, u32& c2)
-{
-  k1 *= c1;
-  k1 = Common::RotateLeft(k1, 11);
-  k1 *= c2;
-  h1 ^= k1;
-  h1 += h2;
-
-  h2 = Common::RotateLeft(h2, 17);
-
-  k2 *= c2;
-  k2 = Common::RotateLeft(k2, 11);
-  k2 *= c1;
-  h2 ^= k2;
-  h2 += h1;
-
-  h1 = h1 * 3 + 0x52dce729;
-  h2 = h2 * 3 + 0x38495ab5;
-
-  c1 = c1 * 5 + 0x7b7d159c;
-  c2 = c2 * 5 + 0x6bce6396;
-}
+  FUNCTION_TARGET_AVX2 void operator()(const u8* stripe, const u64* key) const
+  {
+    for (u32 i = 0; i < 2; ++i)
+    {
+      const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stripe) + i);
+      const __m256i data_key =
+          _mm256_xor_si256(data, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key) + i));
+      const __m256i product =
+          _mm256_mul_epu32(data_key, _mm256_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+      const __m256i data_swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      acc[i] = _mm256_add_epi64(acc[i], _mm256_add_epi64(product, data_swapped));
+    }
+  }
 
-//----------
+  __m256i* acc;
+};
 
-static u64 GetMurmurHash3(const u8* src, u32 len, u32 samples)
+struct ScrambleAVX2
 {
-  const u8* data = (const u8*)src;
-  u32 out[2];
-  const int nblocks = len / 8;
-  u32 Step = (len / 4);
-  if (samples == 0)
-    samples = std::max(Step, 1u);
-  Step = Step / samples;
-  if (Step < 1)
-    Step = 1;
-
-  u32 h1 = 0x8de1c3ac;
-  u32 h2 = 0xbab98226;
-
-  u32 c1 = 0x95543787;
-  u32 c2 = 0x2ad7eb25;
-
-  //----------
-  // body
-
-  const u32* blocks = (const u32*)(data + nblocks * 8);
-
-  for (int i = -nblocks; i < 0; i += Step)
+  FUNCTION_TARGET_AVX2 void operator()() const
   {
-    u32 k1 = getblock(blocks, i * 2 + 0);
-    u32 k2 = getblock(blocks, i * 2 + 1);
-
-    bmix32(h1, h2, k1, k2, c1, c2);
+    const __m256i prime = _mm256_set1_epi32(static_cast<u32>(PRIME32_1));
+    for (u32 i = 0; i < 2; ++i)
+    {
+      __m256i value = _mm256_xor_si256(acc[i], _mm256_srli_epi64(acc[i], 47));
+      value = _mm256_xor_si256(
+          value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(SCRAMBLE_KEY) + i));
+      const __m256i product_lo = _mm256_mul_epu32(value, prime);
+      const __m256i product_hi = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), prime);
+      acc[i] = _mm256_add_epi64(product_lo, _mm256_slli_epi64(product_hi, 32));
+    }
   }
 
-  //----------
-  // tail
+  __m256i* acc;
+};
 
-  const u8* tail = (const u8*)(data + nblocks * 8);
+FUNCTION_TARGET_AVX2
+u64 GetXXH3AVX2(const u8* src, u32 len, u32 samples)
+{
+  if (len < STRIPE_SIZE)
+    return GetShortHash(src, len);
 
-  u32 k1 = 0;
-  u32 k2 = 0;
+  __m256i acc[2];
+  for (u32 i = 0; i < 2; ++i)
+    acc[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&INITIAL_ACCUMULATORS[i * 4]));
 
-  switch (len & 7)
-  {
-  case 7:
-    k2 ^= tail[6] << 16;
-  case 6:
-    k2 ^= tail[5] << 8;
-  case 5:
-    k2 ^= tail[4] << 0;
-  case 4:
-    k1 ^= tail[3] << 24;
-  case 3:
-    k1 ^= tail[2] << 16;
-  case 2:
-    k1 ^= tail[1] << 8;
-  case 1:
-    k1 ^= tail[0] << 0;
-    bmix32(h1, h2, k1, k2, c1, c2);
-  };
-
-  //----------
-  // finalization
-
-  h2 ^= len;
-
-  h1 += h2;
-  h2 += h1;
-
-  h1 = fmix32(h1);
-  h2 = fmix32(h2);
-
-  h1 += h2;
-  h2 += h1;
-
-  out[0] = h1;
-  out[1] = h2;
-
-  return *((u64*)&out);
+  ProcessStripes(src, len, samples, AccumulateAVX2{acc}, ScrambleAVX2{acc});
+
+  alignas(32) u64 result[STRIPE_LANES];
+  for (u32 i = 0; i < 2; ++i)
+    _mm256_store_si256(reinterpret_cast<__m256i*>(result) + i, acc[i]);
+  return MergeAccumulators(result, len);
 }
+
 #endif
+}  // namespace
 
 u64 GetHash64(const u8* src, u32 len, u32 samples)
 {
   return ptrHashFunction(src, len, samples);
 }
 
+u64 GetHash64Generic(const u8* src, u32 len, u32 samples)
+{
+  return GetXXH3Generic(src, len, samples);
+}
+
 // sets the hash function used for the texture cache
 void SetHash64Function()
 {
-#if defined(_M_X86_64) || defined(_M_X86)
-  if (cpu_info.bSSE4_2)  // sse crc32 version
-  {
-    ptrHashFunction = &GetCRC32;
-  }
-  else
-#elif defined(_M_ARM_64)
-  if (cpu_info.bCRC32)
-  {
-    ptrHashFunction = &GetCRC32;
-  }
+#ifdef _M_X86
+  if (cpu_info.bAVX2)
+    ptrHashFunction = &GetXXH3AVX2;
   else
+    ptrHashFunction = &GetXXH3SSE2;
+#else
+  ptrHashFunction = &GetXXH3Generic;
 #endif
-  {
-    ptrHashFunction = &GetMurmurHash3;
-  }
 }
 }  // namespace Common
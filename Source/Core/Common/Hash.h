@@ -13,6 +13,10 @@ namespace Common
 u32 HashFletcher(const u8* data_u8, size_t length);  // FAST. Length & 1 == 0.
 u32 HashAdler32(const u8* data, size_t len);         // Fairly accurate, slightly slower
 u32 HashEctor(const u8* ptr, size_t length);         // JUNK. DO NOT USE FOR NEW THINGS
+// Hashes len bytes at src. If samples is not 0, only about that many 64-byte stripes spread over
+// the data are hashed. SetHash64Function must be called first to pick the fastest implementation.
 u64 GetHash64(const u8* src, u32 len, u32 samples);
+// The portable implementation, which returns the same hashes as the vectorized ones.
+u64 GetHash64Generic(const u8* src, u32 len, u32 samples);
 void SetHash64Function();
 }  // namespace Common
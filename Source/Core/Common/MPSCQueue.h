@@ -0,0 +1,106 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+// A bounded lockless thread-safe,
+// multiple producer, single consumer queue
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+// Every cell carries a sequence number which tells whether it is free for the producer that
+// claimed the position, or holds a value for the consumer (see Dmitry Vyukov's bounded MPMC
+// queue). Producers only race for the write position, so a push never waits for the consumer.
+template <typename T, size_t Capacity>
+class MPSCQueue
+{
+  static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+  static_assert(std::is_default_constructible_v<T>);
+
+public:
+  MPSCQueue()
+  {
+    for (size_t i = 0; i < Capacity; ++i)
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  MPSCQueue(const MPSCQueue&) = delete;
+  MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+  // Can be called from any thread. Returns false if the queue is full.
+  template <typename Arg>
+  bool Push(Arg&& t)
+  {
+    size_t pos = m_write_pos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true)
+    {
+      cell = &m_cells[pos & (Capacity - 1)];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      if (sequence == pos)
+      {
+        if (m_write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+        m_contended_pushes.fetch_add(1, std::memory_order_relaxed);
+      }
+      else if (sequence < pos)
+      {
+        // The consumer hasn't gotten to this cell yet.
+        return false;
+      }
+      else
+      {
+        // Another producer took this position first.
+        pos = m_write_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    cell->value = std::forward<Arg>(t);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only. Returns false if the next value hasn't been completely pushed yet.
+  bool Pop(T& t)
+  {
+    Cell& cell = m_cells[m_read_pos & (Capacity - 1)];
+    if (cell.sequence.load(std::memory_order_acquire) != m_read_pos + 1)
+      return false;
+
+    t = std::move(cell.value);
+    cell.sequence.store(m_read_pos + Capacity, std::memory_order_release);
+    ++m_read_pos;
+    return true;
+  }
+
+  // Consumer only. True if every push which has started so far has been popped.
+  bool Empty() const { return m_write_pos.load(std::memory_order_acquire) == m_read_pos; }
+
+  // Number of times a producer lost the race for a position and had to retry.
+  u64 ContendedPushes() const { return m_contended_pushes.load(std::memory_order_relaxed); }
+
+private:
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    T value{};
+  };
+
+  std::array<Cell, Capacity> m_cells;
+
+  // Keep the producer and consumer sides on separate cache lines.
+  alignas(64) std::atomic<size_t> m_write_pos{0};
+  std::atomic<u64> m_contended_pushes{0};
+  alignas(64) size_t m_read_pos = 0;
+};
+}  // namespace Common
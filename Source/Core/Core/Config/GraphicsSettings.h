@@ -72,6 +72,9 @@ extern const Info<bool> GFX_WAIT_FOR_SHADERS_BEFORE_STARTING;
 extern const Info<ShaderCompilationMode> GFX_SHADER_COMPILATION_MODE;
 extern const Info<int> GFX_SHADER_COMPILER_THREADS;
 extern const Info<int> GFX_SHADER_PRECOMPILER_THREADS;
+extern const Info<int> GFX_TEXTURE_DECODING_THREADS;
+extern const Info<bool> GFX_TEXTURE_DISK_CACHE;
+extern const Info<int> GFX_TEXTURE_DISK_CACHE_SIZE;
 extern const Info<bool> GFX_SAVE_TEXTURE_CACHE_TO_STATE;
 
 extern const Info<bool> GFX_SW_ZCOMPLOC;
@@ -81,6 +84,7 @@ extern const Info<bool> GFX_SW_DUMP_TEV_STAGES;
 extern const Info<bool> GFX_SW_DUMP_TEV_TEX_FETCHES;
 extern const Info<int> GFX_SW_DRAW_START;
 extern const Info<int> GFX_SW_DRAW_END;
+extern const Info<int> GFX_SW_RASTERIZER_THREADS;
 
 extern const Info<bool> GFX_PREFER_GLES;
 
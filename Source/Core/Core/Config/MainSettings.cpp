@@ -22,6 +22,19 @@ const Info<bool> MAIN_LOAD_IPL_DUMP{{System::Main, "Core", "LoadIPLDump"}, true}
 const Info<PowerPC::CPUCore> MAIN_CPU_CORE{{System::Main, "Core", "CPUCore"},
                                            PowerPC::DefaultCPUCore()};
 const Info<bool> MAIN_JIT_FOLLOW_BRANCH{{System::Main, "Core", "JITFollowBranch"}, true};
+const Info<bool> MAIN_JIT_TIERED_COMPILATION{{System::Main, "Core", "JITTieredCompilation"},
+                                             false};
+const Info<u32> MAIN_JIT_TIER_UP_THRESHOLD{{System::Main, "Core", "JITTierUpThreshold"}, 16};
+const Info<u32> MAIN_JIT_TIER_UP_BUDGET{{System::Main, "Core", "JITTierUpBudget"}, 64};
+const Info<bool> MAIN_JIT_ANALYSIS_CACHE{{System::Main, "Core", "JITAnalysisCache"}, false};
+const Info<bool> MAIN_JIT_REGION_COMPILATION{{System::Main, "Core", "JITRegionCompilation"},
+                                             false};
+const Info<u32> MAIN_JIT_REGION_THRESHOLD{{System::Main, "Core", "JITRegionThreshold"}, 1024};
+const Info<bool> MAIN_REWIND_ENABLED{{System::Main, "Core", "RewindEnabled"}, false};
+const Info<u32> MAIN_REWIND_INTERVAL{{System::Main, "Core", "RewindInterval"}, 10};
+const Info<u32> MAIN_REWIND_BUFFER_SIZE{{System::Main, "Core", "RewindBufferSize"}, 1024};
+const Info<bool> MAIN_COPY_ON_WRITE_SAVESTATES{{System::Main, "Core", "CopyOnWriteSavestates"},
+                                               false};
 const Info<bool> MAIN_FASTMEM{{System::Main, "Core", "Fastmem"}, true};
 const Info<bool> MAIN_DSP_HLE{{System::Main, "Core", "DSPHLE"}, true};
 const Info<int> MAIN_TIMING_VARIANCE{{System::Main, "Core", "TimingVariance"}, 40};
@@ -26,6 +26,18 @@ extern const Info<bool> MAIN_SKIP_IPL;
 extern const Info<bool> MAIN_LOAD_IPL_DUMP;
 extern const Info<PowerPC::CPUCore> MAIN_CPU_CORE;
 extern const Info<bool> MAIN_JIT_FOLLOW_BRANCH;
+extern const Info<bool> MAIN_JIT_TIERED_COMPILATION;
+extern const Info<u32> MAIN_JIT_TIER_UP_THRESHOLD;
+extern const Info<u32> MAIN_JIT_TIER_UP_BUDGET;
+extern const Info<bool> MAIN_JIT_ANALYSIS_CACHE;
+extern const Info<bool> MAIN_JIT_REGION_COMPILATION;
+extern const Info<u32> MAIN_JIT_REGION_THRESHOLD;
+extern const Info<bool> MAIN_REWIND_ENABLED;
+// In frames
+extern const Info<u32> MAIN_REWIND_INTERVAL;
+// In MiB
+extern const Info<u32> MAIN_REWIND_BUFFER_SIZE;
+extern const Info<bool> MAIN_COPY_ON_WRITE_SAVESTATES;
 extern const Info<bool> MAIN_FASTMEM;
 // Should really be in the DSP section, but we're kind of stuck with bad decisions made in the past.
 extern const Info<bool> MAIN_DSP_HLE;
@@ -44,6 +44,7 @@
 #include "Core/IOS/ES/ES.h"
 #include "Core/IOS/ES/Formats.h"
 #include "Core/PatchEngine.h"
+#include "Core/PowerPC/PPCAnalysisCache.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/TitleDatabase.h"
@@ -705,6 +706,8 @@ void SConfig::SetRunningGameMetadata(const std::string& game_id, const std::stri
   if (!was_changed)
     return;
 
+  PPCAnalyst::AnalysisCache::OnTitleChanged();
+
   if (game_id == "00000000")
   {
     m_title_description.clear();
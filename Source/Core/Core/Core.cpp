@@ -146,6 +146,8 @@ void OnFrameEnd()
   if (s_memory_watcher)
     s_memory_watcher->Step();
 #endif
+
+  ::State::OnFrameEnd();
 }
 
 // Display messages and return values
@@ -5,6 +5,7 @@
 #include "Core/CoreTiming.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <mutex>
 #include <string>
@@ -16,11 +17,13 @@
 #include "Common/Assert.h"
 #include "Common/ChunkFile.h"
 #include "Common/Logging/Log.h"
+#include "Common/MPSCQueue.h"
 #include "Common/SPSCQueue.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/TimingWheel.h"
 
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/VideoBackendBase.h"
@@ -33,37 +36,23 @@ struct EventType
   const std::string* name;
 };
 
-struct Event
-{
-  s64 time;
-  u64 fifo_order;
-  u64 userdata;
-  EventType* type;
-};
-
-// Sort by time, unless the times are the same, in which case sort by the order added to the queue
-static bool operator>(const Event& left, const Event& right)
-{
-  return std::tie(left.time, left.fifo_order) > std::tie(right.time, right.fifo_order);
-}
-static bool operator<(const Event& left, const Event& right)
-{
-  return std::tie(left.time, left.fifo_order) < std::tie(right.time, right.fifo_order);
-}
-
 // unordered_map stores each element separately as a linked list node so pointers to elements
 // remain stable regardless of rehashes/resizing.
 static std::unordered_map<std::string, EventType> s_event_types;
 
 // STATE_TO_SAVE
-// The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-// We don't use std::priority_queue because we need to be able to serialize, unserialize and
-// erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't accomodated
-// by the standard adaptor class.
-static std::vector<Event> s_event_queue;
+static TimingWheel s_event_queue;
 static u64 s_event_fifo_id;
+
+// Events scheduled from other threads. The lock is only needed once the ring is full. From then
+// on, every producer uses the overflow queue until the CPU thread has emptied both, so that the
+// events of each thread still get moved in the order they were scheduled.
+static constexpr size_t TS_QUEUE_SIZE = 1024;
+static Common::MPSCQueue<Event, TS_QUEUE_SIZE> s_ts_queue;
 static std::mutex s_ts_write_lock;
-static Common::SPSCQueue<Event, false> s_ts_queue;
+static Common::SPSCQueue<Event, false> s_ts_overflow_queue;
+static std::atomic<bool> s_ts_overflowed{false};
+static std::atomic<u64> s_ts_overflow_count{0};
 
 static float s_last_OC_factor;
 static constexpr int MAX_SLICE_LENGTH = 20000;
@@ -117,7 +106,7 @@ EventType* RegisterEvent(const std::string& name, TimedCallback callback)
 
 void UnregisterAllEvents()
 {
-  ASSERT_MSG(POWERPC, s_event_queue.empty(), "Cannot unregister events with events pending");
+  ASSERT_MSG(POWERPC, s_event_queue.Empty(), "Cannot unregister events with events pending");
   s_event_types.clear();
 }
 
@@ -137,12 +126,12 @@ void Init()
   s_is_global_timer_sane = true;
 
   s_event_fifo_id = 0;
+  s_event_queue.Clear(g.global_timer);
   s_ev_lost = RegisterEvent("_lost_event", &EmptyTimedCallback);
 }
 
 void Shutdown()
 {
-  std::lock_guard<std::mutex> lk(s_ts_write_lock);
   MoveEvents();
   ClearPendingEvents();
   UnregisterAllEvents();
@@ -150,7 +139,6 @@ void Shutdown()
 
 void DoState(PointerWrap& p)
 {
-  std::lock_guard<std::mutex> lk(s_ts_write_lock);
   p.Do(g.slice_length);
   p.Do(g.global_timer);
   p.Do(s_idled_cycles);
@@ -165,7 +153,10 @@ void DoState(PointerWrap& p)
   p.DoMarker("CoreTimingData");
 
   MoveEvents();
-  p.DoEachElement(s_event_queue, [](PointerWrap& pw, Event& ev) {
+  std::vector<Event> events;
+  if (p.GetMode() != PointerWrap::MODE_READ)
+    events = s_event_queue.GetSortedEvents();
+  p.DoEachElement(events, [](PointerWrap& pw, Event& ev) {
     pw.Do(ev.time);
     pw.Do(ev.fifo_order);
 
@@ -199,10 +190,13 @@ void DoState(PointerWrap& p)
   p.DoMarker("CoreTimingEvents");
 
   // When loading from a save state, we must assume the Event order is random and meaningless.
-  // The exact layout of the heap in memory is implementation defined, therefore it is platform
-  // and library version specific.
+  // Older versions stored the layout of a heap, which is implementation defined.
   if (p.GetMode() == PointerWrap::MODE_READ)
-    std::make_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+  {
+    s_event_queue.Clear(g.global_timer);
+    for (const Event& ev : events)
+      s_event_queue.Insert(ev);
+  }
 }
 
 // This should only be called from the CPU thread. If you are calling
@@ -225,7 +219,7 @@ u64 GetIdleTicks()
 
 void ClearPendingEvents()
 {
-  s_event_queue.clear();
+  s_event_queue.Clear(g.global_timer);
 }
 
 void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata, FromThread from)
@@ -253,8 +247,7 @@ void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
     if (!s_is_global_timer_sane)
       ForceExceptionCheck(cycles_into_future);
 
-    s_event_queue.emplace_back(Event{timeout, s_event_fifo_id++, userdata, event_type});
-    std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+    s_event_queue.Insert(Event{timeout, s_event_fifo_id++, userdata, event_type});
   }
   else
   {
@@ -266,22 +259,20 @@ void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
                 event_type->name->c_str());
     }
 
-    std::lock_guard<std::mutex> lk(s_ts_write_lock);
-    s_ts_queue.Push(Event{g.global_timer + cycles_into_future, 0, userdata, event_type});
+    const Event ev{g.global_timer + cycles_into_future, 0, userdata, event_type};
+    if (s_ts_overflowed.load(std::memory_order_acquire) || !s_ts_queue.Push(ev))
+    {
+      std::lock_guard<std::mutex> lk(s_ts_write_lock);
+      s_ts_overflowed.store(true, std::memory_order_release);
+      s_ts_overflow_queue.Push(ev);
+      s_ts_overflow_count.fetch_add(1, std::memory_order_relaxed);
+    }
   }
 }
 
 void RemoveEvent(EventType* event_type)
 {
-  auto itr = std::remove_if(s_event_queue.begin(), s_event_queue.end(),
-                            [&](const Event& e) { return e.type == event_type; });
-
-  // Removing random items breaks the invariant so we have to re-establish it.
-  if (itr != s_event_queue.end())
-  {
-    s_event_queue.erase(itr, s_event_queue.end());
-    std::make_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-  }
+  s_event_queue.Remove(event_type);
 }
 
 void RemoveAllEvents(EventType* event_type)
@@ -302,14 +293,31 @@ void ForceExceptionCheck(s64 cycles)
   }
 }
 
+static void MoveEvent(Event ev)
+{
+  ev.fifo_order = s_event_fifo_id++;
+  s_event_queue.Insert(ev);
+}
+
 void MoveEvents()
 {
   for (Event ev; s_ts_queue.Pop(ev);)
-  {
-    ev.fifo_order = s_event_fifo_id++;
-    s_event_queue.emplace_back(std::move(ev));
-    std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-  }
+    MoveEvent(std::move(ev));
+
+  if (!s_ts_overflowed.load(std::memory_order_acquire))
+    return;
+
+  std::lock_guard<std::mutex> lk(s_ts_write_lock);
+  // A producer which is still writing to the ring may have scheduled its earlier events there,
+  // so leave the overflow queue alone until the ring is empty.
+  for (Event ev; s_ts_queue.Pop(ev);)
+    MoveEvent(std::move(ev));
+  if (!s_ts_queue.Empty())
+    return;
+
+  for (Event ev; s_ts_overflow_queue.Pop(ev);)
+    MoveEvent(std::move(ev));
+  s_ts_overflowed.store(false, std::memory_order_release);
 }
 
 void Advance()
@@ -324,11 +332,10 @@ void Advance()
 
   s_is_global_timer_sane = true;
 
-  while (!s_event_queue.empty() && s_event_queue.front().time <= g.global_timer)
+  while (!s_event_queue.Empty() && s_event_queue.Front().time <= g.global_timer)
   {
-    Event evt = std::move(s_event_queue.front());
-    std::pop_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-    s_event_queue.pop_back();
+    const Event evt = s_event_queue.Front();
+    s_event_queue.PopFront();
     // NOTICE_LOG(POWERPC, "[Scheduler] %-20s (%lld, %lld)", evt.type->name->c_str(),
     //            g.global_timer, evt.time);
     evt.type->callback(evt.userdata, g.global_timer - evt.time);
@@ -337,10 +344,10 @@ void Advance()
   s_is_global_timer_sane = false;
 
   // Still events left (scheduled in the future)
-  if (!s_event_queue.empty())
+  if (!s_event_queue.Empty())
   {
     g.slice_length = static_cast<int>(
-        std::min<s64>(s_event_queue.front().time - g.global_timer, MAX_SLICE_LENGTH));
+        std::min<s64>(s_event_queue.Front().time - g.global_timer, MAX_SLICE_LENGTH));
   }
 
   PowerPC::ppcState.downcount = CyclesToDowncount(g.slice_length);
@@ -354,9 +361,7 @@ void Advance()
 
 void LogPendingEvents()
 {
-  auto clone = s_event_queue;
-  std::sort(clone.begin(), clone.end());
-  for (const Event& ev : clone)
+  for (const Event& ev : s_event_queue.GetSortedEvents())
   {
     INFO_LOG(POWERPC, "PENDING: Now: %" PRId64 " Pending: %" PRId64 " Type: %s", g.global_timer,
              ev.time, ev.type->name->c_str());
@@ -366,10 +371,13 @@ void LogPendingEvents()
 // Should only be called from the CPU thread after the PPC clock has changed
 void AdjustEventQueueTimes(u32 new_ppc_clock, u32 old_ppc_clock)
 {
-  for (Event& ev : s_event_queue)
+  std::vector<Event> events = s_event_queue.GetSortedEvents();
+  s_event_queue.Clear(g.global_timer);
+  for (Event& ev : events)
   {
     const s64 ticks = (ev.time - g.global_timer) * new_ppc_clock / old_ppc_clock;
     ev.time = g.global_timer + ticks;
+    s_event_queue.Insert(ev);
   }
 }
 
@@ -392,12 +400,13 @@ std::string GetScheduledEventsSummary()
   std::string text = "Scheduled events\n";
   text.reserve(1000);
 
-  auto clone = s_event_queue;
-  std::sort(clone.begin(), clone.end());
-  for (const Event& ev : clone)
+  for (const Event& ev : s_event_queue.GetSortedEvents())
   {
     text += fmt::format("{} : {} {:016x}\n", *ev.type->name, ev.time, ev.userdata);
   }
+
+  text += fmt::format("\nEvents from other threads\nContended pushes: {}\nOverflowed pushes: {}\n",
+                      s_ts_queue.ContendedPushes(), s_ts_overflow_count.load());
   return text;
 }
 
@@ -44,7 +44,7 @@ static bool IsStackBottom(u32 addr)
   return !addr || !PowerPC::HostIsRAMAddress(addr);
 }
 
-static void WalkTheStack(const std::function<void(u32)>& stack_step)
+void WalkTheStack(const std::function<void(u32)>& stack_step)
 {
   if (!IsStackBottom(PowerPC::ppcState.gpr[1]))
   {
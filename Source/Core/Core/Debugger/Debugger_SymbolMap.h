@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -18,6 +19,9 @@ struct CallstackEntry
   u32 vAddress;
 };
 
+// Calls stack_step with the return address saved in each frame of the guest stack back chain,
+// starting with the innermost caller.
+void WalkTheStack(const std::function<void(u32)>& stack_step);
 bool GetCallstack(std::vector<CallstackEntry>& output);
 void PrintCallstack();
 void PrintCallstack(Common::Log::LOG_TYPE type, Common::Log::LOG_LEVELS level);
@@ -70,6 +70,8 @@ void Shutdown()
   CPU::Shutdown();
   DVDInterface::Shutdown();
   DSP::Shutdown();
+  // A savestate which is still being written may need to copy RAM.
+  State::Flush();
   Memory::Shutdown();
   ExpansionInterface::Shutdown();
   SerialInterface::Shutdown();
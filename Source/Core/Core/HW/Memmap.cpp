@@ -11,13 +11,17 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstring>
 #include <memory>
+#include <optional>
+#include <utility>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/Swap.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
@@ -180,6 +184,7 @@ struct LogicalMemoryView
 {
   void* mapped_pointer;
   u32 mapped_size;
+  u32 shm_position;
 };
 
 // Dolphin allocates memory to represent four regions:
@@ -226,6 +231,49 @@ static std::array<PhysicalMemoryRegion, 4> physical_regions;
 
 static std::vector<LogicalMemoryView> logical_mapped_entries;
 
+// Dirty page tracking and RAM snapshots write protect the views of emulated RAM. The fault handler
+// can run on any thread which writes to emulated RAM, including while that thread is inside one of
+// the functions below, so it takes no locks. It only uses atomics, the physical regions, and
+// buffers which stay allocated until Shutdown. Everything else is only changed on the CPU thread.
+static std::atomic<bool> s_write_protected{false};
+// Incremented whenever all views are protected again.
+static std::atomic<u32> s_protection_generation{0};
+static size_t s_dirty_page_size = 0;
+static size_t s_page_count = 0;
+
+static std::atomic<bool> s_dirty_page_tracking{false};
+static u64 s_dirty_page_epoch = 0;
+// One bit per page which was written to in the current epoch, indexed by shm position.
+static std::unique_ptr<std::atomic<u64>[]> s_dirty_page_bits;
+// The epoch in which each page was last written to, not counting the current epoch.
+static std::vector<u64> s_page_dirty_epochs;
+
+struct SnapshotDestination
+{
+  u32 shm_position;
+  u32 size;
+  u8* destination;
+};
+
+enum : u8
+{
+  SNAPSHOT_PAGE_UNCOPIED,
+  SNAPSHOT_PAGE_COPYING,
+  SNAPSHOT_PAGE_COPIED,
+};
+
+static std::atomic<bool> s_ram_snapshot_active{false};
+// Set until DoState has recorded where the RAM of the snapshot has to be copied to.
+static bool s_ram_snapshot_capturing = false;
+// The state of each page of the snapshot, and the contents from when the snapshot was taken of the
+// pages which the fault handler copied before they got written to. Indexed by shm position.
+static std::unique_ptr<std::atomic<u8>[]> s_ram_snapshot_page_states;
+static std::unique_ptr<u8[]> s_ram_snapshot_copy;
+static std::vector<SnapshotDestination> s_ram_snapshot_destinations;
+
+static bool s_reserve_ram_in_state = false;
+static std::vector<StateRAMRegion> s_reserved_ram_regions;
+
 static u32 GetFlags()
 {
   bool wii = SConfig::GetInstance().bWii;
@@ -382,30 +430,426 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
             PanicAlert("MemoryMap_Setup: Failed finding a memory base.");
             exit(0);
           }
-          logical_mapped_entries.push_back({mapped_pointer, mapped_size});
+          logical_mapped_entries.push_back({mapped_pointer, mapped_size, position});
+
+          // New views aren't protected yet. Pages which already are dirty fault one more time.
+          if (s_write_protected)
+            Common::WriteProtectMemory(mapped_pointer, mapped_size);
         }
       }
     }
   }
 }
 
+// Calls f with every host pointer at which the given range of the shm segment is mapped.
+// The range must not cross a region boundary.
+template <typename F>
+static void ForEachView(u32 shm_position, u32 size, F f)
+{
+  const u32 flags = GetFlags();
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    if ((flags & region.flags) != region.flags || shm_position < region.shm_position ||
+        shm_position - region.shm_position >= region.size)
+    {
+      continue;
+    }
+
+    const u32 offset = shm_position - region.shm_position;
+    f(*region.out_pointer + offset, size);
+    if (is_fastmem_arena_initialized)
+      f(physical_base + region.physical_address + offset, size);
+  }
+
+  for (const LogicalMemoryView& entry : logical_mapped_entries)
+  {
+    const u32 start = std::max(shm_position, entry.shm_position);
+    const u32 end = std::min(shm_position + size, entry.shm_position + entry.mapped_size);
+    if (start < end)
+      f(static_cast<u8*>(entry.mapped_pointer) + (start - entry.shm_position), end - start);
+  }
+}
+
+static void ForEachRegionView(bool write_protect)
+{
+  // Stays set, so that faults which race with removing the protection are still handled.
+  if (write_protect)
+  {
+    s_write_protected = true;
+    ++s_protection_generation;
+  }
+
+  const u32 flags = GetFlags();
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    if ((flags & region.flags) != region.flags)
+      continue;
+
+    ForEachView(region.shm_position, region.size, [write_protect](u8* pointer, u32 size) {
+      if (write_protect)
+        Common::WriteProtectMemory(pointer, size);
+      else
+        Common::UnWriteProtectMemory(pointer, size);
+    });
+  }
+}
+
+static std::optional<u32> GetShmPosition(uintptr_t address)
+{
+  const auto contains = [address](const void* pointer, u32 size) {
+    const uintptr_t start = reinterpret_cast<uintptr_t>(pointer);
+    return pointer && address >= start && address - start < size;
+  };
+
+  const u32 flags = GetFlags();
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    if ((flags & region.flags) != region.flags)
+      continue;
+
+    if (contains(*region.out_pointer, region.size))
+      return region.shm_position + static_cast<u32>(address - (uintptr_t)*region.out_pointer);
+
+    u8* const fastmem_view = physical_base + region.physical_address;
+    if (is_fastmem_arena_initialized && contains(fastmem_view, region.size))
+      return region.shm_position + static_cast<u32>(address - (uintptr_t)fastmem_view);
+  }
+
+  for (const LogicalMemoryView& entry : logical_mapped_entries)
+  {
+    if (contains(entry.mapped_pointer, entry.mapped_size))
+      return entry.shm_position + static_cast<u32>(address - (uintptr_t)entry.mapped_pointer);
+  }
+
+  return std::nullopt;
+}
+
+static bool CanWriteProtectPages()
+{
+#if defined(_M_GENERIC) || (defined(__APPLE__) && !defined(USE_SIGACTION_ON_APPLE))
+  // The fault handler is missing, or only catches faults on the CPU thread.
+  return false;
+#else
+  // The fault handler is only installed when fastmem is enabled.
+  return m_IsInitialized && SConfig::GetInstance().bFastmem;
+#endif
+}
+
+static void AllocatePageState()
+{
+  if (s_dirty_page_bits)
+    return;
+
+  u32 mem_size = 0;
+  const u32 flags = GetFlags();
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    if ((flags & region.flags) == region.flags)
+      mem_size = std::max(mem_size, region.shm_position + region.size);
+  }
+
+  s_dirty_page_size = std::max<size_t>(Common::PageSize(), 0x1000);
+  s_page_count = mem_size / s_dirty_page_size;
+  s_dirty_page_bits = std::make_unique<std::atomic<u64>[]>((s_page_count + 63) / 64);
+  s_ram_snapshot_page_states = std::make_unique<std::atomic<u8>[]>(s_page_count);
+  // Left uninitialized, so that only the pages which get copied take up memory.
+  s_ram_snapshot_copy.reset(new u8[s_page_count * s_dirty_page_size]);
+}
+
+static bool IsPageDirtyInCurrentEpoch(size_t page_index)
+{
+  const u64 bits = s_dirty_page_bits[page_index / 64].load(std::memory_order_relaxed);
+  return (bits >> (page_index % 64)) & 1;
+}
+
+bool EnableDirtyPageTracking()
+{
+  if (!CanWriteProtectPages())
+    return false;
+
+  if (s_dirty_page_tracking)
+    return true;
+
+  AllocatePageState();
+  for (size_t i = 0; i < (s_page_count + 63) / 64; ++i)
+    s_dirty_page_bits[i].store(0, std::memory_order_relaxed);
+  s_page_dirty_epochs.assign(s_page_count, 0);
+  s_dirty_page_epoch = 0;
+  s_dirty_page_tracking = true;
+  return true;
+}
+
+void DisableDirtyPageTracking()
+{
+  if (!s_dirty_page_tracking)
+    return;
+
+  s_dirty_page_tracking = false;
+  if (!s_ram_snapshot_active)
+    ForEachRegionView(false);
+  s_page_dirty_epochs.clear();
+}
+
+bool IsDirtyPageTrackingEnabled()
+{
+  return s_dirty_page_tracking;
+}
+
+size_t GetDirtyPageSize()
+{
+  return s_dirty_page_size;
+}
+
+u64 StartDirtyPageEpoch()
+{
+  if (!s_dirty_page_tracking)
+    return 0;
+
+  // Move the pages written to in the ending epoch out of the bitmap before protecting them again.
+  // Pages which fault from here on belong to the new epoch.
+  for (size_t word = 0; word < (s_page_count + 63) / 64; ++word)
+  {
+    const u64 bits = s_dirty_page_bits[word].exchange(0, std::memory_order_relaxed);
+    for (size_t bit = 0; bits >> bit; ++bit)
+    {
+      if ((bits >> bit) & 1)
+        s_page_dirty_epochs[word * 64 + bit] = s_dirty_page_epoch;
+    }
+  }
+
+  ++s_dirty_page_epoch;
+  ForEachRegionView(true);
+  return s_dirty_page_epoch;
+}
+
+std::vector<u32> GetPagesDirtiedSince(u64 epoch)
+{
+  std::vector<u32> pages;
+  if (!s_dirty_page_tracking)
+    return pages;
+
+  const u32 flags = GetFlags();
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    if ((flags & region.flags) != region.flags)
+      continue;
+
+    for (u32 offset = 0; offset < region.size; offset += s_dirty_page_size)
+    {
+      const size_t page_index = (region.shm_position + offset) / s_dirty_page_size;
+      if (s_page_dirty_epochs[page_index] >= epoch ||
+          (s_dirty_page_epoch >= epoch && IsPageDirtyInCurrentEpoch(page_index)))
+      {
+        pages.push_back(region.physical_address + offset);
+      }
+    }
+  }
+  return pages;
+}
+
+static u8* GetPointerForShmPosition(u32 shm_position)
+{
+  const u32 flags = GetFlags();
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    if ((flags & region.flags) == region.flags && shm_position >= region.shm_position &&
+        shm_position - region.shm_position < region.size)
+    {
+      return *region.out_pointer + (shm_position - region.shm_position);
+    }
+  }
+  return nullptr;
+}
+
+// Copies a page of the snapshot which is still write protected to destination, unless another
+// thread has claimed the page first. In that case, waits until the page is in
+// s_ram_snapshot_copy and returns false.
+static bool ClaimSnapshotPage(u32 page_position, u8* destination, size_t size)
+{
+  std::atomic<u8>& state = s_ram_snapshot_page_states[page_position / s_dirty_page_size];
+  u8 expected = SNAPSHOT_PAGE_UNCOPIED;
+  if (state.compare_exchange_strong(expected, SNAPSHOT_PAGE_COPYING, std::memory_order_acquire))
+  {
+    std::memcpy(destination, GetPointerForShmPosition(page_position), size);
+    state.store(SNAPSHOT_PAGE_COPIED, std::memory_order_release);
+    return true;
+  }
+
+  // The page is only claimed for the duration of a memcpy.
+  while (state.load(std::memory_order_acquire) != SNAPSHOT_PAGE_COPIED)
+  {
+  }
+  return false;
+}
+
+bool HandleProtectedPageFault(uintptr_t address)
+{
+  if (!s_write_protected.load(std::memory_order_acquire))
+    return false;
+
+  const u32 generation = s_protection_generation.load();
+
+  // Other threads only write through the physical views, which are checked before the logical
+  // views that the CPU thread can change.
+  const std::optional<u32> shm_position = GetShmPosition(address);
+  if (!shm_position)
+    return false;
+
+  const u32 page_offset = *shm_position & static_cast<u32>(s_dirty_page_size - 1);
+  const u32 page_position = *shm_position - page_offset;
+  const size_t page_index = page_position / s_dirty_page_size;
+  if (s_dirty_page_tracking.load(std::memory_order_acquire))
+  {
+    s_dirty_page_bits[page_index / 64].fetch_or(u64(1) << (page_index % 64),
+                                                std::memory_order_relaxed);
+  }
+
+  // Keep the contents from when the snapshot was taken.
+  if (s_ram_snapshot_active.load(std::memory_order_acquire))
+  {
+    ClaimSnapshotPage(page_position, s_ram_snapshot_copy.get() + page_position,
+                      s_dirty_page_size);
+  }
+
+  // Only the view which was written to is unprotected. The other views of the page fault once
+  // more when they are written to, which doesn't need to touch the list of views.
+  void* const page = reinterpret_cast<void*>(address - page_offset);
+  Common::UnWriteProtectMemory(page, s_dirty_page_size);
+
+  // If a new epoch or snapshot started in the meantime, the page might have been unprotected
+  // without being recorded for it. Protect it again, and let the retried write fault once more.
+  if (s_protection_generation.load() != generation)
+    Common::WriteProtectMemory(page, s_dirty_page_size);
+  return true;
+}
+
+bool StartRAMSnapshot()
+{
+  if (!CanWriteProtectPages() || s_ram_snapshot_active)
+    return false;
+
+  AllocatePageState();
+  for (size_t i = 0; i < s_page_count; ++i)
+    s_ram_snapshot_page_states[i].store(SNAPSHOT_PAGE_UNCOPIED, std::memory_order_relaxed);
+  s_ram_snapshot_destinations.clear();
+  s_ram_snapshot_capturing = true;
+  s_ram_snapshot_active = true;
+  ForEachRegionView(true);
+  return true;
+}
+
+bool IsRAMSnapshotActive()
+{
+  return s_ram_snapshot_active;
+}
+
+void FinishRAMSnapshot()
+{
+  if (!s_ram_snapshot_active)
+    return;
+
+  for (const SnapshotDestination& destination : s_ram_snapshot_destinations)
+  {
+    for (u32 offset = 0; offset < destination.size; offset += s_dirty_page_size)
+    {
+      // Pages which haven't been claimed yet are still write protected, and writers wait in the
+      // fault handler until they are copied, so the page can't change while it is being copied.
+      const u32 page_position = destination.shm_position + offset;
+      const size_t size = std::min<size_t>(s_dirty_page_size, destination.size - offset);
+      if (!ClaimSnapshotPage(page_position, destination.destination + offset, size))
+        std::memcpy(destination.destination + offset, &s_ram_snapshot_copy[page_position], size);
+    }
+  }
+
+  // The pages stay protected, as this can be called from any thread while the CPU thread changes
+  // the views. Each one faults once more after which the fault handler unprotects it.
+  s_ram_snapshot_capturing = false;
+  s_ram_snapshot_destinations.clear();
+  s_ram_snapshot_active = false;
+}
+
+void ReserveRAMInNextState()
+{
+  s_reserve_ram_in_state = true;
+  s_reserved_ram_regions.clear();
+}
+
+std::vector<StateRAMRegion> TakeReservedRAMRegions()
+{
+  return std::move(s_reserved_ram_regions);
+}
+
+// Writes a region to the state, or only reserves space for it when a snapshot is being taken or
+// the caller fills in RAM itself.
+static void DoRegion(PointerWrap& p, u8* pointer, u32 size)
+{
+  if (p.GetMode() != PointerWrap::MODE_WRITE ||
+      (!s_ram_snapshot_capturing && !s_reserve_ram_in_state))
+  {
+    p.DoArray(pointer, size);
+    return;
+  }
+
+  if (s_ram_snapshot_capturing)
+  {
+    const std::optional<u32> shm_position = GetShmPosition(reinterpret_cast<uintptr_t>(pointer));
+    s_ram_snapshot_destinations.push_back({*shm_position, size, *p.ptr});
+  }
+  else
+  {
+    const auto region =
+        std::find_if(physical_regions.begin(), physical_regions.end(),
+                     [pointer](const PhysicalMemoryRegion& r) { return *r.out_pointer == pointer; });
+    s_reserved_ram_regions.push_back({region->physical_address, size, pointer, *p.ptr});
+  }
+  *p.ptr += size;
+}
+
+static void MarkAllPagesDirty()
+{
+  if (!s_dirty_page_tracking)
+    return;
+
+  // A snapshot still needs the faults to copy pages before they are overwritten.
+  if (!s_ram_snapshot_active)
+    ForEachRegionView(false);
+  std::fill(s_page_dirty_epochs.begin(), s_page_dirty_epochs.end(), s_dirty_page_epoch);
+}
+
 void DoState(PointerWrap& p)
 {
+  // Loading rewrites everything, so don't take a fault for every page.
+  if (p.GetMode() == PointerWrap::MODE_READ)
+    MarkAllPagesDirty();
+
   bool wii = SConfig::GetInstance().bWii;
-  p.DoArray(m_pRAM, GetRamSize());
-  p.DoArray(m_pL1Cache, GetL1CacheSize());
+  DoRegion(p, m_pRAM, GetRamSize());
+  DoRegion(p, m_pL1Cache, GetL1CacheSize());
   p.DoMarker("Memory RAM");
   if (m_pFakeVMEM)
-    p.DoArray(m_pFakeVMEM, GetFakeVMemSize());
+    DoRegion(p, m_pFakeVMEM, GetFakeVMemSize());
   p.DoMarker("Memory FakeVMEM");
   if (wii)
-    p.DoArray(m_pEXRAM, GetExRamSize());
+    DoRegion(p, m_pEXRAM, GetExRamSize());
   p.DoMarker("Memory EXRAM");
+
+  if (p.GetMode() == PointerWrap::MODE_WRITE)
+  {
+    s_ram_snapshot_capturing = false;
+    s_reserve_ram_in_state = false;
+  }
 }
 
 void Shutdown()
 {
+  s_ram_snapshot_destinations.clear();
+  FinishRAMSnapshot();
+  DisableDirtyPageTracking();
   ShutdownFastmemArena();
+  s_write_protected = false;
+  s_dirty_page_bits.reset();
+  s_ram_snapshot_page_states.reset();
+  s_ram_snapshot_copy.reset();
 
   m_IsInitialized = false;
   u32 flags = GetFlags();
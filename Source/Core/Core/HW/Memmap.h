@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
@@ -69,6 +71,48 @@ void DoState(PointerWrap& p);
 
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table);
 
+// Dirty page tracking. All views of emulated RAM are write protected at the start of an epoch,
+// and the first write to a page in that epoch marks it as dirty. Relies on the fault handler
+// from EMM, so this only works while it is installed.
+// Before the first epoch is started, every page counts as dirty.
+// Unless noted otherwise, these and the snapshot functions below must be called on the CPU thread.
+bool EnableDirtyPageTracking();
+void DisableDirtyPageTracking();
+bool IsDirtyPageTrackingEnabled();
+size_t GetDirtyPageSize();
+// Starts a new epoch and returns its number.
+u64 StartDirtyPageEpoch();
+// Physical addresses of the pages which have been written to in the given epoch or later, in
+// every region which DoState saves.
+std::vector<u32> GetPagesDirtiedSince(u64 epoch);
+
+// Copy-on-write snapshot of emulated RAM. After StartRAMSnapshot, the next DoState in write mode
+// only reserves space for RAM, and emulation can continue while FinishRAMSnapshot fills it in
+// with the contents from when the snapshot was taken. The pages are write protected, and the
+// fault handler copies a page before the first write to it.
+// Uses the same fault handler as dirty page tracking, so it has the same requirements.
+bool StartRAMSnapshot();
+bool IsRAMSnapshotActive();
+// Can be called from any thread.
+void FinishRAMSnapshot();
+
+// Called from the fault handler, on any thread.
+bool HandleProtectedPageFault(uintptr_t address);
+
+// Where a region of emulated RAM was placed in a state.
+struct StateRAMRegion
+{
+  u32 physical_address;
+  u32 size;
+  const u8* memory;
+  u8* state_pointer;
+};
+
+// Makes the next DoState in write mode only reserve space for RAM, so that the caller can fill it
+// in itself, for example only with the pages which changed. Must be called on the CPU thread.
+void ReserveRAMInNextState();
+std::vector<StateRAMRegion> TakeReservedRAMRegions();
+
 void Clear();
 
 // Routines to access physically addressed memory, designed for use by
@@ -81,8 +81,12 @@ void CachedInterpreter::ExecuteOneBlock()
   const u8* normal_entry = m_block_cache.Dispatch();
   if (!normal_entry)
   {
+    // Run new blocks right away, so that every call executes guest code. Jit64 relies on this
+    // when it counts the executions of blocks in its cold tier.
     Jit(PC);
-    return;
+    normal_entry = m_block_cache.Dispatch();
+    if (!normal_entry)
+      return;
   }
 
   const Instruction* code = reinterpret_cast<const Instruction*>(normal_entry);
@@ -32,11 +32,14 @@ public:
   const char* GetName() const override { return "Cached Interpreter"; }
   const CommonAsmRoutinesBase* GetAsmRoutines() override { return nullptr; }
 
+  // Runs the block at PC, compiling it first if necessary.
+  // Also used by Jit64 to run code which isn't hot enough to be compiled yet.
+  void ExecuteOneBlock();
+
 private:
   struct Instruction;
 
   u8* GetCodePtr();
-  void ExecuteOneBlock();
 
   bool HandleFunctionHooking(u32 address);
 
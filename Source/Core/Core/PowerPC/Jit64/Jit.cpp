@@ -4,6 +4,7 @@
 
 #include "Core/PowerPC/Jit64/Jit.h"
 
+#include <algorithm>
 #include <map>
 #include <sstream>
 #include <string>
@@ -25,6 +26,7 @@
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
 #include "Common/x64ABI.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/HLE/HLE.h"
@@ -32,8 +34,10 @@
 #include "Core/HW/GPFifo.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/ProcessorInterface.h"
+#include "Core/HW/SystemTimers.h"
 #include "Core/MachineContext.h"
 #include "Core/PatchEngine.h"
+#include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
 #include "Core/PowerPC/Jit64/JitAsm.h"
 #include "Core/PowerPC/Jit64/RegCache/JitRegCache.h"
 #include "Core/PowerPC/Jit64Common/FarCodeCache.h"
@@ -367,6 +371,32 @@ void Jit64::Init()
   if (m_enable_blr_optimization)
     AllocStack();
 
+  // Tiering is pointless when blocks get thrown away right after compiling them anyway, and it
+  // would get in the way of stepping and breakpoints.
+  if (Config::Get(Config::MAIN_JIT_TIERED_COMPILATION) &&
+      !SConfig::GetInstance().bJITNoBlockCache && !SConfig::GetInstance().bEnableDebugging)
+  {
+    m_tier_up_threshold = Config::Get(Config::MAIN_JIT_TIER_UP_THRESHOLD);
+    m_tier_up_budget = std::max<u32>(Config::Get(Config::MAIN_JIT_TIER_UP_BUDGET), 1);
+    m_tier_up_budget_left = m_tier_up_budget;
+    m_tier_up_budget_refill_ticks = 0;
+    m_execution_counts.Clear();
+
+    // The cold tier registers itself with JitRegister as well, so it has to be initialized
+    // before our block cache to not truncate the perf map afterwards.
+    m_cold_tier = std::make_unique<CachedInterpreter>();
+    m_cold_tier->Init();
+  }
+
+  m_enable_region_compilation = Config::Get(Config::MAIN_JIT_REGION_COMPILATION) &&
+                                !SConfig::GetInstance().bJITNoBlockCache &&
+                                !SConfig::GetInstance().bEnableDebugging;
+  if (m_enable_region_compilation)
+  {
+    m_region_threshold = std::max<u32>(Config::Get(Config::MAIN_JIT_REGION_THRESHOLD), 1);
+    analyzer.SetHotBranchPredicate([this](u32 address) { return IsHotBranch(address); });
+  }
+
   blocks.Init();
   asm_routines.Init(m_stack ? (m_stack + STACK_SIZE) : nullptr);
 
@@ -384,6 +414,17 @@ void Jit64::Init()
 
 void Jit64::ClearCache()
 {
+  if (m_cold_tier)
+  {
+    m_cold_tier->ClearCache();
+    m_execution_counts.Clear();
+  }
+
+  // The counters are referenced by the code which is about to be thrown away.
+  m_branch_counters.Clear();
+  m_branch_counter_storage.clear();
+  m_hot_regions.clear();
+
   blocks.Clear();
   trampolines.ClearCodeSpace();
   m_far_code.ClearCodeSpace();
@@ -403,6 +444,106 @@ void Jit64::Shutdown()
   blocks.Shutdown();
   m_far_code.Shutdown();
   m_const_pool.Shutdown();
+
+  if (m_cold_tier)
+  {
+    m_cold_tier->Shutdown();
+    m_cold_tier.reset();
+  }
+}
+
+void Jit64::InvalidateICache(u32 address, u32 size, bool forced)
+{
+  if (m_cold_tier)
+    m_cold_tier->InvalidateICache(address, size, forced);
+  blocks.InvalidateICache(address, size, forced);
+}
+
+void Jit64::ClearSafe()
+{
+  if (m_cold_tier)
+    m_cold_tier->ClearSafe();
+  blocks.Clear();
+}
+
+bool Jit64::ShouldCompile(u32 em_address)
+{
+  if (!m_cold_tier)
+    return true;
+
+  const u64 key = static_cast<u64>(MSR.Hex & JitBaseBlockCache::JIT_CACHE_MSR_MASK) << 32 |
+                  em_address;
+  u32& count = m_execution_counts[key];
+  if (++count < m_tier_up_threshold)
+    return false;
+
+  const u64 ticks = CoreTiming::GetTicks();
+  if (ticks >= m_tier_up_budget_refill_ticks)
+  {
+    m_tier_up_budget_left = m_tier_up_budget;
+    m_tier_up_budget_refill_ticks = ticks + SystemTimers::GetTicksPerSecond() / 1000;
+  }
+
+  // Out of budget for now, keep interpreting. The block will be compiled on one of its next
+  // executions.
+  if (m_tier_up_budget_left == 0)
+    return false;
+
+  --m_tier_up_budget_left;
+  m_execution_counts.Erase(key);
+  return true;
+}
+
+Jit64::BranchCounter* Jit64::GetBranchCounter(u32 address)
+{
+  BranchCounter*& counter = m_branch_counters[address];
+  if (!counter)
+    counter = &m_branch_counter_storage.emplace_back(BranchCounter{});
+  return counter;
+}
+
+bool Jit64::IsHotBranch(u32 address) const
+{
+  // Require some samples, and keep the fall-through below 1/8 of the executions.
+  constexpr u64 MIN_SAMPLES = 32;
+  BranchCounter* const* counter = m_branch_counters.Find(address);
+  if (!counter)
+    return false;
+  const u64 total = (*counter)->taken + (*counter)->not_taken;
+  return total >= MIN_SAMPLES && (*counter)->not_taken * 8 < total;
+}
+
+void Jit64::CountBranch(u32 address, bool taken)
+{
+  BranchCounter* counter = GetBranchCounter(address);
+  MOV(64, R(RSCRATCH), ImmPtr(taken ? &counter->taken : &counter->not_taken));
+  ADD(64, MatR(RSCRATCH), Imm8(1));
+}
+
+void Jit64::WriteRegionEntryCounter(JitBlock* b)
+{
+  // Block profiling already counts the runs.
+  MOV(64, R(RSCRATCH), ImmPtr(&b->profile_data.runCount));
+  if (!jo.profile_blocks)
+    ADD(64, MatR(RSCRATCH), Imm8(1));
+  CMP(64, MatR(RSCRATCH), Imm32(m_region_threshold));
+  FixupBranch hot = J_CC(CC_E, true);
+
+  SwitchToFarCode();
+  SetJumpTarget(hot);
+  MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+  ABI_PushRegistersAndAdjustStack({}, 0);
+  ABI_CallFunctionPC(OnHotRegion, this, js.blockStart);
+  ABI_PopRegistersAndAdjustStack({}, 0);
+  JMP(asm_routines.dispatcher_no_check, true);
+  SwitchToNearCode();
+}
+
+void Jit64::OnHotRegion(Jit64* jit, u32 address)
+{
+  // Throw away the profiling version, the dispatcher will recompile it as a region.
+  jit->m_hot_regions.insert(address);
+  jit->blocks.InvalidateICache(address, 4, true);
 }
 
 void Jit64::FallBackToInterpreter(UGeckoInstruction inst)
@@ -664,6 +805,17 @@ void Jit64::WriteIdleExit(u32 destination)
   WriteExceptionExit();
 }
 
+void Jit64::WriteFollowedBranchSideExit(u32 fall_through)
+{
+  RCForkGuard gpr_guard = gpr.Fork();
+  RCForkGuard fpr_guard = fpr.Fork();
+
+  gpr.Flush();
+  fpr.Flush();
+
+  WriteExit(fall_through);
+}
+
 void Jit64::WriteExceptionExit()
 {
   Cleanup();
@@ -736,6 +888,13 @@ void Jit64::Jit(u32 em_address)
 #endif
   }
 
+  if (!m_hot_regions.count(em_address) && !ShouldCompile(em_address))
+  {
+    // The dispatcher checks the downcount after returning from here.
+    m_cold_tier->ExecuteOneBlock();
+    return;
+  }
+
   if (IsAlmostFull() || m_far_code.IsAlmostFull() || trampolines.IsAlmostFull() ||
       SConfig::GetInstance().bJITNoBlockCache)
   {
@@ -778,7 +937,11 @@ void Jit64::Jit(u32 em_address)
   // Analyze the block, collect all instructions it is made of (including inlining,
   // if that is enabled), reorder instructions for optimal performance, and join joinable
   // instructions.
+  m_compiling_region = m_hot_regions.erase(em_address) != 0;
+  if (m_compiling_region)
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_HOT_BRANCH_FOLLOW);
   const u32 nextPC = analyzer.Analyze(em_address, &code_block, &m_code_buffer, block_size);
+  analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_HOT_BRANCH_FOLLOW);
 
   if (code_block.m_memory_exception)
   {
@@ -831,6 +994,9 @@ u8* Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
     ADD(64, MDisp(ABI_PARAM1, offset), Imm8(1));
     ABI_CallFunction(QueryPerformanceCounter);
   }
+
+  if (IsProfilingRegions())
+    WriteRegionEntryCounter(b);
 #if defined(_DEBUG) || defined(DEBUGFAST) || defined(NAN_CHECK)
   // should help logged stack-traces become more accurate
   MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
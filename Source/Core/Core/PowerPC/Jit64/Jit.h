@@ -18,7 +18,12 @@
 // ----------
 #pragma once
 
+#include <deque>
+#include <memory>
+#include <unordered_set>
+
 #include "Common/CommonTypes.h"
+#include "Common/FlatHashMap.h"
 #include "Common/x64ABI.h"
 #include "Common/x64Emitter.h"
 #include "Core/PowerPC/Jit64/JitAsm.h"
@@ -31,6 +36,8 @@
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/JitCommon/JitCache.h"
 
+class CachedInterpreter;
+
 namespace PPCAnalyst
 {
 struct CodeBlock;
@@ -67,6 +74,8 @@ public:
   void Trace();
 
   void ClearCache() override;
+  void InvalidateICache(u32 address, u32 size, bool forced) override;
+  void ClearSafe() override;
 
   const CommonAsmRoutines* GetAsmRoutines() override { return &asm_routines; }
   const char* GetName() const override { return "JIT64"; }
@@ -100,6 +109,9 @@ public:
   void DoMergedBranch();
   void DoMergedBranchCondition();
   void DoMergedBranchImmediate(s64 val);
+  void WriteFollowedBranchSideExit(u32 fall_through);
+  void CountBranch(u32 address, bool taken);
+  bool IsProfilingRegions() const { return m_enable_region_compilation && !m_compiling_region; }
 
   // Reads a given bit of a given CR register part.
   void GetCRFieldBit(int field, int bit, Gen::X64Reg out, bool negate = false);
@@ -243,6 +255,18 @@ private:
   void AllocStack();
   void FreeStack();
 
+  bool ShouldCompile(u32 em_address);
+
+  struct BranchCounter
+  {
+    u64 taken;
+    u64 not_taken;
+  };
+  BranchCounter* GetBranchCounter(u32 address);
+  bool IsHotBranch(u32 address) const;
+  void WriteRegionEntryCounter(JitBlock* b);
+  static void OnHotRegion(Jit64* jit, u32 address);
+
   JitBlockCache blocks{*this};
   TrampolineCache trampolines{*this};
 
@@ -254,6 +278,28 @@ private:
   bool m_enable_blr_optimization;
   bool m_cleanup_after_stackfault;
   u8* m_stack;
+
+  // Tiered compilation: code runs through a cached interpreter until it has been executed
+  // m_tier_up_threshold times, and at most m_tier_up_budget blocks get compiled per emulated
+  // millisecond. This spreads the compilation work of level loads over time and keeps one-shot
+  // initialization code out of the code cache.
+  std::unique_ptr<CachedInterpreter> m_cold_tier;
+  Common::FlatHashMap<u64, u32> m_execution_counts;  // (msrBits << 32 | address) -> count
+  u32 m_tier_up_threshold = 0;
+  u32 m_tier_up_budget = 0;
+  u32 m_tier_up_budget_left = 0;
+  u64 m_tier_up_budget_refill_ticks = 0;
+
+  // Region compilation: blocks are first compiled with counters for the block entry
+  // (JitBlock::profile_data.runCount) and for every conditional branch. Once a block has run
+  // m_region_threshold times, it gets recompiled with the taken side of almost always taken
+  // branches inlined, so the register caches stay live across them.
+  bool m_enable_region_compilation = false;
+  bool m_compiling_region = false;
+  u32 m_region_threshold = 0;
+  std::deque<BranchCounter> m_branch_counter_storage;  // referenced by generated code
+  Common::FlatHashMap<u32, BranchCounter*> m_branch_counters;  // branch address -> counter
+  std::unordered_set<u32> m_hot_regions;
 };
 
 void LogGeneratedX86(size_t size, const PPCAnalyst::CodeBuffer& code_buffer, const u8* normalEntry,
@@ -193,9 +193,14 @@ void Jit64AsmRoutineManager::Generate()
   ABI_CallFunction(JitTrampoline);
   ABI_PopRegistersAndAdjustStack({}, 0);
 
+  // With tiered compilation, JitTrampoline may have run a block through the interpreter tier
+  // instead of compiling it.
+  CMP(32, PPCSTATE(downcount), Imm8(0));
+  FixupBranch bail_after_jit = J_CC(CC_LE, true);
   JMP(dispatcher_no_check, true);
 
   SetJumpTarget(bail);
+  SetJumpTarget(bail_after_jit);
   do_timing = GetCodePtr();
 
   // make sure npc contains the next pc (needed for exception checking in CoreTiming::Advance)
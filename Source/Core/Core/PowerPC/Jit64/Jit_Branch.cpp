@@ -116,6 +116,10 @@ void Jit64::bcx(UGeckoInstruction inst)
 
   // USES_CR
 
+  const bool count_branch = IsProfilingRegions() && !inst.LK &&
+                            ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0 ||
+                             (inst.BO & BO_DONT_CHECK_CONDITION) == 0);
+
   FixupBranch pCTRDontBranch;
   if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)  // Decrement and test CTR
   {
@@ -133,6 +137,19 @@ void Jit64::bcx(UGeckoInstruction inst)
         JumpIfCRFieldBit(inst.BI >> 2, 3 - (inst.BI & 3), !(inst.BO_2 & BO_BRANCH_IF_TRUE));
   }
 
+  if (js.op->conditionalBranchFollowed)
+  {
+    // The taken side has been inlined, so only the fall-through leaves the block.
+    SwitchToFarCode();
+    if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
+      SetJumpTarget(pConditionDontBranch);
+    if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)
+      SetJumpTarget(pCTRDontBranch);
+    WriteFollowedBranchSideExit(js.compilerPC + 4);
+    SwitchToNearCode();
+    return;
+  }
+
   if (inst.LK)
     MOV(32, PPCSTATE_LR, Imm32(js.compilerPC + 4));
 
@@ -158,6 +175,9 @@ void Jit64::bcx(UGeckoInstruction inst)
     gpr.Flush();
     fpr.Flush();
 
+    if (count_branch)
+      CountBranch(js.compilerPC, true);
+
     if (js.op->branchIsIdleLoop)
     {
       WriteIdleExit(js.op->branchTo);
@@ -173,6 +193,9 @@ void Jit64::bcx(UGeckoInstruction inst)
   if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)
     SetJumpTarget(pCTRDontBranch);
 
+  if (count_branch)
+    CountBranch(js.compilerPC, false);
+
   if (!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE))
   {
     gpr.Flush();
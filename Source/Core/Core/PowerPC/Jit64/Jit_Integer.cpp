@@ -426,6 +426,18 @@ void Jit64::DoMergedBranchCondition()
   else  // SO bit, do not branch (we don't emulate SO for cmp).
     pDontBranch = J(true);
 
+  if (js.op[1].conditionalBranchFollowed)
+  {
+    // The taken side has been inlined, so only the fall-through leaves the block.
+    SwitchToFarCode();
+    SetJumpTarget(pDontBranch);
+    WriteFollowedBranchSideExit(nextPC + 4);
+    SwitchToNearCode();
+    return;
+  }
+
+  const bool count_branch = IsProfilingRegions() && next.OPCD == 16 && !next.LK;
+
   {
     RCForkGuard gpr_guard = gpr.Fork();
     RCForkGuard fpr_guard = fpr.Fork();
@@ -433,11 +445,17 @@ void Jit64::DoMergedBranchCondition()
     gpr.Flush();
     fpr.Flush();
 
+    if (count_branch)
+      CountBranch(nextPC, true);
+
     DoMergedBranch();
   }
 
   SetJumpTarget(pDontBranch);
 
+  if (count_branch)
+    CountBranch(nextPC, false);
+
   if (!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE))
   {
     gpr.Flush();
@@ -467,7 +485,17 @@ void Jit64::DoMergedBranchImmediate(s64 val)
   else  // SO bit, do not branch (we don't emulate SO for cmp).
     branch = false;
 
-  if (branch)
+  if (js.op[1].conditionalBranchFollowed)
+  {
+    // The taken side has been inlined.
+    if (!branch)
+    {
+      gpr.Flush();
+      fpr.Flush();
+      WriteExit(nextPC + 4);
+    }
+  }
+  else if (branch)
   {
     gpr.Flush();
     fpr.Flush();
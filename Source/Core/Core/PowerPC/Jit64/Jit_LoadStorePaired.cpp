@@ -57,32 +57,26 @@ void Jit64::psq_stXX(UGeckoInstruction inst)
   else
     CVTPD2PS(XMM0, Rs);  // pair
 
-  if (gqrIsConstant)
+  const EQuantizeType type = static_cast<EQuantizeType>(gqrValue & 0x7);
+  const bool typeIsValid =
+      type != QUANTIZE_INVALID1 && type != QUANTIZE_INVALID2 && type != QUANTIZE_INVALID3;
+
+  if (gqrIsConstant && typeIsValid)
+  {
+    // With the GQR known, the (de)quantization code is emitted inline for the type and scale,
+    // and the store itself can use fastmem.
+    GenQuantizedStore(w, type, (gqrValue & 0x3F00) >> 8);
+  }
+  else if (gqrIsConstant)
   {
-    int type = gqrValue & 0x7;
-
-    // Paired stores (other than w/type zero) don't yield any real change in
-    // performance right now, but if we can improve fastmem support this might change
-    if (gqrValue == 0)
-    {
-      if (w)
-        GenQuantizedStore(true, static_cast<EQuantizeType>(type), (gqrValue & 0x3F00) >> 8);
-      else
-        GenQuantizedStore(false, static_cast<EQuantizeType>(type), (gqrValue & 0x3F00) >> 8);
-    }
+    // Stash PC in case asm_routine causes exception
+    MOV(32, PPCSTATE(pc), Imm32(js.compilerPC));
+    MOV(32, R(RSCRATCH2), Imm32(gqrValue & 0x3F00));
+
+    if (w)
+      CALL(asm_routines.single_store_quantized[type]);
     else
-    {
-      // Stash PC in case asm_routine causes exception
-      MOV(32, PPCSTATE(pc), Imm32(js.compilerPC));
-      // We know what GQR is here, so we can load RSCRATCH2 and call into the store method directly
-      // with just the scale bits.
-      MOV(32, R(RSCRATCH2), Imm32(gqrValue & 0x3F00));
-
-      if (w)
-        CALL(asm_routines.single_store_quantized[type]);
-      else
-        CALL(asm_routines.paired_store_quantized[type]);
-    }
+      CALL(asm_routines.paired_store_quantized[type]);
   }
   else
   {
@@ -266,6 +266,17 @@ void Jit64::mtspr(UGeckoInstruction inst)
   }
 
   // OK, this is easy.
+  if (iIndex >= SPR_GQR0 && iIndex <= SPR_GQR0 + 7)
+  {
+    // Paired loads and stores later in this block can be specialized for a GQR value which
+    // gets set from a constant.
+    const u8 gqr = static_cast<u8>(iIndex - SPR_GQR0);
+    if (gpr.IsImm(d))
+      js.constantGqr[gqr] = gpr.Imm32(d);
+    else
+      js.constantGqr.erase(gqr);
+  }
+
   RCOpArg Rd = gpr.BindOrImm(d, RCMode::Read);
   RegCache::Realize(Rd);
   MOV(32, PPCSTATE(spr[iIndex]), Rd);
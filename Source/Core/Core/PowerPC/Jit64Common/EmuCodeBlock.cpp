@@ -4,8 +4,10 @@
 
 #include "Core/PowerPC/Jit64Common/EmuCodeBlock.h"
 
+#include <cstddef>
 #include <functional>
 #include <limits>
+#include <optional>
 
 #include "Common/Assert.h"
 #include "Common/CPUDetect.h"
@@ -118,6 +120,88 @@ FixupBranch EmuCodeBlock::CheckIfSafeAddress(const OpArg& reg_value, X64Reg reg_
   return J_CC(CC_Z, m_far_code.Enabled());
 }
 
+std::optional<FixupBranch>
+EmuCodeBlock::HostPageTableAccess(X64Reg reg_addr, const OpArg& reg_value, int access_size,
+                                  bool write, BitSet32 registers_in_use,
+                                  const std::function<void(const OpArg& host_address)>& access)
+{
+  static_assert(sizeof(PowerPC::HostPageTableEntry) == 16);
+  constexpr u32 HOST_PAGE_SIZE = 1 << PowerPC::HOST_PAGE_TABLE_SHIFT;
+
+  // Only registers the memory handlers could clobber are candidates.
+  X64Reg base = INVALID_REG;
+  for (X64Reg reg : {RSCRATCH2, RSCRATCH_EXTRA, RSCRATCH})
+  {
+    if (!registers_in_use[reg] && reg != reg_addr && !reg_value.IsSimpleReg(reg))
+    {
+      base = reg;
+      break;
+    }
+  }
+  if (base == INVALID_REG)
+    return std::nullopt;
+
+  // Holds the TLB tag of the page while the access is made, saved if nothing else is free.
+  X64Reg tag = INVALID_REG;
+  for (X64Reg reg : {RSCRATCH2, RSCRATCH_EXTRA, RSCRATCH, R8})
+  {
+    if (reg != base && reg != reg_addr && !reg_value.IsSimpleReg(reg))
+    {
+      tag = reg;
+      break;
+    }
+  }
+  const bool save_tag = registers_in_use[tag];
+
+  // Accesses crossing into the next page have to be translated one page at a time.
+  std::optional<FixupBranch> crosses_page;
+  if (access_size > 8)
+  {
+    MOV(32, R(base), R(reg_addr));
+    AND(32, R(base), Imm32(HOST_PAGE_SIZE - 1));
+    CMP(32, R(base), Imm32(HOST_PAGE_SIZE - access_size / 8));
+    crosses_page = J_CC(CC_A);
+  }
+
+  MOV(32, R(base), R(reg_addr));
+  SHR(32, R(base), Imm8(PowerPC::HOST_PAGE_TABLE_SHIFT));
+  SHL(64, R(base), Imm8(4));
+  ADD(64, R(base), PPCSTATE(host_page_table));
+  MOV(64, R(base),
+      MDisp(base, write ? offsetof(PowerPC::HostPageTableEntry, write) :
+                          offsetof(PowerPC::HostPageTableEntry, read)));
+  TEST(64, R(base), R(base));
+  FixupBranch not_mapped = J_CC(CC_Z);
+
+  if (save_tag)
+    PUSH(tag);
+  MOV(32, R(tag), R(reg_addr));
+  SHR(32, R(tag), Imm8(PowerPC::HOST_PAGE_TABLE_SHIFT));
+
+  access(MComplex(base, reg_addr, SCALE_1, 0));
+
+  // Make the page the most recently used one in its TLB set, like the lookup in MMU.cpp does.
+  const int tlb_offset = static_cast<int>(reinterpret_cast<char*>(&PowerPC::ppcState.tlb[0][0]) -
+                                          reinterpret_cast<char*>(&PowerPC::ppcState)) -
+                         0x80;
+  const int tag1_offset = tlb_offset + offsetof(PowerPC::TLBEntry, tag) + sizeof(u32);
+  const int recent_offset = tlb_offset + offsetof(PowerPC::TLBEntry, recent);
+  MOV(32, R(base), R(tag));
+  AND(32, R(base), Imm32(PowerPC::TLB_SIZE / PowerPC::TLB_WAYS - 1));
+  IMUL(32, base, R(base), Imm32(sizeof(PowerPC::TLBEntry)));
+  CMP(32, MComplex(RPPCSTATE, base, SCALE_1, tag1_offset), R(tag));
+  SETcc(CC_E, MComplex(RPPCSTATE, base, SCALE_1, recent_offset));
+  if (save_tag)
+    POP(tag);
+
+  FixupBranch done = J(true);
+
+  if (crosses_page)
+    SetJumpTarget(*crosses_page);
+  SetJumpTarget(not_mapped);
+  return done;
+}
+
 void EmuCodeBlock::UnsafeLoadRegToReg(X64Reg reg_addr, X64Reg reg_value, int accessSize, s32 offset,
                                       bool signExtend)
 {
@@ -383,6 +467,17 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress,
     SetJumpTarget(slow);
   }
 
+  // Pages translated through the page table never use the fastmem arena.
+  std::optional<FixupBranch> host_page_table_hit;
+  if (dr_set && m_jit.jo.memcheck)
+  {
+    host_page_table_hit = HostPageTableAccess(
+        reg_addr, R(reg_value), accessSize, false, registersInUse,
+        [&](const OpArg& host_address) {
+          LoadAndSwap(accessSize, reg_value, host_address, signExtend);
+        });
+  }
+
   // Helps external systems know which instruction triggered the read.
   // Invalid for calls from Jit64AsmCommon routines
   if (!(flags & SAFE_LOADSTORE_NO_UPDATE_PC))
@@ -429,6 +524,9 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress,
     }
     SetJumpTarget(exit);
   }
+
+  if (host_page_table_hit)
+    SetJumpTarget(*host_page_table_hit);
 }
 
 void EmuCodeBlock::SafeLoadToRegImmediate(X64Reg reg_value, u32 address, int accessSize,
@@ -551,6 +649,21 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
     SetJumpTarget(slow);
   }
 
+  // Pages translated through the page table never use the fastmem arena.
+  std::optional<FixupBranch> host_page_table_hit;
+  if (dr_set && m_jit.jo.memcheck)
+  {
+    host_page_table_hit = HostPageTableAccess(
+        reg_addr, reg_value, accessSize, true, registersInUse, [&](const OpArg& host_address) {
+          if (reg_value.IsImm())
+            MOV(accessSize, host_address, swap ? SwapImmediate(accessSize, reg_value) : reg_value);
+          else if (swap)
+            SwapAndStore(accessSize, host_address, reg_value.GetSimpleReg());
+          else
+            MOV(accessSize, host_address, reg_value);
+        });
+  }
+
   // PC is used by memory watchpoints (if enabled) or to print accurate PC locations in debug logs
   // Invalid for calls from Jit64AsmCommon routines
   if (!(flags & SAFE_LOADSTORE_NO_UPDATE_PC))
@@ -601,6 +714,9 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
     }
     SetJumpTarget(exit);
   }
+
+  if (host_page_table_hit)
+    SetJumpTarget(*host_page_table_hit);
 }
 
 void EmuCodeBlock::SafeWriteRegToReg(Gen::X64Reg reg_value, Gen::X64Reg reg_addr, int accessSize,
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <functional>
+#include <optional>
 #include <unordered_map>
 
 #include "Common/BitSet.h"
@@ -52,6 +54,13 @@ public:
 
   Gen::FixupBranch CheckIfSafeAddress(const Gen::OpArg& reg_value, Gen::X64Reg reg_addr,
                                       BitSet32 registers_in_use);
+  // Emits a lookup of reg_addr in the host page table of the MMU, followed by access() with the
+  // host address on a hit. Returns the branch taken after the access, execution falls through
+  // on a miss. Returns nothing if there is no free register for the lookup.
+  std::optional<Gen::FixupBranch>
+  HostPageTableAccess(Gen::X64Reg reg_addr, const Gen::OpArg& reg_value, int access_size,
+                      bool write, BitSet32 registers_in_use,
+                      const std::function<void(const Gen::OpArg& host_address)>& access);
   void UnsafeLoadRegToReg(Gen::X64Reg reg_addr, Gen::X64Reg reg_value, int accessSize,
                           s32 offset = 0, bool signExtend = false);
   void UnsafeLoadRegToRegNoSwap(Gen::X64Reg reg_addr, Gen::X64Reg reg_value, int accessSize,
@@ -546,7 +546,9 @@ void QuantizedMemoryRoutines::GenQuantizedStore(bool single, EQuantizeType type,
   if (!single)
     flags |= SAFE_LOADSTORE_NO_SWAP;
 
-  SafeWriteRegToReg(RSCRATCH, RSCRATCH_EXTRA, size, 0, QUANTIZED_REGS_TO_SAVE, flags);
+  // Inline code only needs to preserve what the register caches actually hold.
+  const BitSet32 regsToSave = isInline ? m_jit.CallerSavedRegistersInUse() : QUANTIZED_REGS_TO_SAVE;
+  SafeWriteRegToReg(RSCRATCH, RSCRATCH_EXTRA, size, 0, regsToSave, flags);
 }
 
 void QuantizedMemoryRoutines::GenQuantizedStoreFloat(bool single, bool isInline)
@@ -600,7 +602,8 @@ void QuantizedMemoryRoutines::GenQuantizedLoad(bool single, EQuantizeType type,
 
   if (safe_access)
   {
-    BitSet32 regsToSave = QUANTIZED_REGS_TO_SAVE_LOAD;
+    BitSet32 regsToSave =
+        isInline ? m_jit.CallerSavedRegistersInUse() : QUANTIZED_REGS_TO_SAVE_LOAD;
     int flags = isInline ? 0 :
                            SAFE_LOADSTORE_NO_FASTMEM | SAFE_LOADSTORE_NO_PROLOG |
                                SAFE_LOADSTORE_DR_ON | SAFE_LOADSTORE_NO_UPDATE_PC;
@@ -728,7 +731,7 @@ void QuantizedMemoryRoutines::GenQuantizedLoadFloat(bool single, bool isInline)
 
   if (safe_access)
   {
-    BitSet32 regsToSave = QUANTIZED_REGS_TO_SAVE;
+    BitSet32 regsToSave = isInline ? m_jit.CallerSavedRegistersInUse() : QUANTIZED_REGS_TO_SAVE;
     int flags = isInline ? 0 :
                            SAFE_LOADSTORE_NO_FASTMEM | SAFE_LOADSTORE_NO_PROLOG |
                                SAFE_LOADSTORE_DR_ON | SAFE_LOADSTORE_NO_UPDATE_PC;
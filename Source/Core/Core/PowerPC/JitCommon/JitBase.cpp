@@ -26,6 +26,16 @@ JitBase::JitBase() : m_code_buffer(code_buffer_size)
 
 JitBase::~JitBase() = default;
 
+void JitBase::InvalidateICache(u32 address, u32 size, bool forced)
+{
+  GetBlockCache()->InvalidateICache(address, size, forced);
+}
+
+void JitBase::ClearSafe()
+{
+  GetBlockCache()->Clear();
+}
+
 bool JitBase::CanMergeNextInstructions(int count) const
 {
   if (CPU::IsStepping() || js.instructionsLeft < count)
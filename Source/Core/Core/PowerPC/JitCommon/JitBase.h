@@ -114,6 +114,11 @@ public:
 
   virtual void Jit(u32 em_address) = 0;
 
+  // Throws away all compiled code overlapping the given range. JITs which keep code in more
+  // than one block cache need to override these.
+  virtual void InvalidateICache(u32 address, u32 size, bool forced);
+  virtual void ClearSafe();
+
   virtual const CommonAsmRoutinesBase* GetAsmRoutines() = 0;
 
   virtual bool HandleFault(uintptr_t access_address, SContext* ctx) = 0;
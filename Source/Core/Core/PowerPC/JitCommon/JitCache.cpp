@@ -13,9 +13,9 @@
 #include <array>
 #include <cstring>
 #include <functional>
-#include <map>
 #include <set>
 #include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/JitRegister.h"
@@ -65,13 +65,18 @@ void JitBaseBlockCache::Clear()
 #endif
   m_jit.js.fifoWriteAddresses.clear();
   m_jit.js.pairedQuantizeAddresses.clear();
-  for (auto& e : block_map)
-  {
-    DestroyBlock(e.second);
-  }
-  block_map.clear();
-  links_to.clear();
-  block_range_map.clear();
+  block_map.ForEach([this](u32, JitBlock* block) {
+    while (block)
+    {
+      JitBlock* next = block->next_in_bucket;
+      DestroyBlock(*block);
+      FreeBlock(*block);
+      block = next;
+    }
+  });
+  block_map.Clear();
+  links_to.Clear();
+  block_range_map.Clear();
 
   valid_block.ClearAll();
 
@@ -91,19 +96,22 @@ JitBlock** JitBaseBlockCache::GetFastBlockMap()
 
 void JitBaseBlockCache::RunOnBlocks(std::function<void(const JitBlock&)> f)
 {
-  for (const auto& e : block_map)
-    f(e.second);
+  block_map.ForEach([&f](u32, const JitBlock* block) {
+    for (; block; block = block->next_in_bucket)
+      f(*block);
+  });
 }
 
 JitBlock* JitBaseBlockCache::AllocateBlock(u32 em_address)
 {
   u32 physicalAddress = PowerPC::JitCache_TranslateAddress(em_address).address;
-  JitBlock& b = block_map.emplace(physicalAddress, JitBlock())->second;
+  JitBlock& b = *NewBlock();
   b.effectiveAddress = em_address;
   b.physicalAddress = physicalAddress;
   b.msrBits = MSR.Hex & JIT_CACHE_MSR_MASK;
   b.linkData.clear();
   b.fast_block_map_index = 0;
+  InsertIntoBlockMap(b);
   return &b;
 }
 
@@ -116,18 +124,27 @@ void JitBaseBlockCache::FinalizeBlock(JitBlock& block, bool block_link,
 
   block.physical_addresses = physical_addresses;
 
+  // physical_addresses is sorted, so all addresses of one macro block are adjacent.
   u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
+  bool first_range = true;
+  u32 last_range = 0;
   for (u32 addr : physical_addresses)
   {
     valid_block.Set(addr / 32);
-    block_range_map[addr & range_mask].insert(&block);
+    if (first_range || (addr & range_mask) != last_range)
+    {
+      last_range = addr & range_mask;
+      first_range = false;
+      block_range_map[last_range].push_back(&block);
+    }
   }
 
   if (block_link)
   {
-    for (const auto& e : block.linkData)
+    for (auto& e : block.linkData)
     {
-      links_to.emplace(e.exitAddress, &block);
+      e.owner = &block;
+      AddLinkTo(e);
     }
 
     LinkBlock(block);
@@ -160,12 +177,14 @@ JitBlock* JitBaseBlockCache::GetBlockFromStartAddress(u32 addr, u32 msr)
     translated_addr = translated.address;
   }
 
-  auto iter = block_map.equal_range(translated_addr);
-  for (; iter.first != iter.second; iter.first++)
+  JitBlock* const* bucket = block_map.Find(translated_addr);
+  if (!bucket)
+    return nullptr;
+
+  for (JitBlock* b = *bucket; b; b = b->next_in_bucket)
   {
-    JitBlock& b = iter.first->second;
-    if (b.effectiveAddress == addr && b.msrBits == (msr & JIT_CACHE_MSR_MASK))
-      return &b;
+    if (b->effectiveAddress == addr && b->msrBits == (msr & JIT_CACHE_MSR_MASK))
+      return b;
   }
 
   return nullptr;
@@ -223,50 +242,58 @@ void JitBaseBlockCache::InvalidateICache(u32 address, u32 length, bool forced)
 
 void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length)
 {
-  // Iterate over all macro blocks which overlap the given range.
+  if (length == 0 || block_range_map.Empty())
+    return;
+
+  // Collect all macro blocks which overlap the given range. Huge ranges (e.g. a full cache
+  // invalidation) are cheaper to find by scanning the occupied macro blocks instead.
   u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
-  auto start = block_range_map.lower_bound(address & range_mask);
-  auto end = block_range_map.lower_bound(address + length);
-  while (start != end)
+  const u64 range_start = address & range_mask;
+  const u64 range_end = u64{address} + length;
+  std::vector<u32> ranges;
+  if ((range_end - range_start) / BLOCK_RANGE_MAP_ELEMENTS > block_range_map.Size())
+  {
+    block_range_map.ForEach([&](u32 range, const std::vector<JitBlock*>&) {
+      if (range >= range_start && range < range_end)
+        ranges.push_back(range);
+    });
+  }
+  else
   {
+    for (u64 range = range_start; range < range_end; range += BLOCK_RANGE_MAP_ELEMENTS)
+    {
+      if (block_range_map.Contains(static_cast<u32>(range)))
+        ranges.push_back(static_cast<u32>(range));
+    }
+  }
+
+  std::vector<JitBlock*> overlapping;
+  for (u32 range : ranges)
+  {
+    // Blocks overlapping earlier ranges may already have dropped this macro block.
+    const std::vector<JitBlock*>* blocks = block_range_map.Find(range);
+    if (!blocks)
+      continue;
+
     // Iterate over all blocks in the macro block.
-    auto iter = start->second.begin();
-    while (iter != start->second.end())
+    overlapping.clear();
+    for (JitBlock* block : *blocks)
     {
-      JitBlock* block = *iter;
       if (block->OverlapsPhysicalRange(address, length))
-      {
-        // If the block overlaps, also remove all other occupied slots in the other macro blocks.
-        // This will leak empty macro blocks, but they may be reused or cleared later on.
-        for (u32 addr : block->physical_addresses)
-          if ((addr & range_mask) != start->first)
-            block_range_map[addr & range_mask].erase(block);
-
-        // And remove the block.
-        DestroyBlock(*block);
-        auto block_map_iter = block_map.equal_range(block->physicalAddress);
-        while (block_map_iter.first != block_map_iter.second)
-        {
-          if (&block_map_iter.first->second == block)
-          {
-            block_map.erase(block_map_iter.first);
-            break;
-          }
-          block_map_iter.first++;
-        }
-        iter = start->second.erase(iter);
-      }
-      else
-      {
-        iter++;
-      }
+        overlapping.push_back(block);
     }
 
-    // If the macro block is empty, drop it.
-    if (start->second.empty())
-      start = block_range_map.erase(start);
-    else
-      start++;
+    for (JitBlock* block : overlapping)
+    {
+      // If the block overlaps, remove it from all the macro blocks it occupies.
+      // This drops macro blocks which become empty.
+      RemoveFromBlockRangeMap(*block);
+
+      // And remove the block.
+      DestroyBlock(*block);
+      RemoveFromBlockMap(*block);
+      FreeBlock(*block);
+    }
   }
 }
 
@@ -304,13 +331,18 @@ void JitBaseBlockCache::LinkBlockExits(JitBlock& block)
 void JitBaseBlockCache::LinkBlock(JitBlock& block)
 {
   LinkBlockExits(block);
-  auto ppp = links_to.equal_range(block.effectiveAddress);
 
-  for (auto iter = ppp.first; iter != ppp.second; ++iter)
+  JitBlock::LinkData** first = links_to.Find(block.effectiveAddress);
+  if (!first)
+    return;
+
+  for (JitBlock::LinkData* e = *first; e; e = e->next_link_to)
   {
-    JitBlock& b2 = *iter->second;
-    if (block.msrBits == b2.msrBits)
-      LinkBlockExits(b2);
+    if (!e->linkStatus && e->owner->msrBits == block.msrBits)
+    {
+      WriteLinkBlock(*e, &block);
+      e->linkStatus = true;
+    }
   }
 }
 
@@ -323,21 +355,17 @@ void JitBaseBlockCache::UnlinkBlock(const JitBlock& block)
   }
 
   // Unlink all exits of other blocks which points to this block
-  auto ppp = links_to.equal_range(block.effectiveAddress);
-  for (auto iter = ppp.first; iter != ppp.second; ++iter)
+  JitBlock::LinkData** first = links_to.Find(block.effectiveAddress);
+  if (!first)
+    return;
+
+  for (JitBlock::LinkData* e = *first; e; e = e->next_link_to)
   {
-    JitBlock& sourceBlock = *iter->second;
-    if (sourceBlock.msrBits != block.msrBits)
+    if (e->owner->msrBits != block.msrBits)
       continue;
 
-    for (auto& e : sourceBlock.linkData)
-    {
-      if (e.exitAddress == block.effectiveAddress)
-      {
-        WriteLinkBlock(e, nullptr);
-        e.linkStatus = false;
-      }
-    }
+    WriteLinkBlock(*e, nullptr);
+    e->linkStatus = false;
   }
 }
 
@@ -349,16 +377,10 @@ void JitBaseBlockCache::DestroyBlock(JitBlock& block)
   UnlinkBlock(block);
 
   // Delete linking addresses
-  for (const auto& e : block.linkData)
+  for (auto& e : block.linkData)
   {
-    auto it = links_to.equal_range(e.exitAddress);
-    while (it.first != it.second)
-    {
-      if (it.first->second == &block)
-        it.first = links_to.erase(it.first);
-      else
-        it.first++;
-    }
+    if (e.owner)
+      RemoveLinkTo(e);
   }
 
   // Raise an signal if we are going to call this block again
@@ -388,3 +410,113 @@ size_t JitBaseBlockCache::FastLookupIndexForAddress(u32 address)
 {
   return (address >> 2) & FAST_BLOCK_MAP_MASK;
 }
+
+void JitBaseBlockCache::AddLinkTo(JitBlock::LinkData& link)
+{
+  JitBlock::LinkData*& first = links_to[link.exitAddress];
+  link.prev_link_to = nullptr;
+  link.next_link_to = first;
+  if (first)
+    first->prev_link_to = &link;
+  first = &link;
+}
+
+void JitBaseBlockCache::RemoveLinkTo(JitBlock::LinkData& link)
+{
+  if (link.next_link_to)
+    link.next_link_to->prev_link_to = link.prev_link_to;
+
+  if (link.prev_link_to)
+    link.prev_link_to->next_link_to = link.next_link_to;
+  else if (link.next_link_to)
+    links_to[link.exitAddress] = link.next_link_to;
+  else
+    links_to.Erase(link.exitAddress);
+
+  link.owner = nullptr;
+  link.prev_link_to = nullptr;
+  link.next_link_to = nullptr;
+}
+
+void JitBaseBlockCache::InsertIntoBlockMap(JitBlock& block)
+{
+  JitBlock*& first = block_map[block.physicalAddress];
+  block.next_in_bucket = first;
+  first = &block;
+}
+
+void JitBaseBlockCache::RemoveFromBlockMap(JitBlock& block)
+{
+  JitBlock** first = block_map.Find(block.physicalAddress);
+  if (!first)
+    return;
+
+  for (JitBlock** iter = first; *iter; iter = &(*iter)->next_in_bucket)
+  {
+    if (*iter == &block)
+    {
+      *iter = block.next_in_bucket;
+      break;
+    }
+  }
+
+  if (!*first)
+    block_map.Erase(block.physicalAddress);
+  block.next_in_bucket = nullptr;
+}
+
+void JitBaseBlockCache::RemoveFromBlockRangeMap(JitBlock& block)
+{
+  u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
+  bool first_range = true;
+  u32 last_range = 0;
+  for (u32 addr : block.physical_addresses)
+  {
+    if (!first_range && (addr & range_mask) == last_range)
+      continue;
+    last_range = addr & range_mask;
+    first_range = false;
+
+    std::vector<JitBlock*>* blocks = block_range_map.Find(last_range);
+    if (!blocks)
+      continue;
+
+    auto iter = std::find(blocks->begin(), blocks->end(), &block);
+    if (iter != blocks->end())
+    {
+      *iter = blocks->back();
+      blocks->pop_back();
+    }
+
+    if (blocks->empty())
+      block_range_map.Erase(last_range);
+  }
+}
+
+JitBlock* JitBaseBlockCache::NewBlock()
+{
+  if (!free_blocks)
+  {
+    auto& chunk = block_arena.emplace_back(std::make_unique<JitBlock[]>(BLOCK_ARENA_CHUNK_ELEMENTS));
+    for (size_t i = BLOCK_ARENA_CHUNK_ELEMENTS; i > 0; --i)
+    {
+      chunk[i - 1].next_in_bucket = free_blocks;
+      free_blocks = &chunk[i - 1];
+    }
+  }
+
+  JitBlock* block = free_blocks;
+  free_blocks = block->next_in_bucket;
+  block->next_in_bucket = nullptr;
+  return block;
+}
+
+void JitBaseBlockCache::FreeBlock(JitBlock& block)
+{
+  // Keep the allocations of the containers around for the next user of this block.
+  block.linkData.clear();
+  block.physical_addresses.clear();
+  block.profile_data = {};
+  block.next_in_bucket = free_blocks;
+  free_blocks = &block;
+}
@@ -8,13 +8,13 @@
 #include <bitset>
 #include <cstring>
 #include <functional>
-#include <map>
 #include <memory>
 #include <set>
 #include <type_traits>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/FlatHashMap.h"
 
 class JitBase;
 
@@ -68,9 +68,19 @@ struct JitBlock : public JitBlockData
     u32 exitAddress;
     bool linkStatus;  // is it already linked?
     bool call;
+
+    // Intrusive list of all exits which jump to the same exitAddress, see links_to
+    // in JitBaseBlockCache. Only valid once the owning block has been finalized.
+    JitBlock* owner = nullptr;
+    LinkData* prev_link_to = nullptr;
+    LinkData* next_link_to = nullptr;
   };
   std::vector<LinkData> linkData;
 
+  // Next block with the same physical start address in the block map, or the next
+  // unused block while this block is sitting in the free list of the block arena.
+  JitBlock* next_in_bucket = nullptr;
+
   // This set stores all physical addresses of all occupied instructions.
   std::set<u32> physical_addresses;
 
@@ -175,19 +185,36 @@ private:
   // Fast but risky block lookup based on fast_block_map.
   size_t FastLookupIndexForAddress(u32 address);
 
+  void AddLinkTo(JitBlock::LinkData& link);
+  void RemoveLinkTo(JitBlock::LinkData& link);
+
+  void InsertIntoBlockMap(JitBlock& block);
+  void RemoveFromBlockMap(JitBlock& block);
+  void RemoveFromBlockRangeMap(JitBlock& block);
+
+  JitBlock* NewBlock();
+  void FreeBlock(JitBlock& block);
+
   // links_to hold all exit points of all valid blocks in a reverse way.
   // It is used to query all blocks which links to an address.
-  std::multimap<u32, JitBlock*> links_to;  // destination_PC -> number
+  Common::FlatHashMap<u32, JitBlock::LinkData*> links_to;  // destination_PC -> first exit
 
   // Map indexed by the physical address of the entry point.
   // This is used to query the block based on the current PC in a slow way.
-  std::multimap<u32, JitBlock> block_map;  // start_addr -> block
+  // Blocks sharing a physical address are chained through JitBlock::next_in_bucket.
+  Common::FlatHashMap<u32, JitBlock*> block_map;  // start_addr -> first block
 
   // Range of overlapping code indexed by a masked physical address.
   // This is used for invalidation of memory regions. The range is grouped
   // in macro blocks of each 0x100 bytes.
   static constexpr u32 BLOCK_RANGE_MAP_ELEMENTS = 0x100;
-  std::map<u32, std::set<JitBlock*>> block_range_map;
+  Common::FlatHashMap<u32, std::vector<JitBlock*>> block_range_map;
+
+  // All JitBlocks are allocated from fixed size chunks, so their addresses stay stable
+  // and destroying a block doesn't hit the general purpose allocator.
+  static constexpr size_t BLOCK_ARENA_CHUNK_ELEMENTS = 0x1000;
+  std::vector<std::unique_ptr<JitBlock[]>> block_arena;
+  JitBlock* free_blocks = nullptr;
 
   // This bitsets shows which cachelines overlap with any blocks.
   // It is used to provide a fast way to query if no icache invalidation is needed.
@@ -22,13 +22,16 @@
 #include "Common/MsgHandler.h"
 
 #include "Core/Core.h"
+#include "Core/HW/Memmap.h"
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PPCAnalysisCache.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/PowerPC/Profiler.h"
+#include "Core/PowerPC/SamplingProfiler.h"
 
 #if _M_X86
 #include "Core/PowerPC/Jit64/Jit.h"
@@ -86,6 +89,16 @@ CPUCoreBase* GetCore()
 
 void SetProfilingState(ProfilingState state)
 {
+  if (state == ProfilingState::Enabled)
+  {
+    Profiler::ClearSamples();
+    Profiler::StartSampling();
+  }
+  else
+  {
+    Profiler::StopSampling();
+  }
+
   if (!g_jit)
     return;
 
@@ -94,6 +107,11 @@ void SetProfilingState(ProfilingState state)
 
 void WriteProfileResults(const std::string& filename)
 {
+  // The guest call stacks of the sampling profiler go next to the per block results.
+  const std::string folded_filename = filename + ".folded";
+  if (!Profiler::WriteFoldedStacks(folded_filename))
+    PanicAlert("Failed to open %s", folded_filename.c_str());
+
   Profiler::ProfileStats prof_stats;
   GetProfileResults(&prof_stats);
 
@@ -190,6 +208,10 @@ int GetHostCode(u32* address, const u8** code, u32* code_size)
 
 bool HandleFault(uintptr_t access_address, SContext* ctx)
 {
+  // Writes to write protected RAM can come from any thread, not just from JIT code.
+  if (Memory::HandleProtectedPageFault(access_address))
+    return true;
+
   // Prevent nullptr dereference on a crash with no JIT present
   if (!g_jit)
   {
@@ -217,13 +239,13 @@ void ClearCache()
 void ClearSafe()
 {
   if (g_jit)
-    g_jit->GetBlockCache()->Clear();
+    g_jit->ClearSafe();
 }
 
 void InvalidateICache(u32 address, u32 size, bool forced)
 {
   if (g_jit)
-    g_jit->GetBlockCache()->InvalidateICache(address, size, forced);
+    g_jit->InvalidateICache(address, size, forced);
 }
 
 void CompileExceptionCheck(ExceptionType type)
@@ -271,5 +293,7 @@ void Shutdown()
     delete g_jit;
     g_jit = nullptr;
   }
+
+  PPCAnalyst::AnalysisCache::Shutdown();
 }
 }  // namespace JitInterface
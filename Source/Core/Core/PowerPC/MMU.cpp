@@ -10,6 +10,7 @@
 
 #include "Common/BitUtils.h"
 #include "Common/CommonTypes.h"
+#include "Common/MemoryUtil.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/HW/CPU.h"
@@ -166,11 +167,83 @@ BatTable dbat_table;
 
 static void GenerateDSIException(u32 effective_address, bool write);
 
+// Returns the host address of a data access through the host page table, or nullptr if the
+// access has to be translated the regular way.
+template <XCheckTLBFlag flag, typename T>
+static u8* GetHostPageTablePointer(u32 address, bool write)
+{
+  if (!ppcState.host_page_table || (address & (HW_PAGE_SIZE - 1)) > HW_PAGE_SIZE - sizeof(T))
+    return nullptr;
+
+  const u32 tag = address >> HOST_PAGE_TABLE_SHIFT;
+  const HostPageTableEntry& entry = ppcState.host_page_table[tag];
+  const uintptr_t base = write ? entry.write : entry.read;
+  if (base == 0)
+    return nullptr;
+
+  // Count this as a use of the TLB entry like LookupTLBPageAddress does, or the page would look
+  // cold to UpdateTLBEntry and get evicted while it is being accessed all the time.
+  if (!IsNoExceptionFlag(flag))
+  {
+    TLBEntry& tlbe = ppcState.tlb[0][tag & HW_PAGE_INDEX_MASK];
+    tlbe.recent = tlbe.tag[1] == tag;
+  }
+
+  return reinterpret_cast<u8*>(base + address);
+}
+
+static void MapHostPage(u32 effective_address, u32 physical_address, bool write)
+{
+  if (!ppcState.host_page_table)
+    return;
+
+  const u32 effective_page = effective_address & ~static_cast<u32>(HW_PAGE_SIZE - 1);
+  const u32 physical_page = physical_address & ~static_cast<u32>(HW_PAGE_SIZE - 1);
+
+  u8* host_page;
+  if ((physical_page & 0xF8000000) == 0x00000000)
+    host_page = &Memory::m_pRAM[physical_page & Memory::GetRamMask()];
+  else if (Memory::m_pEXRAM && (physical_page >> 28) == 0x1 &&
+           (physical_page & 0x0FFFFFFF) < Memory::GetExRamSizeReal())
+    host_page = &Memory::m_pEXRAM[physical_page & 0x0FFFFFFF];
+  else
+    return;
+
+  // Memchecks are only handled by the regular path.
+  if (memchecks.OverlapsMemcheck(effective_page, HW_PAGE_SIZE))
+    return;
+
+  const uintptr_t base = reinterpret_cast<uintptr_t>(host_page) - effective_page;
+  if (base == 0)
+    return;
+
+  HostPageTableEntry& entry = ppcState.host_page_table[effective_page >> HOST_PAGE_TABLE_SHIFT];
+  entry.read = base;
+  if (write)
+    entry.write = base;
+}
+
+static void UnmapHostPage(u32 tag)
+{
+  if (ppcState.host_page_table && tag < HOST_PAGE_TABLE_ENTRIES)
+    ppcState.host_page_table[tag] = {};
+}
+
 template <XCheckTLBFlag flag, typename T, bool never_translate = false>
 static T ReadFromHardware(u32 em_address)
 {
   if (!never_translate && MSR.DR)
   {
+    if (!IsOpcodeFlag(flag))
+    {
+      if (const u8* host_ptr = GetHostPageTablePointer<flag, T>(em_address, false))
+      {
+        T value;
+        std::memcpy(&value, host_ptr, sizeof(T));
+        return bswap(value);
+      }
+    }
+
     auto translated_addr = TranslateAddress<flag>(em_address);
     if (!translated_addr.Success())
     {
@@ -178,6 +251,11 @@ static T ReadFromHardware(u32 em_address)
         GenerateDSIException(em_address, false);
       return 0;
     }
+    if (flag == XCheckTLBFlag::Read &&
+        translated_addr.result == TranslateAddressResult::PAGE_TABLE_TRANSLATED)
+    {
+      MapHostPage(em_address, translated_addr.address, false);
+    }
     if ((em_address & (HW_PAGE_SIZE - 1)) > HW_PAGE_SIZE - sizeof(T))
     {
       // This could be unaligned down to the byte level... hopefully this is rare, so doing it this
@@ -259,6 +337,13 @@ static void WriteToHardware(u32 em_address, const T data)
 {
   if (!never_translate && MSR.DR)
   {
+    if (u8* host_ptr = GetHostPageTablePointer<flag, T>(em_address, true))
+    {
+      const T swapped_data = bswap(data);
+      std::memcpy(host_ptr, &swapped_data, sizeof(T));
+      return;
+    }
+
     auto translated_addr = TranslateAddress<flag>(em_address);
     if (!translated_addr.Success())
     {
@@ -266,6 +351,11 @@ static void WriteToHardware(u32 em_address, const T data)
         GenerateDSIException(em_address, true);
       return;
     }
+    if (flag == XCheckTLBFlag::Write &&
+        translated_addr.result == TranslateAddressResult::PAGE_TABLE_TRANSLATED)
+    {
+      MapHostPage(em_address, translated_addr.address, true);
+    }
     if ((em_address & (sizeof(T) - 1)) &&
         (em_address & (HW_PAGE_SIZE - 1)) > HW_PAGE_SIZE - sizeof(T))
     {
@@ -980,6 +1070,7 @@ void SDRUpdated()
   }
   PowerPC::ppcState.pagetable_base = htaborg << 16;
   PowerPC::ppcState.pagetable_hashmask = ((htabmask << 10) | 0x3ff);
+  InvalidateHostPageTable();
 }
 
 enum class TLBLookupResult
@@ -1049,6 +1140,8 @@ static void UpdateTLBEntry(const XCheckTLBFlag flag, UPTE2 PTE2, const u32 addre
   const int tag = address >> HW_PAGE_INDEX_SHIFT;
   TLBEntry& tlbe = ppcState.tlb[IsOpcodeFlag(flag)][tag & HW_PAGE_INDEX_MASK];
   const int index = tlbe.recent == 0 && tlbe.tag[0] != TLBEntry::INVALID_TAG;
+  if (!IsOpcodeFlag(flag))
+    UnmapHostPage(tlbe.tag[index]);
   tlbe.recent = index;
   tlbe.paddr[index] = PTE2.RPN << HW_PAGE_INDEX_SHIFT;
   tlbe.pte[index] = PTE2.Hex;
@@ -1060,6 +1153,8 @@ void InvalidateTLBEntry(u32 address)
   const u32 entry_index = (address >> HW_PAGE_INDEX_SHIFT) & HW_PAGE_INDEX_MASK;
 
   TLBEntry& tlbe = ppcState.tlb[0][entry_index];
+  UnmapHostPage(tlbe.tag[0]);
+  UnmapHostPage(tlbe.tag[1]);
   tlbe.tag[0] = TLBEntry::INVALID_TAG;
   tlbe.tag[1] = TLBEntry::INVALID_TAG;
 
@@ -1068,6 +1163,30 @@ void InvalidateTLBEntry(u32 address)
   tlbe_i.tag[1] = TLBEntry::INVALID_TAG;
 }
 
+void InitHostPageTable()
+{
+  // Only the pages of the table which are actually used get committed.
+  ppcState.host_page_table = static_cast<HostPageTableEntry*>(
+      Common::AllocateMemoryPages(HOST_PAGE_TABLE_ENTRIES * sizeof(HostPageTableEntry)));
+}
+
+void ShutdownHostPageTable()
+{
+  Common::FreeMemoryPages(ppcState.host_page_table,
+                          HOST_PAGE_TABLE_ENTRIES * sizeof(HostPageTableEntry));
+  ppcState.host_page_table = nullptr;
+}
+
+void InvalidateHostPageTable()
+{
+  // Every entry belongs to a page in the data TLB.
+  for (const TLBEntry& tlbe : ppcState.tlb[0])
+  {
+    for (u32 tag : tlbe.tag)
+      UnmapHostPage(tag);
+  }
+}
+
 // Page Address Translation
 static TranslateAddressResult TranslatePageAddress(const u32 address, const XCheckTLBFlag flag)
 {
@@ -1267,6 +1386,9 @@ void DBATUpdated()
   Memory::UpdateLogicalMemory(dbat_table);
 #endif
 
+  // BATs take precedence over the page table, and memchecks might have changed.
+  InvalidateHostPageTable();
+
   // IsOptimizable*Address and dcbz depends on the BAT mapping, so we need a flush here.
   JitInterface::ClearSafe();
 }
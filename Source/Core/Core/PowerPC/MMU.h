@@ -88,6 +88,20 @@ void InvalidateTLBEntry(u32 address);
 void DBATUpdated();
 void IBATUpdated();
 
+// The host page table maps effective pages which were translated through the page table and
+// are backed by RAM to host memory, so that later data accesses to them can skip the BAT check,
+// the TLB lookup and the memory region dispatch.
+//
+// An entry is the host address of the page minus its effective address, so adding the effective
+// address of an access to it gives the host address. Entries only exist for pages which are in
+// the data TLB, and write entries only once the C bit of the PTE is set. Anything which can
+// change the translation of a page clears the entry along with the TLB entry.
+constexpr u32 HOST_PAGE_TABLE_SHIFT = 12;
+constexpr size_t HOST_PAGE_TABLE_ENTRIES = size_t{1} << (32 - HOST_PAGE_TABLE_SHIFT);
+void InitHostPageTable();
+void ShutdownHostPageTable();
+void InvalidateHostPageTable();
+
 // Result changes based on the BAT registers and MSR.DR.  Returns whether
 // it's safe to optimize a read or write to this address to an unguarded
 // memory access.  Does not consider page tables.
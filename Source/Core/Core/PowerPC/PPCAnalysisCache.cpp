@@ -0,0 +1,272 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/PowerPC/PPCAnalysisCache.h"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/FlatHashMap.h"
+#include "Common/LinearDiskCache.h"
+#include "Common/Logging/Log.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PPCTables.h"
+
+namespace PPCAnalyst::AnalysisCache
+{
+namespace
+{
+// How many different versions of the code at one address are kept around,
+// e.g. for overlays which get loaded to the same address.
+constexpr size_t MAX_VERSIONS_PER_ADDRESS = 4;
+
+struct DiskKey
+{
+  u32 address;
+  u32 options;
+  u32 block_size;
+};
+static_assert(std::is_trivially_copyable_v<DiskKey>);
+
+// Followed by num_instructions CodeOps with their opinfo pointers cleared.
+struct CachedBlockHeader
+{
+  u32 next_pc;
+  u32 num_instructions;
+  BlockStats stats;
+  BlockRegStats gpa;
+  BlockRegStats fpa;
+  bool broken;
+  BitSet8 gqr_used;
+  BitSet8 gqr_modified;
+  BitSet32 gpr_inputs;
+};
+static_assert(std::is_trivially_copyable_v<CachedBlockHeader>);
+static_assert(std::is_trivially_copyable_v<CodeOp>);
+
+struct Entry
+{
+  DiskKey key;
+  std::vector<u8> data;
+};
+
+class CacheReader final : public LinearDiskCacheReader<DiskKey, u8>
+{
+public:
+  void Read(const DiskKey& key, const u8* value, u32 value_size) override
+  {
+    entries.push_back({key, std::vector<u8>(value, value + value_size)});
+  }
+
+  std::vector<Entry> entries;
+};
+
+bool s_enabled = false;
+std::atomic<bool> s_title_changed{true};
+LinearDiskCache<DiskKey, u8> s_disk_cache;
+Common::FlatHashMap<u32, std::vector<Entry>> s_entries;
+
+std::string GetCacheFileName(const std::string& game_id)
+{
+  return File::GetUserPath(D_CACHE_IDX) + "JIT" DIR_SEP + game_id + ".analysis";
+}
+
+// Returns false if the oldest entry for the same settings had to be dropped.
+bool Insert(Entry entry)
+{
+  std::vector<Entry>& versions = s_entries[entry.key.address];
+  size_t count = 0;
+  auto oldest = versions.end();
+  for (auto it = versions.begin(); it != versions.end(); ++it)
+  {
+    if (it->key.options != entry.key.options || it->key.block_size != entry.key.block_size)
+      continue;
+    if (oldest == versions.end())
+      oldest = it;
+    ++count;
+  }
+
+  const bool dropped = count >= MAX_VERSIONS_PER_ADDRESS;
+  if (dropped)
+    versions.erase(oldest);
+  versions.push_back(std::move(entry));
+  return !dropped;
+}
+
+// Truncated or otherwise damaged entries must never be copied into a CodeBuffer.
+bool HasValidSize(const Entry& entry)
+{
+  if (entry.data.size() < sizeof(CachedBlockHeader))
+    return false;
+  CachedBlockHeader header;
+  std::memcpy(&header, entry.data.data(), sizeof(header));
+  const size_t ops_size = entry.data.size() - sizeof(header);
+  return ops_size % sizeof(CodeOp) == 0 && ops_size / sizeof(CodeOp) == header.num_instructions;
+}
+
+void Close()
+{
+  s_disk_cache.Sync();
+  s_disk_cache.Close();
+  s_entries.Clear();
+}
+
+void Open(const std::string& game_id)
+{
+  Close();
+  s_enabled = Config::Get(Config::MAIN_JIT_ANALYSIS_CACHE);
+  if (!s_enabled)
+    return;
+
+  const std::string filename = GetCacheFileName(game_id);
+  File::CreateFullPath(filename);
+
+  CacheReader reader;
+  const u32 count = s_disk_cache.OpenAndRead(filename, reader);
+  size_t dropped = 0;
+  for (Entry& entry : reader.entries)
+    dropped += HasValidSize(entry) && Insert(std::move(entry)) ? 0 : 1;
+
+  // The file is append-only, so rewrite it once most of it is made of superseded code versions
+  // or damaged entries.
+  if (dropped > count / 2)
+  {
+    s_disk_cache.Close();
+    File::Delete(filename);
+    CacheReader empty_reader;
+    s_disk_cache.OpenAndRead(filename, empty_reader);
+    s_entries.ForEach([](u32, const std::vector<Entry>& versions) {
+      for (const Entry& entry : versions)
+        s_disk_cache.Append(entry.key, entry.data.data(), static_cast<u32>(entry.data.size()));
+    });
+  }
+
+  INFO_LOG(DYNA_REC, "Loaded %u cached block analyses from %s (%zu superseded or invalid)", count,
+           filename.c_str(), dropped);
+}
+
+bool IsActive()
+{
+  if (s_title_changed.load(std::memory_order_relaxed) && s_title_changed.exchange(false))
+    Open(SConfig::GetInstance().GetGameID());
+  return s_enabled;
+}
+
+// Checks whether the code in memory still matches the cached block, and collects the physical
+// addresses of the block the same way the analyzer would have.
+bool Validate(const Entry& entry, CodeBlock* block)
+{
+  CachedBlockHeader header;
+  std::memcpy(&header, entry.data.data(), sizeof(header));
+  const u8* ops = entry.data.data() + sizeof(header);
+
+  block->m_physical_addresses.clear();
+  for (u32 i = 0; i < header.num_instructions; ++i)
+  {
+    CodeOp op;
+    std::memcpy(&op, ops + i * sizeof(CodeOp), sizeof(CodeOp));
+    const auto result = PowerPC::TryReadInstruction(op.address);
+    if (!result.valid || result.hex != op.inst.hex)
+      return false;
+    block->m_physical_addresses.insert(result.physical_address);
+  }
+  return true;
+}
+}  // Anonymous namespace
+
+void Shutdown()
+{
+  Close();
+  s_enabled = false;
+  s_title_changed = true;
+}
+
+void OnTitleChanged()
+{
+  s_title_changed = true;
+}
+
+std::optional<u32> Lookup(u32 options, u32 address, CodeBlock* block, CodeBuffer* buffer,
+                          std::size_t block_size)
+{
+  if (!IsActive())
+    return std::nullopt;
+
+  const std::vector<Entry>* versions = s_entries.Find(address);
+  if (!versions)
+    return std::nullopt;
+
+  // Newest versions first, they are the most likely ones to be loaded right now.
+  for (auto it = versions->rbegin(); it != versions->rend(); ++it)
+  {
+    const Entry& entry = *it;
+    if (entry.key.options != options || entry.key.block_size != block_size)
+      continue;
+
+    CachedBlockHeader header;
+    std::memcpy(&header, entry.data.data(), sizeof(header));
+    if (header.num_instructions > buffer->size() || !Validate(entry, block))
+      continue;
+
+    CodeOp* code = buffer->data();
+    std::memcpy(code, entry.data.data() + sizeof(header), header.num_instructions * sizeof(CodeOp));
+    for (u32 i = 0; i < header.num_instructions; ++i)
+      code[i].opinfo = PPCTables::GetOpInfo(code[i].inst);
+
+    block->m_address = address;
+    block->m_num_instructions = header.num_instructions;
+    *block->m_stats = header.stats;
+    *block->m_gpa = header.gpa;
+    *block->m_fpa = header.fpa;
+    block->m_broken = header.broken;
+    block->m_memory_exception = false;
+    block->m_gqr_used = header.gqr_used;
+    block->m_gqr_modified = header.gqr_modified;
+    block->m_gpr_inputs = header.gpr_inputs;
+    return header.next_pc;
+  }
+
+  return std::nullopt;
+}
+
+void Store(u32 options, const CodeBlock& block, const CodeBuffer& buffer, std::size_t block_size,
+           u32 next_pc)
+{
+  if (!IsActive() || block.m_memory_exception || block.m_num_instructions == 0)
+    return;
+
+  CachedBlockHeader header{};
+  header.next_pc = next_pc;
+  header.num_instructions = block.m_num_instructions;
+  header.stats = *block.m_stats;
+  header.gpa = *block.m_gpa;
+  header.fpa = *block.m_fpa;
+  header.broken = block.m_broken;
+  header.gqr_used = block.m_gqr_used;
+  header.gqr_modified = block.m_gqr_modified;
+  header.gpr_inputs = block.m_gpr_inputs;
+
+  Entry entry;
+  entry.key = {block.m_address, options, static_cast<u32>(block_size)};
+  entry.data.resize(sizeof(header) + block.m_num_instructions * sizeof(CodeOp));
+  std::memcpy(entry.data.data(), &header, sizeof(header));
+  u8* ops = entry.data.data() + sizeof(header);
+  for (u32 i = 0; i < block.m_num_instructions; ++i)
+  {
+    CodeOp op = buffer[i];
+    op.opinfo = nullptr;
+    std::memcpy(ops + i * sizeof(CodeOp), &op, sizeof(CodeOp));
+  }
+
+  s_disk_cache.Append(entry.key, entry.data.data(), static_cast<u32>(entry.data.size()));
+  Insert(std::move(entry));
+}
+}  // namespace PPCAnalyst::AnalysisCache
@@ -0,0 +1,32 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include "Common/CommonTypes.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+
+// Persistent per-game cache of PPCAnalyzer results.
+//
+// Every analyzed block is stored together with the instruction words it was built from. On later
+// boots, a cached result is only used if the words currently in memory still match, so changed
+// or relocated code (overlays, RELs) falls back to a normal analysis automatically.
+namespace PPCAnalyst::AnalysisCache
+{
+void Shutdown();
+
+// Switches to the cache of the new game ID on the next lookup. Can be called from any thread.
+void OnTitleChanged();
+
+// options combines the analyzer options with anything else the result depends on.
+// Returns the next PC if a valid cached result has been copied to block and buffer.
+std::optional<u32> Lookup(u32 options, u32 address, CodeBlock* block, CodeBuffer* buffer,
+                          std::size_t block_size);
+
+void Store(u32 options, const CodeBlock& block, const CodeBuffer& buffer, std::size_t block_size,
+           u32 next_pc);
+}  // namespace PPCAnalyst::AnalysisCache
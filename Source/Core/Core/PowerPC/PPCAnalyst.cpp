@@ -19,6 +19,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PPCAnalysisCache.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PPCTables.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -41,6 +42,9 @@ namespace PPCAnalyst
 // 0 does not perform block merging
 constexpr u32 BRANCH_FOLLOWING_THRESHOLD = 2;
 
+// Maximum number of hot conditional branches to inline into a single block.
+constexpr u32 HOT_BRANCH_FOLLOWING_THRESHOLD = 8;
+
 constexpr u32 INVALID_BRANCH_TARGET = 0xFFFFFFFF;
 
 static u32 EvaluateBranchTarget(UGeckoInstruction instr, u32 pc)
@@ -728,6 +732,36 @@ bool PPCAnalyzer::IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instruct
 }
 
 u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std::size_t block_size)
+{
+  // With debugging enabled, the analysis also depends on the breakpoints, which can change at any
+  // time, so it isn't cached.
+  if (HasOption(OPTION_HOT_BRANCH_FOLLOW) || SConfig::GetInstance().bEnableDebugging)
+  {
+    bool truncated = false;
+    return AnalyzeUncached(address, block, buffer, block_size, &truncated);
+  }
+
+  // The result also depends on whether branch following is enabled globally.
+  const u32 cache_options =
+      m_options | (SConfig::GetInstance().bJITFollowBranch ? CACHE_OPTION_FOLLOW_BRANCH : 0);
+  if (const auto cached_next_pc =
+          AnalysisCache::Lookup(cache_options, address, block, buffer, block_size))
+  {
+    return *cached_next_pc;
+  }
+
+  bool truncated = false;
+  const u32 next_pc = AnalyzeUncached(address, block, buffer, block_size, &truncated);
+
+  // Blocks which ended at unreadable memory might look different once it is mapped.
+  if (!truncated)
+    AnalysisCache::Store(cache_options, *block, *buffer, block_size, next_pc);
+
+  return next_pc;
+}
+
+u32 PPCAnalyzer::AnalyzeUncached(u32 address, CodeBlock* block, CodeBuffer* buffer,
+                                 std::size_t block_size, bool* truncated)
 {
   // Clear block stats
   *block->m_stats = {};
@@ -755,6 +789,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
   bool found_call = false;
   size_t caller = 0;
   u32 numFollows = 0;
+  u32 numHotFollows = 0;
   u32 num_inst = 0;
 
   const bool enable_follow = SConfig::GetInstance().bJITFollowBranch;
@@ -766,6 +801,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
     {
       if (i == 0)
         block->m_memory_exception = true;
+      *truncated = true;
       break;
     }
 
@@ -878,12 +914,27 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
     code[i].branchIsIdleLoop =
         code[i].branchTo == block->m_address && IsBusyWaitLoop(block, code, i);
 
+    // Only forward branches are inlined, backward ones would duplicate loop bodies.
+    const bool follow_hot = HasOption(OPTION_HOT_BRANCH_FOLLOW) && m_is_hot_branch &&
+                            conditional_continue && inst.OPCD == 16 && !inst.LK &&
+                            code[i].branchTo > address && !code[i].branchIsIdleLoop &&
+                            numHotFollows < HOT_BRANCH_FOLLOWING_THRESHOLD &&
+                            m_is_hot_branch(address);
+
     if (follow && numFollows < BRANCH_FOLLOWING_THRESHOLD)
     {
       // Follow the unconditional branch.
       numFollows++;
       address = code[i].branchTo;
     }
+    else if (follow_hot)
+    {
+      // Continue on the taken side of the conditional branch.
+      numHotFollows++;
+      code[i].conditionalBranchFollowed = true;
+      address = code[i].branchTo;
+      found_call = false;
+    }
     else
     {
       // Just pick the next instruction
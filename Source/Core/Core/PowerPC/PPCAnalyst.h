@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <set>
 #include <vector>
 
@@ -47,6 +48,9 @@ struct CodeOp  // 16B
   bool canEndBlock;
   bool skipLRStack;
   bool skip;  // followed BL-s for example
+  // Conditional branch whose taken side has been inlined by OPTION_HOT_BRANCH_FOLLOW,
+  // so the next op is the branch target and not taking the branch leaves the block.
+  bool conditionalBranchFollowed;
   // which registers are still needed after this instruction in this block
   BitSet32 fprInUse;
   BitSet32 gprInUse;
@@ -195,15 +199,34 @@ public:
 
     // Reorder cror instructions next to their associated fcmp.
     OPTION_CROR_MERGE = (1 << 6),
+
+    // Inline the taken side of forward conditional branches which the hot branch predicate
+    // reports as almost always taken, turning the fall-through into the side exit.
+    // The result depends on runtime profiling data, so it is never cached.
+    // Requires JIT support to be enabled.
+    OPTION_HOT_BRANCH_FOLLOW = (1 << 7),
   };
 
+  // Gets the address of a conditional branch, returns whether it is almost always taken.
+  using HotBranchPredicate = std::function<bool(u32 address)>;
+
   // Option setting/getting
   void SetOption(AnalystOption option) { m_options |= option; }
   void ClearOption(AnalystOption option) { m_options &= ~(option); }
   bool HasOption(AnalystOption option) const { return !!(m_options & option); }
+  void SetHotBranchPredicate(HotBranchPredicate predicate)
+  {
+    m_is_hot_branch = std::move(predicate);
+  }
   u32 Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std::size_t block_size);
 
 private:
+  // Not an actual analyzer option, only used to tell apart cached analysis results.
+  static constexpr u32 CACHE_OPTION_FOLLOW_BRANCH = 1u << 31;
+
+  u32 AnalyzeUncached(u32 address, CodeBlock* block, CodeBuffer* buffer, std::size_t block_size,
+                      bool* truncated);
+
   enum class ReorderType
   {
     Carry,
@@ -218,6 +241,7 @@ private:
 
   // Options
   u32 m_options = 0;
+  HotBranchPredicate m_is_hot_branch;
 };
 
 void FindFunctions(u32 startAddr, u32 endAddr, PPCSymbolDB* func_db);
@@ -29,6 +29,7 @@
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/MMU.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/PowerPC/SamplingProfiler.h"
 
 namespace PowerPC
 {
@@ -121,6 +122,8 @@ void DoState(PointerWrap& p)
   p.DoArray(ppcState.ps);
   p.DoArray(ppcState.sr);
   p.DoArray(ppcState.spr);
+  if (p.GetMode() == PointerWrap::MODE_READ)
+    InvalidateHostPageTable();
   p.DoArray(ppcState.tlb);
   p.Do(ppcState.pagetable_base);
   p.Do(ppcState.pagetable_hashmask);
@@ -253,6 +256,8 @@ void Init(CPUCore cpu_core)
 
   s_invalidate_cache_thread_safe =
       CoreTiming::RegisterEvent("invalidateEmulatedCache", InvalidateCacheThreadSafe);
+  Profiler::Init();
+  InitHostPageTable();
 
   Reset();
 
@@ -267,6 +272,7 @@ void Reset()
 {
   ppcState.pagetable_base = 0;
   ppcState.pagetable_hashmask = 0;
+  InvalidateHostPageTable();
   ppcState.tlb = {};
 
   ResetRegisters();
@@ -289,7 +295,9 @@ void ScheduleInvalidateCacheThreadSafe(u32 address)
 void Shutdown()
 {
   InjectExternalCPUCore(nullptr);
+  Profiler::Shutdown();
   JitInterface::Shutdown();
+  ShutdownHostPageTable();
   s_interpreter->Shutdown();
   s_cpu_core_base = nullptr;
 }
@@ -620,7 +628,11 @@ void CheckBreakPoints()
 void PowerPCState::SetSR(u32 index, u32 value)
 {
   DEBUG_LOG(POWERPC, "%08x: MMU: Segment register %i set to %08x", pc, index, value);
-  sr[index] = value;
+  if (sr[index] != value)
+  {
+    sr[index] = value;
+    InvalidateHostPageTable();
+  }
 }
 
 // FPSCR update functions
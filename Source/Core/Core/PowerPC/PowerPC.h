@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <iosfwd>
 #include <tuple>
 #include <type_traits>
@@ -58,6 +59,14 @@ struct TLBEntry
   u8 recent = 0;
 };
 
+// Entry of the host page table, see MMU.h. Zero means that the access has to go through the
+// regular address translation.
+struct HostPageTableEntry
+{
+  uintptr_t read;
+  uintptr_t write;
+};
+
 struct PairedSingle
 {
   u64 PS0AsU64() const { return ps0; }
@@ -155,6 +164,9 @@ struct PowerPCState
   u32 pagetable_base;
   u32 pagetable_hashmask;
 
+  // Host page table for page table translated data accesses, indexed by effective page.
+  HostPageTableEntry* host_page_table;
+
   InstructionCache iCache;
 
   void UpdateCR1()
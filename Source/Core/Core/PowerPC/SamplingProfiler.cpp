@@ -0,0 +1,224 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/PowerPC/SamplingProfiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/SymbolDB.h"
+#include "Core/CoreTiming.h"
+#include "Core/Debugger/Debugger_SymbolMap.h"
+#include "Core/HW/SystemTimers.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/PowerPC/PowerPC.h"
+
+namespace Profiler
+{
+namespace
+{
+// Emulated time between two samples.
+constexpr u32 SAMPLES_PER_SECOND = 1000;
+
+// Time spent paused or loading a savestate shouldn't get attributed to whatever code happens
+// to run next.
+constexpr std::chrono::microseconds MAX_SAMPLE_WEIGHT{50000};
+
+struct StackKey
+{
+  // Outermost caller first, the sampled PC last.
+  std::vector<u32> frames;
+  // Guest address of the JIT block the PC is in, if any.
+  u32 jit_block;
+  bool in_jit_block;
+
+  bool operator<(const StackKey& other) const
+  {
+    return std::tie(frames, jit_block, in_jit_block) <
+           std::tie(other.frames, other.jit_block, other.in_jit_block);
+  }
+};
+
+CoreTiming::EventType* s_event = nullptr;
+std::atomic<bool> s_sampling{false};
+std::atomic<u64> s_generation{0};
+
+// Only accessed from the CPU thread.
+u64 s_running_generation = 0;
+std::chrono::steady_clock::time_point s_last_sample;
+
+std::mutex s_samples_mutex;
+std::map<StackKey, u64> s_samples;  // stack -> microseconds
+
+s64 GetSampleInterval()
+{
+  return SystemTimers::GetTicksPerSecond() / SAMPLES_PER_SECOND;
+}
+
+StackKey CaptureStack()
+{
+  StackKey key{};
+
+  std::vector<u32> callers;
+  Dolphin_Debugger::WalkTheStack([&callers](u32 return_address) {
+    callers.push_back(return_address - 4);
+  });
+  key.frames.assign(callers.rbegin(), callers.rend());
+
+  // Leaf functions don't save LR in their stack frame, so the caller is only known from LR.
+  // For everything else LR duplicates a frame, which is folded away when symbolizing.
+  if (LR != 0)
+    key.frames.push_back(LR - 4);
+  key.frames.push_back(PC);
+
+  if (PowerPC::GetMode() == PowerPC::CoreMode::JIT)
+  {
+    u32 address = PC;
+    const u8* code;
+    u32 code_size;
+    key.in_jit_block = JitInterface::GetHostCode(&address, &code, &code_size) == 0;
+    key.jit_block = key.in_jit_block ? address : 0;
+  }
+
+  return key;
+}
+
+void SampleCallback(u64 generation, s64 cycles_late)
+{
+  if (!s_sampling || generation != s_generation)
+    return;
+
+  const auto now = std::chrono::steady_clock::now();
+  if (generation != s_running_generation)
+  {
+    // The first event of a sampling session only starts the clock.
+    s_running_generation = generation;
+  }
+  else
+  {
+    const auto weight = std::min(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - s_last_sample),
+        MAX_SAMPLE_WEIGHT);
+    StackKey key = CaptureStack();
+
+    std::lock_guard<std::mutex> lk(s_samples_mutex);
+    s_samples[std::move(key)] += static_cast<u64>(weight.count());
+  }
+  s_last_sample = now;
+
+  CoreTiming::ScheduleEvent(GetSampleInterval() - cycles_late, s_event, generation);
+}
+
+void ScheduleFirstSample()
+{
+  CoreTiming::ScheduleEvent(0, s_event, s_generation, CoreTiming::FromThread::ANY);
+}
+
+std::string GetFrameName(u32 address)
+{
+  const Common::Symbol* symbol = g_symbolDB.GetSymbolFromAddr(address);
+  if (!symbol)
+    return fmt::format("0x{:08x}", address);
+
+  // ';' separates frames in the folded format.
+  std::string name = symbol->name;
+  std::replace(name.begin(), name.end(), ';', ':');
+  return name;
+}
+
+std::string GetFoldedStack(const StackKey& key)
+{
+  std::string stack;
+  std::string previous;
+  for (u32 address : key.frames)
+  {
+    std::string name = GetFrameName(address);
+    if (name == previous)
+      continue;
+
+    if (!stack.empty())
+      stack += ';';
+    stack += name;
+    previous = std::move(name);
+  }
+
+  if (key.in_jit_block)
+    stack += fmt::format(";[JIT block 0x{:08x}]", key.jit_block);
+
+  return stack;
+}
+}  // Anonymous namespace
+
+void Init()
+{
+  s_event = CoreTiming::RegisterEvent("SamplingProfiler", SampleCallback);
+  s_running_generation = 0;
+  if (s_sampling)
+    ScheduleFirstSample();
+}
+
+void Shutdown()
+{
+  s_event = nullptr;
+}
+
+void StartSampling()
+{
+  if (s_sampling.exchange(true))
+    return;
+
+  ++s_generation;
+  if (s_event)
+    ScheduleFirstSample();
+}
+
+void StopSampling()
+{
+  s_sampling = false;
+}
+
+bool IsSampling()
+{
+  return s_sampling;
+}
+
+void ClearSamples()
+{
+  std::lock_guard<std::mutex> lk(s_samples_mutex);
+  s_samples.clear();
+}
+
+bool WriteFoldedStacks(const std::string& filename)
+{
+  // Different PCs in the same function end up as the same stack.
+  std::map<std::string, u64> stacks;
+  {
+    std::lock_guard<std::mutex> lk(s_samples_mutex);
+    for (const auto& [key, weight] : s_samples)
+      stacks[GetFoldedStack(key)] += weight;
+  }
+
+  File::IOFile f(filename, "w");
+  if (!f)
+    return false;
+
+  for (const auto& [stack, weight] : stacks)
+  {
+    if (weight != 0)
+      fmt::print(f.GetHandle(), "{} {}\n", stack, weight);
+  }
+  return true;
+}
+}  // namespace Profiler
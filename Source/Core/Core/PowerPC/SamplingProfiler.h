@@ -0,0 +1,28 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+// Sampling profiler for guest code.
+//
+// A CoreTiming event takes a sample of the guest call stack at regular intervals of emulated
+// time. Each sample is weighted with the host time which passed since the previous one, so the
+// result shows which guest functions the host spends its time in.
+namespace Profiler
+{
+void Init();
+void Shutdown();
+
+// Can be called from any thread.
+void StartSampling();
+void StopSampling();
+bool IsSampling();
+void ClearSamples();
+
+// Writes all samples as collapsed stacks, one "outer;...;inner microseconds" line per distinct
+// stack. flamegraph.pl, inferno and speedscope can read this format.
+bool WriteFoldedStacks(const std::string& filename);
+}  // namespace Profiler
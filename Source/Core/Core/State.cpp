@@ -4,15 +4,24 @@
 
 #include "Core/State.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <deque>
 #include <lzo/lzo1x.h>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include <fmt/format.h>
+#include <zstd.h>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -25,6 +34,7 @@
 #include "Common/Timer.h"
 #include "Common/Version.h"
 
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -37,6 +47,8 @@
 #include "Core/NetPlayClient.h"
 #include "Core/PowerPC/PowerPC.h"
 
+#include "DiscIO/MultithreadedCompressor.h"
+
 #include "VideoCommon/FrameDump.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/VideoBackendBase.h"
@@ -55,10 +67,27 @@ static const u32 OUT_LEN = IN_LEN + (IN_LEN / 16) + 64 + 3;
 
 static unsigned char __LZO_MMODEL out[OUT_LEN];
 
-#define HEAP_ALLOC(var, size)                                                                      \
-  lzo_align_t __LZO_MMODEL var[((size) + (sizeof(lzo_align_t) - 1)) / sizeof(lzo_align_t)]
+// Compressed states are a sequence of zstd frames which can be compressed and decompressed
+// independently of each other. The file starts with the StateHeader and the magic, and ends
+// with an index of the frames followed by a ChunkedStateFooter.
+// Older states instead contain a sequence of LZO chunks, each prefixed with its size.
+constexpr u32 CHUNKED_STATE_MAGIC = 0xFFFFFFFF;  // Never a valid LZO chunk size
+constexpr size_t CHUNKED_STATE_CHUNK_SIZE = 1024 * 1024;
+constexpr int CHUNKED_STATE_COMPRESSION_LEVEL = 1;
 
-static HEAP_ALLOC(wrkmem, LZO1X_1_MEM_COMPRESS);
+struct ChunkIndexEntry
+{
+  u64 offset;  // In the file
+  u32 compressed_size;
+  u32 uncompressed_size;
+};
+
+struct ChunkedStateFooter
+{
+  u64 index_offset;
+  u32 chunk_count;
+  u32 magic;
+};
 
 static AfterLoadCallbackFunc s_on_after_load_callback;
 
@@ -73,6 +102,53 @@ static Common::Event g_compressAndDumpStateSyncEvent;
 
 static std::thread g_save_thread;
 
+// Rewind keeps the most recently captured state in full. Every older state is stored as the
+// ranges in which it differs from the next newer one, so stepping back only copies those ranges.
+// RAM is left out when capturing a state, and only the pages which were written to since the last
+// capture are compared against the latest state.
+constexpr size_t REWIND_CHUNK_SIZE = 0x1000;
+
+struct RewindSpan
+{
+  u32 offset;
+  u32 size;
+};
+
+struct RewindEntry
+{
+  // Set if the layout of the state changed, in which case data holds the whole older state.
+  bool is_full;
+  std::vector<RewindSpan> spans;
+  std::vector<u8> data;
+};
+
+static std::mutex s_rewind_mutex;
+static std::deque<RewindEntry> s_rewind_entries;
+static std::vector<u8> s_rewind_latest;
+struct RewindRAMRegion
+{
+  u32 physical_address;
+  u32 size;
+  size_t offset;  // In the state
+  const u8* memory;
+
+  bool operator==(const RewindRAMRegion& other) const
+  {
+    return std::tie(physical_address, size, offset, memory) ==
+           std::tie(other.physical_address, other.size, other.offset, other.memory);
+  }
+};
+
+static std::vector<RewindRAMRegion> s_rewind_latest_ram;
+// The state being captured, without RAM. Kept around to avoid reallocating it for every capture.
+static std::vector<u8> s_rewind_capture_buffer;
+static u64 s_rewind_dirty_page_epoch = 0;
+static size_t s_rewind_memory_usage = 0;
+// Set after s_rewind_latest has been loaded, so that rewinding again goes back further.
+static bool s_rewind_latest_loaded = false;
+static u32 s_rewind_frame_counter = 0;
+static std::atomic<bool> s_rewind_capture_pending{false};
+
 // Don't forget to increase this after doing changes on the savestate system
 constexpr u32 STATE_VERSION = 122;  // Last changed in PR 8571
 
@@ -301,6 +377,166 @@ static std::map<double, int> GetSavedStates()
   return m;
 }
 
+namespace
+{
+struct ZstdCCtxDeleter
+{
+  void operator()(ZSTD_CCtx* ctx) const { ZSTD_freeCCtx(ctx); }
+};
+
+struct ZstdDCtxDeleter
+{
+  void operator()(ZSTD_DCtx* ctx) const { ZSTD_freeDCtx(ctx); }
+};
+
+using ZstdCCtx = std::unique_ptr<ZSTD_CCtx, ZstdCCtxDeleter>;
+using ZstdDCtx = std::unique_ptr<ZSTD_DCtx, ZstdDCtxDeleter>;
+
+struct CompressedChunk
+{
+  std::vector<u8> data;
+  u32 uncompressed_size;
+};
+}  // Anonymous namespace
+
+// Compresses the chunks on all cores, and writes them out in order while the later chunks are
+// still being compressed.
+bool WriteChunkedState(File::IOFile& f, const u8* data, size_t size)
+{
+  using DiscIO::ConversionResultCode;
+
+  if (!f.WriteArray(&CHUNKED_STATE_MAGIC, 1))
+    return false;
+
+  std::vector<ChunkIndexEntry> index;
+  u64 offset = f.Tell();
+
+  DiscIO::MultithreadedCompressor<ZstdCCtx, size_t, CompressedChunk> compressor(
+      [](ZstdCCtx* ctx) {
+        ctx->reset(ZSTD_createCCtx());
+        return *ctx ? ConversionResultCode::Success : ConversionResultCode::InternalError;
+      },
+      [data, size](ZstdCCtx* ctx,
+                   size_t chunk_offset) -> DiscIO::ConversionResult<CompressedChunk> {
+        const size_t chunk_size = std::min(size - chunk_offset, CHUNKED_STATE_CHUNK_SIZE);
+
+        CompressedChunk chunk;
+        chunk.data.resize(ZSTD_compressBound(chunk_size));
+        const size_t result =
+            ZSTD_compressCCtx(ctx->get(), chunk.data.data(), chunk.data.size(),
+                              data + chunk_offset, chunk_size, CHUNKED_STATE_COMPRESSION_LEVEL);
+        if (ZSTD_isError(result))
+          return ConversionResultCode::InternalError;
+
+        chunk.data.resize(result);
+        chunk.uncompressed_size = static_cast<u32>(chunk_size);
+        return chunk;
+      },
+      [&f, &index, &offset](CompressedChunk chunk) {
+        if (!f.WriteBytes(chunk.data.data(), chunk.data.size()))
+          return ConversionResultCode::WriteFailed;
+
+        const u32 compressed_size = static_cast<u32>(chunk.data.size());
+        index.push_back({offset, compressed_size, chunk.uncompressed_size});
+        offset += compressed_size;
+        return ConversionResultCode::Success;
+      });
+
+  for (size_t chunk_offset = 0; chunk_offset < size; chunk_offset += CHUNKED_STATE_CHUNK_SIZE)
+    compressor.CompressAndWrite(chunk_offset);
+  compressor.Shutdown();
+
+  if (compressor.GetStatus() != ConversionResultCode::Success)
+    return false;
+
+  const ChunkedStateFooter footer{offset, static_cast<u32>(index.size()), CHUNKED_STATE_MAGIC};
+  return f.WriteArray(index.data(), index.size()) && f.WriteArray(&footer, 1);
+}
+
+// Reads all chunks first, then decompresses them on all cores straight into their final place.
+// Nothing is allocated before the footer and the index have been checked against the file size,
+// so damaged files fail cleanly instead of requesting absurd amounts of memory.
+bool ReadChunkedState(File::IOFile& f, u32 uncompressed_size, std::vector<u8>& buffer)
+{
+  constexpr u64 data_start = sizeof(StateHeader) + sizeof(CHUNKED_STATE_MAGIC);
+
+  const u64 file_size = f.GetSize();
+  ChunkedStateFooter footer;
+  if (file_size < data_start + sizeof(footer) ||
+      !f.Seek(-static_cast<s64>(sizeof(footer)), SEEK_END) || !f.ReadArray(&footer, 1) ||
+      footer.magic != CHUNKED_STATE_MAGIC)
+  {
+    return false;
+  }
+
+  // The index has to fit exactly between the compressed data and the footer.
+  const u64 index_size = u64{footer.chunk_count} * sizeof(ChunkIndexEntry);
+  if (index_size > file_size - data_start - sizeof(footer) ||
+      footer.index_offset != file_size - sizeof(footer) - index_size)
+  {
+    return false;
+  }
+
+  std::vector<ChunkIndexEntry> index(footer.chunk_count);
+  if (!f.Seek(footer.index_offset, SEEK_SET) || !f.ReadArray(index.data(), index.size()))
+    return false;
+
+  std::vector<u8> compressed(footer.index_offset - data_start);
+  if (!f.Seek(data_start, SEEK_SET) || !f.ReadBytes(compressed.data(), compressed.size()))
+    return false;
+
+  std::vector<size_t> destinations(index.size());
+  size_t total_size = 0;
+  for (size_t i = 0; i < index.size(); ++i)
+  {
+    const ChunkIndexEntry& entry = index[i];
+    if (entry.offset < data_start || entry.offset > footer.index_offset ||
+        entry.compressed_size > footer.index_offset - entry.offset ||
+        entry.uncompressed_size > uncompressed_size - total_size)
+    {
+      return false;
+    }
+    destinations[i] = total_size;
+    total_size += entry.uncompressed_size;
+  }
+  if (total_size != uncompressed_size)
+    return false;
+
+  buffer.resize(uncompressed_size);
+
+  std::atomic<size_t> next_chunk{0};
+  std::atomic<bool> success{true};
+  const auto decompress_chunks = [&] {
+    ZstdDCtx ctx(ZSTD_createDCtx());
+    if (!ctx)
+    {
+      success = false;
+      return;
+    }
+
+    for (size_t i = next_chunk++; i < index.size(); i = next_chunk++)
+    {
+      const ChunkIndexEntry& entry = index[i];
+      const size_t result = ZSTD_decompressDCtx(
+          ctx.get(), buffer.data() + destinations[i], entry.uncompressed_size,
+          compressed.data() + (entry.offset - data_start), entry.compressed_size);
+      if (ZSTD_isError(result) || result != entry.uncompressed_size)
+        success = false;
+    }
+  };
+
+  const size_t thread_count =
+      std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), index.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(decompress_chunks);
+  decompress_chunks();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  return success;
+}
+
 struct CompressAndDumpState_args
 {
   std::vector<u8>* buffer_vector;
@@ -333,6 +569,9 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
   // For easy debugging
   Common::SetCurrentThreadName("SaveState thread");
 
+  // Emulation may already be running again, so fill in RAM from the snapshot before anything else.
+  Memory::FinishRAMSnapshot();
+
   // Moving to last overwritten save-state
   if (File::Exists(filename))
   {
@@ -369,32 +608,10 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
 
   if (header.size != 0)  // non-zero header size means the state is compressed
   {
-    lzo_uint i = 0;
-    while (true)
+    if (!WriteChunkedState(f, buffer_data, buffer_size))
     {
-      lzo_uint32 cur_len = 0;
-      lzo_uint out_len = 0;
-
-      if ((i + IN_LEN) >= buffer_size)
-      {
-        cur_len = (lzo_uint32)(buffer_size - i);
-      }
-      else
-      {
-        cur_len = IN_LEN;
-      }
-
-      if (lzo1x_1_compress(buffer_data + i, cur_len, out, &out_len, wrkmem) != LZO_E_OK)
-        PanicAlertT("Internal LZO Error - compression failed");
-
-      // The size of the data to write is 'out_len'
-      f.WriteArray((lzo_uint32*)&out_len, 1);
-      f.WriteBytes(out, out_len);
-
-      if (cur_len != IN_LEN)
-        break;
-
-      i += cur_len;
+      Core::DisplayMessage("Could not save state", 2000);
+      return;
     }
   }
   else  // uncompressed
@@ -425,9 +642,18 @@ void SaveAs(const std::string& filename, bool wait)
         {
           std::lock_guard<std::mutex> lk(g_cs_current_buffer);
           g_current_buffer.resize(buffer_size);
+
+          // With a snapshot, RAM is copied on the save thread instead, and pages which are written
+          // to in the meantime get copied first.
+          if (Config::Get(Config::MAIN_COPY_ON_WRITE_SAVESTATES))
+            Memory::StartRAMSnapshot();
+
           ptr = &g_current_buffer[0];
           p.SetMode(PointerWrap::MODE_WRITE);
           DoState(p);
+
+          if (p.GetMode() != PointerWrap::MODE_WRITE)
+            Memory::FinishRAMSnapshot();
         }
 
         if (p.GetMode() == PointerWrap::MODE_WRITE)
@@ -509,8 +735,21 @@ static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_
   {
     Core::DisplayMessage("Decompressing State...", 500);
 
-    buffer.resize(header.size);
+    u32 magic = 0;
+    if (f.ReadArray(&magic, 1) && magic == CHUNKED_STATE_MAGIC)
+    {
+      if (!ReadChunkedState(f, header.size, buffer))
+      {
+        PanicAlertT("Internal zstd Error - decompression failed");
+        return;
+      }
+      ret_data.swap(buffer);
+      return;
+    }
 
+    // Older states are a sequence of LZO chunks.
+    buffer.resize(header.size);
+    f.Seek(sizeof(StateHeader), SEEK_SET);
     lzo_uint i = 0;
     while (true)
     {
@@ -623,6 +862,236 @@ void LoadAs(const std::string& filename)
   s_load_or_save_in_progress = false;
 }
 
+// Copies the current contents of a range into the latest state, and records the older contents in
+// the entry if they differ.
+static void UpdateRewindRange(RewindEntry& entry, size_t offset, const u8* contents, size_t size)
+{
+  u8* const latest = s_rewind_latest.data() + offset;
+  if (std::memcmp(latest, contents, size) == 0)
+    return;
+
+  if (!entry.spans.empty() && entry.spans.back().offset + entry.spans.back().size == offset)
+    entry.spans.back().size += static_cast<u32>(size);
+  else
+    entry.spans.push_back({static_cast<u32>(offset), static_cast<u32>(size)});
+  entry.data.insert(entry.data.end(), latest, latest + size);
+  std::memcpy(latest, contents, size);
+}
+
+static void UpdateRewindChunks(RewindEntry& entry, size_t offset, const u8* contents, size_t size)
+{
+  for (size_t chunk = 0; chunk < size; chunk += REWIND_CHUNK_SIZE)
+  {
+    UpdateRewindRange(entry, offset + chunk, contents + chunk,
+                      std::min(REWIND_CHUNK_SIZE, size - chunk));
+  }
+}
+
+// Turns the state after the entry into the state before it.
+static void ApplyRewindEntry(RewindEntry& entry, std::vector<u8>& state)
+{
+  if (entry.is_full)
+  {
+    state.swap(entry.data);
+    return;
+  }
+
+  size_t source = 0;
+  for (const RewindSpan& span : entry.spans)
+  {
+    std::memcpy(state.data() + span.offset, entry.data.data() + source, span.size);
+    source += span.size;
+  }
+}
+
+static size_t GetRewindEntryMemoryUsage(const RewindEntry& entry)
+{
+  return entry.data.size() + entry.spans.size() * sizeof(RewindSpan);
+}
+
+static void ClearRewindStates()
+{
+  std::lock_guard<std::mutex> lk(s_rewind_mutex);
+  s_rewind_entries.clear();
+  std::vector<u8>().swap(s_rewind_latest);
+  std::vector<u8>().swap(s_rewind_capture_buffer);
+  s_rewind_latest_ram.clear();
+  s_rewind_memory_usage = 0;
+  s_rewind_latest_loaded = false;
+}
+
+// Brings s_rewind_latest up to date with the emulated state, and returns the older contents of
+// everything which changed. Returns nothing for the first capture. Must be called on the CPU thread.
+static std::optional<RewindEntry> UpdateRewindLatest()
+{
+  // Tracking starts out with every page counted as dirty.
+  if (!Memory::IsDirtyPageTrackingEnabled())
+    s_rewind_dirty_page_epoch = 0;
+  std::optional<std::vector<u32>> dirty_pages;
+  if (Memory::EnableDirtyPageTracking())
+  {
+    dirty_pages = Memory::GetPagesDirtiedSince(s_rewind_dirty_page_epoch);
+    s_rewind_dirty_page_epoch = Memory::StartDirtyPageEpoch();
+  }
+
+  u8* ptr = nullptr;
+  PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+  DoState(p);
+  s_rewind_capture_buffer.resize(reinterpret_cast<size_t>(ptr));
+
+  u8* const buffer = s_rewind_capture_buffer.data();
+  ptr = buffer;
+  p.SetMode(PointerWrap::MODE_WRITE);
+  Memory::ReserveRAMInNextState();
+  DoState(p);
+
+  std::vector<RewindRAMRegion> ram;
+  for (const Memory::StateRAMRegion& region : Memory::TakeReservedRAMRegions())
+  {
+    ram.push_back({region.physical_address, region.size,
+                   static_cast<size_t>(region.state_pointer - buffer), region.memory});
+  }
+
+  std::optional<RewindEntry> entry;
+  if (!s_rewind_latest.empty())
+    entry.emplace();
+
+  if (s_rewind_latest.size() != s_rewind_capture_buffer.size() || ram != s_rewind_latest_ram)
+  {
+    if (entry)
+    {
+      entry->is_full = true;
+      entry->data = std::move(s_rewind_latest);
+    }
+    s_rewind_latest = s_rewind_capture_buffer;
+    for (const RewindRAMRegion& region : ram)
+      std::memcpy(s_rewind_latest.data() + region.offset, region.memory, region.size);
+    s_rewind_latest_ram = std::move(ram);
+    return entry;
+  }
+
+  // Everything besides RAM is small enough to compare in full.
+  size_t offset = 0;
+  for (const RewindRAMRegion& region : ram)
+  {
+    UpdateRewindChunks(*entry, offset, buffer + offset, region.offset - offset);
+    offset = region.offset + region.size;
+  }
+  UpdateRewindChunks(*entry, offset, buffer + offset, s_rewind_capture_buffer.size() - offset);
+
+  if (!dirty_pages)
+  {
+    for (const RewindRAMRegion& region : ram)
+      UpdateRewindChunks(*entry, region.offset, region.memory, region.size);
+    return entry;
+  }
+
+  const size_t page_size = Memory::GetDirtyPageSize();
+  for (u32 page_address : *dirty_pages)
+  {
+    const auto region = std::find_if(ram.begin(), ram.end(), [page_address](const auto& r) {
+      return page_address - r.physical_address < r.size;
+    });
+    if (region == ram.end())
+      continue;
+
+    const u32 page_offset = page_address - region->physical_address;
+    UpdateRewindChunks(*entry, region->offset + page_offset, region->memory + page_offset,
+                       std::min<size_t>(page_size, region->size - page_offset));
+  }
+  return entry;
+}
+
+static void CaptureRewindState()
+{
+  if (!Core::IsRunningAndStarted() || NetPlay::IsNetPlayRunning() || Movie::IsMovieActive() ||
+      s_load_or_save_in_progress)
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lk(s_rewind_mutex);
+  const size_t previous_size = s_rewind_latest.size();
+  std::optional<RewindEntry> entry;
+  Core::RunOnCPUThread([&] { entry = UpdateRewindLatest(); }, true);
+
+  s_rewind_memory_usage += s_rewind_latest.size();
+  s_rewind_memory_usage -= previous_size;
+  if (entry)
+  {
+    s_rewind_memory_usage += GetRewindEntryMemoryUsage(*entry);
+    s_rewind_entries.push_back(std::move(*entry));
+  }
+  s_rewind_latest_loaded = false;
+
+  const size_t budget = size_t{Config::Get(Config::MAIN_REWIND_BUFFER_SIZE)} * 1024 * 1024;
+  while (!s_rewind_entries.empty() && s_rewind_memory_usage > budget)
+  {
+    s_rewind_memory_usage -= GetRewindEntryMemoryUsage(s_rewind_entries.front());
+    s_rewind_entries.pop_front();
+  }
+}
+
+void OnFrameEnd()
+{
+  if (!Config::Get(Config::MAIN_REWIND_ENABLED))
+    return;
+
+  if (++s_rewind_frame_counter < Config::Get(Config::MAIN_REWIND_INTERVAL))
+    return;
+  s_rewind_frame_counter = 0;
+
+  // Saving has to pause the CPU thread, which can only be done from the host thread.
+  if (!s_rewind_capture_pending.exchange(true))
+  {
+    Core::QueueHostJob([] {
+      CaptureRewindState();
+      s_rewind_capture_pending = false;
+    });
+  }
+}
+
+void Rewind()
+{
+  if (NetPlay::IsNetPlayRunning())
+  {
+    OSD::AddMessage("Rewinding is disabled in Netplay to prevent desyncs");
+    return;
+  }
+
+  if (Movie::IsMovieActive())
+  {
+    OSD::AddMessage("Rewinding is disabled while recording or playing back input to prevent "
+                    "desyncs");
+    return;
+  }
+
+  std::lock_guard<std::mutex> lk(s_rewind_mutex);
+  if (s_rewind_latest_loaded)
+  {
+    if (s_rewind_entries.empty())
+    {
+      Core::DisplayMessage("Cannot rewind any further", 2000);
+      return;
+    }
+
+    RewindEntry& entry = s_rewind_entries.back();
+    s_rewind_memory_usage -= GetRewindEntryMemoryUsage(entry) + s_rewind_latest.size();
+    ApplyRewindEntry(entry, s_rewind_latest);
+    s_rewind_memory_usage += s_rewind_latest.size();
+    s_rewind_entries.pop_back();
+  }
+  else if (s_rewind_latest.empty())
+  {
+    Core::DisplayMessage("There is nothing to rewind to", 2000);
+    return;
+  }
+
+  LoadFromBuffer(s_rewind_latest);
+  s_rewind_latest_loaded = true;
+  s_rewind_frame_counter = 0;
+}
+
 void SetOnAfterLoadCallback(AfterLoadCallbackFunc callback)
 {
   s_on_after_load_callback = std::move(callback);
@@ -650,6 +1119,8 @@ void Shutdown()
     std::lock_guard<std::mutex> lk(g_cs_undo_load_buffer);
     std::vector<u8>().swap(g_undo_load_buffer);
   }
+
+  ClearRewindStates();
 }
 
 static std::string MakeStateFilename(int number)
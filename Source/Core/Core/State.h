@@ -12,6 +12,11 @@
 
 #include "Common/CommonTypes.h"
 
+namespace File
+{
+class IOFile;
+}
+
 namespace State
 {
 // number of states
@@ -55,6 +60,11 @@ void SaveFirstSaved();
 void UndoSaveState();
 void UndoLoadState();
 
+// Captures a state for rewinding every few frames if rewinding is enabled. CPU thread only.
+void OnFrameEnd();
+// Loads the most recently captured state, or the one before it if that has just been loaded.
+void Rewind();
+
 // wait until previously scheduled savestate event (if any) is done
 void Flush();
 
@@ -63,4 +73,10 @@ using AfterLoadCallbackFunc = std::function<void()>;
 void SetOnAfterLoadCallback(AfterLoadCallbackFunc callback);
 
 u32 GetVersion();
+
+// The compressed state format, exposed for tests. Both functions expect the file to be
+// positioned right after the StateHeader.
+bool WriteChunkedState(File::IOFile& f, const u8* data, size_t size);
+// Fails without allocating anything if the file is truncated or damaged.
+bool ReadChunkedState(File::IOFile& f, u32 uncompressed_size, std::vector<u8>& buffer);
 }  // namespace State
@@ -0,0 +1,234 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/TimingWheel.h"
+
+#include <algorithm>
+
+#include "Common/Assert.h"
+#include "Common/BitSet.h"
+
+namespace CoreTiming
+{
+TimingWheel::TimingWheel()
+{
+  Clear(0);
+}
+
+void TimingWheel::Clear(s64 now)
+{
+  m_now = static_cast<u64>(std::max<s64>(now, 0));
+  m_size = 0;
+  m_front = nullptr;
+  m_buckets.fill({});
+  for (auto& level : m_occupied)
+    level.fill(0);
+  m_node_storage.clear();
+  m_free_nodes.clear();
+  m_events_by_type.clear();
+}
+
+u32 TimingWheel::GetBucket(const Event& event) const
+{
+  if (event.time < 0 || static_cast<u64>(event.time) < m_now)
+    return OVERDUE_BUCKET;
+
+  const u64 time = static_cast<u64>(event.time);
+  u32 level = 0;
+  for (u64 diff = (time ^ m_now) >> BITS_PER_LEVEL; diff != 0; diff >>= BITS_PER_LEVEL)
+    ++level;
+
+  const u32 slot = static_cast<u32>(time >> (level * BITS_PER_LEVEL)) & (SLOTS_PER_LEVEL - 1);
+  return level * SLOTS_PER_LEVEL + slot;
+}
+
+void TimingWheel::Link(Node* node)
+{
+  Bucket& bucket = m_buckets[node->bucket];
+
+  // Only level 0 slots and the overdue list need to be in order. Everything else gets sorted
+  // into level 0 before it can become the front.
+  Node* prev = bucket.tail;
+  if (node->bucket < SLOTS_PER_LEVEL || node->bucket == OVERDUE_BUCKET)
+  {
+    while (prev && node->event < prev->event)
+      prev = prev->prev;
+  }
+
+  node->prev = prev;
+  node->next = prev ? prev->next : bucket.head;
+  (node->next ? node->next->prev : bucket.tail) = node;
+  (prev ? prev->next : bucket.head) = node;
+
+  if (node->bucket != OVERDUE_BUCKET)
+  {
+    const u32 slot = node->bucket % SLOTS_PER_LEVEL;
+    m_occupied[node->bucket / SLOTS_PER_LEVEL][slot / 64] |= u64{1} << (slot % 64);
+  }
+}
+
+void TimingWheel::Unlink(Node* node)
+{
+  Bucket& bucket = m_buckets[node->bucket];
+  (node->prev ? node->prev->next : bucket.head) = node->next;
+  (node->next ? node->next->prev : bucket.tail) = node->prev;
+
+  if (!bucket.head && node->bucket != OVERDUE_BUCKET)
+  {
+    const u32 slot = node->bucket % SLOTS_PER_LEVEL;
+    m_occupied[node->bucket / SLOTS_PER_LEVEL][slot / 64] &= ~(u64{1} << (slot % 64));
+  }
+}
+
+void TimingWheel::Free(Node* node)
+{
+  if (node == m_front)
+    m_front = nullptr;
+  m_free_nodes.push_back(node);
+  --m_size;
+}
+
+void TimingWheel::Insert(const Event& event)
+{
+  Node* node;
+  if (m_free_nodes.empty())
+  {
+    node = &m_node_storage.emplace_back();
+  }
+  else
+  {
+    node = m_free_nodes.back();
+    m_free_nodes.pop_back();
+  }
+
+  node->event = event;
+  node->bucket = GetBucket(event);
+  Link(node);
+
+  Node*& type_head = m_events_by_type[event.type];
+  node->type_prev = nullptr;
+  node->type_next = type_head;
+  if (type_head)
+    type_head->type_prev = node;
+  type_head = node;
+
+  ++m_size;
+  if (m_front && event < m_front->event)
+    m_front = node;
+}
+
+void TimingWheel::Remove(const EventType* type)
+{
+  const auto it = m_events_by_type.find(type);
+  if (it == m_events_by_type.end())
+    return;
+
+  for (Node* node = it->second; node;)
+  {
+    Node* next = node->type_next;
+    Unlink(node);
+    Free(node);
+    node = next;
+  }
+  it->second = nullptr;
+}
+
+const Event& TimingWheel::Front()
+{
+  if (m_front)
+    return m_front->event;
+
+  if (m_buckets[OVERDUE_BUCKET].head)
+  {
+    m_front = m_buckets[OVERDUE_BUCKET].head;
+    return m_front->event;
+  }
+
+  // The lowest level which has events after the current time has the earliest ones. Above level
+  // 0, the slot covering the current time is always empty.
+  for (u32 level = 0; level < NUM_LEVELS; ++level)
+  {
+    const u32 now_slot =
+        static_cast<u32>(m_now >> (level * BITS_PER_LEVEL)) & (SLOTS_PER_LEVEL - 1);
+    const u32 first_slot = level == 0 ? now_slot : now_slot + 1;
+    for (u32 word = first_slot / 64; word < SLOTS_PER_LEVEL / 64; ++word)
+    {
+      u64 bits = m_occupied[level][word];
+      if (word == first_slot / 64)
+        bits &= ~u64{0} << (first_slot % 64);
+      if (bits == 0)
+        continue;
+
+      const u32 slot = word * 64 + Common::LeastSignificantSetBit(bits);
+      Node* node = m_buckets[level * SLOTS_PER_LEVEL + slot].head;
+      m_front = node;
+      if (level != 0)
+      {
+        for (node = node->next; node; node = node->next)
+        {
+          if (node->event < m_front->event)
+            m_front = node;
+        }
+      }
+      return m_front->event;
+    }
+  }
+
+  ASSERT_MSG(POWERPC, false, "Front() called on an empty timing wheel");
+  return m_buckets[OVERDUE_BUCKET].head->event;
+}
+
+void TimingWheel::SetCurrentTime(u64 time)
+{
+  m_now = time;
+
+  // Move down the events in the slots which now cover the current time.
+  for (u32 level = NUM_LEVELS - 1; level > 0; --level)
+  {
+    const u32 slot = static_cast<u32>(time >> (level * BITS_PER_LEVEL)) & (SLOTS_PER_LEVEL - 1);
+    Bucket& bucket = m_buckets[level * SLOTS_PER_LEVEL + slot];
+    Node* node = bucket.head;
+    if (!node)
+      continue;
+
+    bucket = {};
+    m_occupied[level][slot / 64] &= ~(u64{1} << (slot % 64));
+    while (node)
+    {
+      Node* next = node->next;
+      node->bucket = GetBucket(node->event);
+      Link(node);
+      node = next;
+    }
+  }
+}
+
+void TimingWheel::PopFront()
+{
+  Front();
+  Node* node = m_front;
+  if (node->bucket != OVERDUE_BUCKET)
+    SetCurrentTime(static_cast<u64>(node->event.time));
+
+  Unlink(node);
+  (node->type_prev ? node->type_prev->type_next : m_events_by_type[node->event.type]) =
+      node->type_next;
+  if (node->type_next)
+    node->type_next->type_prev = node->type_prev;
+  Free(node);
+}
+
+std::vector<Event> TimingWheel::GetSortedEvents() const
+{
+  std::vector<Event> events;
+  events.reserve(m_size);
+  for (const Bucket& bucket : m_buckets)
+  {
+    for (const Node* node = bucket.head; node; node = node->next)
+      events.push_back(node->event);
+  }
+  std::sort(events.begin(), events.end());
+  return events;
+}
+}  // namespace CoreTiming
@@ -0,0 +1,109 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace CoreTiming
+{
+struct EventType;
+
+struct Event
+{
+  s64 time;
+  u64 fifo_order;
+  u64 userdata;
+  EventType* type;
+};
+
+// Sort by time, unless the times are the same, in which case sort by the order added to the queue
+inline bool operator>(const Event& left, const Event& right)
+{
+  return std::tie(left.time, left.fifo_order) > std::tie(right.time, right.fifo_order);
+}
+inline bool operator<(const Event& left, const Event& right)
+{
+  return std::tie(left.time, left.fifo_order) < std::tie(right.time, right.fifo_order);
+}
+
+// Hierarchical timing wheel holding the pending events, ordered like operator<.
+//
+// Level k has 256 slots which each cover 256^k cycles. An event goes into the lowest level at
+// which its time and the current time of the wheel only differ in that level's byte, so level 0
+// slots only contain events of one exact time. Popping an event moves the current time of the
+// wheel up to it, and redistributes the events in the slots which now cover the current time to
+// lower levels. Events which are scheduled earlier than the current time go into a separate
+// sorted list, which is expected to stay very short.
+//
+// Inserting and removing is O(1), apart from keeping events of the same time in FIFO order.
+class TimingWheel
+{
+public:
+  TimingWheel();
+
+  // Removes all events and sets the current time.
+  void Clear(s64 now);
+
+  bool Empty() const { return m_size == 0; }
+  size_t Size() const { return m_size; }
+
+  void Insert(const Event& event);
+  // Removes every event of the given type.
+  void Remove(const EventType* type);
+
+  // The queue must not be empty.
+  const Event& Front();
+  void PopFront();
+
+  std::vector<Event> GetSortedEvents() const;
+
+private:
+  static constexpr u32 BITS_PER_LEVEL = 8;
+  static constexpr u32 SLOTS_PER_LEVEL = 1 << BITS_PER_LEVEL;
+  static constexpr u32 NUM_LEVELS = 64 / BITS_PER_LEVEL;
+  static constexpr u32 OVERDUE_BUCKET = NUM_LEVELS * SLOTS_PER_LEVEL;
+
+  struct Node
+  {
+    Event event;
+    u32 bucket;
+    Node* prev;
+    Node* next;
+    Node* type_prev;
+    Node* type_next;
+  };
+
+  struct Bucket
+  {
+    Node* head = nullptr;
+    Node* tail = nullptr;
+  };
+
+  u32 GetBucket(const Event& event) const;
+  void Link(Node* node);
+  void Unlink(Node* node);
+  void Free(Node* node);
+  void SetCurrentTime(u64 time);
+
+  u64 m_now = 0;
+  size_t m_size = 0;
+  Node* m_front = nullptr;
+
+  std::array<Bucket, OVERDUE_BUCKET + 1> m_buckets{};
+  // One bit per non-empty slot.
+  std::array<std::array<u64, SLOTS_PER_LEVEL / 64>, NUM_LEVELS> m_occupied{};
+
+  std::deque<Node> m_node_storage;
+  std::vector<Node*> m_free_nodes;
+  std::unordered_map<const EventType*, Node*> m_events_by_type;
+};
+}  // namespace CoreTiming
@@ -555,6 +555,7 @@ void MainWindow::ConnectHotkeys()
           &MainWindow::StateSaveOldest);
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateSaveFile, this, &MainWindow::StateSave);
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateLoadFile, this, &MainWindow::StateLoad);
+  connect(m_hotkey_scheduler, &HotkeyScheduler::StateRewind, this, &MainWindow::StateRewind);
 
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateLoadSlotHotkey, this,
           &MainWindow::StateLoadSlot);
@@ -1262,6 +1263,11 @@ void MainWindow::StateSaveOldest()
   State::SaveFirstSaved();
 }
 
+void MainWindow::StateRewind()
+{
+  State::Rewind();
+}
+
 void MainWindow::SetStateSlot(int slot)
 {
   Settings::Instance().SetStateSlot(slot);
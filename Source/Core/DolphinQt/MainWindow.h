@@ -98,6 +98,7 @@ private:
   void StateLoadUndo();
   void StateSaveUndo();
   void StateSaveOldest();
+  void StateRewind();
   void SetStateSlot(int slot);
   void BootWiiSystemMenu();
 
@@ -0,0 +1,299 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// Replays a FIFO log a number of times on the Null or Software backend without a window, and
+// reports the CPU time of every frame, split by the stages of the GPU emulation.
+
+#include <OptionParser.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/Flag.h"
+#include "Common/Version.h"
+#include "Common/WindowSystemInfo.h"
+#include "Core/Boot/Boot.h"
+#include "Core/BootManager.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/FifoPlayer/FifoPlayer.h"
+#include "Core/Host.h"
+#include "UICommon/UICommon.h"
+#include "VideoCommon/StageProfiler.h"
+
+void Host_NotifyMapLoaded()
+{
+}
+void Host_RefreshDSPDebuggerWindow()
+{
+}
+void Host_Message(HostMessageID)
+{
+}
+void Host_UpdateTitle(const std::string&)
+{
+}
+void Host_UpdateDisasmDialog()
+{
+}
+void Host_UpdateMainFrame()
+{
+}
+void Host_RequestRenderWindowSize(int, int)
+{
+}
+void Host_TargetRectangleWasUpdated()
+{
+}
+bool Host_RendererHasFocus()
+{
+  return false;
+}
+bool Host_RendererIsFullscreen()
+{
+  return false;
+}
+void Host_YieldToUI()
+{
+}
+void Host_TitleChanged()
+{
+}
+bool Host_UIBlocksControllerState()
+{
+  return false;
+}
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct FrameTimes
+{
+  // Nanoseconds from the start of the frame to the start of the next one.
+  u64 total = 0;
+  StageProfiler::Times stages{};
+};
+
+class Benchmark
+{
+public:
+  Benchmark(u32 warmup_replays, u32 measured_replays)
+      : m_warmup_replays(warmup_replays), m_replays(measured_replays)
+  {
+  }
+
+  // Called by the FifoPlayer before it writes each frame. The GPU runs on the CPU thread and has
+  // finished the previous frame at this point.
+  void OnFrameStart()
+  {
+    if (m_done.IsSet())
+      return;
+
+    const Clock::time_point now = Clock::now();
+    const FifoPlayer& player = FifoPlayer::GetInstance();
+
+    if (!StageProfiler::IsEnabled())
+    {
+      StageProfiler::SetEnabled(true);
+      m_last_stages = {};
+    }
+    else
+    {
+      const StageProfiler::Times stages = StageProfiler::GetTimes();
+      if (m_replay >= m_warmup_replays)
+      {
+        FrameTimes& times = m_replays[m_replay - m_warmup_replays].emplace_back();
+        times.total = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_last_frame_start)
+                          .count();
+        for (size_t i = 0; i < StageProfiler::NUM_STAGES; ++i)
+          times.stages[i] = stages[i] - m_last_stages[i];
+      }
+      m_last_stages = stages;
+
+      if (player.GetCurrentFrameNum() == player.GetFrameRangeStart() &&
+          ++m_replay == m_warmup_replays + m_replays.size())
+      {
+        StageProfiler::SetEnabled(false);
+        m_done.Set();
+        return;
+      }
+    }
+
+    m_last_frame_start = now;
+  }
+
+  bool IsDone() const { return m_done.IsSet(); }
+
+  void PrintSummary() const
+  {
+    fmt::print("{:>6} {:>10}", "frame", "total");
+    for (size_t i = 0; i < StageProfiler::NUM_STAGES; ++i)
+      fmt::print(" {:>11}", StageProfiler::GetStageName(static_cast<StageProfiler::Stage>(i)));
+    fmt::print(" {:>10}  (ms, mean of {} replays)\n", "other", m_replays.size());
+
+    const size_t num_frames = m_replays.front().size();
+    FrameTimes all_frames;
+    for (size_t frame = 0; frame < num_frames; ++frame)
+    {
+      FrameTimes sum;
+      for (const std::vector<FrameTimes>& replay : m_replays)
+      {
+        sum.total += replay[frame].total;
+        for (size_t i = 0; i < StageProfiler::NUM_STAGES; ++i)
+          sum.stages[i] += replay[frame].stages[i];
+      }
+      PrintRow(std::to_string(frame), sum, m_replays.size());
+
+      all_frames.total += sum.total;
+      for (size_t i = 0; i < StageProfiler::NUM_STAGES; ++i)
+        all_frames.stages[i] += sum.stages[i];
+    }
+    PrintRow("mean", all_frames, m_replays.size() * num_frames);
+  }
+
+  void PrintCSV() const
+  {
+    fmt::print("replay,frame,total");
+    for (size_t i = 0; i < StageProfiler::NUM_STAGES; ++i)
+      fmt::print(",{}", StageProfiler::GetStageName(static_cast<StageProfiler::Stage>(i)));
+    fmt::print("\n");
+
+    for (size_t replay = 0; replay < m_replays.size(); ++replay)
+    {
+      for (size_t frame = 0; frame < m_replays[replay].size(); ++frame)
+      {
+        const FrameTimes& times = m_replays[replay][frame];
+        fmt::print("{},{},{}", replay, frame, times.total);
+        for (u64 stage : times.stages)
+          fmt::print(",{}", stage);
+        fmt::print("\n");
+      }
+    }
+  }
+
+private:
+  static void PrintRow(const std::string& label, const FrameTimes& sum, size_t count)
+  {
+    const auto to_ms = [count](u64 ns) { return ns / 1e6 / count; };
+
+    u64 other = sum.total;
+    fmt::print("{:>6} {:>10.3f}", label, to_ms(sum.total));
+    for (u64 stage : sum.stages)
+    {
+      fmt::print(" {:>11.3f}", to_ms(stage));
+      other -= stage;
+    }
+    fmt::print(" {:>10.3f}\n", to_ms(other));
+  }
+
+  u32 m_warmup_replays;
+  u32 m_replay = 0;
+  Clock::time_point m_last_frame_start;
+  StageProfiler::Times m_last_stages{};
+  Common::Flag m_done;
+
+  // The measured replays, with the times of every frame.
+  std::vector<std::vector<FrameTimes>> m_replays;
+};
+}  // Anonymous namespace
+
+int main(int argc, char* argv[])
+{
+  optparse::OptionParser parser;
+  parser.usage("usage: %prog [options]... FILE.dff").version(Common::scm_rev_str);
+  parser.add_option("-u", "--user").action("store").help("User folder path");
+  parser.add_option("-v", "--video_backend")
+      .choices({"Null", "Software"})
+      .set_default("Null")
+      .help("Video backend to replay on [%choices], default %default");
+  parser.add_option("-n", "--replays")
+      .type("int")
+      .set_default(10)
+      .help("Number of measured replays of the log, default %default");
+  parser.add_option("-w", "--warmup")
+      .type("int")
+      .set_default(1)
+      .help("Number of replays before measuring, default %default");
+  parser.add_option("--csv")
+      .action("store_true")
+      .help("Print the times of every frame of every replay in nanoseconds, as CSV");
+
+  const optparse::Values& options = parser.parse_args(argc, argv);
+  const std::vector<std::string> args = parser.args();
+  const int replays = options.get("replays");
+  const int warmup = options.get("warmup");
+  if (args.size() != 1 || replays < 1 || warmup < 0)
+  {
+    parser.print_help();
+    return 1;
+  }
+
+  std::string user_directory;
+  if (options.is_set("user"))
+    user_directory = static_cast<const char*>(options.get("user"));
+
+  UICommon::SetUserDirectory(user_directory);
+  UICommon::Init();
+
+  const std::string backend = static_cast<const char*>(options.get("video_backend"));
+  Config::SetCurrent(Config::MAIN_GFX_BACKEND,
+                     backend == "Software" ? "Software Renderer" : backend);
+
+  // Run the GPU on the CPU thread, so that the frames don't overlap and the profiler isn't shared
+  // between threads, and replay as fast as possible.
+  SConfig& config = SConfig::GetInstance();
+  config.bCPUThread = false;
+  config.m_EmulationSpeed = 0.0f;
+  config.bLoopFifoReplay = true;
+  config.sBackend = BACKEND_NULLSOUND;
+
+  Benchmark benchmark(warmup, replays);
+  FifoPlayer::GetInstance().SetFrameWrittenCallback([&benchmark] { benchmark.OnFrameStart(); });
+
+  Common::Flag stopped;
+  Core::SetOnStateChangedCallback([&stopped](Core::State state) {
+    if (state == Core::State::Uninitialized)
+      stopped.Set();
+  });
+
+  WindowSystemInfo wsi;
+  wsi.type = WindowSystemType::Headless;
+  if (!BootManager::BootCore(BootParameters::GenerateFromFile(args.front()), wsi))
+  {
+    std::fprintf(stderr, "Could not boot %s\n", args.front().c_str());
+    return 1;
+  }
+
+  while (!benchmark.IsDone() && !stopped.IsSet())
+  {
+    Core::HostDispatchJobs();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  Core::Stop();
+  Core::Shutdown();
+  FifoPlayer::GetInstance().SetFrameWrittenCallback(nullptr);
+  UICommon::Shutdown();
+
+  if (!benchmark.IsDone())
+  {
+    std::fprintf(stderr, "The replay stopped before all frames were measured.\n");
+    return 1;
+  }
+
+  if (options.get("csv"))
+    benchmark.PrintCSV();
+  else
+    benchmark.PrintSummary();
+
+  return 0;
+}
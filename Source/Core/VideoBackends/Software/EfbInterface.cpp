@@ -15,8 +15,10 @@
 
 #include "VideoBackends/Software/CopyRegion.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/LookUpTables.h"
 #include "VideoCommon/PerfQueryBase.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoCommon.h"
 
 namespace EfbInterface
@@ -24,6 +26,21 @@ namespace EfbInterface
 static std::array<u8, EFB_WIDTH * EFB_HEIGHT * 6> efb;
 
 static std::array<u32, PQ_NUM_MEMBERS> perf_values;
+static std::array<u32, PQ_NUM_MEMBERS> perf_quad_pixels;
+
+// Pixels are 3 bytes wide, so only ever touch those bytes. A wider access would race with the
+// neighbouring pixel when it is drawn by another rasterizer thread.
+static inline u32 LoadPixel(u32 offset)
+{
+  u32 value = 0;
+  std::memcpy(&value, &efb[offset], 3);
+  return value;
+}
+
+static inline void StorePixel(u32 offset, u32 value)
+{
+  std::memcpy(&efb[offset], &value, 3);
+}
 
 static inline u32 GetColorOffset(u16 x, u16 y)
 {
@@ -49,10 +66,9 @@ static void SetPixelAlphaOnly(u32 offset, u8 a)
   case PEControl::RGBA6_Z24:
   {
     u32 a32 = a;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xffffffc0;
+    u32 val = LoadPixel(offset) & 0x00ffffc0;
     val |= (a32 >> 2) & 0x0000003f;
-    *dst = val;
+    StorePixel(offset, val);
   }
   break;
   default:
@@ -68,31 +84,26 @@ static void SetPixelColorOnly(u32 offset, u8* rgb)
   case PEControl::Z24:
   {
     u32 src = *(u32*)rgb;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
-    val |= src >> 8;
-    *dst = val;
+    u32 val = src >> 8;
+    StorePixel(offset, val);
   }
   break;
   case PEControl::RGBA6_Z24:
   {
     u32 src = *(u32*)rgb;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff00003f;
+    u32 val = LoadPixel(offset) & 0x0000003f;
     val |= (src >> 4) & 0x00000fc0;  // blue
     val |= (src >> 6) & 0x0003f000;  // green
     val |= (src >> 8) & 0x00fc0000;  // red
-    *dst = val;
+    StorePixel(offset, val);
   }
   break;
   case PEControl::RGB565_Z16:
   {
     INFO_LOG(VIDEO, "RGB565_Z16 is not supported correctly yet");
     u32 src = *(u32*)rgb;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
-    val |= src >> 8;
-    *dst = val;
+    u32 val = src >> 8;
+    StorePixel(offset, val);
   }
   break;
   default:
@@ -108,32 +119,27 @@ static void SetPixelAlphaColor(u32 offset, u8* color)
   case PEControl::Z24:
   {
     u32 src = *(u32*)color;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
-    val |= src >> 8;
-    *dst = val;
+    u32 val = src >> 8;
+    StorePixel(offset, val);
   }
   break;
   case PEControl::RGBA6_Z24:
   {
     u32 src = *(u32*)color;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
+    u32 val = 0;
     val |= (src >> 2) & 0x0000003f;  // alpha
     val |= (src >> 4) & 0x00000fc0;  // blue
     val |= (src >> 6) & 0x0003f000;  // green
     val |= (src >> 8) & 0x00fc0000;  // red
-    *dst = val;
+    StorePixel(offset, val);
   }
   break;
   case PEControl::RGB565_Z16:
   {
     INFO_LOG(VIDEO, "RGB565_Z16 is not supported correctly yet");
     u32 src = *(u32*)color;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
-    val |= src >> 8;
-    *dst = val;
+    u32 val = src >> 8;
+    StorePixel(offset, val);
   }
   break;
   default:
@@ -143,8 +149,7 @@ static void SetPixelAlphaColor(u32 offset, u8* color)
 
 static u32 GetPixelColor(u32 offset)
 {
-  u32 src;
-  std::memcpy(&src, &efb[offset], sizeof(u32));
+  const u32 src = LoadPixel(offset);
 
   switch (bpmem.zcontrol.pixel_format)
   {
@@ -176,19 +181,15 @@ static void SetPixelDepth(u32 offset, u32 depth)
   case PEControl::RGBA6_Z24:
   case PEControl::Z24:
   {
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
-    val |= depth & 0x00ffffff;
-    *dst = val;
+    u32 val = depth & 0x00ffffff;
+    StorePixel(offset, val);
   }
   break;
   case PEControl::RGB565_Z16:
   {
     INFO_LOG(VIDEO, "RGB565_Z16 is not supported correctly yet");
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
-    val |= depth & 0x00ffffff;
-    *dst = val;
+    u32 val = depth & 0x00ffffff;
+    StorePixel(offset, val);
   }
   break;
   default:
@@ -206,13 +207,13 @@ static u32 GetPixelDepth(u32 offset)
   case PEControl::RGBA6_Z24:
   case PEControl::Z24:
   {
-    depth = (*(u32*)&efb[offset]) & 0x00ffffff;
+    depth = LoadPixel(offset);
   }
   break;
   case PEControl::RGB565_Z16:
   {
     INFO_LOG(VIDEO, "RGB565_Z16 is not supported correctly yet");
-    depth = (*(u32*)&efb[offset]) & 0x00ffffff;
+    depth = LoadPixel(offset);
   }
   break;
   default:
@@ -696,18 +697,41 @@ u32 GetPerfQueryResult(PerfQueryType type)
 void ResetPerfQuery()
 {
   perf_values = {};
+  perf_quad_pixels = {};
+}
+
+void PixelCounters::UpdateBoundingBox(u16 x, u16 y)
+{
+  bbox_left = std::min(bbox_left, x);
+  bbox_right = std::max(bbox_right, x);
+  bbox_top = std::min(bbox_top, y);
+  bbox_bottom = std::max(bbox_bottom, y);
 }
 
-void IncPerfCounterQuadCount(PerfQueryType type)
+void CommitPixelCounters(PixelCounters* counters)
 {
   // NOTE: hardware doesn't process individual pixels but quads instead.
   // Current software renderer architecture works on pixels though, so
   // we have this "quad" hack here to only increment the registers on
-  // every fourth rendered pixel
-  static u32 quad[PQ_NUM_MEMBERS];
-  if (++quad[type] != 3)
-    return;
-  quad[type] = 0;
-  ++perf_values[type];
+  // every third rendered pixel. Only the total number of pixels matters,
+  // so it doesn't depend on which thread drew them.
+  for (size_t i = 0; i < PQ_NUM_MEMBERS; ++i)
+  {
+    perf_quad_pixels[i] += counters->perf_pixels[i];
+    perf_values[i] += perf_quad_pixels[i] / 3;
+    perf_quad_pixels[i] %= 3;
+  }
+
+  ADDSTAT(g_stats.this_frame.rasterized_pixels, counters->rasterized_pixels);
+  ADDSTAT(g_stats.this_frame.tev_pixels_in, counters->tev_pixels_in);
+  ADDSTAT(g_stats.this_frame.tev_pixels_out, counters->tev_pixels_out);
+
+  if (counters->bbox_left <= counters->bbox_right)
+  {
+    BoundingBox::Update(counters->bbox_left, counters->bbox_right, counters->bbox_top,
+                        counters->bbox_bottom);
+  }
+
+  *counters = {};
 }
 }  // namespace EfbInterface
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
 #include "VideoCommon/PerfQueryBase.h"
@@ -59,5 +61,26 @@ void EncodeXFB(u8* xfb_in_ram, u32 memory_stride, const MathUtil::Rectangle<int>
 
 u32 GetPerfQueryResult(PerfQueryType type);
 void ResetPerfQuery();
-void IncPerfCounterQuadCount(PerfQueryType type);
+
+// Counts the pixels drawn by one thread. The counts only reach the performance queries, statistics
+// and bounding box through CommitPixelCounters(), so that several threads can draw at once.
+struct PixelCounters
+{
+  std::array<u32, PQ_NUM_MEMBERS> perf_pixels{};
+  u32 rasterized_pixels = 0;
+  u32 tev_pixels_in = 0;
+  u32 tev_pixels_out = 0;
+
+  // Empty while left > right.
+  u16 bbox_left = 0xFFFF;
+  u16 bbox_right = 0;
+  u16 bbox_top = 0xFFFF;
+  u16 bbox_bottom = 0;
+
+  void IncPerfCounter(PerfQueryType type) { ++perf_pixels[type]; }
+  void UpdateBoundingBox(u16 x, u16 y);
+};
+
+// Adds the counts to the global state and resets them.
+void CommitPixelCounters(PixelCounters* counters);
 }  // namespace EfbInterface
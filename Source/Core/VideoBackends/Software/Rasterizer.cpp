@@ -5,9 +5,17 @@
 #include "VideoBackends/Software/Rasterizer.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Thread.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/NativeVertexFormat.h"
 #include "VideoBackends/Software/Tev.h"
@@ -21,22 +29,89 @@ namespace Rasterizer
 {
 static constexpr int BLOCK_SIZE = 2;
 
-static Slope ZSlope;
-static Slope WSlope;
-static Slope ColorSlopes[2][4];
-static Slope TexSlopes[8][3];
+// When rasterizing on several threads, triangles are binned into tiles of this size. It is a
+// multiple of the block size, so that every block lies within a single tile.
+static constexpr int TILE_SIZE = 64;
+static constexpr int TILES_X = (EFB_WIDTH + TILE_SIZE - 1) / TILE_SIZE;
+static constexpr int TILES_Y = (EFB_HEIGHT + TILE_SIZE - 1) / TILE_SIZE;
+static_assert(TILE_SIZE % BLOCK_SIZE == 0);
+static_assert(BLOCK_SIZE * BLOCK_SIZE == Tev::QUAD_SIZE);
 
-static s32 vertex0X;
-static s32 vertex0Y;
-static float vertexOffsetX;
-static float vertexOffsetY;
+// Batches covering fewer pixels than this are not worth waking up the workers for.
+static constexpr u64 MIN_PIXELS_FOR_WORKERS = 4096;
+static constexpr size_t MAX_QUEUED_TRIANGLES = 4096;
 
-static Tev tev;
-static RasterBlock rasterBlock;
+// Everything needed to rasterize a triangle, calculated once when it is set up.
+struct TriangleSetup
+{
+  Slope ZSlope;
+  Slope WSlope;
+  Slope ColorSlopes[2][4];
+  Slope TexSlopes[8][3];
+
+  s32 vertex0X;
+  s32 vertex0Y;
+  float vertexOffsetX;
+  float vertexOffsetY;
+
+  // Half-edge constants and deltas
+  s32 C1, C2, C3;
+  s32 DX12, DX23, DX31;
+  s32 DY12, DY23, DY31;
+
+  // Bounds in pixels, with minx and miny aligned to the block size
+  s32 minx, maxx, miny, maxy;
+};
+
+// The state of a thread drawing pixels.
+struct DrawContext
+{
+  Tev tev;
+  RasterBlock rasterBlock;
+};
+
+// The z slope is kept between triangles for zfreeze.
+static Slope ZSlope;
+
+// The first context belongs to the GPU thread, the others to the workers.
+static std::vector<std::unique_ptr<DrawContext>> s_contexts;
+
+// Triangles waiting to be drawn by the workers, and the triangles overlapping each tile in order.
+static std::vector<TriangleSetup> s_triangles;
+static std::array<std::vector<u32>, TILES_X * TILES_Y> s_tile_triangles;
+static std::vector<u32> s_tile_jobs;
+static std::atomic<size_t> s_next_tile_job{0};
+static u64 s_queued_pixels = 0;
+
+static std::vector<std::thread> s_workers;
+static std::mutex s_workers_mutex;
+static std::condition_variable s_workers_wakeup;
+static std::condition_variable s_workers_done;
+// Number of workers which should still pick up the current tiles.
+static u32 s_free_worker_slots = 0;
+// Number of workers which are still drawing the current tiles.
+static u32 s_running_workers = 0;
+static bool s_workers_exit = false;
+
+// Konstant colors, so that contexts created later on start out with the current ones.
+static s16 s_tev_konst_colors[4][4];
+
+static void CreateContext()
+{
+  auto context = std::make_unique<DrawContext>();
+  context->tev.Init();
+  for (int reg = 0; reg < 4; reg++)
+  {
+    for (int comp = 0; comp < 4; comp++)
+      context->tev.SetRegColor(reg, comp, s_tev_konst_colors[reg][comp]);
+  }
+  s_contexts.push_back(std::move(context));
+}
 
 void Init()
 {
-  tev.Init();
+  s_contexts.clear();
+  CreateContext();
 
   // Set initial z reference plane in the unlikely case that zfreeze is enabled when drawing the
   // first primitive.
@@ -69,58 +144,82 @@ static inline int iround(float x)
 
 void SetTevReg(int reg, int comp, s16 color)
 {
-  tev.SetRegColor(reg, comp, color);
+  s_tev_konst_colors[reg][comp] = color;
+  for (auto& context : s_contexts)
+    context->tev.SetRegColor(reg, comp, color);
 }
 
-static void Draw(s32 x, s32 y, s32 xi, s32 yi)
+// Draws the pixels of the block at x, y which are set in the mask, where bit yi * BLOCK_SIZE + xi
+// stands for the pixel at x + xi, y + yi. The pixels which pass the early depth test are shaded
+// together.
+static void Draw(DrawContext& context, const TriangleSetup& setup, s32 x, s32 y, u32 pixel_mask)
 {
-  INCSTAT(g_stats.this_frame.rasterized_pixels);
-
-  float dx = vertexOffsetX + (float)(x - vertex0X);
-  float dy = vertexOffsetY + (float)(y - vertex0Y);
+  Tev& tev = context.tev;
+  const RasterBlock& rasterBlock = context.rasterBlock;
 
-  s32 z = (s32)std::clamp<float>(ZSlope.GetValue(dx, dy), 0.0f, 16777215.0f);
-
-  if (bpmem.UseEarlyDepthTest() && g_ActiveConfig.bZComploc)
+  for (s32 yi = 0; yi < BLOCK_SIZE; yi++)
   {
-    // TODO: Test if perf regs are incremented even if test is disabled
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT_ZCOMPLOC);
-    if (bpmem.zmode.testenable)
+    for (s32 xi = 0; xi < BLOCK_SIZE; xi++)
     {
-      // early z
-      if (!EfbInterface::ZCompare(x, y, z))
-        return;
-    }
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT_ZCOMPLOC);
-  }
+      const int pixel = yi * BLOCK_SIZE + xi;
+      if (!(pixel_mask & (1u << pixel)))
+        continue;
 
-  RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
+      tev.Counters.rasterized_pixels++;
 
-  tev.Position[0] = x;
-  tev.Position[1] = y;
-  tev.Position[2] = z;
+      float dx = setup.vertexOffsetX + (float)(x + xi - setup.vertex0X);
+      float dy = setup.vertexOffsetY + (float)(y + yi - setup.vertex0Y);
 
-  //  colors
-  for (unsigned int i = 0; i < bpmem.genMode.numcolchans; i++)
-  {
-    for (int comp = 0; comp < 4; comp++)
-    {
-      u16 color = (u16)ColorSlopes[i][comp].GetValue(dx, dy);
+      s32 z = (s32)std::clamp<float>(setup.ZSlope.GetValue(dx, dy), 0.0f, 16777215.0f);
+
+      if (bpmem.UseEarlyDepthTest() && g_ActiveConfig.bZComploc)
+      {
+        // TODO: Test if perf regs are incremented even if test is disabled
+        tev.Counters.IncPerfCounter(PQ_ZCOMP_INPUT_ZCOMPLOC);
+        if (bpmem.zmode.testenable)
+        {
+          // early z
+          if (!EfbInterface::ZCompare(x + xi, y + yi, z))
+          {
+            pixel_mask &= ~(1u << pixel);
+            continue;
+          }
+        }
+        tev.Counters.IncPerfCounter(PQ_ZCOMP_OUTPUT_ZCOMPLOC);
+      }
+
+      const RasterBlockPixel& rasterPixel = rasterBlock.Pixel[xi][yi];
+
+      tev.Position[pixel][0] = x + xi;
+      tev.Position[pixel][1] = y + yi;
+      tev.Position[pixel][2] = z;
+
+      //  colors
+      for (unsigned int i = 0; i < bpmem.genMode.numcolchans; i++)
+      {
+        for (int comp = 0; comp < 4; comp++)
+        {
+          u16 color = (u16)setup.ColorSlopes[i][comp].GetValue(dx, dy);
+
+          // clamp color value to 0
+          u16 mask = ~(color >> 8);
 
-      // clamp color value to 0
-      u16 mask = ~(color >> 8);
+          tev.Color[pixel][i][comp] = color & mask;
+        }
+      }
 
-      tev.Color[i][comp] = color & mask;
+      // tex coords
+      for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
+      {
+        // multiply by 128 because TEV stores UVs as s17.7
+        tev.Uv[pixel][i].s = (s32)(rasterPixel.Uv[i][0] * 128);
+        tev.Uv[pixel][i].t = (s32)(rasterPixel.Uv[i][1] * 128);
+      }
     }
   }
 
-  // tex coords
-  for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
-  {
-    // multiply by 128 because TEV stores UVs as s17.7
-    tev.Uv[i].s = (s32)(pixel.Uv[i][0] * 128);
-    tev.Uv[i].t = (s32)(pixel.Uv[i][1] * 128);
-  }
+  if (pixel_mask == 0)
+    return;
 
   for (unsigned int i = 0; i < bpmem.genMode.numindstages; i++)
   {
@@ -134,19 +233,19 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
     tev.TextureLinear[i] = rasterBlock.TextureLinear[i];
   }
 
-  tev.Draw();
+  tev.Draw(pixel_mask);
 }
 
-static void InitTriangle(float X1, float Y1, s32 xi, s32 yi)
+static void InitTriangle(TriangleSetup* setup, float X1, float Y1, s32 xi, s32 yi)
 {
-  vertex0X = xi;
-  vertex0Y = yi;
+  setup->vertex0X = xi;
+  setup->vertex0Y = yi;
 
   // adjust a little less than 0.5
   const float adjust = 0.495f;
 
-  vertexOffsetX = ((float)xi - X1) + adjust;
-  vertexOffsetY = ((float)yi - Y1) + adjust;
+  setup->vertexOffsetX = ((float)xi - X1) + adjust;
+  setup->vertexOffsetY = ((float)yi - Y1) + adjust;
 }
 
 static void InitSlope(Slope* slope, float f1, float f2, float f3, float DX31, float DX12,
@@ -162,7 +261,8 @@ static void InitSlope(Slope* slope, float f1, float f2, float f3, float DX31, fl
   slope->f0 = f1;
 }
 
-static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoord)
+static inline void CalculateLOD(const RasterBlock& rasterBlock, s32* lodp, bool* linear,
+                                u32 texmap, u32 texcoord)
 {
   const FourTexUnits& texUnit = bpmem.tex[(texmap >> 2) & 1];
   const u8 subTexmap = texmap & 3;
@@ -175,17 +275,17 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
   float sDelta, tDelta;
   if (tm0.diag_lod)
   {
-    float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-    float* uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
+    const float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+    const float* uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
 
     sDelta = fabsf(uv0[0] - uv1[0]);
     tDelta = fabsf(uv0[1] - uv1[1]);
   }
   else
   {
-    float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-    float* uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
-    float* uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
+    const float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+    const float* uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
+    const float* uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
 
     sDelta = std::max(fabsf(uv0[0] - uv1[0]), fabsf(uv0[0] - uv2[0]));
     tDelta = std::max(fabsf(uv0[1] - uv1[1]), fabsf(uv0[1] - uv2[1]));
@@ -210,7 +310,8 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
   *lodp = lod;
 }
 
-static void BuildBlock(s32 blockX, s32 blockY)
+static void BuildBlock(RasterBlock& rasterBlock, const TriangleSetup& setup, s32 blockX,
+                       s32 blockY)
 {
   for (s32 yi = 0; yi < BLOCK_SIZE; yi++)
   {
@@ -218,10 +319,10 @@ static void BuildBlock(s32 blockX, s32 blockY)
     {
       RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
-      float dx = vertexOffsetX + (float)(xi + blockX - vertex0X);
-      float dy = vertexOffsetY + (float)(yi + blockY - vertex0Y);
+      float dx = setup.vertexOffsetX + (float)(xi + blockX - setup.vertex0X);
+      float dy = setup.vertexOffsetY + (float)(yi + blockY - setup.vertex0Y);
 
-      float invW = 1.0f / WSlope.GetValue(dx, dy);
+      float invW = 1.0f / setup.WSlope.GetValue(dx, dy);
       pixel.InvW = invW;
 
       // tex coords
@@ -230,13 +331,13 @@ static void BuildBlock(s32 blockX, s32 blockY)
         float projection = invW;
         if (xfmem.texMtxInfo[i].projection)
         {
-          float q = TexSlopes[i][2].GetValue(dx, dy) * invW;
+          float q = setup.TexSlopes[i][2].GetValue(dx, dy) * invW;
           if (q != 0.0f)
             projection = invW / q;
         }
 
-        pixel.Uv[i][0] = TexSlopes[i][0].GetValue(dx, dy) * projection;
-        pixel.Uv[i][1] = TexSlopes[i][1].GetValue(dx, dy) * projection;
+        pixel.Uv[i][0] = setup.TexSlopes[i][0].GetValue(dx, dy) * projection;
+        pixel.Uv[i][1] = setup.TexSlopes[i][1].GetValue(dx, dy) * projection;
       }
     }
   }
@@ -249,7 +350,8 @@ static void BuildBlock(s32 blockX, s32 blockY)
     u32 texcoord = indref & 3;
     indref >>= 3;
 
-    CalculateLOD(&rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap, texcoord);
+    CalculateLOD(rasterBlock, &rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap,
+                 texcoord);
   }
 
   for (unsigned int i = 0; i <= bpmem.genMode.numtevstages; i++)
@@ -261,9 +363,266 @@ static void BuildBlock(s32 blockX, s32 blockY)
       u32 texmap = order.getTexMap(stageOdd);
       u32 texcoord = order.getTexCoord(stageOdd);
 
-      CalculateLOD(&rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap, texcoord);
+      CalculateLOD(rasterBlock, &rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap,
+                   texcoord);
+    }
+  }
+}
+
+// Draws the part of the triangle which lies within [left, right) x [top, bottom). The bounds have
+// to be aligned to the block size.
+static void RasterizeTriangle(DrawContext& context, const TriangleSetup& setup, s32 left,
+                              s32 right, s32 top, s32 bottom)
+{
+  const s32 C1 = setup.C1;
+  const s32 C2 = setup.C2;
+  const s32 C3 = setup.C3;
+
+  const s32 DX12 = setup.DX12;
+  const s32 DX23 = setup.DX23;
+  const s32 DX31 = setup.DX31;
+
+  const s32 DY12 = setup.DY12;
+  const s32 DY23 = setup.DY23;
+  const s32 DY31 = setup.DY31;
+
+  // Fixed-pos32 deltas
+  const s32 FDX12 = DX12 * 16;
+  const s32 FDX23 = DX23 * 16;
+  const s32 FDX31 = DX31 * 16;
+
+  const s32 FDY12 = DY12 * 16;
+  const s32 FDY23 = DY23 * 16;
+  const s32 FDY31 = DY31 * 16;
+
+  const s32 minx = std::max(setup.minx, left);
+  const s32 maxx = std::min(setup.maxx, right);
+  const s32 miny = std::max(setup.miny, top);
+  const s32 maxy = std::min(setup.maxy, bottom);
+
+  // Loop through blocks
+  for (s32 y = miny; y < maxy; y += BLOCK_SIZE)
+  {
+    for (s32 x = minx; x < maxx; x += BLOCK_SIZE)
+    {
+      // Corners of block
+      s32 x0 = x << 4;
+      s32 x1 = (x + BLOCK_SIZE - 1) << 4;
+      s32 y0 = y << 4;
+      s32 y1 = (y + BLOCK_SIZE - 1) << 4;
+
+      // Evaluate half-space functions
+      bool a00 = C1 + DX12 * y0 - DY12 * x0 > 0;
+      bool a10 = C1 + DX12 * y0 - DY12 * x1 > 0;
+      bool a01 = C1 + DX12 * y1 - DY12 * x0 > 0;
+      bool a11 = C1 + DX12 * y1 - DY12 * x1 > 0;
+      int a = (a00 << 0) | (a10 << 1) | (a01 << 2) | (a11 << 3);
+
+      bool b00 = C2 + DX23 * y0 - DY23 * x0 > 0;
+      bool b10 = C2 + DX23 * y0 - DY23 * x1 > 0;
+      bool b01 = C2 + DX23 * y1 - DY23 * x0 > 0;
+      bool b11 = C2 + DX23 * y1 - DY23 * x1 > 0;
+      int b = (b00 << 0) | (b10 << 1) | (b01 << 2) | (b11 << 3);
+
+      bool c00 = C3 + DX31 * y0 - DY31 * x0 > 0;
+      bool c10 = C3 + DX31 * y0 - DY31 * x1 > 0;
+      bool c01 = C3 + DX31 * y1 - DY31 * x0 > 0;
+      bool c11 = C3 + DX31 * y1 - DY31 * x1 > 0;
+      int c = (c00 << 0) | (c10 << 1) | (c01 << 2) | (c11 << 3);
+
+      // Skip block when outside an edge
+      if (a == 0x0 || b == 0x0 || c == 0x0)
+        continue;
+
+      BuildBlock(context.rasterBlock, setup, x, y);
+
+      // Accept whole block when totally covered
+      if (a == 0xF && b == 0xF && c == 0xF)
+      {
+        Draw(context, setup, x, y, 0xF);
+      }
+      else  // Partially covered block
+      {
+        u32 pixel_mask = 0;
+
+        s32 CY1 = C1 + DX12 * y0 - DY12 * x0;
+        s32 CY2 = C2 + DX23 * y0 - DY23 * x0;
+        s32 CY3 = C3 + DX31 * y0 - DY31 * x0;
+
+        for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
+        {
+          s32 CX1 = CY1;
+          s32 CX2 = CY2;
+          s32 CX3 = CY3;
+
+          for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
+          {
+            if (CX1 > 0 && CX2 > 0 && CX3 > 0)
+              pixel_mask |= 1u << (iy * BLOCK_SIZE + ix);
+
+            CX1 -= FDY12;
+            CX2 -= FDY23;
+            CX3 -= FDY31;
+          }
+
+          CY1 += FDX12;
+          CY2 += FDX23;
+          CY3 += FDX31;
+        }
+
+        Draw(context, setup, x, y, pixel_mask);
+      }
+    }
+  }
+}
+
+static void RasterizeTile(DrawContext& context, u32 tile)
+{
+  const s32 left = static_cast<s32>(tile % TILES_X) * TILE_SIZE;
+  const s32 top = static_cast<s32>(tile / TILES_X) * TILE_SIZE;
+
+  // Every tile is drawn by a single thread, in the order the triangles were submitted, so the
+  // result is the same as when drawing everything on the GPU thread.
+  for (u32 index : s_tile_triangles[tile])
+    RasterizeTriangle(context, s_triangles[index], left, left + TILE_SIZE, top, top + TILE_SIZE);
+}
+
+static void RunTileJobs(DrawContext& context)
+{
+  for (size_t i = s_next_tile_job.fetch_add(1); i < s_tile_jobs.size();
+       i = s_next_tile_job.fetch_add(1))
+  {
+    RasterizeTile(context, s_tile_jobs[i]);
+  }
+}
+
+static void WorkerThread(DrawContext* context)
+{
+  Common::SetCurrentThreadName("Software rasterizer worker");
+
+  std::unique_lock lk(s_workers_mutex);
+  while (true)
+  {
+    s_workers_wakeup.wait(lk, [] { return s_workers_exit || s_free_worker_slots != 0; });
+    if (s_workers_exit)
+      return;
+
+    --s_free_worker_slots;
+    lk.unlock();
+
+    RunTileJobs(*context);
+
+    lk.lock();
+    if (--s_running_workers == 0)
+      s_workers_done.notify_one();
+  }
+}
+
+static void StopWorkers()
+{
+  {
+    std::lock_guard lk(s_workers_mutex);
+    s_workers_exit = true;
+  }
+  s_workers_wakeup.notify_all();
+
+  for (std::thread& worker : s_workers)
+    worker.join();
+  s_workers.clear();
+}
+
+static void SetWorkerCount(u32 count)
+{
+  if (count == s_workers.size())
+    return;
+
+  StopWorkers();
+
+  while (s_contexts.size() < count + 1)
+    CreateContext();
+
+  s_workers_exit = false;
+  s_free_worker_slots = 0;
+  s_running_workers = 0;
+  for (u32 i = 0; i < count; ++i)
+    s_workers.emplace_back(WorkerThread, s_contexts[i + 1].get());
+}
+
+static void DrawQueuedTriangles()
+{
+  if (s_triangles.empty())
+    return;
+
+  for (u32 tile = 0; tile < s_tile_triangles.size(); ++tile)
+  {
+    if (!s_tile_triangles[tile].empty())
+      s_tile_jobs.push_back(tile);
+  }
+  s_next_tile_job.store(0, std::memory_order_relaxed);
+
+  // The GPU thread works on the tiles too, so only wake up workers for the remaining ones.
+  u32 helpers = 0;
+  if (s_queued_pixels >= MIN_PIXELS_FOR_WORKERS)
+  {
+    helpers =
+        std::min(static_cast<u32>(s_workers.size()), static_cast<u32>(s_tile_jobs.size() - 1));
+  }
+  if (helpers != 0)
+  {
+    {
+      std::lock_guard lk(s_workers_mutex);
+      s_free_worker_slots = helpers;
+      s_running_workers = helpers;
     }
+    s_workers_wakeup.notify_all();
   }
+
+  RunTileJobs(*s_contexts[0]);
+
+  if (helpers != 0)
+  {
+    std::unique_lock lk(s_workers_mutex);
+    s_workers_done.wait(lk, [] { return s_running_workers == 0; });
+  }
+
+  for (u32 tile : s_tile_jobs)
+    s_tile_triangles[tile].clear();
+  s_tile_jobs.clear();
+  s_triangles.clear();
+  s_queued_pixels = 0;
+}
+
+void Flush()
+{
+  DrawQueuedTriangles();
+
+  for (auto& context : s_contexts)
+    EfbInterface::CommitPixelCounters(&context->tev.Counters);
+
+  // The TEV debug dumps go to buffers shared by all pixels, so they can't be drawn in parallel.
+  const bool dumping = g_ActiveConfig.bDumpTevStages || g_ActiveConfig.bDumpTevTextureFetches;
+  SetWorkerCount(dumping ? 0 : g_ActiveConfig.GetSWRasterizerThreads());
+}
+
+void Shutdown()
+{
+  StopWorkers();
+}
+
+static void QueueTriangle(const TriangleSetup& setup)
+{
+  const u32 index = static_cast<u32>(s_triangles.size());
+  s_triangles.push_back(setup);
+  s_queued_pixels += static_cast<u64>(setup.maxx - setup.minx) * (setup.maxy - setup.miny);
+
+  for (s32 ty = setup.miny / TILE_SIZE; ty <= (setup.maxy - 1) / TILE_SIZE; ty++)
+  {
+    for (s32 tx = setup.minx / TILE_SIZE; tx <= (setup.maxx - 1) / TILE_SIZE; tx++)
+      s_tile_triangles[ty * TILES_X + tx].push_back(index);
+  }
+
+  if (s_triangles.size() >= MAX_QUEUED_TRIANGLES)
+    DrawQueuedTriangles();
 }
 
 void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
@@ -292,15 +651,6 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   const s32 DY23 = Y2 - Y3;
   const s32 DY31 = Y3 - Y1;
 
-  // Fixed-pos32 deltas
-  const s32 FDX12 = DX12 * 16;
-  const s32 FDX23 = DX23 * 16;
-  const s32 FDX31 = DX31 * 16;
-
-  const s32 FDY12 = DY12 * 16;
-  const s32 FDY23 = DY23 * 16;
-  const s32 FDY31 = DY31 * 16;
-
   // Bounding rectangle
   s32 minx = (std::min(std::min(X1, X2), X3) + 0xF) >> 4;
   s32 maxx = (std::max(std::max(X1, X2), X3) + 0xF) >> 4;
@@ -335,6 +685,8 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   if (minx >= maxx || miny >= maxy)
     return;
 
+  TriangleSetup setup;
+
   // Setup slopes
   float fltx1 = v0->screenPosition.x;
   float flty1 = v0->screenPosition.y;
@@ -343,11 +695,11 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   float fltdy12 = flty1 - v1->screenPosition.y;
   float fltdy31 = v2->screenPosition.y - flty1;
 
-  InitTriangle(fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
+  InitTriangle(&setup, fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
 
   float w[3] = {1.0f / v0->projectedPosition.w, 1.0f / v1->projectedPosition.w,
                 1.0f / v2->projectedPosition.w};
-  InitSlope(&WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+  InitSlope(&setup.WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
 
   // TODO: The zfreeze emulation is not quite correct, yet!
   // Many things might prevent us from reaching this line (culling, clipping, scissoring).
@@ -358,19 +710,21 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   if (!bpmem.genMode.zfreeze || !g_ActiveConfig.bZFreeze)
     InitSlope(&ZSlope, v0->screenPosition[2], v1->screenPosition[2], v2->screenPosition[2], fltdx31,
               fltdx12, fltdy12, fltdy31);
+  setup.ZSlope = ZSlope;
 
   for (unsigned int i = 0; i < bpmem.genMode.numcolchans; i++)
   {
     for (int comp = 0; comp < 4; comp++)
-      InitSlope(&ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp], v2->color[i][comp],
-                fltdx31, fltdx12, fltdy12, fltdy31);
+      InitSlope(&setup.ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp],
+                v2->color[i][comp], fltdx31, fltdx12, fltdy12, fltdy31);
   }
 
   for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
   {
     for (int comp = 0; comp < 3; comp++)
-      InitSlope(&TexSlopes[i][comp], v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1],
-                v2->texCoords[i][comp] * w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+      InitSlope(&setup.TexSlopes[i][comp], v0->texCoords[i][comp] * w[0],
+                v1->texCoords[i][comp] * w[1], v2->texCoords[i][comp] * w[2], fltdx31, fltdx12,
+                fltdy12, fltdy31);
   }
 
   // Half-edge constants
@@ -386,87 +740,25 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   if (DY31 < 0 || (DY31 == 0 && DX31 > 0))
     C3++;
 
-  // Start in corner of 8x8 block
-  minx &= ~(BLOCK_SIZE - 1);
-  miny &= ~(BLOCK_SIZE - 1);
-
-  // Loop through blocks
-  for (s32 y = miny; y < maxy; y += BLOCK_SIZE)
-  {
-    for (s32 x = minx; x < maxx; x += BLOCK_SIZE)
-    {
-      // Corners of block
-      s32 x0 = x << 4;
-      s32 x1 = (x + BLOCK_SIZE - 1) << 4;
-      s32 y0 = y << 4;
-      s32 y1 = (y + BLOCK_SIZE - 1) << 4;
-
-      // Evaluate half-space functions
-      bool a00 = C1 + DX12 * y0 - DY12 * x0 > 0;
-      bool a10 = C1 + DX12 * y0 - DY12 * x1 > 0;
-      bool a01 = C1 + DX12 * y1 - DY12 * x0 > 0;
-      bool a11 = C1 + DX12 * y1 - DY12 * x1 > 0;
-      int a = (a00 << 0) | (a10 << 1) | (a01 << 2) | (a11 << 3);
-
-      bool b00 = C2 + DX23 * y0 - DY23 * x0 > 0;
-      bool b10 = C2 + DX23 * y0 - DY23 * x1 > 0;
-      bool b01 = C2 + DX23 * y1 - DY23 * x0 > 0;
-      bool b11 = C2 + DX23 * y1 - DY23 * x1 > 0;
-      int b = (b00 << 0) | (b10 << 1) | (b01 << 2) | (b11 << 3);
-
-      bool c00 = C3 + DX31 * y0 - DY31 * x0 > 0;
-      bool c10 = C3 + DX31 * y0 - DY31 * x1 > 0;
-      bool c01 = C3 + DX31 * y1 - DY31 * x0 > 0;
-      bool c11 = C3 + DX31 * y1 - DY31 * x1 > 0;
-      int c = (c00 << 0) | (c10 << 1) | (c01 << 2) | (c11 << 3);
-
-      // Skip block when outside an edge
-      if (a == 0x0 || b == 0x0 || c == 0x0)
-        continue;
-
-      BuildBlock(x, y);
-
-      // Accept whole block when totally covered
-      if (a == 0xF && b == 0xF && c == 0xF)
-      {
-        for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
-        {
-          for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
-          {
-            Draw(x + ix, y + iy, ix, iy);
-          }
-        }
-      }
-      else  // Partially covered block
-      {
-        s32 CY1 = C1 + DX12 * y0 - DY12 * x0;
-        s32 CY2 = C2 + DX23 * y0 - DY23 * x0;
-        s32 CY3 = C3 + DX31 * y0 - DY31 * x0;
-
-        for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
-        {
-          s32 CX1 = CY1;
-          s32 CX2 = CY2;
-          s32 CX3 = CY3;
+  setup.C1 = C1;
+  setup.C2 = C2;
+  setup.C3 = C3;
+  setup.DX12 = DX12;
+  setup.DX23 = DX23;
+  setup.DX31 = DX31;
+  setup.DY12 = DY12;
+  setup.DY23 = DY23;
+  setup.DY31 = DY31;
 
-          for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
-          {
-            if (CX1 > 0 && CX2 > 0 && CX3 > 0)
-            {
-              Draw(x + ix, y + iy, ix, iy);
-            }
-
-            CX1 -= FDY12;
-            CX2 -= FDY23;
-            CX3 -= FDY31;
-          }
+  // Start in corner of 8x8 block
+  setup.minx = minx & ~(BLOCK_SIZE - 1);
+  setup.miny = miny & ~(BLOCK_SIZE - 1);
+  setup.maxx = maxx;
+  setup.maxy = maxy;
 
-          CY1 += FDX12;
-          CY2 += FDX23;
-          CY3 += FDX31;
-        }
-      }
-    }
-  }
+  if (s_workers.empty())
+    RasterizeTriangle(*s_contexts[0], setup, 0, EFB_WIDTH, 0, EFB_HEIGHT);
+  else
+    QueueTriangle(setup);
 }
 }  // namespace Rasterizer
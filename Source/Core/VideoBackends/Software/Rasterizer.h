@@ -11,12 +11,17 @@ struct OutputVertexData;
 namespace Rasterizer
 {
 void Init();
+void Shutdown();
 
 void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
                            const OutputVertexData* v2);
 
 void SetTevReg(int reg, int comp, s16 color);
 
+// Finishes drawing the queued triangles and commits their pixel counters. Has to be called after
+// each batch, as the queued triangles are drawn with the current BP and XF state.
+void Flush();
+
 struct Slope
 {
   float dfdx;
@@ -129,6 +129,7 @@ void VideoSoftware::Shutdown()
   if (g_renderer)
     g_renderer->Shutdown();
 
+  Rasterizer::Shutdown();
   DebugUtil::Shutdown();
   g_texture_cache.reset();
   g_perf_query.reset();
@@ -13,10 +13,8 @@
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/TextureSampler.h"
 
-#include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/PerfQueryBase.h"
 #include "VideoCommon/PixelShaderManager.h"
-#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
@@ -44,63 +42,71 @@ void Tev::Init()
     comp = 0;
   }
 
-  m_ColorInputLUT[0][RED_INP] = &Reg[0][RED_C];
-  m_ColorInputLUT[0][GRN_INP] = &Reg[0][GRN_C];
-  m_ColorInputLUT[0][BLU_INP] = &Reg[0][BLU_C];  // prev.rgb
-  m_ColorInputLUT[1][RED_INP] = &Reg[0][ALP_C];
-  m_ColorInputLUT[1][GRN_INP] = &Reg[0][ALP_C];
-  m_ColorInputLUT[1][BLU_INP] = &Reg[0][ALP_C];  // prev.aaa
-  m_ColorInputLUT[2][RED_INP] = &Reg[1][RED_C];
-  m_ColorInputLUT[2][GRN_INP] = &Reg[1][GRN_C];
-  m_ColorInputLUT[2][BLU_INP] = &Reg[1][BLU_C];  // c0.rgb
-  m_ColorInputLUT[3][RED_INP] = &Reg[1][ALP_C];
-  m_ColorInputLUT[3][GRN_INP] = &Reg[1][ALP_C];
-  m_ColorInputLUT[3][BLU_INP] = &Reg[1][ALP_C];  // c0.aaa
-  m_ColorInputLUT[4][RED_INP] = &Reg[2][RED_C];
-  m_ColorInputLUT[4][GRN_INP] = &Reg[2][GRN_C];
-  m_ColorInputLUT[4][BLU_INP] = &Reg[2][BLU_C];  // c1.rgb
-  m_ColorInputLUT[5][RED_INP] = &Reg[2][ALP_C];
-  m_ColorInputLUT[5][GRN_INP] = &Reg[2][ALP_C];
-  m_ColorInputLUT[5][BLU_INP] = &Reg[2][ALP_C];  // c1.aaa
-  m_ColorInputLUT[6][RED_INP] = &Reg[3][RED_C];
-  m_ColorInputLUT[6][GRN_INP] = &Reg[3][GRN_C];
-  m_ColorInputLUT[6][BLU_INP] = &Reg[3][BLU_C];  // c2.rgb
-  m_ColorInputLUT[7][RED_INP] = &Reg[3][ALP_C];
-  m_ColorInputLUT[7][GRN_INP] = &Reg[3][ALP_C];
-  m_ColorInputLUT[7][BLU_INP] = &Reg[3][ALP_C];  // c2.aaa
-  m_ColorInputLUT[8][RED_INP] = &TexColor[RED_C];
-  m_ColorInputLUT[8][GRN_INP] = &TexColor[GRN_C];
-  m_ColorInputLUT[8][BLU_INP] = &TexColor[BLU_C];  // tex.rgb
-  m_ColorInputLUT[9][RED_INP] = &TexColor[ALP_C];
-  m_ColorInputLUT[9][GRN_INP] = &TexColor[ALP_C];
-  m_ColorInputLUT[9][BLU_INP] = &TexColor[ALP_C];  // tex.aaa
-  m_ColorInputLUT[10][RED_INP] = &RasColor[RED_C];
-  m_ColorInputLUT[10][GRN_INP] = &RasColor[GRN_C];
-  m_ColorInputLUT[10][BLU_INP] = &RasColor[BLU_C];  // ras.rgb
-  m_ColorInputLUT[11][RED_INP] = &RasColor[ALP_C];
-  m_ColorInputLUT[11][GRN_INP] = &RasColor[ALP_C];
-  m_ColorInputLUT[11][BLU_INP] = &RasColor[ALP_C];  // ras.rgb
-  m_ColorInputLUT[12][RED_INP] = &FixedConstants[8];
-  m_ColorInputLUT[12][GRN_INP] = &FixedConstants[8];
-  m_ColorInputLUT[12][BLU_INP] = &FixedConstants[8];  // one
-  m_ColorInputLUT[13][RED_INP] = &FixedConstants[4];
-  m_ColorInputLUT[13][GRN_INP] = &FixedConstants[4];
-  m_ColorInputLUT[13][BLU_INP] = &FixedConstants[4];  // half
-  m_ColorInputLUT[14][RED_INP] = &StageKonst[RED_C];
-  m_ColorInputLUT[14][GRN_INP] = &StageKonst[GRN_C];
-  m_ColorInputLUT[14][BLU_INP] = &StageKonst[BLU_C];  // konst
-  m_ColorInputLUT[15][RED_INP] = &FixedConstants[0];
-  m_ColorInputLUT[15][GRN_INP] = &FixedConstants[0];
-  m_ColorInputLUT[15][BLU_INP] = &FixedConstants[0];  // zero
-
-  m_AlphaInputLUT[0] = &Reg[0][ALP_C];      // prev
-  m_AlphaInputLUT[1] = &Reg[1][ALP_C];      // c0
-  m_AlphaInputLUT[2] = &Reg[2][ALP_C];      // c1
-  m_AlphaInputLUT[3] = &Reg[3][ALP_C];      // c2
-  m_AlphaInputLUT[4] = &TexColor[ALP_C];    // tex
-  m_AlphaInputLUT[5] = &RasColor[ALP_C];    // ras
-  m_AlphaInputLUT[6] = &StageKonst[ALP_C];  // konst
-  m_AlphaInputLUT[7] = &Zero16[ALP_C];      // zero
+  m_Pixels = {};
+  for (int pixel = 0; pixel < QUAD_SIZE; pixel++)
+  {
+    PixelState& state = m_Pixels[pixel];
+    auto& color_lut = m_ColorInputLUT[pixel];
+    auto& alpha_lut = m_AlphaInputLUT[pixel];
+
+    color_lut[0][RED_INP] = &state.Reg[0][RED_C];
+    color_lut[0][GRN_INP] = &state.Reg[0][GRN_C];
+    color_lut[0][BLU_INP] = &state.Reg[0][BLU_C];  // prev.rgb
+    color_lut[1][RED_INP] = &state.Reg[0][ALP_C];
+    color_lut[1][GRN_INP] = &state.Reg[0][ALP_C];
+    color_lut[1][BLU_INP] = &state.Reg[0][ALP_C];  // prev.aaa
+    color_lut[2][RED_INP] = &state.Reg[1][RED_C];
+    color_lut[2][GRN_INP] = &state.Reg[1][GRN_C];
+    color_lut[2][BLU_INP] = &state.Reg[1][BLU_C];  // c0.rgb
+    color_lut[3][RED_INP] = &state.Reg[1][ALP_C];
+    color_lut[3][GRN_INP] = &state.Reg[1][ALP_C];
+    color_lut[3][BLU_INP] = &state.Reg[1][ALP_C];  // c0.aaa
+    color_lut[4][RED_INP] = &state.Reg[2][RED_C];
+    color_lut[4][GRN_INP] = &state.Reg[2][GRN_C];
+    color_lut[4][BLU_INP] = &state.Reg[2][BLU_C];  // c1.rgb
+    color_lut[5][RED_INP] = &state.Reg[2][ALP_C];
+    color_lut[5][GRN_INP] = &state.Reg[2][ALP_C];
+    color_lut[5][BLU_INP] = &state.Reg[2][ALP_C];  // c1.aaa
+    color_lut[6][RED_INP] = &state.Reg[3][RED_C];
+    color_lut[6][GRN_INP] = &state.Reg[3][GRN_C];
+    color_lut[6][BLU_INP] = &state.Reg[3][BLU_C];  // c2.rgb
+    color_lut[7][RED_INP] = &state.Reg[3][ALP_C];
+    color_lut[7][GRN_INP] = &state.Reg[3][ALP_C];
+    color_lut[7][BLU_INP] = &state.Reg[3][ALP_C];  // c2.aaa
+    color_lut[8][RED_INP] = &state.TexColor[RED_C];
+    color_lut[8][GRN_INP] = &state.TexColor[GRN_C];
+    color_lut[8][BLU_INP] = &state.TexColor[BLU_C];  // tex.rgb
+    color_lut[9][RED_INP] = &state.TexColor[ALP_C];
+    color_lut[9][GRN_INP] = &state.TexColor[ALP_C];
+    color_lut[9][BLU_INP] = &state.TexColor[ALP_C];  // tex.aaa
+    color_lut[10][RED_INP] = &state.RasColor[RED_C];
+    color_lut[10][GRN_INP] = &state.RasColor[GRN_C];
+    color_lut[10][BLU_INP] = &state.RasColor[BLU_C];  // ras.rgb
+    color_lut[11][RED_INP] = &state.RasColor[ALP_C];
+    color_lut[11][GRN_INP] = &state.RasColor[ALP_C];
+    color_lut[11][BLU_INP] = &state.RasColor[ALP_C];  // ras.rgb
+    color_lut[12][RED_INP] = &FixedConstants[8];
+    color_lut[12][GRN_INP] = &FixedConstants[8];
+    color_lut[12][BLU_INP] = &FixedConstants[8];  // one
+    color_lut[13][RED_INP] = &FixedConstants[4];
+    color_lut[13][GRN_INP] = &FixedConstants[4];
+    color_lut[13][BLU_INP] = &FixedConstants[4];  // half
+    color_lut[14][RED_INP] = &StageKonst[RED_C];
+    color_lut[14][GRN_INP] = &StageKonst[GRN_C];
+    color_lut[14][BLU_INP] = &StageKonst[BLU_C];  // konst
+    color_lut[15][RED_INP] = &FixedConstants[0];
+    color_lut[15][GRN_INP] = &FixedConstants[0];
+    color_lut[15][BLU_INP] = &FixedConstants[0];  // zero
+
+    alpha_lut[0] = &state.Reg[0][ALP_C];    // prev
+    alpha_lut[1] = &state.Reg[1][ALP_C];    // c0
+    alpha_lut[2] = &state.Reg[2][ALP_C];    // c1
+    alpha_lut[3] = &state.Reg[3][ALP_C];    // c2
+    alpha_lut[4] = &state.TexColor[ALP_C];  // tex
+    alpha_lut[5] = &state.RasColor[ALP_C];  // ras
+    alpha_lut[6] = &StageKonst[ALP_C];      // konst
+    alpha_lut[7] = &Zero16[ALP_C];          // zero
+  }
 
   for (int comp = 0; comp < 4; comp++)
   {
@@ -146,68 +152,48 @@ void Tev::Init()
     m_KonstLUT[31][comp] = &KonstantColors[3][ALP_C];
   }
 
-  m_BiasLUT[0] = 0;
-  m_BiasLUT[1] = 128;
-  m_BiasLUT[2] = -128;
-  m_BiasLUT[3] = 0;
-
-  m_ScaleLShiftLUT[0] = 0;
-  m_ScaleLShiftLUT[1] = 1;
-  m_ScaleLShiftLUT[2] = 2;
-  m_ScaleLShiftLUT[3] = 0;
-
-  m_ScaleRShiftLUT[0] = 0;
-  m_ScaleRShiftLUT[1] = 0;
-  m_ScaleRShiftLUT[2] = 0;
-  m_ScaleRShiftLUT[3] = 1;
+  // BP registers are only 24 bits wide, so these never match a stage.
+  m_CombinerKeys.fill(~u64(0));
 }
 
-static inline s16 Clamp255(s16 in)
+void Tev::SetRasColor(int pixel, int colorChan, int swaptable)
 {
-  return in > 255 ? 255 : (in < 0 ? 0 : in);
-}
+  PixelState& state = m_Pixels[pixel];
 
-static inline s16 Clamp1024(s16 in)
-{
-  return in > 1023 ? 1023 : (in < -1024 ? -1024 : in);
-}
-
-void Tev::SetRasColor(int colorChan, int swaptable)
-{
   switch (colorChan)
   {
   case 0:  // Color0
   {
-    const u8* color = Color[0];
-    RasColor[RED_C] = color[bpmem.tevksel[swaptable].swap1];
-    RasColor[GRN_C] = color[bpmem.tevksel[swaptable].swap2];
+    const u8* color = Color[pixel][0];
+    state.RasColor[RED_C] = color[bpmem.tevksel[swaptable].swap1];
+    state.RasColor[GRN_C] = color[bpmem.tevksel[swaptable].swap2];
     swaptable++;
-    RasColor[BLU_C] = color[bpmem.tevksel[swaptable].swap1];
-    RasColor[ALP_C] = color[bpmem.tevksel[swaptable].swap2];
+    state.RasColor[BLU_C] = color[bpmem.tevksel[swaptable].swap1];
+    state.RasColor[ALP_C] = color[bpmem.tevksel[swaptable].swap2];
   }
   break;
   case 1:  // Color1
   {
-    const u8* color = Color[1];
-    RasColor[RED_C] = color[bpmem.tevksel[swaptable].swap1];
-    RasColor[GRN_C] = color[bpmem.tevksel[swaptable].swap2];
+    const u8* color = Color[pixel][1];
+    state.RasColor[RED_C] = color[bpmem.tevksel[swaptable].swap1];
+    state.RasColor[GRN_C] = color[bpmem.tevksel[swaptable].swap2];
     swaptable++;
-    RasColor[BLU_C] = color[bpmem.tevksel[swaptable].swap1];
-    RasColor[ALP_C] = color[bpmem.tevksel[swaptable].swap2];
+    state.RasColor[BLU_C] = color[bpmem.tevksel[swaptable].swap1];
+    state.RasColor[ALP_C] = color[bpmem.tevksel[swaptable].swap2];
   }
   break;
   case 5:  // alpha bump
   {
-    for (s16& comp : RasColor)
+    for (s16& comp : state.RasColor)
     {
-      comp = AlphaBump;
+      comp = state.AlphaBump;
     }
   }
   break;
   case 6:  // alpha bump normalized
   {
-    const u8 normalized = AlphaBump | AlphaBump >> 5;
-    for (s16& comp : RasColor)
+    const u8 normalized = state.AlphaBump | state.AlphaBump >> 5;
+    for (s16& comp : state.RasColor)
     {
       comp = normalized;
     }
@@ -215,7 +201,7 @@ void Tev::SetRasColor(int colorChan, int swaptable)
   break;
   default:  // zero
   {
-    for (s16& comp : RasColor)
+    for (s16& comp : state.RasColor)
     {
       comp = 0;
     }
@@ -224,155 +210,118 @@ void Tev::SetRasColor(int colorChan, int swaptable)
   }
 }
 
-void Tev::DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4])
-{
-  for (int i = 0; i < 3; i++)
-  {
-    const InputRegType& InputReg = inputs[BLU_C + i];
-
-    const u16 c = InputReg.c + (InputReg.c >> 7);
-
-    s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
-    temp <<= m_ScaleLShiftLUT[cc.shift];
-    temp += (cc.shift == 3) ? 0 : (cc.op == 1) ? 127 : 128;
-    temp >>= 8;
-    temp = cc.op ? -temp : temp;
-
-    s32 result = ((InputReg.d + m_BiasLUT[cc.bias]) << m_ScaleLShiftLUT[cc.shift]) + temp;
-    result = result >> m_ScaleRShiftLUT[cc.shift];
-
-    Reg[cc.dest][BLU_C + i] = result;
-  }
-}
-
-void Tev::DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4])
+void Tev::DrawColorCompare(int pixel, const TevStageCombiner::ColorCombiner& cc,
+                           const TevCombiner::Inputs& inputs)
 {
+  s16* const dest = m_Pixels[pixel].Reg[cc.dest];
   for (int i = BLU_C; i <= RED_C; i++)
   {
     switch ((cc.shift << 1) | cc.op | 8)  // encoded compare mode
     {
     case TEVCMP_R8_GT:
-      Reg[cc.dest][i] = inputs[i].d + ((inputs[RED_C].a > inputs[RED_C].b) ? inputs[i].c : 0);
+      dest[i] = inputs.d[i] + ((inputs.a[RED_C] > inputs.b[RED_C]) ? inputs.c[i] : 0);
       break;
 
     case TEVCMP_R8_EQ:
-      Reg[cc.dest][i] = inputs[i].d + ((inputs[RED_C].a == inputs[RED_C].b) ? inputs[i].c : 0);
+      dest[i] = inputs.d[i] + ((inputs.a[RED_C] == inputs.b[RED_C]) ? inputs.c[i] : 0);
       break;
 
     case TEVCMP_GR16_GT:
     {
-      const u32 a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-      const u32 b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-      Reg[cc.dest][i] = inputs[i].d + ((a > b) ? inputs[i].c : 0);
+      const u32 a = (inputs.a[GRN_C] << 8) | inputs.a[RED_C];
+      const u32 b = (inputs.b[GRN_C] << 8) | inputs.b[RED_C];
+      dest[i] = inputs.d[i] + ((a > b) ? inputs.c[i] : 0);
     }
     break;
 
     case TEVCMP_GR16_EQ:
     {
-      const u32 a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-      const u32 b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-      Reg[cc.dest][i] = inputs[i].d + ((a == b) ? inputs[i].c : 0);
+      const u32 a = (inputs.a[GRN_C] << 8) | inputs.a[RED_C];
+      const u32 b = (inputs.b[GRN_C] << 8) | inputs.b[RED_C];
+      dest[i] = inputs.d[i] + ((a == b) ? inputs.c[i] : 0);
     }
     break;
 
     case TEVCMP_BGR24_GT:
     {
-      const u32 a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-      const u32 b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-      Reg[cc.dest][i] = inputs[i].d + ((a > b) ? inputs[i].c : 0);
+      const u32 a = (inputs.a[BLU_C] << 16) | (inputs.a[GRN_C] << 8) | inputs.a[RED_C];
+      const u32 b = (inputs.b[BLU_C] << 16) | (inputs.b[GRN_C] << 8) | inputs.b[RED_C];
+      dest[i] = inputs.d[i] + ((a > b) ? inputs.c[i] : 0);
     }
     break;
 
     case TEVCMP_BGR24_EQ:
     {
-      const u32 a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-      const u32 b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-      Reg[cc.dest][i] = inputs[i].d + ((a == b) ? inputs[i].c : 0);
+      const u32 a = (inputs.a[BLU_C] << 16) | (inputs.a[GRN_C] << 8) | inputs.a[RED_C];
+      const u32 b = (inputs.b[BLU_C] << 16) | (inputs.b[GRN_C] << 8) | inputs.b[RED_C];
+      dest[i] = inputs.d[i] + ((a == b) ? inputs.c[i] : 0);
     }
     break;
 
     case TEVCMP_RGB8_GT:
-      Reg[cc.dest][i] = inputs[i].d + ((inputs[i].a > inputs[i].b) ? inputs[i].c : 0);
+      dest[i] = inputs.d[i] + ((inputs.a[i] > inputs.b[i]) ? inputs.c[i] : 0);
       break;
 
     case TEVCMP_RGB8_EQ:
-      Reg[cc.dest][i] = inputs[i].d + ((inputs[i].a == inputs[i].b) ? inputs[i].c : 0);
+      dest[i] = inputs.d[i] + ((inputs.a[i] == inputs.b[i]) ? inputs.c[i] : 0);
       break;
     }
   }
 }
 
-void Tev::DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
+void Tev::DrawAlphaCompare(int pixel, const TevStageCombiner::AlphaCombiner& ac,
+                           const TevCombiner::Inputs& inputs)
 {
-  const InputRegType& InputReg = inputs[ALP_C];
+  s16& dest = m_Pixels[pixel].Reg[ac.dest][ALP_C];
 
-  const u16 c = InputReg.c + (InputReg.c >> 7);
-
-  s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
-  temp <<= m_ScaleLShiftLUT[ac.shift];
-  temp += (ac.shift != 3) ? 0 : (ac.op == 1) ? 127 : 128;
-  temp = ac.op ? (-temp >> 8) : (temp >> 8);
-
-  s32 result = ((InputReg.d + m_BiasLUT[ac.bias]) << m_ScaleLShiftLUT[ac.shift]) + temp;
-  result = result >> m_ScaleRShiftLUT[ac.shift];
-
-  Reg[ac.dest][ALP_C] = result;
-}
-
-void Tev::DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
-{
   switch ((ac.shift << 1) | ac.op | 8)  // encoded compare mode
   {
   case TEVCMP_R8_GT:
-    Reg[ac.dest][ALP_C] =
-        inputs[ALP_C].d + ((inputs[RED_C].a > inputs[RED_C].b) ? inputs[ALP_C].c : 0);
+    dest = inputs.d[ALP_C] + ((inputs.a[RED_C] > inputs.b[RED_C]) ? inputs.c[ALP_C] : 0);
     break;
 
   case TEVCMP_R8_EQ:
-    Reg[ac.dest][ALP_C] =
-        inputs[ALP_C].d + ((inputs[RED_C].a == inputs[RED_C].b) ? inputs[ALP_C].c : 0);
+    dest = inputs.d[ALP_C] + ((inputs.a[RED_C] == inputs.b[RED_C]) ? inputs.c[ALP_C] : 0);
     break;
 
   case TEVCMP_GR16_GT:
   {
-    const u32 a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-    const u32 b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-    Reg[ac.dest][ALP_C] = inputs[ALP_C].d + ((a > b) ? inputs[ALP_C].c : 0);
+    const u32 a = (inputs.a[GRN_C] << 8) | inputs.a[RED_C];
+    const u32 b = (inputs.b[GRN_C] << 8) | inputs.b[RED_C];
+    dest = inputs.d[ALP_C] + ((a > b) ? inputs.c[ALP_C] : 0);
   }
   break;
 
   case TEVCMP_GR16_EQ:
   {
-    const u32 a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-    const u32 b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-    Reg[ac.dest][ALP_C] = inputs[ALP_C].d + ((a == b) ? inputs[ALP_C].c : 0);
+    const u32 a = (inputs.a[GRN_C] << 8) | inputs.a[RED_C];
+    const u32 b = (inputs.b[GRN_C] << 8) | inputs.b[RED_C];
+    dest = inputs.d[ALP_C] + ((a == b) ? inputs.c[ALP_C] : 0);
   }
   break;
 
   case TEVCMP_BGR24_GT:
   {
-    const u32 a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-    const u32 b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-    Reg[ac.dest][ALP_C] = inputs[ALP_C].d + ((a > b) ? inputs[ALP_C].c : 0);
+    const u32 a = (inputs.a[BLU_C] << 16) | (inputs.a[GRN_C] << 8) | inputs.a[RED_C];
+    const u32 b = (inputs.b[BLU_C] << 16) | (inputs.b[GRN_C] << 8) | inputs.b[RED_C];
+    dest = inputs.d[ALP_C] + ((a > b) ? inputs.c[ALP_C] : 0);
   }
   break;
 
   case TEVCMP_BGR24_EQ:
   {
-    const u32 a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-    const u32 b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-    Reg[ac.dest][ALP_C] = inputs[ALP_C].d + ((a == b) ? inputs[ALP_C].c : 0);
+    const u32 a = (inputs.a[BLU_C] << 16) | (inputs.a[GRN_C] << 8) | inputs.a[RED_C];
+    const u32 b = (inputs.b[BLU_C] << 16) | (inputs.b[GRN_C] << 8) | inputs.b[RED_C];
+    dest = inputs.d[ALP_C] + ((a == b) ? inputs.c[ALP_C] : 0);
   }
   break;
 
   case TEVCMP_A8_GT:
-    Reg[ac.dest][ALP_C] =
-        inputs[ALP_C].d + ((inputs[ALP_C].a > inputs[ALP_C].b) ? inputs[ALP_C].c : 0);
+    dest = inputs.d[ALP_C] + ((inputs.a[ALP_C] > inputs.b[ALP_C]) ? inputs.c[ALP_C] : 0);
     break;
 
   case TEVCMP_A8_EQ:
-    Reg[ac.dest][ALP_C] =
-        inputs[ALP_C].d + ((inputs[ALP_C].a == inputs[ALP_C].b) ? inputs[ALP_C].c : 0);
+    dest = inputs.d[ALP_C] + ((inputs.a[ALP_C] == inputs.b[ALP_C]) ? inputs.c[ALP_C] : 0);
     break;
   }
 }
@@ -445,10 +394,11 @@ static inline s32 WrapIndirectCoord(s32 coord, int wrapMode)
   }
 }
 
-void Tev::Indirect(unsigned int stageNum, s32 s, s32 t)
+void Tev::Indirect(int pixel, unsigned int stageNum, s32 s, s32 t)
 {
+  PixelState& state = m_Pixels[pixel];
   const TevStageIndirect& indirect = bpmem.tevind[stageNum];
-  const u8* indmap = IndirectTex[indirect.bt];
+  const u8* indmap = state.IndirectTex[indirect.bt];
 
   s32 indcoord[3];
 
@@ -456,16 +406,16 @@ void Tev::Indirect(unsigned int stageNum, s32 s, s32 t)
   switch (indirect.bs)
   {
   case ITBA_OFF:
-    AlphaBump = 0;
+    state.AlphaBump = 0;
     break;
   case ITBA_S:
-    AlphaBump = indmap[TextureSampler::ALP_SMP];
+    state.AlphaBump = indmap[TextureSampler::ALP_SMP];
     break;
   case ITBA_T:
-    AlphaBump = indmap[TextureSampler::BLU_SMP];
+    state.AlphaBump = indmap[TextureSampler::BLU_SMP];
     break;
   case ITBA_U:
-    AlphaBump = indmap[TextureSampler::GRN_SMP];
+    state.AlphaBump = indmap[TextureSampler::GRN_SMP];
     break;
   }
 
@@ -483,25 +433,25 @@ void Tev::Indirect(unsigned int stageNum, s32 s, s32 t)
     indcoord[0] = indmap[TextureSampler::ALP_SMP] + bias[0];
     indcoord[1] = indmap[TextureSampler::BLU_SMP] + bias[1];
     indcoord[2] = indmap[TextureSampler::GRN_SMP] + bias[2];
-    AlphaBump = AlphaBump & 0xf8;
+    state.AlphaBump = state.AlphaBump & 0xf8;
     break;
   case ITF_5:
     indcoord[0] = (indmap[TextureSampler::ALP_SMP] & 0x1f) + bias[0];
     indcoord[1] = (indmap[TextureSampler::BLU_SMP] & 0x1f) + bias[1];
     indcoord[2] = (indmap[TextureSampler::GRN_SMP] & 0x1f) + bias[2];
-    AlphaBump = AlphaBump & 0xe0;
+    state.AlphaBump = state.AlphaBump & 0xe0;
     break;
   case ITF_4:
     indcoord[0] = (indmap[TextureSampler::ALP_SMP] & 0x0f) + bias[0];
     indcoord[1] = (indmap[TextureSampler::BLU_SMP] & 0x0f) + bias[1];
     indcoord[2] = (indmap[TextureSampler::GRN_SMP] & 0x0f) + bias[2];
-    AlphaBump = AlphaBump & 0xf0;
+    state.AlphaBump = state.AlphaBump & 0xf0;
     break;
   case ITF_3:
     indcoord[0] = (indmap[TextureSampler::ALP_SMP] & 0x07) + bias[0];
     indcoord[1] = (indmap[TextureSampler::BLU_SMP] & 0x07) + bias[1];
     indcoord[2] = (indmap[TextureSampler::GRN_SMP] & 0x07) + bias[2];
-    AlphaBump = AlphaBump & 0xf8;
+    state.AlphaBump = state.AlphaBump & 0xf8;
     break;
   default:
     PanicAlert("Tev::Indirect");
@@ -555,31 +505,56 @@ void Tev::Indirect(unsigned int stageNum, s32 s, s32 t)
 
   if (indirect.fb_addprev)
   {
-    TexCoord.s += (int)(WrapIndirectCoord(s, indirect.sw) + indtevtrans[0]);
-    TexCoord.t += (int)(WrapIndirectCoord(t, indirect.tw) + indtevtrans[1]);
+    state.TexCoord.s += (int)(WrapIndirectCoord(s, indirect.sw) + indtevtrans[0]);
+    state.TexCoord.t += (int)(WrapIndirectCoord(t, indirect.tw) + indtevtrans[1]);
   }
   else
   {
-    TexCoord.s = (int)(WrapIndirectCoord(s, indirect.sw) + indtevtrans[0]);
-    TexCoord.t = (int)(WrapIndirectCoord(t, indirect.tw) + indtevtrans[1]);
+    state.TexCoord.s = (int)(WrapIndirectCoord(s, indirect.sw) + indtevtrans[0]);
+    state.TexCoord.t = (int)(WrapIndirectCoord(t, indirect.tw) + indtevtrans[1]);
   }
 }
 
-void Tev::Draw()
+void Tev::Draw(u32 pixel_mask)
 {
-  ASSERT(Position[0] >= 0 && Position[0] < s32(EFB_WIDTH));
-  ASSERT(Position[1] >= 0 && Position[1] < s32(EFB_HEIGHT));
-
-  INCSTAT(g_stats.this_frame.tev_pixels_in);
-
-  // initial color values
-  for (int i = 0; i < 4; i++)
+#if ALLOW_TEV_DUMPS
+  // The dumps go through one buffer for each stage, so they need the pixels one at a time.
+  if ((g_ActiveConfig.bDumpTevStages || g_ActiveConfig.bDumpTevTextureFetches) &&
+      (pixel_mask & (pixel_mask - 1)) != 0)
   {
-    Reg[i][RED_C] = PixelShaderManager::constants.colors[i][0];
-    Reg[i][GRN_C] = PixelShaderManager::constants.colors[i][1];
-    Reg[i][BLU_C] = PixelShaderManager::constants.colors[i][2];
-    Reg[i][ALP_C] = PixelShaderManager::constants.colors[i][3];
+    for (int pixel = 0; pixel < QUAD_SIZE; pixel++)
+    {
+      if (pixel_mask & (1u << pixel))
+        Draw(1u << pixel);
+    }
+    return;
   }
+#endif
+
+  const auto for_each_pixel = [pixel_mask](const auto& function) {
+    for (int pixel = 0; pixel < QUAD_SIZE; pixel++)
+    {
+      if (pixel_mask & (1u << pixel))
+        function(pixel);
+    }
+  };
+
+  for_each_pixel([&](int pixel) {
+    ASSERT(Position[pixel][0] >= 0 && Position[pixel][0] < s32(EFB_WIDTH));
+    ASSERT(Position[pixel][1] >= 0 && Position[pixel][1] < s32(EFB_HEIGHT));
+
+    Counters.tev_pixels_in++;
+
+    // initial color values
+    PixelState& state = m_Pixels[pixel];
+    for (int i = 0; i < 4; i++)
+    {
+      state.Reg[i][RED_C] = PixelShaderManager::constants.colors[i][0];
+      state.Reg[i][GRN_C] = PixelShaderManager::constants.colors[i][1];
+      state.Reg[i][BLU_C] = PixelShaderManager::constants.colors[i][2];
+      state.Reg[i][ALP_C] = PixelShaderManager::constants.colors[i][3];
+    }
+  });
 
   for (unsigned int stageNum = 0; stageNum < bpmem.genMode.numindstages; stageNum++)
   {
@@ -593,21 +568,26 @@ void Tev::Draw()
     const s32 scaleS = stageOdd ? texscale.ss1 : texscale.ss0;
     const s32 scaleT = stageOdd ? texscale.ts1 : texscale.ts0;
 
-    TextureSampler::Sample(Uv[texcoordSel].s >> scaleS, Uv[texcoordSel].t >> scaleT,
-                           IndirectLod[stageNum], IndirectLinear[stageNum], texmap,
-                           IndirectTex[stageNum]);
+    for_each_pixel([&](int pixel) {
+      const TextureCoordinateType& uv = Uv[pixel][texcoordSel];
+      u8* const indirectTex = m_Pixels[pixel].IndirectTex[stageNum];
+      TextureSampler::Sample(uv.s >> scaleS, uv.t >> scaleT, IndirectLod[stageNum],
+                             IndirectLinear[stageNum], texmap, indirectTex);
 
 #if ALLOW_TEV_DUMPS
-    if (g_ActiveConfig.bDumpTevStages)
-    {
-      u8 stage[4] = {IndirectTex[stageNum][TextureSampler::ALP_SMP],
-                     IndirectTex[stageNum][TextureSampler::BLU_SMP],
-                     IndirectTex[stageNum][TextureSampler::GRN_SMP], 255};
-      DebugUtil::DrawTempBuffer(stage, INDIRECT + stageNum);
-    }
+      if (g_ActiveConfig.bDumpTevStages)
+      {
+        u8 stage[4] = {indirectTex[TextureSampler::ALP_SMP], indirectTex[TextureSampler::BLU_SMP],
+                       indirectTex[TextureSampler::GRN_SMP], 255};
+        DebugUtil::DrawTempBuffer(stage, INDIRECT + stageNum);
+      }
 #endif
+    });
   }
 
+  // The combiners also run on the lanes of the pixels outside the mask, which stay zero.
+  TevCombiner::QuadInputs inputs{};
+
   for (unsigned int stageNum = 0; stageNum <= bpmem.genMode.numtevstages; stageNum++)
   {
     const int stageNum2 = stageNum >> 1;
@@ -622,31 +602,6 @@ void Tev::Draw()
     const int texcoordSel = order.getTexCoord(stageOdd);
     const int texmap = order.getTexMap(stageOdd);
 
-    Indirect(stageNum, Uv[texcoordSel].s, Uv[texcoordSel].t);
-
-    // sample texture
-    if (order.getEnable(stageOdd))
-    {
-      // RGBA
-      u8 texel[4];
-
-      TextureSampler::Sample(TexCoord.s, TexCoord.t, TextureLod[stageNum], TextureLinear[stageNum],
-                             texmap, texel);
-
-#if ALLOW_TEV_DUMPS
-      if (g_ActiveConfig.bDumpTevTextureFetches)
-        DebugUtil::DrawTempBuffer(texel, DIRECT_TFETCH + stageNum);
-#endif
-
-      int swaptable = ac.tswap * 2;
-
-      TexColor[RED_C] = texel[bpmem.tevksel[swaptable].swap1];
-      TexColor[GRN_C] = texel[bpmem.tevksel[swaptable].swap2];
-      swaptable++;
-      TexColor[BLU_C] = texel[bpmem.tevksel[swaptable].swap1];
-      TexColor[ALP_C] = texel[bpmem.tevksel[swaptable].swap2];
-    }
-
     // set konst for this stage
     const int kc = kSel.getKC(stageOdd);
     const int ka = kSel.getKA(stageOdd);
@@ -655,67 +610,141 @@ void Tev::Draw()
     StageKonst[BLU_C] = *(m_KonstLUT[kc][BLU_C]);
     StageKonst[ALP_C] = *(m_KonstLUT[ka][ALP_C]);
 
-    // set color
-    SetRasColor(order.getColorChan(stageOdd), ac.rswap * 2);
+    for_each_pixel([&](int pixel) {
+      PixelState& state = m_Pixels[pixel];
 
-    // combine inputs
-    InputRegType inputs[4];
-    for (int i = 0; i < 3; i++)
-    {
-      inputs[BLU_C + i].a = *m_ColorInputLUT[cc.a][i];
-      inputs[BLU_C + i].b = *m_ColorInputLUT[cc.b][i];
-      inputs[BLU_C + i].c = *m_ColorInputLUT[cc.c][i];
-      inputs[BLU_C + i].d = *m_ColorInputLUT[cc.d][i];
-    }
-    inputs[ALP_C].a = *m_AlphaInputLUT[ac.a];
-    inputs[ALP_C].b = *m_AlphaInputLUT[ac.b];
-    inputs[ALP_C].c = *m_AlphaInputLUT[ac.c];
-    inputs[ALP_C].d = *m_AlphaInputLUT[ac.d];
+      Indirect(pixel, stageNum, Uv[pixel][texcoordSel].s, Uv[pixel][texcoordSel].t);
 
-    if (cc.bias != 3)
-      DrawColorRegular(cc, inputs);
-    else
-      DrawColorCompare(cc, inputs);
+      // sample texture
+      if (order.getEnable(stageOdd))
+      {
+        // RGBA
+        u8 texel[4];
+
+        TextureSampler::Sample(state.TexCoord.s, state.TexCoord.t, TextureLod[stageNum],
+                               TextureLinear[stageNum], texmap, texel);
 
-    if (cc.clamp)
+#if ALLOW_TEV_DUMPS
+        if (g_ActiveConfig.bDumpTevTextureFetches)
+          DebugUtil::DrawTempBuffer(texel, DIRECT_TFETCH + stageNum);
+#endif
+
+        int swaptable = ac.tswap * 2;
+
+        state.TexColor[RED_C] = texel[bpmem.tevksel[swaptable].swap1];
+        state.TexColor[GRN_C] = texel[bpmem.tevksel[swaptable].swap2];
+        swaptable++;
+        state.TexColor[BLU_C] = texel[bpmem.tevksel[swaptable].swap1];
+        state.TexColor[ALP_C] = texel[bpmem.tevksel[swaptable].swap2];
+      }
+
+      // set color
+      SetRasColor(pixel, order.getColorChan(stageOdd), ac.rswap * 2);
+
+      // combine inputs, truncated to the width of the hardware inputs
+      const auto truncate_abc = [](s16 value) -> s16 { return value & 0xff; };
+      const auto truncate_d = [](s16 value) -> s16 { return static_cast<s16>(value << 5) >> 5; };
+      const auto& colorInputs = m_ColorInputLUT[pixel];
+      const auto& alphaInputs = m_AlphaInputLUT[pixel];
+      for (int i = 0; i < 3; i++)
+      {
+        inputs.a[pixel][BLU_C + i] = truncate_abc(*colorInputs[cc.a][i]);
+        inputs.b[pixel][BLU_C + i] = truncate_abc(*colorInputs[cc.b][i]);
+        inputs.c[pixel][BLU_C + i] = truncate_abc(*colorInputs[cc.c][i]);
+        inputs.d[pixel][BLU_C + i] = truncate_d(*colorInputs[cc.d][i]);
+      }
+      inputs.a[pixel][ALP_C] = truncate_abc(*alphaInputs[ac.a]);
+      inputs.b[pixel][ALP_C] = truncate_abc(*alphaInputs[ac.b]);
+      inputs.c[pixel][ALP_C] = truncate_abc(*alphaInputs[ac.c]);
+      inputs.d[pixel][ALP_C] = truncate_d(*alphaInputs[ac.d]);
+    });
+
+    if (cc.bias != 3 || ac.bias != 3)
     {
-      Reg[cc.dest][RED_C] = Clamp255(Reg[cc.dest][RED_C]);
-      Reg[cc.dest][GRN_C] = Clamp255(Reg[cc.dest][GRN_C]);
-      Reg[cc.dest][BLU_C] = Clamp255(Reg[cc.dest][BLU_C]);
+      const u64 key = (u64(cc.hex) << 32) | ac.hex;
+      if (m_CombinerKeys[stageNum] != key)
+      {
+        m_CombinerParams[stageNum] = TevCombiner::Params(cc, ac);
+        m_CombinerKeys[stageNum] = key;
+      }
+
+      const TevCombiner::QuadComponents result =
+          TevCombiner::CombineRegular(m_CombinerParams[stageNum], inputs);
+      for_each_pixel([&](int pixel) {
+        PixelState& state = m_Pixels[pixel];
+        if (cc.bias != 3)
+        {
+          state.Reg[cc.dest][RED_C] = result[pixel][RED_C];
+          state.Reg[cc.dest][GRN_C] = result[pixel][GRN_C];
+          state.Reg[cc.dest][BLU_C] = result[pixel][BLU_C];
+        }
+        if (ac.bias != 3)
+          state.Reg[ac.dest][ALP_C] = result[pixel][ALP_C];
+      });
     }
-    else
+
+    if (cc.bias == 3)
     {
-      Reg[cc.dest][RED_C] = Clamp1024(Reg[cc.dest][RED_C]);
-      Reg[cc.dest][GRN_C] = Clamp1024(Reg[cc.dest][GRN_C]);
-      Reg[cc.dest][BLU_C] = Clamp1024(Reg[cc.dest][BLU_C]);
+      for_each_pixel([&](int pixel) {
+        DrawColorCompare(pixel, cc,
+                         {inputs.a[pixel], inputs.b[pixel], inputs.c[pixel], inputs.d[pixel]});
+
+        s16* const dest = m_Pixels[pixel].Reg[cc.dest];
+        if (cc.clamp)
+        {
+          dest[RED_C] = TevCombiner::Clamp255(dest[RED_C]);
+          dest[GRN_C] = TevCombiner::Clamp255(dest[GRN_C]);
+          dest[BLU_C] = TevCombiner::Clamp255(dest[BLU_C]);
+        }
+        else
+        {
+          dest[RED_C] = TevCombiner::Clamp1024(dest[RED_C]);
+          dest[GRN_C] = TevCombiner::Clamp1024(dest[GRN_C]);
+          dest[BLU_C] = TevCombiner::Clamp1024(dest[BLU_C]);
+        }
+      });
     }
 
-    if (ac.bias != 3)
-      DrawAlphaRegular(ac, inputs);
-    else
-      DrawAlphaCompare(ac, inputs);
-
-    if (ac.clamp)
-      Reg[ac.dest][ALP_C] = Clamp255(Reg[ac.dest][ALP_C]);
-    else
-      Reg[ac.dest][ALP_C] = Clamp1024(Reg[ac.dest][ALP_C]);
+    if (ac.bias == 3)
+    {
+      for_each_pixel([&](int pixel) {
+        DrawAlphaCompare(pixel, ac,
+                         {inputs.a[pixel], inputs.b[pixel], inputs.c[pixel], inputs.d[pixel]});
+
+        s16& dest = m_Pixels[pixel].Reg[ac.dest][ALP_C];
+        if (ac.clamp)
+          dest = TevCombiner::Clamp255(dest);
+        else
+          dest = TevCombiner::Clamp1024(dest);
+      });
+    }
 
 #if ALLOW_TEV_DUMPS
     if (g_ActiveConfig.bDumpTevStages)
     {
-      u8 stage[4] = {(u8)Reg[0][RED_C], (u8)Reg[0][GRN_C], (u8)Reg[0][BLU_C], (u8)Reg[0][ALP_C]};
-      DebugUtil::DrawTempBuffer(stage, DIRECT + stageNum);
+      for_each_pixel([&](int pixel) {
+        const s16* prev = m_Pixels[pixel].Reg[0];
+        u8 stage[4] = {(u8)prev[RED_C], (u8)prev[GRN_C], (u8)prev[BLU_C], (u8)prev[ALP_C]};
+        DebugUtil::DrawTempBuffer(stage, DIRECT + stageNum);
+      });
     }
 #endif
   }
 
+  for_each_pixel([this](int pixel) { DrawOutput(pixel); });
+}
+
+void Tev::DrawOutput(int pixel)
+{
+  const PixelState& state = m_Pixels[pixel];
+
   // convert to 8 bits per component
   // the results of the last tev stage are put onto the screen,
   // regardless of the used destination register - TODO: Verify!
   const u32 color_index = bpmem.combiners[bpmem.genMode.numtevstages].colorC.dest;
   const u32 alpha_index = bpmem.combiners[bpmem.genMode.numtevstages].alphaC.dest;
-  u8 output[4] = {(u8)Reg[alpha_index][ALP_C], (u8)Reg[color_index][BLU_C],
-                  (u8)Reg[color_index][GRN_C], (u8)Reg[color_index][RED_C]};
+  u8 output[4] = {(u8)state.Reg[alpha_index][ALP_C], (u8)state.Reg[color_index][BLU_C],
+                  (u8)state.Reg[color_index][GRN_C], (u8)state.Reg[color_index][RED_C]};
 
   if (!TevAlphaTest(output[ALP_C]))
     return;
@@ -727,20 +756,20 @@ void Tev::Draw()
     switch (bpmem.ztex2.type)
     {
     case 0:  // 8 bit
-      ztex += TexColor[ALP_C];
+      ztex += state.TexColor[ALP_C];
       break;
     case 1:  // 16 bit
-      ztex += TexColor[ALP_C] << 8 | TexColor[RED_C];
+      ztex += state.TexColor[ALP_C] << 8 | state.TexColor[RED_C];
       break;
     case 2:  // 24 bit
-      ztex += TexColor[RED_C] << 16 | TexColor[GRN_C] << 8 | TexColor[BLU_C];
+      ztex += state.TexColor[RED_C] << 16 | state.TexColor[GRN_C] << 8 | state.TexColor[BLU_C];
       break;
     }
 
     if (bpmem.ztex2.op == ZTEXTURE_ADD)
-      ztex += Position[2];
+      ztex += Position[pixel][2];
 
-    Position[2] = ztex & 0x00ffffff;
+    Position[pixel][2] = ztex & 0x00ffffff;
   }
 
   // fog
@@ -752,7 +781,7 @@ void Tev::Draw()
     {
       // perspective
       // ze = A/(B - (Zs >> B_SHF))
-      const s32 denom = bpmem.fog.b_magnitude - (Position[2] >> bpmem.fog.b_shift);
+      const s32 denom = bpmem.fog.b_magnitude - (Position[pixel][2] >> bpmem.fog.b_shift);
       // in addition downscale magnitude and zs to 0.24 bits
       ze = (bpmem.fog.GetA() * 16777215.0f) / static_cast<float>(denom);
     }
@@ -761,7 +790,7 @@ void Tev::Draw()
       // orthographic
       // ze = a*Zs
       // in addition downscale zs to 0.24 bits
-      ze = bpmem.fog.GetA() * (static_cast<float>(Position[2]) / 16777215.0f);
+      ze = bpmem.fog.GetA() * (static_cast<float>(Position[pixel][2]) / 16777215.0f);
     }
 
     if (bpmem.fogRange.Base.Enabled)
@@ -773,7 +802,7 @@ void Tev::Draw()
 
       // First, calculate the offset from the viewport center (normalized to 0..1)
       const float offset =
-          (Position[0] - (static_cast<s32>(bpmem.fogRange.Base.Center.Value()) - 342)) /
+          (Position[pixel][0] - (static_cast<s32>(bpmem.fogRange.Base.Center.Value()) - 342)) /
           static_cast<float>(xfmem.viewport.wd);
 
       // Based on that, choose the index such that points which are far away from the z-axis use the
@@ -833,24 +862,24 @@ void Tev::Draw()
   if (late_ztest && bpmem.zmode.testenable)
   {
     // TODO: Check against hw if these values get incremented even if depth testing is disabled
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT);
+    Counters.IncPerfCounter(PQ_ZCOMP_INPUT);
 
-    if (!EfbInterface::ZCompare(Position[0], Position[1], Position[2]))
+    if (!EfbInterface::ZCompare(Position[pixel][0], Position[pixel][1], Position[pixel][2]))
       return;
 
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT);
+    Counters.IncPerfCounter(PQ_ZCOMP_OUTPUT);
   }
 
-  BoundingBox::Update(static_cast<u16>(Position[0]), static_cast<u16>(Position[0]),
-                      static_cast<u16>(Position[1]), static_cast<u16>(Position[1]));
+  Counters.UpdateBoundingBox(static_cast<u16>(Position[pixel][0]),
+                             static_cast<u16>(Position[pixel][1]));
 
 #if ALLOW_TEV_DUMPS
   if (g_ActiveConfig.bDumpTevStages)
   {
     for (u32 i = 0; i < bpmem.genMode.numindstages; ++i)
-      DebugUtil::CopyTempBuffer(Position[0], Position[1], INDIRECT, i, "Indirect");
+      DebugUtil::CopyTempBuffer(Position[pixel][0], Position[pixel][1], INDIRECT, i, "Indirect");
     for (u32 i = 0; i <= bpmem.genMode.numtevstages; ++i)
-      DebugUtil::CopyTempBuffer(Position[0], Position[1], DIRECT, i, "Stage");
+      DebugUtil::CopyTempBuffer(Position[pixel][0], Position[pixel][1], DIRECT, i, "Stage");
   }
 
   if (g_ActiveConfig.bDumpTevTextureFetches)
@@ -859,15 +888,18 @@ void Tev::Draw()
     {
       TwoTevStageOrders& order = bpmem.tevorders[i >> 1];
       if (order.getEnable(i & 1))
-        DebugUtil::CopyTempBuffer(Position[0], Position[1], DIRECT_TFETCH, i, "TFetch");
+      {
+        DebugUtil::CopyTempBuffer(Position[pixel][0], Position[pixel][1], DIRECT_TFETCH, i,
+                                  "TFetch");
+      }
     }
   }
 #endif
 
-  INCSTAT(g_stats.this_frame.tev_pixels_out);
-  EfbInterface::IncPerfCounterQuadCount(PQ_BLEND_INPUT);
+  Counters.tev_pixels_out++;
+  Counters.IncPerfCounter(PQ_BLEND_INPUT);
 
-  EfbInterface::BlendTev(Position[0], Position[1], output);
+  EfbInterface::BlendTev(Position[pixel][0], Position[pixel][1], output);
 }
 
 void Tev::SetRegColor(int reg, int comp, s16 color)
@@ -4,43 +4,54 @@
 
 #pragma once
 
+#include <array>
+
+#include "VideoBackends/Software/EfbInterface.h"
+#include "VideoBackends/Software/TevCombiner.h"
 #include "VideoCommon/BPMemory.h"
 
 class Tev
 {
-  struct InputRegType
-  {
-    unsigned a : 8;
-    unsigned b : 8;
-    unsigned c : 8;
-    signed d : 11;
-  };
+public:
+  // The pixels of a 2x2 block are shaded together.
+  static constexpr int QUAD_SIZE = TevCombiner::QUAD_SIZE;
 
+private:
   struct TextureCoordinateType
   {
     signed s : 24;
     signed t : 24;
   };
 
-  // color order: ABGR
-  s16 Reg[4][4];
+  // The state of each pixel in the quad.
+  struct PixelState
+  {
+    // color order: ABGR
+    s16 Reg[4][4];
+    s16 TexColor[4];
+    s16 RasColor[4];
+
+    u8 AlphaBump;
+    u8 IndirectTex[4][4];
+    TextureCoordinateType TexCoord;
+  };
+
+  std::array<PixelState, QUAD_SIZE> m_Pixels;
+
   s16 KonstantColors[4][4];
-  s16 TexColor[4];
-  s16 RasColor[4];
   s16 StageKonst[4];
   s16 Zero16[4];
 
   s16 FixedConstants[9];
-  u8 AlphaBump;
-  u8 IndirectTex[4][4];
-  TextureCoordinateType TexCoord;
 
-  s16* m_ColorInputLUT[16][3];
-  s16* m_AlphaInputLUT[8];  // values must point to ABGR color
+  // The inputs of each pixel, pointing into its own state and the shared constants.
+  s16* m_ColorInputLUT[QUAD_SIZE][16][3];
+  s16* m_AlphaInputLUT[QUAD_SIZE][8];  // values must point to ABGR color
   s16* m_KonstLUT[32][4];
-  s16 m_BiasLUT[4];
-  u8 m_ScaleLShiftLUT[4];
-  u8 m_ScaleRShiftLUT[4];
+
+  // The combiner configuration of each stage, rebuilt when the stage changes.
+  std::array<TevCombiner::Params, 16> m_CombinerParams;
+  std::array<u64, 16> m_CombinerKeys;
 
   // enumeration for color input LUT
   enum
@@ -57,24 +68,33 @@ class Tev
     INDIRECT = 32
   };
 
-  void SetRasColor(int colorChan, int swaptable);
+  void SetRasColor(int pixel, int colorChan, int swaptable);
 
-  void DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
-  void DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
-  void DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
-  void DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
+  void DrawColorCompare(int pixel, const TevStageCombiner::ColorCombiner& cc,
+                        const TevCombiner::Inputs& inputs);
+  void DrawAlphaCompare(int pixel, const TevStageCombiner::AlphaCombiner& ac,
+                        const TevCombiner::Inputs& inputs);
 
-  void Indirect(unsigned int stageNum, s32 s, s32 t);
+  void Indirect(int pixel, unsigned int stageNum, s32 s, s32 t);
+
+  // Runs the steps after the TEV stages on one pixel, and writes it to the EFB if it passes.
+  void DrawOutput(int pixel);
 
 public:
-  s32 Position[3];
-  u8 Color[2][4];  // must be RGBA for correct swap table ordering
-  TextureCoordinateType Uv[8];
+  // The inputs of each pixel in the quad.
+  s32 Position[QUAD_SIZE][3];
+  u8 Color[QUAD_SIZE][2][4];  // must be RGBA for correct swap table ordering
+  TextureCoordinateType Uv[QUAD_SIZE][8];
+
+  // Shared by the quad.
   s32 IndirectLod[4];
   bool IndirectLinear[4];
   s32 TextureLod[16];
   bool TextureLinear[16];
 
+  // What happened to the pixels drawn by this instance. Committed by the rasterizer.
+  EfbInterface::PixelCounters Counters;
+
   enum
   {
     ALP_C,
@@ -85,7 +105,8 @@ public:
 
   void Init();
 
-  void Draw();
+  // Shades the pixels of the quad which are set in the mask.
+  void Draw(u32 pixel_mask);
 
   void SetRegColor(int reg, int comp, s16 color);
 };
@@ -0,0 +1,265 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoBackends/Software/TevCombiner.h"
+
+#include <algorithm>
+
+#include "Common/CPUDetect.h"
+#include "Common/Intrinsics.h"
+
+namespace TevCombiner
+{
+namespace
+{
+enum
+{
+  ALP_C,
+  BLU_C,
+  GRN_C,
+  RED_C
+};
+
+constexpr std::array<s16, 4> BIAS_LUT = {0, 128, -128, 0};
+constexpr std::array<u8, 4> SCALE_LSHIFT_LUT = {0, 1, 2, 0};
+constexpr std::array<u8, 4> SCALE_RSHIFT_LUT = {0, 0, 0, 1};
+}  // namespace
+
+Params::Params(const TevStageCombiner::ColorCombiner& cc,
+               const TevStageCombiner::AlphaCombiner& ac)
+{
+  scale = {};
+  bias = {};
+  clamp_min = {};
+  clamp_max = {};
+
+  for (int i = BLU_C; i <= RED_C; i++)
+  {
+    scale[i] = 1 << SCALE_LSHIFT_LUT[cc.shift];
+    bias[i] = BIAS_LUT[cc.bias];
+    clamp_min[i] = cc.clamp ? 0 : -1024;
+    clamp_max[i] = cc.clamp ? 255 : 1023;
+    round[i] = (cc.shift == 3) ? 0 : (cc.op == 1) ? 127 : 128;
+    negate_before[i] = 0;
+    negate_after[i] = cc.op ? -1 : 0;
+    halve[i] = SCALE_RSHIFT_LUT[cc.shift] ? -1 : 0;
+  }
+
+  // The alpha combiner rounds only when the color combiner doesn't, and negates before dividing.
+  scale[ALP_C] = 1 << SCALE_LSHIFT_LUT[ac.shift];
+  bias[ALP_C] = BIAS_LUT[ac.bias];
+  clamp_min[ALP_C] = ac.clamp ? 0 : -1024;
+  clamp_max[ALP_C] = ac.clamp ? 255 : 1023;
+  round[ALP_C] = (ac.shift != 3) ? 0 : (ac.op == 1) ? 127 : 128;
+  negate_before[ALP_C] = ac.op ? -1 : 0;
+  negate_after[ALP_C] = 0;
+  halve[ALP_C] = SCALE_RSHIFT_LUT[ac.shift] ? -1 : 0;
+
+  for (auto* values : {&scale, &bias, &clamp_min, &clamp_max})
+    std::copy_n(values->begin(), 4, values->begin() + 4);
+}
+
+#ifdef _M_X86
+QuadComponents CombineRegular(const Params& params, const QuadInputs& inputs)
+{
+  return cpu_info.bAVX2 ? CombineRegularAVX2(params, inputs) : CombineRegularSSE2(params, inputs);
+}
+
+// Combines two pixels, with the components of the first one in the low half of each register.
+static __m128i CombineTwoPixels(const Params& params, __m128i a, __m128i b, __m128i c, __m128i d)
+{
+  const auto load_params = [](const auto& values) {
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(values.data()));
+  };
+
+  const __m128i scale = load_params(params.scale);
+
+  // Expand c from [0, 255] to [0, 256], and fold the scale into the weights. The weights are at
+  // most 1024, so a * (256 - c) + b * c fits in the 32 bit lanes of a single multiply-add.
+  const __m128i c256 = _mm_add_epi16(c, _mm_srli_epi16(c, 7));
+  const __m128i weight_a = _mm_mullo_epi16(_mm_sub_epi16(_mm_set1_epi16(256), c256), scale);
+  const __m128i weight_b = _mm_mullo_epi16(c256, scale);
+  __m128i lerp[2] = {
+      _mm_madd_epi16(_mm_unpacklo_epi16(a, b), _mm_unpacklo_epi16(weight_a, weight_b)),
+      _mm_madd_epi16(_mm_unpackhi_epi16(a, b), _mm_unpackhi_epi16(weight_a, weight_b))};
+
+  // (d + bias) * 4 still fits in 16 bits, so sign extend after scaling.
+  const __m128i d_scaled = _mm_mullo_epi16(_mm_add_epi16(d, load_params(params.bias)), scale);
+  const __m128i d_extended[2] = {_mm_srai_epi32(_mm_unpacklo_epi16(d_scaled, d_scaled), 16),
+                                 _mm_srai_epi32(_mm_unpackhi_epi16(d_scaled, d_scaled), 16)};
+
+  const __m128i round = load_params(params.round);
+  const __m128i negate_before = load_params(params.negate_before);
+  const __m128i negate_after = load_params(params.negate_after);
+  const __m128i halve = load_params(params.halve);
+  __m128i result[2];
+  for (int i = 0; i < 2; i++)
+  {
+    lerp[i] = _mm_add_epi32(lerp[i], round);
+    lerp[i] = _mm_sub_epi32(_mm_xor_si128(lerp[i], negate_before), negate_before);
+    lerp[i] = _mm_srai_epi32(lerp[i], 8);
+    lerp[i] = _mm_sub_epi32(_mm_xor_si128(lerp[i], negate_after), negate_after);
+
+    result[i] = _mm_add_epi32(d_extended[i], lerp[i]);
+    result[i] = _mm_or_si128(_mm_and_si128(halve, _mm_srai_epi32(result[i], 1)),
+                             _mm_andnot_si128(halve, result[i]));
+  }
+
+  // The result is within [-5632, 5631], so packing doesn't saturate.
+  __m128i packed = _mm_packs_epi32(result[0], result[1]);
+  packed = _mm_max_epi16(packed, load_params(params.clamp_min));
+  return _mm_min_epi16(packed, load_params(params.clamp_max));
+}
+
+QuadComponents CombineRegularSSE2(const Params& params, const QuadInputs& inputs)
+{
+  const auto load_inputs = [](const QuadComponents& components, int pixel) {
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(components[pixel].data()));
+  };
+
+  QuadComponents output;
+  for (int pixel = 0; pixel < QUAD_SIZE; pixel += 2)
+  {
+    const __m128i result =
+        CombineTwoPixels(params, load_inputs(inputs.a, pixel), load_inputs(inputs.b, pixel),
+                         load_inputs(inputs.c, pixel), load_inputs(inputs.d, pixel));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output[pixel].data()), result);
+  }
+  return output;
+}
+
+// Lambdas don't inherit the target of the function they are in, so these are separate functions.
+FUNCTION_TARGET_AVX2
+static __m256i LoadQuadAVX2(const QuadComponents& components)
+{
+  return _mm256_load_si256(reinterpret_cast<const __m256i*>(components.data()));
+}
+
+// Repeats the parameters of the first two pixels for the other two.
+template <typename T>
+FUNCTION_TARGET_AVX2 static __m256i LoadParamsAVX2(const T& values)
+{
+  const __m128i two_pixels = _mm_load_si128(reinterpret_cast<const __m128i*>(values.data()));
+  return _mm256_broadcastsi128_si256(two_pixels);
+}
+
+// The same as CombineTwoPixels, on the whole quad at once. The unpacking works within each 128 bit
+// half, so the low halves of the 32 bit results hold the first and third pixel, and packing puts
+// the pixels back in order.
+FUNCTION_TARGET_AVX2
+QuadComponents CombineRegularAVX2(const Params& params, const QuadInputs& inputs)
+{
+  const __m256i a = LoadQuadAVX2(inputs.a);
+  const __m256i b = LoadQuadAVX2(inputs.b);
+  const __m256i c = LoadQuadAVX2(inputs.c);
+  const __m256i d = LoadQuadAVX2(inputs.d);
+  const __m256i scale = LoadParamsAVX2(params.scale);
+
+  const __m256i c256 = _mm256_add_epi16(c, _mm256_srli_epi16(c, 7));
+  const __m256i weight_a =
+      _mm256_mullo_epi16(_mm256_sub_epi16(_mm256_set1_epi16(256), c256), scale);
+  const __m256i weight_b = _mm256_mullo_epi16(c256, scale);
+  __m256i lerp[2] = {
+      _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), _mm256_unpacklo_epi16(weight_a, weight_b)),
+      _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), _mm256_unpackhi_epi16(weight_a, weight_b))};
+
+  const __m256i d_scaled =
+      _mm256_mullo_epi16(_mm256_add_epi16(d, LoadParamsAVX2(params.bias)), scale);
+  const __m256i d_extended[2] = {
+      _mm256_srai_epi32(_mm256_unpacklo_epi16(d_scaled, d_scaled), 16),
+      _mm256_srai_epi32(_mm256_unpackhi_epi16(d_scaled, d_scaled), 16)};
+
+  const __m256i round = LoadParamsAVX2(params.round);
+  const __m256i negate_before = LoadParamsAVX2(params.negate_before);
+  const __m256i negate_after = LoadParamsAVX2(params.negate_after);
+  const __m256i halve = LoadParamsAVX2(params.halve);
+  __m256i result[2];
+  for (int i = 0; i < 2; i++)
+  {
+    lerp[i] = _mm256_add_epi32(lerp[i], round);
+    lerp[i] = _mm256_sub_epi32(_mm256_xor_si256(lerp[i], negate_before), negate_before);
+    lerp[i] = _mm256_srai_epi32(lerp[i], 8);
+    lerp[i] = _mm256_sub_epi32(_mm256_xor_si256(lerp[i], negate_after), negate_after);
+
+    result[i] = _mm256_add_epi32(d_extended[i], lerp[i]);
+    result[i] = _mm256_blendv_epi8(result[i], _mm256_srai_epi32(result[i], 1), halve);
+  }
+
+  __m256i packed = _mm256_packs_epi32(result[0], result[1]);
+  packed = _mm256_max_epi16(packed, LoadParamsAVX2(params.clamp_min));
+  packed = _mm256_min_epi16(packed, LoadParamsAVX2(params.clamp_max));
+
+  QuadComponents output;
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(output.data()), packed);
+  return output;
+}
+#else
+QuadComponents CombineRegular(const Params& params, const QuadInputs& inputs)
+{
+  QuadComponents output;
+  for (int pixel = 0; pixel < QUAD_SIZE; pixel++)
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      const s32 a = inputs.a[pixel][i];
+      const s32 b = inputs.b[pixel][i];
+      const s32 c = inputs.c[pixel][i] + (inputs.c[pixel][i] >> 7);
+
+      s32 lerp = (a * (256 - c) + b * c) * params.scale[i] + params.round[i];
+      lerp = (lerp ^ params.negate_before[i]) - params.negate_before[i];
+      lerp >>= 8;
+      lerp = (lerp ^ params.negate_after[i]) - params.negate_after[i];
+
+      s32 result = (inputs.d[pixel][i] + params.bias[i]) * params.scale[i] + lerp;
+      if (params.halve[i])
+        result >>= 1;
+
+      output[pixel][i] =
+          std::clamp<s16>(static_cast<s16>(result), params.clamp_min[i], params.clamp_max[i]);
+    }
+  }
+  return output;
+}
+#endif
+
+Components CombineRegularGeneric(const TevStageCombiner::ColorCombiner& cc,
+                                 const TevStageCombiner::AlphaCombiner& ac, const Inputs& inputs)
+{
+  Components output;
+
+  for (int i = BLU_C; i <= RED_C; i++)
+  {
+    const u16 c = inputs.c[i] + (inputs.c[i] >> 7);
+
+    s32 temp = inputs.a[i] * (256 - c) + (inputs.b[i] * c);
+    temp <<= SCALE_LSHIFT_LUT[cc.shift];
+    temp += (cc.shift == 3) ? 0 : (cc.op == 1) ? 127 : 128;
+    temp >>= 8;
+    temp = cc.op ? -temp : temp;
+
+    s32 result = ((inputs.d[i] + BIAS_LUT[cc.bias]) << SCALE_LSHIFT_LUT[cc.shift]) + temp;
+    result = result >> SCALE_RSHIFT_LUT[cc.shift];
+
+    output[i] =
+        cc.clamp ? Clamp255(static_cast<s16>(result)) : Clamp1024(static_cast<s16>(result));
+  }
+
+  {
+    const u16 c = inputs.c[ALP_C] + (inputs.c[ALP_C] >> 7);
+
+    s32 temp = inputs.a[ALP_C] * (256 - c) + (inputs.b[ALP_C] * c);
+    temp <<= SCALE_LSHIFT_LUT[ac.shift];
+    temp += (ac.shift != 3) ? 0 : (ac.op == 1) ? 127 : 128;
+    temp = ac.op ? (-temp >> 8) : (temp >> 8);
+
+    s32 result = ((inputs.d[ALP_C] + BIAS_LUT[ac.bias]) << SCALE_LSHIFT_LUT[ac.shift]) + temp;
+    result = result >> SCALE_RSHIFT_LUT[ac.shift];
+
+    output[ALP_C] =
+        ac.clamp ? Clamp255(static_cast<s16>(result)) : Clamp1024(static_cast<s16>(result));
+  }
+
+  return output;
+}
+}  // namespace TevCombiner
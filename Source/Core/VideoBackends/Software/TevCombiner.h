@@ -0,0 +1,84 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+
+// The arithmetic of the regular (non-compare) TEV stage combiners. The color and alpha combiners
+// of a stage are evaluated together for the four pixels of a 2x2 quad, with one component of a
+// pixel per SIMD lane.
+namespace TevCombiner
+{
+constexpr int QUAD_SIZE = 4;
+
+// One value per component, in the order of the TEV registers: alpha, blue, green, red.
+using Components = std::array<s16, 4>;
+using QuadComponents = std::array<Components, QUAD_SIZE>;
+
+// The combiner inputs, already truncated like the hardware does: a, b and c are unsigned 8 bit
+// values, d is a signed 11 bit value.
+struct Inputs
+{
+  Components a;
+  Components b;
+  Components c;
+  Components d;
+};
+
+// The inputs of all pixels of a quad, each input stored contiguously for SIMD loads.
+struct alignas(32) QuadInputs
+{
+  QuadComponents a;
+  QuadComponents b;
+  QuadComponents c;
+  QuadComponents d;
+};
+
+// Everything the combiners of a stage need to know about their configuration, laid out for SIMD.
+struct alignas(16) Params
+{
+  Params() = default;
+  Params(const TevStageCombiner::ColorCombiner& cc, const TevStageCombiner::AlphaCombiner& ac);
+
+  // The 16 bit values are repeated for a second pixel.
+  std::array<s16, 8> scale;
+  std::array<s16, 8> bias;
+  std::array<s16, 8> clamp_min;
+  std::array<s16, 8> clamp_max;
+  std::array<s32, 4> round;
+  // All bits set in the lanes which negate the weighted sum before or after dividing it by 256.
+  std::array<s32, 4> negate_before;
+  std::array<s32, 4> negate_after;
+  // All bits set in the lanes which halve the result.
+  std::array<s32, 4> halve;
+};
+
+// Returns the clamped results of both combiners for every pixel of the quad, as if they were both
+// regular. The caller picks the components of the ones which actually are.
+QuadComponents CombineRegular(const Params& params, const QuadInputs& inputs);
+
+#ifdef _M_X86
+// The implementations CombineRegular picks from, depending on the CPU.
+QuadComponents CombineRegularSSE2(const Params& params, const QuadInputs& inputs);
+QuadComponents CombineRegularAVX2(const Params& params, const QuadInputs& inputs);
+#endif
+
+// The scalar reference for CombineRegular.
+Components CombineRegularGeneric(const TevStageCombiner::ColorCombiner& cc,
+                                 const TevStageCombiner::AlphaCombiner& ac, const Inputs& inputs);
+
+constexpr s16 Clamp255(s16 in)
+{
+  return in > 255 ? 255 : (in < 0 ? 0 : in);
+}
+
+constexpr s16 Clamp1024(s16 in)
+{
+  return in > 1023 ? 1023 : (in < -1024 ? -1024 : in);
+}
+}  // namespace TevCombiner
@@ -0,0 +1,93 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "Common/Assert.h"
+#include "Common/CommonTypes.h"
+#include "Common/FlatHashMap.h"
+
+// Index of address ranges which finds all ranges overlapping a given one.
+//
+// Memory is split into pages, and every range is added to the list of each page it touches. A
+// lookup only has to look at the lists of the pages it covers, so it doesn't get slower with the
+// number of ranges elsewhere in memory.
+template <typename T>
+class AddressRangeIndex
+{
+public:
+  static constexpr u32 PAGE_BITS = 16;
+
+  void Add(u32 address, u32 size, const T& value)
+  {
+    const u32 end = address + size;
+    for (u32 page = FirstPage(address); page <= LastPage(address, size); ++page)
+      m_pages[page].push_back({address, end, value});
+  }
+
+  // The range has to be the same that the value was added with.
+  void Remove(u32 address, u32 size, const T& value)
+  {
+    for (u32 page = FirstPage(address); page <= LastPage(address, size); ++page)
+    {
+      std::vector<Entry>* entries = m_pages.Find(page);
+      ASSERT(entries);
+
+      const auto iter = std::find_if(entries->begin(), entries->end(),
+                                     [&value](const Entry& entry) { return entry.value == value; });
+      ASSERT(iter != entries->end());
+
+      *iter = std::move(entries->back());
+      entries->pop_back();
+      if (entries->empty())
+        m_pages.Erase(page);
+    }
+  }
+
+  void Clear() { m_pages.Clear(); }
+
+  // Calls f once for every value whose range overlaps [address, address + size), in no particular
+  // order.
+  template <typename F>
+  void ForEachOverlapping(u32 address, u32 size, F f) const
+  {
+    const u32 end = address + size;
+    const u32 first_page = FirstPage(address);
+    for (u32 page = first_page; page <= LastPage(address, size); ++page)
+    {
+      const std::vector<Entry>* entries = m_pages.Find(page);
+      if (!entries)
+        continue;
+
+      for (const Entry& entry : *entries)
+      {
+        // Ranges spanning several pages of the lookup are only reported on the first one.
+        if (page != first_page && FirstPage(entry.address) != page)
+          continue;
+
+        if (entry.address < end && address < entry.end)
+          f(entry.value);
+      }
+    }
+  }
+
+private:
+  struct Entry
+  {
+    u32 address;
+    u32 end;
+    T value;
+  };
+
+  static u32 FirstPage(u32 address) { return address >> PAGE_BITS; }
+  static u32 LastPage(u32 address, u32 size)
+  {
+    return size == 0 ? FirstPage(address) : (address + size - 1) >> PAGE_BITS;
+  }
+
+  Common::FlatHashMap<u32, std::vector<Entry>> m_pages;
+};
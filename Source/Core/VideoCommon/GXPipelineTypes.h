@@ -109,6 +109,15 @@ struct SerializedGXUberPipelineUid
   u32 depth_state_bits;
   u32 blending_state_bits;
 };
+
+// Entry in the UID cache file, with how often and how recently the pipeline was used, so that
+// the pipelines most likely to be needed can be precompiled first.
+struct SerializedGXPipelineUidCacheEntry
+{
+  SerializedGXPipelineUid uid;
+  u32 use_count;          // Number of sessions the pipeline was used in.
+  u32 last_used_session;  // Session counter of the UID cache file when last used.
+};
 #pragma pack(pop)
 
 }  // namespace VideoCommon
@@ -8,7 +8,9 @@
 #include <cstddef>
 #include <cstring>
 
+#include "Common/CPUDetect.h"
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Common/Logging/Log.h"
 #include "VideoCommon/OpcodeDecoding.h"
 #include "VideoCommon/VideoConfig.h"
@@ -81,11 +83,10 @@ u16* AddStrip(u16* index_ptr, u32 num_verts, u32 index)
  * so we use 6 indices for 3 triangles
  */
 
+// Continues a fan at its i-th vertex.
 template <bool pr>
-u16* AddFan(u16* index_ptr, u32 num_verts, u32 index)
+u16* AddFanFrom(u16* index_ptr, u32 num_verts, u32 index, u32 i)
 {
-  u32 i = 2;
-
   if constexpr (pr)
   {
     for (; i + 3 <= num_verts; i += 3)
@@ -115,6 +116,12 @@ u16* AddFan(u16* index_ptr, u32 num_verts, u32 index)
   return index_ptr;
 }
 
+template <bool pr>
+u16* AddFan(u16* index_ptr, u32 num_verts, u32 index)
+{
+  return AddFanFrom<pr>(index_ptr, num_verts, index, 2);
+}
+
 /*
  * QUAD simulator
  *
@@ -199,9 +206,263 @@ u16* AddPoints(u16* index_ptr, u32 num_verts, u32 index)
   }
   return index_ptr;
 }
+
+// Vectorized generators. All primitives repeat a short pattern of indices, advancing by a fixed
+// number of vertices each time. Each vector register holds consecutive indices from a block of
+// as many repetitions as there are lanes, so advancing to the next block is a single add per
+// register. The scalar generators above finish the remaining vertices.
+
+// Pattern entries are offsets from the first vertex of the repetition, or one of these.
+constexpr s8 RESTART = -1;
+// The first vertex of the primitive, which stays the same for all repetitions.
+constexpr s8 FIRST = -2;
+
+template <u32 lanes, u32 advance, s8... pattern>
+struct PatternTables
+{
+  static constexpr u32 size = lanes * sizeof...(pattern);
+
+  // Values for the first block, without the base index.
+  std::array<u16, size> offsets{};
+  // Set for the lanes which the base index is added to.
+  std::array<u16, size> index_mask{};
+  // Added to every lane for the next block.
+  std::array<u16, size> step{};
+
+  constexpr PatternTables()
+  {
+    constexpr std::array<s8, sizeof...(pattern)> entries{pattern...};
+    for (u32 i = 0; i < size; ++i)
+    {
+      const u32 repetition = i / entries.size();
+      const s8 entry = entries[i % entries.size()];
+      if (entry == RESTART)
+      {
+        offsets[i] = s_primitive_restart;
+      }
+      else if (entry == FIRST)
+      {
+        index_mask[i] = 0xffff;
+      }
+      else
+      {
+        offsets[i] = static_cast<u16>(repetition * advance + entry);
+        index_mask[i] = 0xffff;
+        step[i] = static_cast<u16>(lanes * advance);
+      }
+    }
+  }
+};
+
+#ifdef _M_X86
+struct SSE2Writer
+{
+  static constexpr u32 LANES = 8;
+
+  template <u32 advance, s8... pattern>
+  static u16* Write(u16* index_ptr, u32 index, u32 blocks)
+  {
+    static constexpr PatternTables<LANES, advance, pattern...> tables;
+    constexpr u32 num_vectors = sizeof...(pattern);
+
+    const __m128i base = _mm_set1_epi16(static_cast<s16>(index));
+    __m128i values[num_vectors];
+    __m128i steps[num_vectors];
+    for (u32 i = 0; i < num_vectors; ++i)
+    {
+      const auto* offsets = reinterpret_cast<const __m128i*>(&tables.offsets[i * LANES]);
+      const auto* index_mask = reinterpret_cast<const __m128i*>(&tables.index_mask[i * LANES]);
+      const auto* step = reinterpret_cast<const __m128i*>(&tables.step[i * LANES]);
+      values[i] = _mm_add_epi16(_mm_loadu_si128(offsets),
+                                _mm_and_si128(base, _mm_loadu_si128(index_mask)));
+      steps[i] = _mm_loadu_si128(step);
+    }
+
+    for (u32 block = 0; block < blocks; ++block)
+    {
+      for (u32 i = 0; i < num_vectors; ++i)
+      {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(index_ptr), values[i]);
+        values[i] = _mm_add_epi16(values[i], steps[i]);
+        index_ptr += LANES;
+      }
+    }
+    return index_ptr;
+  }
+};
+
+struct AVX2Writer
+{
+  static constexpr u32 LANES = 16;
+
+  template <u32 advance, s8... pattern>
+  FUNCTION_TARGET_AVX2 static u16* Write(u16* index_ptr, u32 index, u32 blocks)
+  {
+    static constexpr PatternTables<LANES, advance, pattern...> tables;
+    constexpr u32 num_vectors = sizeof...(pattern);
+
+    const __m256i base = _mm256_set1_epi16(static_cast<s16>(index));
+    __m256i values[num_vectors];
+    __m256i steps[num_vectors];
+    for (u32 i = 0; i < num_vectors; ++i)
+    {
+      const auto* offsets = reinterpret_cast<const __m256i*>(&tables.offsets[i * LANES]);
+      const auto* index_mask = reinterpret_cast<const __m256i*>(&tables.index_mask[i * LANES]);
+      const auto* step = reinterpret_cast<const __m256i*>(&tables.step[i * LANES]);
+      values[i] = _mm256_add_epi16(_mm256_loadu_si256(offsets),
+                                   _mm256_and_si256(base, _mm256_loadu_si256(index_mask)));
+      steps[i] = _mm256_loadu_si256(step);
+    }
+
+    for (u32 block = 0; block < blocks; ++block)
+    {
+      for (u32 i = 0; i < num_vectors; ++i)
+      {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(index_ptr), values[i]);
+        values[i] = _mm256_add_epi16(values[i], steps[i]);
+        index_ptr += LANES;
+      }
+    }
+    return index_ptr;
+  }
+};
+#endif
+
+// Writes as many of the repetitions as fill whole blocks, and returns how many were written.
+template <typename Writer, u32 advance, s8... pattern>
+u32 WriteRepeated(u16** index_ptr, u32 index, u32 repetitions)
+{
+  const u32 blocks = repetitions / Writer::LANES;
+  *index_ptr = Writer::template Write<advance, pattern...>(*index_ptr, index, blocks);
+  return blocks * Writer::LANES;
+}
+
+template <typename Writer, bool pr>
+u16* AddListVectorized(u16* index_ptr, u32 num_verts, u32 index)
+{
+  u32 done;
+  if constexpr (pr)
+    done = WriteRepeated<Writer, 3, 0, 1, 2, RESTART>(&index_ptr, index, num_verts / 3);
+  else
+    done = WriteRepeated<Writer, 3, 0, 1, 2>(&index_ptr, index, num_verts / 3);
+  return AddList<pr>(index_ptr, num_verts - done * 3, index + done * 3);
+}
+
+template <typename Writer, bool pr>
+u16* AddStripVectorized(u16* index_ptr, u32 num_verts, u32 index)
+{
+  if constexpr (pr)
+  {
+    const u32 done = WriteRepeated<Writer, 1, 0>(&index_ptr, index, num_verts);
+    index_ptr = AddPoints(index_ptr, num_verts - done, index + done);
+    *index_ptr++ = s_primitive_restart;
+    return index_ptr;
+  }
+  else
+  {
+    // Two triangles at a time, so that the winding is the same for every repetition.
+    const u32 pairs = num_verts >= 2 ? (num_verts - 2) / 2 : 0;
+    const u32 done = WriteRepeated<Writer, 2, 0, 1, 2, 1, 3, 2>(&index_ptr, index, pairs);
+    return AddStrip<pr>(index_ptr, num_verts - done * 2, index + done * 2);
+  }
+}
+
+template <typename Writer, bool pr>
+u16* AddFanVectorized(u16* index_ptr, u32 num_verts, u32 index)
+{
+  u32 done;
+  if constexpr (pr)
+  {
+    const u32 groups = num_verts >= 2 ? (num_verts - 2) / 3 : 0;
+    done = WriteRepeated<Writer, 3, 1, 2, FIRST, 3, 4, RESTART>(&index_ptr, index, groups) * 3;
+  }
+  else
+  {
+    const u32 triangles = num_verts >= 2 ? num_verts - 2 : 0;
+    done = WriteRepeated<Writer, 1, FIRST, 1, 2>(&index_ptr, index, triangles);
+  }
+  return AddFanFrom<pr>(index_ptr, num_verts, index, 2 + done);
+}
+
+template <typename Writer, bool pr>
+u16* AddQuadsVectorized(u16* index_ptr, u32 num_verts, u32 index)
+{
+  u32 done;
+  if constexpr (pr)
+    done = WriteRepeated<Writer, 4, 1, 2, 0, 3, RESTART>(&index_ptr, index, num_verts / 4);
+  else
+    done = WriteRepeated<Writer, 4, 0, 1, 2, 0, 2, 3>(&index_ptr, index, num_verts / 4);
+  return AddQuads<pr>(index_ptr, num_verts - done * 4, index + done * 4);
+}
+
+template <typename Writer, bool pr>
+u16* AddQuadsVectorized_nonstandard(u16* index_ptr, u32 num_verts, u32 index)
+{
+  WARN_LOG(VIDEO, "Non-standard primitive drawing command GL_DRAW_QUADS_2");
+  return AddQuadsVectorized<Writer, pr>(index_ptr, num_verts, index);
+}
+
+template <typename Writer>
+u16* AddLineListVectorized(u16* index_ptr, u32 num_verts, u32 index)
+{
+  const u32 done = WriteRepeated<Writer, 2, 0, 1>(&index_ptr, index, num_verts / 2);
+  return AddLineList(index_ptr, num_verts - done * 2, index + done * 2);
+}
+
+template <typename Writer>
+u16* AddLineStripVectorized(u16* index_ptr, u32 num_verts, u32 index)
+{
+  const u32 lines = num_verts >= 1 ? num_verts - 1 : 0;
+  const u32 done = WriteRepeated<Writer, 1, 0, 1>(&index_ptr, index, lines);
+  return AddLineStrip(index_ptr, num_verts - done, index + done);
+}
+
+template <typename Writer>
+u16* AddPointsVectorized(u16* index_ptr, u32 num_verts, u32 index)
+{
+  const u32 done = WriteRepeated<Writer, 1, 0>(&index_ptr, index, num_verts);
+  return AddPoints(index_ptr, num_verts - done, index + done);
+}
+
+template <typename Writer, typename Table>
+void FillVectorizedTable(Table* table, bool primitive_restart)
+{
+  if (primitive_restart)
+  {
+    (*table)[OpcodeDecoder::GX_DRAW_QUADS] = AddQuadsVectorized<Writer, true>;
+    (*table)[OpcodeDecoder::GX_DRAW_QUADS_2] = AddQuadsVectorized_nonstandard<Writer, true>;
+    (*table)[OpcodeDecoder::GX_DRAW_TRIANGLES] = AddListVectorized<Writer, true>;
+    (*table)[OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP] = AddStripVectorized<Writer, true>;
+    (*table)[OpcodeDecoder::GX_DRAW_TRIANGLE_FAN] = AddFanVectorized<Writer, true>;
+  }
+  else
+  {
+    (*table)[OpcodeDecoder::GX_DRAW_QUADS] = AddQuadsVectorized<Writer, false>;
+    (*table)[OpcodeDecoder::GX_DRAW_QUADS_2] = AddQuadsVectorized_nonstandard<Writer, false>;
+    (*table)[OpcodeDecoder::GX_DRAW_TRIANGLES] = AddListVectorized<Writer, false>;
+    (*table)[OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP] = AddStripVectorized<Writer, false>;
+    (*table)[OpcodeDecoder::GX_DRAW_TRIANGLE_FAN] = AddFanVectorized<Writer, false>;
+  }
+  (*table)[OpcodeDecoder::GX_DRAW_LINES] = AddLineListVectorized<Writer>;
+  (*table)[OpcodeDecoder::GX_DRAW_LINE_STRIP] = AddLineStripVectorized<Writer>;
+  (*table)[OpcodeDecoder::GX_DRAW_POINTS] = AddPointsVectorized<Writer>;
+}
 }  // Anonymous namespace
 
 void IndexGenerator::Init()
+{
+#ifdef _M_X86
+  const bool primitive_restart = g_Config.backend_info.bSupportsPrimitiveRestart;
+  if (cpu_info.bAVX2)
+    FillVectorizedTable<AVX2Writer>(&m_primitive_table, primitive_restart);
+  else
+    FillVectorizedTable<SSE2Writer>(&m_primitive_table, primitive_restart);
+#else
+  InitGeneric();
+#endif
+}
+
+void IndexGenerator::InitGeneric()
 {
   if (g_Config.backend_info.bSupportsPrimitiveRestart)
   {
@@ -14,6 +14,8 @@ class IndexGenerator
 {
 public:
   void Init();
+  // Only uses the scalar generators, as a reference for the vectorized ones.
+  void InitGeneric();
   void Start(u16* index_ptr);
 
   void AddIndices(int primitive, u32 num_vertices);
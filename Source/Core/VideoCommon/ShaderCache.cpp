@@ -4,6 +4,11 @@
 
 #include "VideoCommon/ShaderCache.h"
 
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
 #include "Common/Assert.h"
 #include "Common/FileUtil.h"
 #include "Common/MsgHandler.h"
@@ -111,8 +116,11 @@ void ShaderCache::Shutdown()
 const AbstractPipeline* ShaderCache::GetPipelineForUid(const GXPipelineUid& uid)
 {
   auto it = m_gx_pipeline_cache.find(uid);
-  if (it != m_gx_pipeline_cache.end() && !it->second.second)
-    return it->second.first.get();
+  if (it != m_gx_pipeline_cache.end() && !it->second.pending)
+  {
+    it->second.used = true;
+    return it->second.pipeline.get();
+  }
 
   const bool exists_in_cache = it != m_gx_pipeline_cache.end();
   std::unique_ptr<AbstractPipeline> pipeline;
@@ -121,7 +129,9 @@ const AbstractPipeline* ShaderCache::GetPipelineForUid(const GXPipelineUid& uid)
     pipeline = g_renderer->CreatePipeline(*pipeline_config);
   if (g_ActiveConfig.bShaderCache && !exists_in_cache)
     AppendGXPipelineUID(uid);
-  return InsertGXPipeline(uid, std::move(pipeline));
+  const AbstractPipeline* result = InsertGXPipeline(uid, std::move(pipeline));
+  m_gx_pipeline_cache[uid].used = true;
+  return result;
 }
 
 std::optional<const AbstractPipeline*> ShaderCache::GetPipelineForUidAsync(const GXPipelineUid& uid)
@@ -129,23 +139,25 @@ std::optional<const AbstractPipeline*> ShaderCache::GetPipelineForUidAsync(const
   auto it = m_gx_pipeline_cache.find(uid);
   if (it != m_gx_pipeline_cache.end())
   {
-    // .second is the pending flag, i.e. compiling in the background.
-    if (!it->second.second)
-      return it->second.first.get();
+    // The pending flag is set while compiling in the background.
+    it->second.used = true;
+    if (!it->second.pending)
+      return it->second.pipeline.get();
     else
       return {};
   }
 
   AppendGXPipelineUID(uid);
   QueuePipelineCompile(uid, COMPILE_PRIORITY_ONDEMAND_PIPELINE);
+  m_gx_pipeline_cache[uid].used = true;
   return {};
 }
 
 const AbstractPipeline* ShaderCache::GetUberPipelineForUid(const GXUberPipelineUid& uid)
 {
   auto it = m_gx_uber_pipeline_cache.find(uid);
-  if (it != m_gx_uber_pipeline_cache.end() && !it->second.second)
-    return it->second.first.get();
+  if (it != m_gx_uber_pipeline_cache.end() && !it->second.pending)
+    return it->second.pipeline.get();
 
   std::unique_ptr<AbstractPipeline> pipeline;
   std::optional<AbstractPipelineConfig> pipeline_config = GetGXPipelineConfig(uid);
@@ -291,8 +303,8 @@ void ShaderCache::LoadPipelineCache(T& cache, LinearDiskCache<DiskKeyType, u8>&
       }
 
       auto& entry = cache[real_uid];
-      entry.first = std::move(pipeline);
-      entry.second = false;
+      entry.pipeline = std::move(pipeline);
+      entry.pending = false;
     }
 
   private:
@@ -329,8 +341,8 @@ void ShaderCache::ClearPipelineCache(T& cache, Y& disk_cache)
   // Set the pending flag to false, and destroy the pipeline.
   for (auto& it : cache)
   {
-    it.second.first.reset();
-    it.second.second = false;
+    it.second.pipeline.reset();
+    it.second.pending = false;
   }
 }
 
@@ -402,15 +414,30 @@ void ShaderCache::ClearCaches()
 
 void ShaderCache::CompileMissingPipelines()
 {
-  // Queue all uids with a null pipeline for compilation.
-  for (auto& it : m_gx_pipeline_cache)
+  // Queue all uids with a null pipeline for compilation. The specialized pipelines that were used
+  // most recently, and then in the most sessions, are the most likely to be needed soon, so they
+  // are given the lowest priorities. Priorities remain above the on-demand and ubershader
+  // pipelines, which are still compiled first, and are kept when a pipeline is re-queued.
+  std::vector<decltype(m_gx_pipeline_cache)::const_iterator> missing_pipelines;
+  for (auto it = m_gx_pipeline_cache.cbegin(); it != m_gx_pipeline_cache.cend(); ++it)
+  {
+    if (!it->second.pipeline)
+      missing_pipelines.push_back(it);
+  }
+  std::stable_sort(missing_pipelines.begin(), missing_pipelines.end(),
+                   [](const auto& lhs, const auto& rhs) {
+                     return std::tie(lhs->second.last_used_session, lhs->second.use_count) >
+                            std::tie(rhs->second.last_used_session, rhs->second.use_count);
+                   });
+  for (size_t i = 0; i < missing_pipelines.size(); i++)
   {
-    if (!it.second.first)
-      QueuePipelineCompile(it.first, COMPILE_PRIORITY_SHADERCACHE_PIPELINE);
+    QueuePipelineCompile(missing_pipelines[i]->first,
+                         COMPILE_PRIORITY_SHADERCACHE_PIPELINE + static_cast<u32>(i));
   }
+
   for (auto& it : m_gx_uber_pipeline_cache)
   {
-    if (!it.second.first)
+    if (!it.second.pipeline)
       QueueUberPipelineCompile(it.first, COMPILE_PRIORITY_UBERSHADER_PIPELINE);
   }
 }
@@ -674,14 +701,14 @@ const AbstractPipeline* ShaderCache::InsertGXPipeline(const GXPipelineUid& confi
                                                       std::unique_ptr<AbstractPipeline> pipeline)
 {
   auto& entry = m_gx_pipeline_cache[config];
-  entry.second = false;
-  if (!entry.first && pipeline)
+  entry.pending = false;
+  if (!entry.pipeline && pipeline)
   {
-    entry.first = std::move(pipeline);
+    entry.pipeline = std::move(pipeline);
 
     if (g_ActiveConfig.bShaderCache)
     {
-      auto cache_data = entry.first->GetCacheData();
+      auto cache_data = entry.pipeline->GetCacheData();
       if (!cache_data.empty())
       {
         SerializedGXPipelineUid disk_uid;
@@ -692,7 +719,7 @@ const AbstractPipeline* ShaderCache::InsertGXPipeline(const GXPipelineUid& confi
     }
   }
 
-  return entry.first.get();
+  return entry.pipeline.get();
 }
 
 const AbstractPipeline*
@@ -700,14 +727,14 @@ ShaderCache::InsertGXUberPipeline(const GXUberPipelineUid& config,
                                   std::unique_ptr<AbstractPipeline> pipeline)
 {
   auto& entry = m_gx_uber_pipeline_cache[config];
-  entry.second = false;
-  if (!entry.first && pipeline)
+  entry.pending = false;
+  if (!entry.pipeline && pipeline)
   {
-    entry.first = std::move(pipeline);
+    entry.pipeline = std::move(pipeline);
 
     if (g_ActiveConfig.bShaderCache)
     {
-      auto cache_data = entry.first->GetCacheData();
+      auto cache_data = entry.pipeline->GetCacheData();
       if (!cache_data.empty())
       {
         SerializedGXUberPipelineUid disk_uid;
@@ -718,54 +745,77 @@ ShaderCache::InsertGXUberPipeline(const GXUberPipelineUid& config,
     }
   }
 
-  return entry.first.get();
+  return entry.pipeline.get();
 }
 
+// The UID cache file starts with the magic, GX_PIPELINE_UID_VERSION and the session counter,
+// followed by SerializedGXPipelineUidCacheEntry records. Legacy files have no session counter and
+// only contain SerializedGXPipelineUid records.
+constexpr u32 UID_CACHE_FILE_MAGIC = 0x32495550;         // PUI2
+constexpr u32 LEGACY_UID_CACHE_FILE_MAGIC = 0x44495550;  // PUID
+
 void ShaderCache::LoadPipelineUIDCache()
 {
-  constexpr u32 CACHE_FILE_MAGIC = 0x44495550;  // PUID
-  constexpr size_t CACHE_HEADER_SIZE = sizeof(u32) + sizeof(u32);
+  constexpr size_t CACHE_HEADER_SIZE = sizeof(u32) * 3;
+  constexpr size_t LEGACY_CACHE_HEADER_SIZE = sizeof(u32) * 2;
   std::string filename =
       File::GetUserPath(D_CACHE_IDX) + SConfig::GetInstance().GetGameID() + ".uidcache";
+
+  // Ensure the expected size matches the actual size of the file. If it doesn't, it means
+  // the cache file may be corrupted, and we should not proceed with loading potentially
+  // garbage or invalid UIDs.
+  const auto read_records = [this](size_t header_size, auto record, const auto& add_record) {
+    const u64 file_size = m_gx_pipeline_uid_cache_file.GetSize();
+    const size_t record_count = static_cast<size_t>(file_size - header_size) / sizeof(record);
+    if (file_size != record_count * sizeof(record) + header_size)
+      return false;
+
+    for (size_t i = 0; i < record_count; i++)
+    {
+      if (!m_gx_pipeline_uid_cache_file.ReadBytes(&record, sizeof(record)))
+        return false;
+
+      // This just adds the pipeline to the map, it is compiled later.
+      add_record(record);
+    }
+    return true;
+  };
+
   if (m_gx_pipeline_uid_cache_file.Open(filename, "rb+"))
   {
     // If an existing case exists, validate the version before reading entries.
     u32 existing_magic;
     u32 existing_version;
+    u32 existing_session;
     bool uid_file_valid = false;
     if (m_gx_pipeline_uid_cache_file.ReadBytes(&existing_magic, sizeof(existing_magic)) &&
         m_gx_pipeline_uid_cache_file.ReadBytes(&existing_version, sizeof(existing_version)) &&
-        existing_magic == CACHE_FILE_MAGIC && existing_version == GX_PIPELINE_UID_VERSION)
+        existing_version == GX_PIPELINE_UID_VERSION)
     {
-      // Ensure the expected size matches the actual size of the file. If it doesn't, it means
-      // the cache file may be corrupted, and we should not proceed with loading potentially
-      // garbage or invalid UIDs.
-      const u64 file_size = m_gx_pipeline_uid_cache_file.GetSize();
-      const size_t uid_count =
-          static_cast<size_t>(file_size - CACHE_HEADER_SIZE) / sizeof(SerializedGXPipelineUid);
-      const size_t expected_size = uid_count * sizeof(SerializedGXPipelineUid) + CACHE_HEADER_SIZE;
-      uid_file_valid = file_size == expected_size;
-      if (uid_file_valid)
+      if (existing_magic == UID_CACHE_FILE_MAGIC &&
+          m_gx_pipeline_uid_cache_file.ReadBytes(&existing_session, sizeof(existing_session)))
       {
-        for (size_t i = 0; i < uid_count; i++)
-        {
-          SerializedGXPipelineUid serialized_uid;
-          if (m_gx_pipeline_uid_cache_file.ReadBytes(&serialized_uid, sizeof(serialized_uid)))
-          {
-            // This just adds the pipeline to the map, it is compiled later.
-            AddSerializedGXPipelineUID(serialized_uid);
-          }
-          else
-          {
-            uid_file_valid = false;
-            break;
-          }
-        }
+        // The session counter is stored when the file is closed, so this session is the next one.
+        m_gx_pipeline_uid_cache_session = existing_session + 1;
+        uid_file_valid = read_records(
+            CACHE_HEADER_SIZE, SerializedGXPipelineUidCacheEntry{},
+            [this](const SerializedGXPipelineUidCacheEntry& entry) {
+              AddSerializedGXPipelineUID(entry);
+            });
+
+        // We open the file for reading and writing, so we must seek to the end before writing.
+        if (uid_file_valid)
+          uid_file_valid = m_gx_pipeline_uid_cache_file.Seek(0, SEEK_END);
+      }
+      else if (existing_magic == LEGACY_UID_CACHE_FILE_MAGIC)
+      {
+        // Keep the UIDs without any usage statistics. The file is left marked as invalid, so that
+        // it gets rewritten in the current format below.
+        read_records(LEGACY_CACHE_HEADER_SIZE, SerializedGXPipelineUid{},
+                     [this](const SerializedGXPipelineUid& uid) {
+                       AddSerializedGXPipelineUID({uid, 0, 0});
+                     });
       }
-
-      // We open the file for reading and writing, so we must seek to the end before writing.
-      if (uid_file_valid)
-        uid_file_valid = m_gx_pipeline_uid_cache_file.Seek(expected_size, SEEK_SET);
     }
 
     // If the file is invalid, close it. We re-open and truncate it below.
@@ -778,16 +828,10 @@ void ShaderCache::LoadPipelineUIDCache()
   {
     if (m_gx_pipeline_uid_cache_file.Open(filename, "wb"))
     {
-      // Write the version identifier.
-      m_gx_pipeline_uid_cache_file.WriteBytes(&CACHE_FILE_MAGIC, sizeof(GX_PIPELINE_UID_VERSION));
-      m_gx_pipeline_uid_cache_file.WriteBytes(&GX_PIPELINE_UID_VERSION,
-                                              sizeof(GX_PIPELINE_UID_VERSION));
-
       // Write any current UIDs out to the file.
       // This way, if we load a UID cache where the data was incomplete (e.g. Dolphin crashed),
       // we don't lose the existing UIDs which were previously at the beginning.
-      for (const auto& it : m_gx_pipeline_cache)
-        AppendGXPipelineUID(it.first);
+      WritePipelineUIDCache();
     }
   }
 
@@ -797,22 +841,50 @@ void ShaderCache::LoadPipelineUIDCache()
 
 void ShaderCache::ClosePipelineUIDCache()
 {
-  // This is left as a method in case we need to append extra data to the file in the future.
+  if (!m_gx_pipeline_uid_cache_file.IsOpen())
+    return;
+
+  // Rewrite the file with the usage statistics of this session. New UIDs were already appended as
+  // they were created, so if this fails, only the statistics of this session are lost.
+  if (!m_gx_pipeline_uid_cache_file.Seek(0, SEEK_SET) || !WritePipelineUIDCache() ||
+      !m_gx_pipeline_uid_cache_file.Resize(m_gx_pipeline_uid_cache_file.Tell()))
+  {
+    WARN_LOG(VIDEO, "Writing pipeline UID usage statistics to cache failed.");
+  }
   m_gx_pipeline_uid_cache_file.Close();
 }
 
-void ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid)
+bool ShaderCache::WritePipelineUIDCache()
 {
-  GXPipelineUid real_uid;
-  UnserializePipelineUid(uid, real_uid);
+  const u32 header[] = {UID_CACHE_FILE_MAGIC, GX_PIPELINE_UID_VERSION,
+                        m_gx_pipeline_uid_cache_session};
+  if (!m_gx_pipeline_uid_cache_file.WriteArray(header, std::size(header)))
+    return false;
 
-  auto iter = m_gx_pipeline_cache.find(real_uid);
-  if (iter != m_gx_pipeline_cache.end())
-    return;
+  std::vector<SerializedGXPipelineUidCacheEntry> entries;
+  entries.reserve(m_gx_pipeline_cache.size());
+  for (const auto& it : m_gx_pipeline_cache)
+  {
+    SerializedGXPipelineUidCacheEntry& entry = entries.emplace_back();
+    SerializePipelineUid(it.first, entry.uid);
+    entry.use_count = it.second.use_count + (it.second.used ? 1 : 0);
+    entry.last_used_session =
+        it.second.used ? m_gx_pipeline_uid_cache_session : it.second.last_used_session;
+  }
+  return m_gx_pipeline_uid_cache_file.WriteArray(entries.data(), entries.size());
+}
 
-  // Flag it as empty with a null pipeline object, for later compilation.
-  auto& entry = m_gx_pipeline_cache[real_uid];
-  entry.second = false;
+void ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUidCacheEntry& entry)
+{
+  GXPipelineUid real_uid;
+  UnserializePipelineUid(entry.uid, real_uid);
+
+  // Flag it as empty with a null pipeline object, for later compilation. Should the UID be in the
+  // file twice, keep the highest statistics.
+  auto& cache_entry = m_gx_pipeline_cache[real_uid];
+  cache_entry.use_count = std::max(cache_entry.use_count, entry.use_count);
+  cache_entry.last_used_session =
+      std::max(cache_entry.last_used_session, entry.last_used_session);
 }
 
 void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
@@ -820,9 +892,12 @@ void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
   if (!m_gx_pipeline_uid_cache_file.IsOpen())
     return;
 
-  SerializedGXPipelineUid disk_uid;
-  SerializePipelineUid(config, disk_uid);
-  if (!m_gx_pipeline_uid_cache_file.WriteBytes(&disk_uid, sizeof(disk_uid)))
+  // The statistics are counted from this session, in case the file isn't rewritten on close.
+  SerializedGXPipelineUidCacheEntry disk_entry;
+  SerializePipelineUid(config, disk_entry.uid);
+  disk_entry.use_count = 1;
+  disk_entry.last_used_session = m_gx_pipeline_uid_cache_session;
+  if (!m_gx_pipeline_uid_cache_file.WriteBytes(&disk_entry, sizeof(disk_entry)))
   {
     WARN_LOG(VIDEO, "Writing pipeline UID to cache failed, closing file.");
     m_gx_pipeline_uid_cache_file.Close();
@@ -1012,7 +1087,7 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
 
   auto wi = m_async_shader_compiler->CreateWorkItem<PipelineWorkItem>(this, uid, priority);
   m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
-  m_gx_pipeline_cache[uid].second = true;
+  m_gx_pipeline_cache[uid].pending = true;
 }
 
 void ShaderCache::QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 priority)
@@ -1085,7 +1160,7 @@ void ShaderCache::QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 pri
 
   auto wi = m_async_shader_compiler->CreateWorkItem<UberPipelineWorkItem>(this, uid, priority);
   m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
-  m_gx_uber_pipeline_cache[uid].second = true;
+  m_gx_uber_pipeline_cache[uid].pending = true;
 }
 
 void ShaderCache::QueueUberShaderPipelines()
@@ -1123,7 +1198,7 @@ void ShaderCache::QueueUberShaderPipelines()
       return;
 
     auto& entry = m_gx_uber_pipeline_cache[config];
-    entry.second = false;
+    entry.pending = false;
   };
 
   // Populate the pipeline configs with empty entries, these will be compiled afterwards.
@@ -0,0 +1,79 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/StageProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "Common/Assert.h"
+
+namespace StageProfiler
+{
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// Deeper than any nesting of the stages, including display lists calling display lists.
+constexpr size_t MAX_DEPTH = 32;
+
+Times s_times;
+std::array<Stage, MAX_DEPTH> s_stack;
+size_t s_depth = 0;
+Clock::time_point s_last_change;
+
+// Charges the time since the last change to the innermost stage.
+void ChargeCurrentStage(Clock::time_point now)
+{
+  if (s_depth == 0)
+    return;
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - s_last_change);
+  s_times[static_cast<size_t>(s_stack[std::min(s_depth, MAX_DEPTH) - 1])] += elapsed.count();
+}
+}  // Anonymous namespace
+
+bool g_enabled = false;
+
+void SetEnabled(bool enabled)
+{
+  ASSERT(s_depth == 0);
+
+  g_enabled = enabled;
+  s_times = {};
+}
+
+Times GetTimes()
+{
+  return s_times;
+}
+
+const char* GetStageName(Stage stage)
+{
+  static constexpr std::array<const char*, NUM_STAGES> names = {
+      "decode", "vertex load", "texture", "shader uid", "draw",
+  };
+  return names[static_cast<size_t>(stage)];
+}
+
+void EnterStage(Stage stage)
+{
+  const Clock::time_point now = Clock::now();
+  ChargeCurrentStage(now);
+  s_last_change = now;
+
+  // Past the maximum depth, the time is charged to the deepest stage that fits.
+  if (s_depth < MAX_DEPTH)
+    s_stack[s_depth] = stage;
+  s_depth++;
+}
+
+void LeaveStage()
+{
+  const Clock::time_point now = Clock::now();
+  ChargeCurrentStage(now);
+  s_last_change = now;
+  s_depth--;
+}
+}  // namespace StageProfiler
@@ -0,0 +1,70 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "Common/CommonTypes.h"
+
+// Accumulates the CPU time the GPU thread spends in each stage of processing the FIFO. Stages
+// nest, and the time of a nested stage is only counted for that stage, not for the outer one.
+//
+// Profiling is disabled by default, which leaves a single branch per scope. It only supports the
+// GPU running on the CPU thread, as nothing synchronizes the totals.
+namespace StageProfiler
+{
+enum class Stage
+{
+  Decode,
+  VertexLoad,
+  TextureLoad,
+  ShaderUid,
+  Draw,
+  Count
+};
+
+constexpr size_t NUM_STAGES = static_cast<size_t>(Stage::Count);
+
+// Nanoseconds spent in each stage.
+using Times = std::array<u64, NUM_STAGES>;
+
+extern bool g_enabled;
+
+// Must not be called while any stage is being profiled.
+void SetEnabled(bool enabled);
+inline bool IsEnabled()
+{
+  return g_enabled;
+}
+
+// The totals since profiling was enabled.
+Times GetTimes();
+const char* GetStageName(Stage stage);
+
+void EnterStage(Stage stage);
+void LeaveStage();
+
+class Scope
+{
+public:
+  explicit Scope(Stage stage, bool active = true) : m_active(active && IsEnabled())
+  {
+    if (m_active)
+      EnterStage(stage);
+  }
+  ~Scope()
+  {
+    if (m_active)
+      LeaveStage();
+  }
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  bool m_active;
+};
+}  // namespace StageProfiler
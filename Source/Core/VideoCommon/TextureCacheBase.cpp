@@ -9,6 +9,7 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 #if defined(_M_X86) || defined(_M_X86_64)
@@ -20,6 +21,7 @@
 #include "Common/Align.h"
 #include "Common/Assert.h"
 #include "Common/ChunkFile.h"
+#include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
 #include "Common/Hash.h"
@@ -89,6 +91,9 @@ TextureCacheBase::TextureCacheBase()
   temp_size = 2048 * 2048 * 4;
   temp = static_cast<u8*>(Common::AllocateAlignedMemory(temp_size, 16));
 
+  m_decode_pool.SetWorkerCount(backup_config.texture_decoding_threads);
+  OpenDiskCache();
+
   TexDecoder_SetTexFmtOverlayOptions(backup_config.texfmt_overlay,
                                      backup_config.texfmt_overlay_center);
 
@@ -132,7 +137,8 @@ void TextureCacheBase::Invalidate()
     delete tex.second;
   }
   textures_by_address.clear();
-  textures_by_hash.clear();
+  textures_by_range.Clear();
+  textures_by_hash.Clear();
 
   texture_pool.clear();
 }
@@ -158,7 +164,17 @@ void TextureCacheBase::OnConfigChanged(const VideoConfig& config)
     TexDecoder_SetTexFmtOverlayOptions(config.bTexFmtOverlayEnable, config.bTexFmtOverlayCenter);
   }
 
+  if (config.GetTextureDecodingThreads() != backup_config.texture_decoding_threads)
+    m_decode_pool.SetWorkerCount(config.GetTextureDecodingThreads());
+
+  const bool reopen_disk_cache =
+      config.bTextureDiskCache != backup_config.texture_disk_cache ||
+      config.iTextureDiskCacheSize != backup_config.texture_disk_cache_size;
+
   SetBackupConfig(config);
+
+  if (reopen_disk_cache)
+    OpenDiskCache();
 }
 
 void TextureCacheBase::Cleanup(int _frameCount)
@@ -247,6 +263,20 @@ void TextureCacheBase::SetBackupConfig(const VideoConfig& config)
   backup_config.gpu_texture_decoding = config.bEnableGPUTextureDecoding;
   backup_config.disable_vram_copies = config.bDisableCopyToVRAM;
   backup_config.arbitrary_mipmap_detection = config.bArbitraryMipmapDetection;
+  backup_config.texture_decoding_threads = config.GetTextureDecodingThreads();
+  backup_config.texture_disk_cache = config.bTextureDiskCache;
+  backup_config.texture_disk_cache_size = config.iTextureDiskCacheSize;
+}
+
+void TextureCacheBase::OpenDiskCache()
+{
+  m_disk_cache.Close();
+  if (!backup_config.texture_disk_cache || backup_config.texture_disk_cache_size <= 0)
+    return;
+
+  const std::string filename = File::GetUserPath(D_CACHE_IDX) + "Textures" DIR_SEP +
+                               SConfig::GetInstance().GetGameID() + ".texcache";
+  m_disk_cache.Open(filename, static_cast<size_t>(backup_config.texture_disk_cache_size) << 20);
 }
 
 TextureCacheBase::TCacheEntry*
@@ -314,7 +344,7 @@ TextureCacheBase::ApplyPaletteToEntry(TCacheEntry* entry, u8* palette, TLUTForma
     g_renderer->EndUtilityDrawing();
   }
 
-  textures_by_address.emplace(decoded_entry->addr, decoded_entry);
+  AddTextureToCache(decoded_entry->addr, decoded_entry);
 
   return decoded_entry;
 }
@@ -361,7 +391,7 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::ReinterpretEntry(const TCacheEn
   g_renderer->EndUtilityDrawing();
   reinterpreted_entry->texture->FinishedRendering();
 
-  textures_by_address.emplace(reinterpreted_entry->addr, reinterpreted_entry);
+  AddTextureToCache(reinterpreted_entry->addr, reinterpreted_entry);
 
   return reinterpreted_entry;
 }
@@ -555,14 +585,16 @@ void TextureCacheBase::DoSaveState(PointerWrap& p)
         textures_by_address_list.emplace_back(it.first, id);
       }
     }
-    for (const auto& it : textures_by_hash)
-    {
-      if (ShouldSaveEntry(it.second))
+    textures_by_hash.ForEach([&](u64 hash, const std::vector<TCacheEntry*>& entries) {
+      for (TCacheEntry* entry : entries)
       {
-        const u32 id = AddCacheEntryToMap(it.second);
-        textures_by_hash_list.emplace_back(it.first, id);
+        if (ShouldSaveEntry(entry))
+        {
+          const u32 id = AddCacheEntryToMap(entry);
+          textures_by_hash_list.emplace_back(hash, id);
+        }
       }
-    }
+    });
   }
 
   // Save the texture cache entries out in the order the were referenced.
@@ -652,7 +684,6 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
     // to update the point in the state state. We'll just throw it away if it's invalid.
     auto tex = DeserializeTexture(p);
     TCacheEntry* entry = new TCacheEntry(std::move(tex->texture), std::move(tex->framebuffer));
-    entry->textures_by_hash_iter = textures_by_hash.end();
     entry->DoState(p);
     if (entry->texture && commit_state)
       id_map.emplace(i, entry);
@@ -685,7 +716,7 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
 
     TCacheEntry* entry = GetEntry(id);
     if (entry)
-      textures_by_address.emplace(addr, entry);
+      AddTextureToCache(addr, entry);
   }
 
   // Fill in hash map.
@@ -699,7 +730,7 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
 
     TCacheEntry* entry = GetEntry(id);
     if (entry)
-      entry->textures_by_hash_iter = textures_by_hash.emplace(hash, entry);
+      AddTextureToHashCache(hash, entry);
   }
 }
 
@@ -752,10 +783,10 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u8* pale
 
   u32 numBlocksX = (entry_to_update->native_width + block_width - 1) / block_width;
 
-  auto iter = FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes);
-  while (iter.first != iter.second)
+  for (TexAddrCache::iterator iter :
+       FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes))
   {
-    TCacheEntry* entry = iter.first->second;
+    TCacheEntry* entry = iter->second;
     if (entry != entry_to_update && entry->IsCopy() && !entry->tmem_only &&
         entry->references.count(entry_to_update) == 0 &&
         entry->OverlapsMemoryRange(entry_to_update->addr, entry_to_update->size_in_bytes) &&
@@ -767,10 +798,7 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u8* pale
         if (!IsCompatibleTextureFormat(entry_to_update->format.texfmt, entry->format.texfmt))
         {
           if (!CanReinterpretTextureOnGPU(entry_to_update->format.texfmt, entry->format.texfmt))
-          {
-            ++iter.first;
             continue;
-          }
 
           TCacheEntry* reinterpreted_entry =
               ReinterpretEntry(entry, entry_to_update->format.texfmt);
@@ -792,7 +820,6 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u8* pale
           }
           else
           {
-            ++iter.first;
             continue;
           }
         }
@@ -854,7 +881,6 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u8* pale
             static_cast<u32>(dst_x + copy_width) > entry_to_update->GetWidth() ||
             static_cast<u32>(dst_y + copy_height) > entry_to_update->GetHeight())
         {
-          ++iter.first;
           continue;
         }
 
@@ -880,7 +906,7 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u8* pale
         {
           // Remove the temporary converted texture, it won't be used anywhere else
           // TODO: It would be nice to convert and copy in one step, but this code path isn't common
-          iter.first = InvalidateTexture(iter.first);
+          InvalidateTexture(iter);
           continue;
         }
         else
@@ -894,11 +920,9 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u8* pale
       else
       {
         // If the hash does not match, this EFB copy will not be used for anything, so remove it
-        iter.first = InvalidateTexture(iter.first);
-        continue;
+        InvalidateTexture(iter);
       }
     }
-    ++iter.first;
   }
 
   return entry_to_update;
@@ -1471,23 +1495,21 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
   // textures cause unnecessary slowdowns
   // Example: Tales of Symphonia (GC) uses over 500 small textures in menus, but only around 70
   // different ones
-  if (textureCacheSafetyColorSampleSize == 0 ||
-      std::max(texture_size, palette_size) <= (u32)textureCacheSafetyColorSampleSize * 8)
+  const std::vector<TCacheEntry*>* hash_entries = textures_by_hash.Find(full_hash);
+  if (hash_entries && (textureCacheSafetyColorSampleSize == 0 ||
+                       std::max(texture_size, palette_size) <=
+                           (u32)textureCacheSafetyColorSampleSize * 8))
   {
-    auto hash_range = textures_by_hash.equal_range(full_hash);
-    TexHashCache::iterator hash_iter = hash_range.first;
-    while (hash_iter != hash_range.second)
+    for (TCacheEntry* entry : *hash_entries)
     {
-      TCacheEntry* entry = hash_iter->second;
       // All parameters, except the address, need to match here
       if (entry->format == full_format && entry->native_levels >= tex_levels &&
           entry->native_width == nativeW && entry->native_height == nativeH)
       {
-        entry = DoPartialTextureUpdates(hash_iter->second, &texMem[tlutaddr], tlutfmt);
+        entry = DoPartialTextureUpdates(entry, &texMem[tlutaddr], tlutfmt);
         entry->texture->FinishedRendering();
         return entry;
       }
-      ++hash_iter;
     }
   }
 
@@ -1537,6 +1559,35 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
 
   ArbitraryMipmapDetector arbitrary_mip_detector;
   const u8* tlut = &texMem[tlutaddr];
+
+  // Textures which are decoded on the CPU can be loaded from the disk cache instead. The sampled
+  // hashes above can't tell apart textures across sessions, so the key uses full hashes.
+  const bool use_disk_cache = m_disk_cache.IsOpen() && !hires_tex && !decode_on_gpu &&
+                              !from_tmem && !backup_config.texfmt_overlay;
+  TextureDiskCache::Key disk_cache_key{};
+  const std::vector<u8>* disk_cache_data = nullptr;
+  if (use_disk_cache)
+  {
+    disk_cache_key = {Common::GetHash64(src_data, texture_size + additional_mips_size, 0),
+                      isPaletteTexture ? Common::GetHash64(tlut, palette_size, 0) : 0,
+                      static_cast<u32>(texformat),
+                      static_cast<u32>(tlutfmt),
+                      width,
+                      height,
+                      texLevels};
+
+    size_t decoded_size = 0;
+    for (u32 level = 0; level != texLevels; ++level)
+    {
+      decoded_size += Common::AlignUp(CalculateLevelSize(width, level), bsw) *
+                      Common::AlignUp(CalculateLevelSize(height, level), bsh) * sizeof(u32);
+    }
+
+    disk_cache_data = m_disk_cache.Lookup(disk_cache_key);
+    if (disk_cache_data && disk_cache_data->size() != decoded_size)
+      disk_cache_data = nullptr;
+  }
+
   if (hires_tex)
   {
     const auto& level = hires_tex->m_levels[0];
@@ -1547,6 +1598,30 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
   // Initialized to null because only software loading uses this buffer
   u8* dst_buffer = nullptr;
 
+  // Levels which are decoded on the CPU. They are decoded all at once after the mipmaps have been
+  // set up, and uploaded when decoding has finished.
+  struct DecodedLevel
+  {
+    u32 level;
+    u32 width;
+    u32 height;
+    u32 row_length;
+    const u8* data;
+    size_t size;
+  };
+  std::vector<DecodedLevel> decoded_levels;
+  const auto queue_decode = [&](u8* dst, const u8* src, u32 decode_width, u32 decode_height) {
+    // Cached levels are copied all at once before the first level.
+    if (disk_cache_data)
+      return;
+
+    // The format overlay is drawn by the decoder, so it would show up once for every band.
+    if (backup_config.texfmt_overlay)
+      TexDecoder_Decode(dst, src, decode_width, decode_height, texformat, tlut, tlutfmt);
+    else
+      m_decode_pool.QueueLevel(dst, src, decode_width, decode_height, texformat, tlut, tlutfmt);
+  };
+
   if (!hires_tex)
   {
     if (!decode_on_gpu ||
@@ -1574,10 +1649,12 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
 
       CheckTempSize(total_texture_size);
       dst_buffer = temp;
+      if (disk_cache_data)
+        std::memcpy(dst_buffer, disk_cache_data->data(), disk_cache_data->size());
+
       if (!(texformat == TextureFormat::RGBA8 && from_tmem))
       {
-        TexDecoder_Decode(dst_buffer, src_data, expandedWidth, expandedHeight, texformat, tlut,
-                          tlutfmt);
+        queue_decode(dst_buffer, src_data, expandedWidth, expandedHeight);
       }
       else
       {
@@ -1586,21 +1663,12 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
                                        expandedHeight);
       }
 
-      entry->texture->Load(0, width, height, expandedWidth, dst_buffer, decoded_texture_size);
-
-      arbitrary_mip_detector.AddLevel(width, height, expandedWidth, dst_buffer);
-
+      decoded_levels.push_back(
+          {0, width, height, expandedWidth, dst_buffer, decoded_texture_size});
       dst_buffer += decoded_texture_size;
     }
   }
 
-  iter = textures_by_address.emplace(address, entry);
-  if (textureCacheSafetyColorSampleSize == 0 ||
-      std::max(texture_size, palette_size) <= (u32)textureCacheSafetyColorSampleSize * 8)
-  {
-    entry->textures_by_hash_iter = textures_by_hash.emplace(full_hash, entry);
-  }
-
   entry->SetGeneralParameters(address, texture_size, full_format, false);
   entry->SetDimensions(nativeW, nativeH, tex_levels);
   entry->SetHashes(base_hash, full_hash);
@@ -1608,6 +1676,13 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
   entry->memory_stride = entry->BytesPerRow();
   entry->SetNotCopy();
 
+  iter = AddTextureToCache(address, entry);
+  if (textureCacheSafetyColorSampleSize == 0 ||
+      std::max(texture_size, palette_size) <= (u32)textureCacheSafetyColorSampleSize * 8)
+  {
+    AddTextureToHashCache(full_hash, entry);
+  }
+
   std::string basename;
   if (g_ActiveConfig.bDumpTextures && !hires_tex)
   {
@@ -1655,18 +1730,25 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
       {
         // No need to call CheckTempSize here, as the whole buffer is preallocated at the beginning
         const u32 decoded_mip_size = expanded_mip_width * sizeof(u32) * expanded_mip_height;
-        TexDecoder_Decode(dst_buffer, mip_src_data, expanded_mip_width, expanded_mip_height,
-                          texformat, tlut, tlutfmt);
-        entry->texture->Load(level, mip_width, mip_height, expanded_mip_width, dst_buffer,
-                             decoded_mip_size);
-
-        arbitrary_mip_detector.AddLevel(mip_width, mip_height, expanded_mip_width, dst_buffer);
-
+        queue_decode(dst_buffer, mip_src_data, expanded_mip_width, expanded_mip_height);
+        decoded_levels.push_back(
+            {level, mip_width, mip_height, expanded_mip_width, dst_buffer, decoded_mip_size});
         dst_buffer += decoded_mip_size;
       }
 
       mip_src_data += mip_size;
     }
+
+    m_decode_pool.Flush();
+    for (const DecodedLevel& level : decoded_levels)
+    {
+      entry->texture->Load(level.level, level.width, level.height, level.row_length, level.data,
+                           level.size);
+      arbitrary_mip_detector.AddLevel(level.width, level.height, level.row_length, level.data);
+    }
+
+    if (use_disk_cache && !disk_cache_data)
+      m_disk_cache.Insert(disk_cache_key, temp, static_cast<size_t>(dst_buffer - temp));
   }
 
   entry->has_arbitrary_mips = hires_tex ? hires_tex->HasArbitraryMipmaps() :
@@ -1756,7 +1838,7 @@ TextureCacheBase::GetXFBTexture(u32 address, u32 width, u32 height, u32 stride,
   entry->texture->FinishedRendering();
 
   // Insert into the texture cache so we can re-use it next frame, if needed.
-  textures_by_address.emplace(entry->addr, entry);
+  AddTextureToCache(entry->addr, entry);
   SETSTAT(g_stats.num_textures_alive, static_cast<int>(textures_by_address.size()));
   INCSTAT(g_stats.num_textures_uploaded);
 
@@ -1826,15 +1908,15 @@ void TextureCacheBase::StitchXFBCopy(TCacheEntry* stitched_entry)
   std::vector<TCacheEntry*> candidates;
   bool create_upscaled_copy = false;
 
-  auto iter = FindOverlappingTextures(stitched_entry->addr, stitched_entry->size_in_bytes);
-  while (iter.first != iter.second)
+  for (TexAddrCache::iterator iter :
+       FindOverlappingTextures(stitched_entry->addr, stitched_entry->size_in_bytes))
   {
     // Currently, this checks the stride of the VRAM copy against the VI request. Therefore, for
     // interlaced modes, VRAM copies won't be considered candidates. This is okay for now, because
     // our force progressive hack means that an XFB copy should always have a matching stride. If
     // the hack is disabled, XFB2RAM should also be enabled. Should we wish to implement interlaced
     // stitching in the future, this would require a shader which grabs every second line.
-    TCacheEntry* entry = iter.first->second;
+    TCacheEntry* entry = iter->second;
     if (entry != stitched_entry && entry->IsCopy() && !entry->tmem_only &&
         entry->OverlapsMemoryRange(stitched_entry->addr, stitched_entry->size_in_bytes) &&
         entry->memory_stride == stitched_entry->memory_stride)
@@ -1850,11 +1932,9 @@ void TextureCacheBase::StitchXFBCopy(TCacheEntry* stitched_entry)
       else
       {
         // If the hash does not match, this EFB copy will not be used for anything, so remove it
-        iter.first = InvalidateTexture(iter.first);
-        continue;
+        InvalidateTexture(iter);
       }
     }
-    ++iter.first;
   }
 
   if (candidates.empty())
@@ -2246,10 +2326,9 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   // as our efb copy are marked to check them for partial texture updates.
   // TODO: The logic to detect overlapping strided efb copies is not 100% accurate.
   bool strided_efb_copy = dstStride != bytes_per_row;
-  auto iter = FindOverlappingTextures(dstAddr, covered_range);
-  while (iter.first != iter.second)
+  for (TexAddrCache::iterator iter : FindOverlappingTextures(dstAddr, covered_range))
   {
-    TCacheEntry* overlapping_entry = iter.first->second;
+    TCacheEntry* overlapping_entry = iter->second;
 
     if (overlapping_entry->addr == dstAddr && overlapping_entry->is_xfb_copy)
     {
@@ -2271,7 +2350,7 @@ void TextureCacheBase::CopyRenderTargetToTexture(
       {
         // Pending EFB copies which are completely covered by this new copy can simply be tossed,
         // instead of having to flush them later on, since this copy will write over everything.
-        iter.first = InvalidateTexture(iter.first, true);
+        InvalidateTexture(iter, true);
         continue;
       }
 
@@ -2295,13 +2374,8 @@ void TextureCacheBase::CopyRenderTargetToTexture(
 
       // Do not load textures by hash, if they were at least partly overwritten by an efb copy.
       // In this case, comparing the hash is not enough to check, if two textures are identical.
-      if (overlapping_entry->textures_by_hash_iter != textures_by_hash.end())
-      {
-        textures_by_hash.erase(overlapping_entry->textures_by_hash_iter);
-        overlapping_entry->textures_by_hash_iter = textures_by_hash.end();
-      }
+      RemoveTextureFromHashCache(overlapping_entry);
     }
-    ++iter.first;
   }
 
   if (OpcodeDecoder::g_record_fifo_data)
@@ -2322,7 +2396,7 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   {
     const u64 hash = entry->CalculateHash();
     entry->SetHashes(hash, hash);
-    textures_by_address.emplace(dstAddr, entry);
+    AddTextureToCache(dstAddr, entry);
   }
 }
 
@@ -2370,8 +2444,7 @@ void TextureCacheBase::FlushEFBCopy(TCacheEntry* entry)
   if (entry->is_xfb_copy)
   {
     const u32 covered_range = entry->pending_efb_copy_height * entry->memory_stride;
-    auto range = FindOverlappingTextures(entry->addr, covered_range);
-    for (auto iter = range.first; iter != range.second; ++iter)
+    for (TexAddrCache::iterator iter : FindOverlappingTextures(entry->addr, covered_range))
     {
       TCacheEntry* overlapping_entry = iter->second;
       if (overlapping_entry->may_have_overlapping_textures && overlapping_entry->is_xfb_copy &&
@@ -2457,7 +2530,6 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::AllocateCacheEntry(const Textur
 
   TCacheEntry* cacheEntry =
       new TCacheEntry(std::move(alloc->texture), std::move(alloc->framebuffer));
-  cacheEntry->textures_by_hash_iter = textures_by_hash.end();
   cacheEntry->id = last_entry_id++;
   return cacheEntry;
 }
@@ -2528,21 +2600,50 @@ TextureCacheBase::GetTexCacheIter(TextureCacheBase::TCacheEntry* entry)
   return textures_by_address.end();
 }
 
-std::pair<TextureCacheBase::TexAddrCache::iterator, TextureCacheBase::TexAddrCache::iterator>
-TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
+TextureCacheBase::TexAddrCache::iterator TextureCacheBase::AddTextureToCache(u32 addr,
+                                                                              TCacheEntry* entry)
+{
+  const auto iter = textures_by_address.emplace(addr, entry);
+  textures_by_range.Add(addr, entry->size_in_bytes, iter);
+  return iter;
+}
+
+void TextureCacheBase::AddTextureToHashCache(u64 hash, TCacheEntry* entry)
 {
-  // We index by the starting address only, so there is no way to query all textures
-  // which end after the given addr. But the GC textures have a limited size, so we
-  // look for all textures which have a start address bigger than addr minus the maximal
-  // texture size. But this yields false-positives which must be checked later on.
+  textures_by_hash[hash].push_back(entry);
+  entry->textures_by_hash_key = hash;
+}
 
-  // 1024 x 1024 texel times 8 nibbles per texel
-  constexpr u32 max_texture_size = 1024 * 1024 * 4;
-  u32 lower_addr = addr > max_texture_size ? addr - max_texture_size : 0;
-  auto begin = textures_by_address.lower_bound(lower_addr);
-  auto end = textures_by_address.upper_bound(addr + size_in_bytes);
+void TextureCacheBase::RemoveTextureFromHashCache(TCacheEntry* entry)
+{
+  if (!entry->textures_by_hash_key)
+    return;
 
-  return std::make_pair(begin, end);
+  std::vector<TCacheEntry*>* entries = textures_by_hash.Find(*entry->textures_by_hash_key);
+  if (entries)
+  {
+    entries->erase(std::find(entries->begin(), entries->end(), entry));
+    if (entries->empty())
+      textures_by_hash.Erase(*entry->textures_by_hash_key);
+  }
+  entry->textures_by_hash_key.reset();
+}
+
+std::vector<TextureCacheBase::TexAddrCache::iterator>
+TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
+{
+  std::vector<TexAddrCache::iterator> overlapping;
+  textures_by_range.ForEachOverlapping(
+      addr, size_in_bytes, [&overlapping](TexAddrCache::iterator iter) {
+        overlapping.push_back(iter);
+      });
+
+  // Callers apply partial updates in this order, so keep it the same as the order of
+  // textures_by_address, where entries at the same address are in the order they were added.
+  std::sort(overlapping.begin(), overlapping.end(), [](const auto& a, const auto& b) {
+    return std::tie(a->first, a->second->id) < std::tie(b->first, b->second->id);
+  });
+  return overlapping;
 }
 
 TextureCacheBase::TexAddrCache::iterator
@@ -2553,11 +2654,7 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
 
   TCacheEntry* entry = iter->second;
 
-  if (entry->textures_by_hash_iter != textures_by_hash.end())
-  {
-    textures_by_hash.erase(entry->textures_by_hash_iter);
-    entry->textures_by_hash_iter = textures_by_hash.end();
-  }
+  RemoveTextureFromHashCache(entry);
 
   for (size_t i = 0; i < bound_textures.size(); ++i)
   {
@@ -2597,6 +2694,8 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
     }
   }
 
+  textures_by_range.Remove(iter->first, entry->size_in_bytes, iter);
+
   auto config = entry->texture->GetConfig();
   texture_pool.emplace(config,
                        TexPoolEntry(std::move(entry->texture), std::move(entry->framebuffer)));
@@ -16,11 +16,15 @@
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/FlatHashMap.h"
 #include "Common/MathUtil.h"
 #include "VideoCommon/AbstractTexture.h"
+#include "VideoCommon/AddressRangeIndex.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/TextureConfig.h"
+#include "VideoCommon/TextureDecodePool.h"
 #include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/TextureDiskCache.h"
 
 class AbstractFramebuffer;
 class AbstractStagingTexture;
@@ -115,9 +119,9 @@ public:
     // used to delete textures which haven't been used for TEXTURE_KILL_THRESHOLD frames
     int frameCount = FRAMECOUNT_INVALID;
 
-    // Keep an iterator to the entry in textures_by_hash, so it does not need to be searched when
-    // removing the cache entry
-    std::multimap<u64, TCacheEntry*>::iterator textures_by_hash_iter;
+    // The hash this entry is stored under in textures_by_hash, if it is in there. This can differ
+    // from the current hash, as the hash of XFB copies is updated while they are in the cache.
+    std::optional<u64> textures_by_hash_key;
 
     // This is used to keep track of both:
     //   * efb copies used by this partially updated texture
@@ -276,12 +280,14 @@ protected:
 
 private:
   using TexAddrCache = std::multimap<u32, TCacheEntry*>;
-  using TexHashCache = std::multimap<u64, TCacheEntry*>;
+  // Entries with the same hash are kept in the order they were added.
+  using TexHashCache = Common::FlatHashMap<u64, std::vector<TCacheEntry*>>;
   using TexPool = std::unordered_multimap<TextureConfig, TexPoolEntry>;
 
   bool CreateUtilityTextures();
 
   void SetBackupConfig(const VideoConfig& config);
+  void OpenDiskCache();
 
   TCacheEntry* GetXFBFromCache(u32 address, u32 width, u32 height, u32 stride, u64 hash);
 
@@ -301,10 +307,14 @@ private:
   TexPool::iterator FindMatchingTextureFromPool(const TextureConfig& config);
   TexAddrCache::iterator GetTexCacheIter(TCacheEntry* entry);
 
-  // Return all possible overlapping textures. As addr+size of the textures is not
-  // indexed, this may return false positives.
-  std::pair<TexAddrCache::iterator, TexAddrCache::iterator>
-  FindOverlappingTextures(u32 addr, u32 size_in_bytes);
+  // Adds an entry to textures_by_address and the overlap index. The address and size of the entry
+  // must not change until it is removed again by InvalidateTexture.
+  TexAddrCache::iterator AddTextureToCache(u32 addr, TCacheEntry* entry);
+  void AddTextureToHashCache(u64 hash, TCacheEntry* entry);
+  void RemoveTextureFromHashCache(TCacheEntry* entry);
+
+  // Returns all textures which overlap the given memory range, ordered by address.
+  std::vector<TexAddrCache::iterator> FindOverlappingTextures(u32 addr, u32 size_in_bytes);
 
   // Removes and unlinks texture from texture cache and returns it to the pool
   TexAddrCache::iterator InvalidateTexture(TexAddrCache::iterator t_iter,
@@ -334,6 +344,7 @@ private:
   void DoLoadState(PointerWrap& p);
 
   TexAddrCache textures_by_address;
+  AddressRangeIndex<TexAddrCache::iterator> textures_by_range;
   TexHashCache textures_by_hash;
   TexPool texture_pool;
   u64 last_entry_id = 0;
@@ -352,6 +363,9 @@ private:
     bool gpu_texture_decoding;
     bool disable_vram_copies;
     bool arbitrary_mipmap_detection;
+    u32 texture_decoding_threads;
+    bool texture_disk_cache;
+    int texture_disk_cache_size;
   };
   BackupConfig backup_config = {};
 
@@ -362,6 +376,12 @@ private:
   // Decoding texture used for GPU texture decoding.
   std::unique_ptr<AbstractTexture> m_decoding_texture;
 
+  // Worker threads for decoding textures on the CPU.
+  TextureDecodePool m_decode_pool;
+
+  // Textures decoded on the CPU in earlier sessions of the running game.
+  TextureDiskCache m_disk_cache;
+
   // Pool of readback textures used for deferred EFB copies.
   std::vector<std::unique_ptr<AbstractStagingTexture>> m_efb_copy_staging_texture_pool;
 
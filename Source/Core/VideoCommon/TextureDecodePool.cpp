@@ -0,0 +1,124 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/TextureDecodePool.h"
+
+#include <algorithm>
+
+#include "Common/Align.h"
+#include "Common/Thread.h"
+
+// Levels below this size are not worth waking up another thread for, as they only take a few
+// microseconds to decode.
+constexpr u32 MIN_TEXELS_PER_JOB = 256 * 256;
+
+TextureDecodePool::~TextureDecodePool()
+{
+  StopWorkers();
+}
+
+void TextureDecodePool::SetWorkerCount(u32 count)
+{
+  if (count == m_workers.size())
+    return;
+
+  StopWorkers();
+
+  m_exit = false;
+  m_free_slots = 0;
+  m_running_workers = 0;
+  for (u32 i = 0; i < count; ++i)
+    m_workers.emplace_back(&TextureDecodePool::WorkerThread, this);
+}
+
+void TextureDecodePool::StopWorkers()
+{
+  {
+    std::lock_guard lk(m_mutex);
+    m_exit = true;
+  }
+  m_wakeup.notify_all();
+
+  for (std::thread& worker : m_workers)
+    worker.join();
+  m_workers.clear();
+}
+
+void TextureDecodePool::QueueLevel(u8* dst, const u8* src, u32 width, u32 height,
+                                   TextureFormat format, const u8* tlut, TLUTFormat tlut_format)
+{
+  const u32 block_height = static_cast<u32>(TexDecoder_GetBlockHeightInTexels(format));
+  const u32 band_height =
+      m_workers.empty() ? height :
+                          Common::AlignUp(std::max(MIN_TEXELS_PER_JOB / width, 1u), block_height);
+
+  for (u32 y = 0; y < height; y += band_height)
+  {
+    const u32 src_offset = static_cast<u32>(TexDecoder_GetTextureSizeInBytes(width, y, format));
+    m_jobs.push_back({dst + y * width * sizeof(u32), src + src_offset, width,
+                      std::min(band_height, height - y), format, tlut, tlut_format});
+  }
+}
+
+void TextureDecodePool::Flush()
+{
+  if (m_jobs.empty())
+    return;
+
+  m_next_job.store(0, std::memory_order_relaxed);
+
+  // The calling thread works on the jobs too, so only wake up workers for the remaining ones.
+  const u32 helpers = std::min(GetWorkerCount(), static_cast<u32>(m_jobs.size() - 1));
+  if (helpers != 0)
+  {
+    {
+      std::lock_guard lk(m_mutex);
+      m_free_slots = helpers;
+      m_running_workers = helpers;
+    }
+    m_wakeup.notify_all();
+  }
+
+  RunJobs();
+
+  if (helpers != 0)
+  {
+    std::unique_lock lk(m_mutex);
+    m_done.wait(lk, [this] { return m_running_workers == 0; });
+  }
+
+  m_jobs.clear();
+}
+
+void TextureDecodePool::RunJobs()
+{
+  for (size_t i = m_next_job.fetch_add(1); i < m_jobs.size(); i = m_next_job.fetch_add(1))
+  {
+    const Job& job = m_jobs[i];
+    TexDecoder_Decode(job.dst, job.src, job.width, job.height, job.format, job.tlut,
+                      job.tlut_format);
+  }
+}
+
+void TextureDecodePool::WorkerThread()
+{
+  Common::SetCurrentThreadName("Texture decoding worker");
+
+  std::unique_lock lk(m_mutex);
+  while (true)
+  {
+    m_wakeup.wait(lk, [this] { return m_exit || m_free_slots != 0; });
+    if (m_exit)
+      return;
+
+    --m_free_slots;
+    lk.unlock();
+
+    RunJobs();
+
+    lk.lock();
+    if (--m_running_workers == 0)
+      m_done.notify_one();
+  }
+}
@@ -0,0 +1,67 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecoder.h"
+
+// Decodes texture levels on a pool of worker threads. Levels are queued up while the texture is
+// being set up, and then decoded all at once by the workers and the calling thread together.
+// Large levels are split into bands of block rows so that a single big texture can make use of
+// all workers, while small levels are decoded as a single piece.
+class TextureDecodePool
+{
+public:
+  TextureDecodePool() = default;
+  ~TextureDecodePool();
+
+  // Changes the number of worker threads. With no workers, everything is decoded by the thread
+  // which calls Flush().
+  void SetWorkerCount(u32 count);
+  u32 GetWorkerCount() const { return static_cast<u32>(m_workers.size()); }
+
+  // Queues a texture level for decoding. width and height must be aligned to the block size of
+  // the format. The source data and palette have to stay valid until Flush() returns.
+  void QueueLevel(u8* dst, const u8* src, u32 width, u32 height, TextureFormat format,
+                  const u8* tlut, TLUTFormat tlut_format);
+
+  // Decodes all queued levels and waits for them to finish.
+  void Flush();
+
+private:
+  struct Job
+  {
+    u8* dst;
+    const u8* src;
+    u32 width;
+    u32 height;
+    TextureFormat format;
+    const u8* tlut;
+    TLUTFormat tlut_format;
+  };
+
+  void WorkerThread();
+  void RunJobs();
+  void StopWorkers();
+
+  std::vector<Job> m_jobs;
+  std::atomic<size_t> m_next_job{0};
+
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+  std::condition_variable m_done;
+  // Number of workers which should still pick up the current batch of jobs.
+  u32 m_free_slots = 0;
+  // Number of workers which are still working on the current batch of jobs.
+  u32 m_running_workers = 0;
+  bool m_exit = false;
+};
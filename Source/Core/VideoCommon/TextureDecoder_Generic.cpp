@@ -72,25 +72,29 @@ static inline u32 DecodePixel_Paletted(u16 pixel, TLUTFormat tlutfmt)
   }
 }
 
-static inline void DecodeBytes_C4(u32* dst, const u8* src, const u8* tlut_, TLUTFormat tlutfmt)
+// Converts the first `count` palette entries, so that C4 and C8 textures only need to look up
+// the final colors instead of converting every texel.
+static void DecodePalette(u32* palette, const u8* tlut_, TLUTFormat tlutfmt, int count)
+{
+  const u16* tlut = (const u16*)tlut_;
+  for (int i = 0; i < count; i++)
+    palette[i] = DecodePixel_Paletted(tlut[i], tlutfmt);
+}
+
+static inline void DecodeBytes_C4(u32* dst, const u8* src, const u32* palette)
 {
-  const u16* tlut = (u16*)tlut_;
   for (int x = 0; x < 4; x++)
   {
     u8 val = src[x];
-    *dst++ = DecodePixel_Paletted(tlut[val >> 4], tlutfmt);
-    *dst++ = DecodePixel_Paletted(tlut[val & 0xF], tlutfmt);
+    *dst++ = palette[val >> 4];
+    *dst++ = palette[val & 0xF];
   }
 }
 
-static inline void DecodeBytes_C8(u32* dst, const u8* src, const u8* tlut_, TLUTFormat tlutfmt)
+static inline void DecodeBytes_C8(u32* dst, const u8* src, const u32* palette)
 {
-  const u16* tlut = (u16*)tlut_;
   for (int x = 0; x < 8; x++)
-  {
-    u8 val = src[x];
-    *dst++ = DecodePixel_Paletted(tlut[val], tlutfmt);
-  }
+    *dst++ = palette[src[x]];
 }
 
 static inline void DecodeBytes_C14X2(u32* dst, const u16* src, const u8* tlut_, TLUTFormat tlutfmt)
@@ -204,11 +208,15 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
   switch (texformat)
   {
   case TextureFormat::C4:
+  {
+    u32 palette[16];
+    DecodePalette(palette, tlut, tlutfmt, 16);
     for (int y = 0; y < height; y += 8)
       for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
         for (int iy = 0, xStep = 8 * yStep; iy < 8; iy++, xStep++)
-          DecodeBytes_C4(dst + (y + iy) * width + x, src + 4 * xStep, tlut, tlutfmt);
-    break;
+          DecodeBytes_C4(dst + (y + iy) * width + x, src + 4 * xStep, palette);
+  }
+  break;
   case TextureFormat::I4:
   {
     // Reference C implementation:
@@ -256,11 +264,15 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
   }
   break;
   case TextureFormat::C8:
+  {
+    u32 palette[256];
+    DecodePalette(palette, tlut, tlutfmt, 256);
     for (int y = 0; y < height; y += 4)
       for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
         for (int iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
-          DecodeBytes_C8((u32*)dst + (y + iy) * width + x, src + 8 * xStep, tlut, tlutfmt);
-    break;
+          DecodeBytes_C8((u32*)dst + (y + iy) * width + x, src + 8 * xStep, palette);
+  }
+  break;
   case TextureFormat::IA4:
   {
     for (int y = 0; y < height; y += 4)
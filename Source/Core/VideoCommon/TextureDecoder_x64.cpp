@@ -58,66 +58,45 @@ static inline u32 DecodePixel_RGB5A3(u16 val)
   return r | (g << 8) | (b << 16) | (a << 24);
 }
 
-static inline void DecodeBytes_C4_IA8(u32* dst, const u8* src, const u8* tlut_)
+// Converts the first `count` palette entries, so that C4 and C8 textures only need to look up
+// the final colors instead of converting every texel.
+static void DecodePalette(u32* palette, const u8* tlut_, TLUTFormat tlutfmt, int count)
 {
-  const u16* tlut = (u16*)tlut_;
-  for (int x = 0; x < 4; x++)
-  {
-    u8 val = src[x];
-    *dst++ = DecodePixel_IA8(tlut[val >> 4]);
-    *dst++ = DecodePixel_IA8(tlut[val & 0xF]);
-  }
-}
-
-static inline void DecodeBytes_C4_RGB565(u32* dst, const u8* src, const u8* tlut_)
-{
-  const u16* tlut = (u16*)tlut_;
-  for (int x = 0; x < 4; x++)
+  const u16* tlut = (const u16*)tlut_;
+  switch (tlutfmt)
   {
-    u8 val = src[x];
-    *dst++ = DecodePixel_RGB565(Common::swap16(tlut[val >> 4]));
-    *dst++ = DecodePixel_RGB565(Common::swap16(tlut[val & 0xF]));
+  case TLUTFormat::IA8:
+    for (int i = 0; i < count; i++)
+      palette[i] = DecodePixel_IA8(tlut[i]);
+    break;
+  case TLUTFormat::RGB565:
+    for (int i = 0; i < count; i++)
+      palette[i] = DecodePixel_RGB565(Common::swap16(tlut[i]));
+    break;
+  case TLUTFormat::RGB5A3:
+    for (int i = 0; i < count; i++)
+      palette[i] = DecodePixel_RGB5A3(Common::swap16(tlut[i]));
+    break;
+  default:
+    std::fill(palette, palette + count, 0);
+    break;
   }
 }
 
-static inline void DecodeBytes_C4_RGB5A3(u32* dst, const u8* src, const u8* tlut_)
+static inline void DecodeBytes_C4(u32* dst, const u8* src, const u32* palette)
 {
-  const u16* tlut = (u16*)tlut_;
   for (int x = 0; x < 4; x++)
   {
     u8 val = src[x];
-    *dst++ = DecodePixel_RGB5A3(Common::swap16(tlut[val >> 4]));
-    *dst++ = DecodePixel_RGB5A3(Common::swap16(tlut[val & 0xF]));
+    *dst++ = palette[val >> 4];
+    *dst++ = palette[val & 0xF];
   }
 }
 
-static inline void DecodeBytes_C8_IA8(u32* dst, const u8* src, const u8* tlut_)
+static inline void DecodeBytes_C8(u32* dst, const u8* src, const u32* palette)
 {
-  const u16* tlut = (u16*)tlut_;
   for (int x = 0; x < 8; x++)
-  {
-    *dst++ = DecodePixel_IA8(tlut[src[x]]);
-  }
-}
-
-static inline void DecodeBytes_C8_RGB565(u32* dst, const u8* src, const u8* tlut_)
-{
-  const u16* tlut = (u16*)tlut_;
-  for (int x = 0; x < 8; x++)
-  {
-    u8 val = src[x];
-    *dst++ = DecodePixel_RGB565(Common::swap16(tlut[val]));
-  }
-}
-
-static inline void DecodeBytes_C8_RGB5A3(u32* dst, const u8* src, const u8* tlut_)
-{
-  const u16* tlut = (u16*)tlut_;
-  for (int x = 0; x < 8; x++)
-  {
-    u8 val = src[x];
-    *dst++ = DecodePixel_RGB5A3(Common::swap16(tlut[val]));
-  }
+    *dst++ = palette[src[x]];
 }
 
 static inline void DecodeBytes_C14X2_IA8(u32* dst, const u16* src, const u8* tlut_)
@@ -150,17 +129,6 @@ static inline void DecodeBytes_C14X2_RGB5A3(u32* dst, const u16* src, const u8*
   }
 }
 
-static inline void DecodeBytes_IA4(u32* dst, const u8* src)
-{
-  for (int x = 0; x < 8; x++)
-  {
-    const u8 val = src[x];
-    u8 a = Convert4To8(val >> 4);
-    u8 l = Convert4To8(val & 0xF);
-    dst[x] = (a << 24) | l << 16 | l << 8 | l;
-  }
-}
-
 #ifdef CHECK
 static void DecodeDXTBlock(u32* dst, const DXTBlock* src, int pitch)
 {
@@ -216,37 +184,66 @@ static void TexDecoder_DecodeImpl_C4(u32* dst, const u8* src, int width, int hei
                                      TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                      int Wsteps4, int Wsteps8)
 {
-  switch (tlutfmt)
-  {
-  case TLUTFormat::RGB5A3:
-  {
-    for (int y = 0; y < height; y += 8)
-      for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
-        for (int iy = 0, xStep = 8 * yStep; iy < 8; iy++, xStep++)
-          DecodeBytes_C4_RGB5A3(dst + (y + iy) * width + x, src + 4 * xStep, tlut);
-  }
-  break;
+  u32 palette[16];
+  DecodePalette(palette, tlut, tlutfmt, 16);
 
-  case TLUTFormat::IA8:
-  {
-    for (int y = 0; y < height; y += 8)
-      for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
-        for (int iy = 0, xStep = 8 * yStep; iy < 8; iy++, xStep++)
-          DecodeBytes_C4_IA8(dst + (y + iy) * width + x, src + 4 * xStep, tlut);
-  }
-  break;
+  for (int y = 0; y < height; y += 8)
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+      for (int iy = 0, xStep = 8 * yStep; iy < 8; iy++, xStep++)
+        DecodeBytes_C4(dst + (y + iy) * width + x, src + 4 * xStep, palette);
+}
 
-  case TLUTFormat::RGB565:
+FUNCTION_TARGET_SSSE3
+static void TexDecoder_DecodeImpl_C4_SSSE3(u32* dst, const u8* src, int width, int height,
+                                           TextureFormat texformat, const u8* tlut,
+                                           TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // The 16 palette colors fit into one register per channel, so the lookups can be done with
+  // pshufb, using the 4-bit indices directly as shuffle indices.
+  u32 palette[16];
+  DecodePalette(palette, tlut, tlutfmt, 16);
+  alignas(16) u8 channels[4][16];
+  for (int i = 0; i < 16; i++)
   {
-    for (int y = 0; y < height; y += 8)
-      for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
-        for (int iy = 0, xStep = 8 * yStep; iy < 8; iy++, xStep++)
-          DecodeBytes_C4_RGB565(dst + (y + iy) * width + x, src + 4 * xStep, tlut);
+    for (int c = 0; c < 4; c++)
+      channels[c][i] = static_cast<u8>(palette[i] >> (8 * c));
   }
-  break;
+  const __m128i r = _mm_load_si128((const __m128i*)channels[0]);
+  const __m128i g = _mm_load_si128((const __m128i*)channels[1]);
+  const __m128i b = _mm_load_si128((const __m128i*)channels[2]);
+  const __m128i a = _mm_load_si128((const __m128i*)channels[3]);
+  const __m128i kMask_x0f = _mm_set1_epi8(0x0f);
 
-  default:
-    break;
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 8 * yStep; iy < 8; iy += 2, xStep += 2)
+      {
+        // Two rows of 8 texels each. The high nibble of each byte is the left texel.
+        const __m128i packed = _mm_loadl_epi64((const __m128i*)(src + 4 * xStep));
+        const __m128i left = _mm_and_si128(_mm_srli_epi16(packed, 4), kMask_x0f);
+        const __m128i right = _mm_and_si128(packed, kMask_x0f);
+        const __m128i indices = _mm_unpacklo_epi8(left, right);
+
+        const __m128i rv = _mm_shuffle_epi8(r, indices);
+        const __m128i gv = _mm_shuffle_epi8(g, indices);
+        const __m128i bv = _mm_shuffle_epi8(b, indices);
+        const __m128i av = _mm_shuffle_epi8(a, indices);
+
+        const __m128i rg0 = _mm_unpacklo_epi8(rv, gv);
+        const __m128i ba0 = _mm_unpacklo_epi8(bv, av);
+        const __m128i rg1 = _mm_unpackhi_epi8(rv, gv);
+        const __m128i ba1 = _mm_unpackhi_epi8(bv, av);
+
+        __m128i* row0 = (__m128i*)(dst + (y + iy) * width + x);
+        __m128i* row1 = (__m128i*)(dst + (y + iy + 1) * width + x);
+        _mm_storeu_si128(row0, _mm_unpacklo_epi16(rg0, ba0));
+        _mm_storeu_si128(row0 + 1, _mm_unpackhi_epi16(rg0, ba0));
+        _mm_storeu_si128(row1, _mm_unpacklo_epi16(rg1, ba1));
+        _mm_storeu_si128(row1 + 1, _mm_unpackhi_epi16(rg1, ba1));
+      }
+    }
   }
 }
 
@@ -525,37 +522,35 @@ static void TexDecoder_DecodeImpl_C8(u32* dst, const u8* src, int width, int hei
                                      TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                      int Wsteps4, int Wsteps8)
 {
-  switch (tlutfmt)
-  {
-  case TLUTFormat::RGB5A3:
-  {
-    for (int y = 0; y < height; y += 4)
-      for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
-        for (int iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
-          DecodeBytes_C8_RGB5A3((u32*)dst + (y + iy) * width + x, src + 8 * xStep, tlut);
-  }
-  break;
+  u32 palette[256];
+  DecodePalette(palette, tlut, tlutfmt, 256);
 
-  case TLUTFormat::IA8:
-  {
-    for (int y = 0; y < height; y += 4)
-      for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
-        for (int iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
-          DecodeBytes_C8_IA8(dst + (y + iy) * width + x, src + 8 * xStep, tlut);
-  }
-  break;
+  for (int y = 0; y < height; y += 4)
+    for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
+        DecodeBytes_C8(dst + (y + iy) * width + x, src + 8 * xStep, palette);
+}
 
-  case TLUTFormat::RGB565:
-  {
-    for (int y = 0; y < height; y += 4)
-      for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
-        for (int iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
-          DecodeBytes_C8_RGB565(dst + (y + iy) * width + x, src + 8 * xStep, tlut);
-  }
-  break;
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C8_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  u32 palette[256];
+  DecodePalette(palette, tlut, tlutfmt, 256);
 
-  default:
-    break;
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
+      {
+        const __m256i indices =
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + 8 * xStep)));
+        const __m256i colors = _mm256_i32gather_epi32((const int*)palette, indices, 4);
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x), colors);
+      }
+    }
   }
 }
 
@@ -563,13 +558,35 @@ static void TexDecoder_DecodeImpl_IA4(u32* dst, const u8* src, int width, int he
                                       TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                       int Wsteps4, int Wsteps8)
 {
+  const __m128i kMask_x0f = _mm_set1_epi8(0x0f);
   for (int y = 0; y < height; y += 4)
   {
     for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
     {
-      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
       {
-        DecodeBytes_IA4(dst + (y + iy) * width + x, src + 8 * xStep);
+        // Two rows of 8 texels each, with the alpha in the high nibble and the intensity in the
+        // low nibble of each byte.
+        const __m128i r0 = _mm_loadu_si128((const __m128i*)(src + 8 * xStep));
+
+        // Expand both nibbles to 8 bits by replicating them: 0000abcd -> abcdabcd
+        const __m128i a0 = _mm_and_si128(_mm_srli_epi16(r0, 4), kMask_x0f);
+        const __m128i a1 = _mm_or_si128(a0, _mm_slli_epi16(a0, 4));
+        const __m128i i0 = _mm_and_si128(r0, kMask_x0f);
+        const __m128i i1 = _mm_or_si128(i0, _mm_slli_epi16(i0, 4));
+
+        // Interleave to (A I I I) for each texel.
+        const __m128i ii0 = _mm_unpacklo_epi8(i1, i1);
+        const __m128i ia0 = _mm_unpacklo_epi8(i1, a1);
+        const __m128i ii1 = _mm_unpackhi_epi8(i1, i1);
+        const __m128i ia1 = _mm_unpackhi_epi8(i1, a1);
+
+        __m128i* row0 = (__m128i*)(dst + (y + iy) * width + x);
+        __m128i* row1 = (__m128i*)(dst + (y + iy + 1) * width + x);
+        _mm_storeu_si128(row0, _mm_unpacklo_epi16(ii0, ia0));
+        _mm_storeu_si128(row0 + 1, _mm_unpackhi_epi16(ii0, ia0));
+        _mm_storeu_si128(row1, _mm_unpacklo_epi16(ii1, ia1));
+        _mm_storeu_si128(row1 + 1, _mm_unpackhi_epi16(ii1, ia1));
       }
     }
   }
@@ -661,6 +678,123 @@ static void TexDecoder_DecodeImpl_IA8(u32* dst, const u8* src, int width, int he
   }
 }
 
+// The AVX2 decoders for the 16-bit formats handle two rows of a 4x4 block at once, with each
+// texel zero-extended to 32 bits.
+FUNCTION_TARGET_AVX2
+static __m256i LoadBigEndian16x8(const u8* src)
+{
+  const __m128i swap_mask = _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+  return _mm256_cvtepu16_epi32(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)src), swap_mask));
+}
+
+FUNCTION_TARGET_AVX2
+static void StoreTwoRows(u32* dst, int width, __m256i texels)
+{
+  _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(texels));
+  _mm_storeu_si128((__m128i*)(dst + width), _mm256_extracti128_si256(texels, 1));
+}
+
+FUNCTION_TARGET_AVX2
+static __m256i DecodeIA8x8(__m256i val)
+{
+  // (0 0 A I) -> (A I I I)
+  const __m256i mask = _mm256_set_epi8(13, 12, 12, 12, 9, 8, 8, 8, 5, 4, 4, 4, 1, 0, 0, 0, 13, 12,
+                                       12, 12, 9, 8, 8, 8, 5, 4, 4, 4, 1, 0, 0, 0);
+  return _mm256_shuffle_epi8(val, mask);
+}
+
+FUNCTION_TARGET_AVX2
+static __m256i DecodeRGB565x8(__m256i val)
+{
+  const __m256i kMask_x1f = _mm256_set1_epi32(0x1f);
+  const __m256i r5 = _mm256_srli_epi32(val, 11);
+  const __m256i g6 = _mm256_and_si256(_mm256_srli_epi32(val, 5), _mm256_set1_epi32(0x3f));
+  const __m256i b5 = _mm256_and_si256(val, kMask_x1f);
+  const __m256i r = _mm256_or_si256(_mm256_slli_epi32(r5, 3), _mm256_srli_epi32(r5, 2));
+  const __m256i g = _mm256_or_si256(_mm256_slli_epi32(g6, 2), _mm256_srli_epi32(g6, 4));
+  const __m256i b = _mm256_or_si256(_mm256_slli_epi32(b5, 3), _mm256_srli_epi32(b5, 2));
+  return _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                         _mm256_or_si256(_mm256_slli_epi32(b, 16), _mm256_set1_epi32(0xFF000000)));
+}
+
+FUNCTION_TARGET_AVX2
+static __m256i DecodeRGB5A3x8(__m256i val)
+{
+  const __m256i kMask_x1f = _mm256_set1_epi32(0x1f);
+  const __m256i kMask_x0f = _mm256_set1_epi32(0x0f);
+
+  // RGB555: Swizzle bits: 00012345 -> 12345123
+  const __m256i r5 = _mm256_and_si256(_mm256_srli_epi32(val, 10), kMask_x1f);
+  const __m256i g5 = _mm256_and_si256(_mm256_srli_epi32(val, 5), kMask_x1f);
+  const __m256i b5 = _mm256_and_si256(val, kMask_x1f);
+  const __m256i rgb555 = _mm256_or_si256(
+      _mm256_or_si256(
+          _mm256_or_si256(_mm256_slli_epi32(r5, 3), _mm256_srli_epi32(r5, 2)),
+          _mm256_slli_epi32(_mm256_or_si256(_mm256_slli_epi32(g5, 3), _mm256_srli_epi32(g5, 2)),
+                            8)),
+      _mm256_or_si256(
+          _mm256_slli_epi32(_mm256_or_si256(_mm256_slli_epi32(b5, 3), _mm256_srli_epi32(b5, 2)),
+                            16),
+          _mm256_set1_epi32(0xFF000000)));
+
+  // RGB4A3: Swizzle bits: 00001234 -> 12341234, 00000123 -> 12312312
+  const __m256i r4 = _mm256_and_si256(_mm256_srli_epi32(val, 8), kMask_x0f);
+  const __m256i g4 = _mm256_and_si256(_mm256_srli_epi32(val, 4), kMask_x0f);
+  const __m256i b4 = _mm256_and_si256(val, kMask_x0f);
+  const __m256i a3 = _mm256_and_si256(_mm256_srli_epi32(val, 12), _mm256_set1_epi32(0x07));
+  const __m256i a8 = _mm256_or_si256(
+      _mm256_or_si256(_mm256_slli_epi32(a3, 5), _mm256_slli_epi32(a3, 2)), _mm256_srli_epi32(a3, 1));
+  const __m256i rgb4a3 = _mm256_or_si256(
+      _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(r4, 4), r4),
+                      _mm256_slli_epi32(_mm256_or_si256(_mm256_slli_epi32(g4, 4), g4), 8)),
+      _mm256_or_si256(_mm256_slli_epi32(_mm256_or_si256(_mm256_slli_epi32(b4, 4), b4), 16),
+                      _mm256_slli_epi32(a8, 24)));
+
+  // The top bit selects the format.
+  const __m256i is_rgb555 = _mm256_srai_epi32(_mm256_slli_epi32(val, 16), 31);
+  return _mm256_blendv_epi8(rgb4a3, rgb555, is_rgb555);
+}
+
+template <TLUTFormat tlutfmt>
+FUNCTION_TARGET_AVX2 static void TexDecoder_DecodeImpl_C14X2_AVX2(u32* dst, const u8* src,
+                                                                  int width, int height,
+                                                                  const u8* tlut, int Wsteps4)
+{
+  const __m256i kMask_x3fff = _mm256_set1_epi32(0x3fff);
+  const __m256i kMask_xffff = _mm256_set1_epi32(0xffff);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        const __m256i indices = _mm256_and_si256(LoadBigEndian16x8(src + 8 * xStep), kMask_x3fff);
+
+        // There is no 16-bit gather, so load the aligned pair of palette entries containing each
+        // index and shift the right one down. This never reads past the end of the palette.
+        const __m256i pairs =
+            _mm256_i32gather_epi32((const int*)tlut, _mm256_srli_epi32(indices, 1), 4);
+        const __m256i shift = _mm256_slli_epi32(_mm256_and_si256(indices, _mm256_set1_epi32(1)), 4);
+        const __m256i entries = _mm256_and_si256(_mm256_srlv_epi32(pairs, shift), kMask_xffff);
+
+        // Byte swap the palette entries.
+        const __m256i val = _mm256_or_si256(_mm256_srli_epi32(entries, 8),
+                                            _mm256_and_si256(_mm256_slli_epi32(entries, 8),
+                                                             _mm256_set1_epi32(0xff00)));
+
+        __m256i texels;
+        if constexpr (tlutfmt == TLUTFormat::IA8)
+          texels = DecodeIA8x8(val);
+        else if constexpr (tlutfmt == TLUTFormat::RGB565)
+          texels = DecodeRGB565x8(val);
+        else
+          texels = DecodeRGB5A3x8(val);
+        StoreTwoRows(dst + (y + iy) * width + x, width, texels);
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_C14X2(u32* dst, const u8* src, int width, int height,
                                         TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                         int Wsteps4, int Wsteps8)
@@ -770,6 +904,60 @@ static void TexDecoder_DecodeImpl_RGB565(u32* dst, const u8* src, int width, int
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGB565_AVX2(u32* dst, const u8* src, int width, int height,
+                                              TextureFormat texformat, const u8* tlut,
+                                              TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        StoreTwoRows(dst + (y + iy) * width + x, width,
+                     DecodeRGB565x8(LoadBigEndian16x8(src + 8 * xStep)));
+      }
+    }
+  }
+}
+
+// Decodes 4 RGB5A3 texels, which are zero-extended to 32 bits, regardless of whether they use
+// alpha or not.
+static __m128i DecodeRGB5A3x4(__m128i val)
+{
+  const __m128i kMask_x1f = _mm_set1_epi32(0x0000001fL);
+  const __m128i kMask_x0f = _mm_set1_epi32(0x0000000fL);
+  const __m128i kMask_x07 = _mm_set1_epi32(0x00000007L);
+
+  // RGB555: Swizzle bits: 00012345 -> 12345123
+  const __m128i r5 = _mm_and_si128(_mm_srli_epi32(val, 10), kMask_x1f);
+  const __m128i g5 = _mm_and_si128(_mm_srli_epi32(val, 5), kMask_x1f);
+  const __m128i b5 = _mm_and_si128(val, kMask_x1f);
+  const __m128i rgb555 = _mm_or_si128(
+      _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r5, 3), _mm_srli_epi32(r5, 2)),
+                   _mm_slli_epi32(_mm_or_si128(_mm_slli_epi32(g5, 3), _mm_srli_epi32(g5, 2)), 8)),
+      _mm_or_si128(_mm_slli_epi32(_mm_or_si128(_mm_slli_epi32(b5, 3), _mm_srli_epi32(b5, 2)), 16),
+                   _mm_set1_epi32(0xFF000000L)));
+
+  // RGB4A3: Swizzle bits: 00001234 -> 12341234, 00000123 -> 12312312
+  const __m128i r4 = _mm_and_si128(_mm_srli_epi32(val, 8), kMask_x0f);
+  const __m128i g4 = _mm_and_si128(_mm_srli_epi32(val, 4), kMask_x0f);
+  const __m128i b4 = _mm_and_si128(val, kMask_x0f);
+  const __m128i a3 = _mm_and_si128(_mm_srli_epi32(val, 12), kMask_x07);
+  const __m128i a8 = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(a3, 5), _mm_slli_epi32(a3, 2)),
+                                  _mm_srli_epi32(a3, 1));
+  const __m128i rgb4a3 = _mm_or_si128(
+      _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r4, 4), r4),
+                   _mm_slli_epi32(_mm_or_si128(_mm_slli_epi32(g4, 4), g4), 8)),
+      _mm_or_si128(_mm_slli_epi32(_mm_or_si128(_mm_slli_epi32(b4, 4), b4), 16),
+                   _mm_slli_epi32(a8, 24)));
+
+  // The top bit selects the format.
+  const __m128i is_rgb555 = _mm_srai_epi32(_mm_slli_epi32(val, 16), 31);
+  return _mm_or_si128(_mm_and_si128(is_rgb555, rgb555), _mm_andnot_si128(is_rgb555, rgb4a3));
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_RGB5A3_SSSE3(u32* dst, const u8* src, int width, int height,
                                                TextureFormat texformat, const u8* tlut,
@@ -847,36 +1035,32 @@ static void TexDecoder_DecodeImpl_RGB5A3_SSSE3(u32* dst, const u8* src, int widt
         }
         else
         {
-          // TODO: Vectorise (Either 4-way branch or do both and select is better than this)
-          u32* vals = (u32*)&valV;
-          int r, g, b, a;
-          for (int i = 0; i < 4; ++i)
-          {
-            if (vals[i] & 0x8000)
-            {
-              // Swizzle bits: 00012345 -> 12345123
-              r = (((vals[i] >> 10) & 0x1f) << 3) | (((vals[i] >> 10) & 0x1f) >> 2);
-              g = (((vals[i] >> 5) & 0x1f) << 3) | (((vals[i] >> 5) & 0x1f) >> 2);
-              b = (((vals[i]) & 0x1f) << 3) | (((vals[i]) & 0x1f) >> 2);
-              a = 0xFF;
-            }
-            else
-            {
-              a = (((vals[i] >> 12) & 0x7) << 5) | (((vals[i] >> 12) & 0x7) << 2) |
-                  (((vals[i] >> 12) & 0x7) >> 1);
-              // Swizzle bits: 00001234 -> 12341234
-              r = (((vals[i] >> 8) & 0xf) << 4) | ((vals[i] >> 8) & 0xf);
-              g = (((vals[i] >> 4) & 0xf) << 4) | ((vals[i] >> 4) & 0xf);
-              b = (((vals[i]) & 0xf) << 4) | ((vals[i]) & 0xf);
-            }
-            newdst[i] = r | (g << 8) | (b << 16) | (a << 24);
-          }
+          // Mixed block: decode both ways and select per texel.
+          _mm_storeu_si128((__m128i*)newdst, DecodeRGB5A3x4(valV));
         }
       }
     }
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGB5A3_AVX2(u32* dst, const u8* src, int width, int height,
+                                              TextureFormat texformat, const u8* tlut,
+                                              TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        StoreTwoRows(dst + (y + iy) * width + x, width,
+                     DecodeRGB5A3x8(LoadBigEndian16x8(src + 8 * xStep)));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_RGB5A3(u32* dst, const u8* src, int width, int height,
                                          TextureFormat texformat, const u8* tlut,
                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
@@ -967,30 +1151,8 @@ static void TexDecoder_DecodeImpl_RGB5A3(u32* dst, const u8* src, int width, int
         }
         else
         {
-          // TODO: Vectorise (Either 4-way branch or do both and select is better than this)
-          u32* vals = (u32*)&valV;
-          int r, g, b, a;
-          for (int i = 0; i < 4; ++i)
-          {
-            if (vals[i] & 0x8000)
-            {
-              // Swizzle bits: 00012345 -> 12345123
-              r = (((vals[i] >> 10) & 0x1f) << 3) | (((vals[i] >> 10) & 0x1f) >> 2);
-              g = (((vals[i] >> 5) & 0x1f) << 3) | (((vals[i] >> 5) & 0x1f) >> 2);
-              b = (((vals[i]) & 0x1f) << 3) | (((vals[i]) & 0x1f) >> 2);
-              a = 0xFF;
-            }
-            else
-            {
-              a = (((vals[i] >> 12) & 0x7) << 5) | (((vals[i] >> 12) & 0x7) << 2) |
-                  (((vals[i] >> 12) & 0x7) >> 1);
-              // Swizzle bits: 00001234 -> 12341234
-              r = (((vals[i] >> 8) & 0xf) << 4) | ((vals[i] >> 8) & 0xf);
-              g = (((vals[i] >> 4) & 0xf) << 4) | ((vals[i] >> 4) & 0xf);
-              b = (((vals[i]) & 0xf) << 4) | ((vals[i]) & 0xf);
-            }
-            newdst[i] = r | (g << 8) | (b << 16) | (a << 24);
-          }
+          // Mixed block: decode both ways and select per texel.
+          _mm_storeu_si128((__m128i*)newdst, DecodeRGB5A3x4(valV));
         }
       }
     }
@@ -1409,6 +1571,83 @@ static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int h
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_CMPR_AVX2(u32* dst, const u8* src, int width, int height,
+                                            TextureFormat texformat, const u8* tlut,
+                                            TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Two horizontally adjacent DXT blocks are decoded together. Their 8 colors fit in one
+  // register, so each row of 8 texels is one permute.
+  const __m128i color_mask = _mm_set_epi8(-128, -128, 10, 11, -128, -128, 8, 9, -128, -128, 2, 3,
+                                          -128, -128, 0, 1);
+  const __m128i kMask_x1f = _mm_set1_epi32(0x1f);
+  const __m128i kMask_x3f = _mm_set1_epi32(0x3f);
+  const __m128i transparent_mask = _mm_set_epi32(0x00FFFFFF, 0x00FFFFFF, -1, -1);
+  const __m256i palette_order = _mm256_set_epi32(7, 5, 3, 2, 6, 4, 1, 0);
+  const __m256i lines_order = _mm256_set_epi32(3, 3, 3, 3, 1, 1, 1, 1);
+  // The first texel of a row is in the top bits.
+  const __m256i shifts = _mm256_set_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+  const __m256i block_offsets = _mm256_set_epi32(4, 4, 4, 4, 0, 0, 0, 0);
+  const __m256i kMask_x3 = _mm256_set1_epi32(3);
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int z = 0, xStep = 2 * yStep; z < 2; ++z, xStep++)
+      {
+        const __m128i dxt = _mm_loadu_si128((const __m128i*)(src + sizeof(DXTBlock) * 2 * xStep));
+
+        // (color2 color1) of both blocks, as native 16-bit values and as RGBA8.
+        const __m128i c = _mm_shuffle_epi8(dxt, color_mask);
+        const __m128i r5 = _mm_srli_epi32(c, 11);
+        const __m128i g6 = _mm_and_si128(_mm_srli_epi32(c, 5), kMask_x3f);
+        const __m128i b5 = _mm_and_si128(c, kMask_x1f);
+        const __m128i r8 = _mm_or_si128(_mm_slli_epi32(r5, 3), _mm_srli_epi32(r5, 2));
+        const __m128i g8 = _mm_or_si128(_mm_slli_epi32(g6, 2), _mm_srli_epi32(g6, 4));
+        const __m128i b8 = _mm_or_si128(_mm_slli_epi32(b5, 3), _mm_srli_epi32(b5, 2));
+        const __m128i rgb =
+            _mm_or_si128(_mm_or_si128(r8, _mm_slli_epi32(g8, 8)),
+                         _mm_or_si128(_mm_slli_epi32(b8, 16), _mm_set1_epi32(0xFF000000)));
+
+        // Interpolate the two other colors of both blocks with 16 bits per channel.
+        const __m128i rgb1 = _mm_cvtepu8_epi16(_mm_shuffle_epi32(rgb, _MM_SHUFFLE(2, 0, 2, 0)));
+        const __m128i rgb2 = _mm_cvtepu8_epi16(_mm_shuffle_epi32(rgb, _MM_SHUFFLE(3, 1, 3, 1)));
+        const __m128i three = _mm_set1_epi16(3);
+        const __m128i five = _mm_set1_epi16(5);
+        const __m128i blend2 = _mm_srli_epi16(
+            _mm_add_epi16(_mm_mullo_epi16(rgb2, three), _mm_mullo_epi16(rgb1, five)), 3);
+        const __m128i blend3 = _mm_srli_epi16(
+            _mm_add_epi16(_mm_mullo_epi16(rgb1, three), _mm_mullo_epi16(rgb2, five)), 3);
+        const __m128i average = _mm_srli_epi16(_mm_add_epi16(rgb1, rgb2), 1);
+
+        // If color1 <= color2, the third color is the average of both colors, and the fourth is
+        // the same but transparent.
+        const __m128i c1_greater = _mm_cmpgt_epi32(c, _mm_srli_si128(c, 4));
+        const __m128i select = _mm_shuffle_epi32(c1_greater, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128i blended = _mm_blendv_epi8(
+            _mm_and_si128(_mm_packus_epi16(average, average), transparent_mask),
+            _mm_packus_epi16(blend2, blend3), select);
+
+        // Reorder to the 4 colors of the first block followed by the 4 colors of the second one.
+        const __m256i palette = _mm256_permutevar8x32_epi32(
+            _mm256_inserti128_si256(_mm256_castsi128_si256(rgb), blended, 1), palette_order);
+        const __m256i lines =
+            _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(dxt), lines_order);
+
+        u32* dst32 = dst + (y + z * 4) * width + x;
+        for (int row = 0; row < 4; row++)
+        {
+          const __m256i row_shifts = _mm256_add_epi32(shifts, _mm256_set1_epi32(8 * row));
+          const __m256i indices = _mm256_add_epi32(
+              _mm256_and_si256(_mm256_srlv_epi32(lines, row_shifts), kMask_x3), block_offsets);
+          _mm256_storeu_si256((__m256i*)(dst32 + width * row),
+                              _mm256_permutevar8x32_epi32(palette, indices));
+        }
+      }
+    }
+  }
+}
+
 void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
                             const u8* tlut, TLUTFormat tlutfmt)
 {
@@ -1418,7 +1657,11 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
   switch (texformat)
   {
   case TextureFormat::C4:
-    TexDecoder_DecodeImpl_C4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bSSSE3)
+      TexDecoder_DecodeImpl_C4_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                     Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
     break;
 
   case TextureFormat::I4:
@@ -1438,7 +1681,11 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::C8:
-    TexDecoder_DecodeImpl_C8(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_C8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C8(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
     break;
 
   case TextureFormat::IA4:
@@ -1455,17 +1702,31 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::C14X2:
-    TexDecoder_DecodeImpl_C14X2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
-                                Wsteps8);
+    if (cpu_info.bAVX2 && tlutfmt == TLUTFormat::IA8)
+      TexDecoder_DecodeImpl_C14X2_AVX2<TLUTFormat::IA8>(dst, src, width, height, tlut, Wsteps4);
+    else if (cpu_info.bAVX2 && tlutfmt == TLUTFormat::RGB565)
+      TexDecoder_DecodeImpl_C14X2_AVX2<TLUTFormat::RGB565>(dst, src, width, height, tlut, Wsteps4);
+    else if (cpu_info.bAVX2 && tlutfmt == TLUTFormat::RGB5A3)
+      TexDecoder_DecodeImpl_C14X2_AVX2<TLUTFormat::RGB5A3>(dst, src, width, height, tlut, Wsteps4);
+    else
+      TexDecoder_DecodeImpl_C14X2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                  Wsteps8);
     break;
 
   case TextureFormat::RGB565:
-    TexDecoder_DecodeImpl_RGB565(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
-                                 Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGB565_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                        Wsteps8);
+    else
+      TexDecoder_DecodeImpl_RGB565(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                   Wsteps8);
     break;
 
   case TextureFormat::RGB5A3:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGB5A3_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                        Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_RGB5A3_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                          Wsteps8);
     else
@@ -1483,7 +1744,12 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::CMPR:
-    TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_CMPR_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                      Wsteps8);
+    else
+      TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                 Wsteps8);
     break;
 
   case TextureFormat::XFB:
@@ -0,0 +1,182 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/TextureDiskCache.h"
+
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+
+class TextureDiskCache::Reader final : public LinearDiskCacheReader<Key, u8>
+{
+public:
+  explicit Reader(TextureDiskCache* cache) : m_cache(cache) {}
+
+  void Read(const Key& key, const u8* value, u32 value_size) override
+  {
+    // Records without data mark a hit on a texture in an earlier session.
+    if (value_size == 0)
+    {
+      m_cache->Touch(key);
+      return;
+    }
+
+    m_cache->InsertEntry(key, std::vector<u8>(value, value + value_size));
+    data_size += value_size;
+  }
+
+  size_t data_size = 0;
+
+private:
+  TextureDiskCache* m_cache;
+};
+
+TextureDiskCache::~TextureDiskCache()
+{
+  Close();
+}
+
+void TextureDiskCache::Open(const std::string& filename, size_t max_size)
+{
+  Close();
+  m_filename = filename;
+  m_max_size = max_size;
+  File::CreateFullPath(filename);
+
+  Reader reader(this);
+  m_file_records = m_file.OpenAndRead(filename, reader);
+  m_file_data_size = reader.data_size;
+  m_open = true;
+
+  // The file is append-only, so rewrite it once most of it is made of evicted textures or hits.
+  if (m_file_data_size > m_size * 2 || m_file_records > m_lru.size() * 4)
+    Rewrite();
+
+  INFO_LOG(VIDEO, "Loaded %zu decoded textures (%zu KiB) from %s", m_lru.size(), m_size / 1024,
+           filename.c_str());
+}
+
+void TextureDiskCache::Close()
+{
+  if (!m_open)
+    return;
+
+  m_file.Sync();
+  m_file.Close();
+  m_lru.clear();
+  m_entries.Clear();
+  m_size = 0;
+  m_open = false;
+}
+
+const std::vector<u8>* TextureDiskCache::Lookup(const Key& key)
+{
+  if (!m_open)
+    return nullptr;
+
+  const auto iter = Find(key);
+  if (iter == m_lru.end())
+    return nullptr;
+
+  m_lru.splice(m_lru.end(), m_lru, iter);
+  if (!iter->touched)
+  {
+    iter->touched = true;
+    m_file.Append(key, nullptr, 0);
+    m_file_records++;
+    RewriteIfMostlyStale();
+  }
+  return &iter->data;
+}
+
+void TextureDiskCache::Insert(const Key& key, const u8* data, size_t size)
+{
+  if (!m_open || size == 0 || size > m_max_size)
+    return;
+
+  InsertEntry(key, std::vector<u8>(data, data + size));
+  m_file.Append(key, data, static_cast<u32>(size));
+  m_file_data_size += size;
+  m_file_records++;
+  RewriteIfMostlyStale();
+}
+
+u64 TextureDiskCache::HashKey(const Key& key)
+{
+  // The texture and palette hashes are already well distributed, so the rest only needs to be
+  // mixed in. Lookups compare the whole key anyway.
+  u64 hash = key.texture_hash ^ (key.tlut_hash * 0x9E3779B97F4A7C15);
+  hash ^= (u64{key.format} << 56) ^ (u64{key.tlut_format} << 48) ^ (u64{key.width} << 32) ^
+          (u64{key.height} << 16) ^ key.levels;
+  return hash;
+}
+
+TextureDiskCache::EntryList::iterator TextureDiskCache::Find(const Key& key)
+{
+  const EntryList::iterator* iter = m_entries.Find(HashKey(key));
+  if (!iter || std::memcmp(&(*iter)->key, &key, sizeof(Key)) != 0)
+    return m_lru.end();
+  return *iter;
+}
+
+void TextureDiskCache::InsertEntry(const Key& key, std::vector<u8> data)
+{
+  const u64 hash = HashKey(key);
+  if (const EntryList::iterator* existing = m_entries.Find(hash))
+  {
+    m_size -= (*existing)->data.size();
+    m_lru.erase(*existing);
+    m_entries.Erase(hash);
+  }
+
+  if (data.size() > m_max_size)
+    return;
+
+  EvictUntilFits(data.size());
+  m_size += data.size();
+  m_lru.push_back({key, std::move(data), false});
+  m_entries[hash] = std::prev(m_lru.end());
+}
+
+void TextureDiskCache::Touch(const Key& key)
+{
+  const auto iter = Find(key);
+  if (iter != m_lru.end())
+    m_lru.splice(m_lru.end(), m_lru, iter);
+}
+
+void TextureDiskCache::EvictUntilFits(size_t size)
+{
+  while (!m_lru.empty() && m_size + size > m_max_size)
+  {
+    const Entry& oldest = m_lru.front();
+    m_size -= oldest.data.size();
+    m_entries.Erase(HashKey(oldest.key));
+    m_lru.pop_front();
+  }
+}
+
+void TextureDiskCache::RewriteIfMostlyStale()
+{
+  // Textures which were re-inserted or evicted stay in the file. Only rewriting it once it is
+  // twice the size limit keeps the cost of rewriting below the cost of the appends before it.
+  if (m_file_data_size > m_max_size * 2 || m_file_records > m_lru.size() * 4 + 1024)
+    Rewrite();
+}
+
+void TextureDiskCache::Rewrite()
+{
+  m_file.Close();
+  File::Delete(m_filename);
+
+  Reader empty_reader(this);
+  m_file.OpenAndRead(m_filename, empty_reader);
+  for (const Entry& entry : m_lru)
+    m_file.Append(entry.key, entry.data.data(), static_cast<u32>(entry.data.size()));
+  m_file_data_size = m_size;
+  m_file_records = m_lru.size();
+}
@@ -0,0 +1,93 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FlatHashMap.h"
+#include "Common/LinearDiskCache.h"
+
+// Persistent cache of textures decoded on the CPU, so that they don't have to be decoded again
+// when a game shows them in a later session.
+//
+// Textures are keyed by hashes of all of their source data and palette, together with everything
+// else the decoded data depends on. While a game is running, the cache is kept in memory and
+// bounded in size, evicting the least recently used textures first. The file itself is
+// append-only: hits are appended as records without data, so that the next session starts with
+// the same order, and the file is rewritten when it is mostly made up of stale records, both when
+// it is loaded and once it grows past twice the size limit while a game is running.
+class TextureDiskCache
+{
+public:
+  struct Key
+  {
+    u64 texture_hash;
+    u64 tlut_hash;
+    u32 format;
+    u32 tlut_format;
+    u32 width;
+    u32 height;
+    u32 levels;
+    u32 padding = 0;
+  };
+  static_assert(std::is_trivially_copyable_v<Key>);
+  static_assert(sizeof(Key) == 40, "Key must not contain implicit padding");
+
+  TextureDiskCache() = default;
+  ~TextureDiskCache();
+
+  // Loads the cache from the given file, keeping at most max_size bytes of texture data.
+  void Open(const std::string& filename, size_t max_size);
+  void Close();
+  bool IsOpen() const { return m_open; }
+
+  // Returns the decoded texture data for the key, or nullptr if it isn't cached. The data stays
+  // valid until the next call to Insert or Close.
+  const std::vector<u8>* Lookup(const Key& key);
+  void Insert(const Key& key, const u8* data, size_t size);
+
+  size_t GetSize() const { return m_size; }
+  size_t GetCount() const { return m_lru.size(); }
+
+private:
+  struct Entry
+  {
+    Key key;
+    std::vector<u8> data;
+    // Whether a hit has already been recorded in the file during this session.
+    bool touched;
+  };
+  using EntryList = std::list<Entry>;
+
+  class Reader;
+
+  static u64 HashKey(const Key& key);
+  EntryList::iterator Find(const Key& key);
+  void InsertEntry(const Key& key, std::vector<u8> data);
+  void Touch(const Key& key);
+  void EvictUntilFits(size_t size);
+  void RewriteIfMostlyStale();
+  void Rewrite();
+
+  bool m_open = false;
+  std::string m_filename;
+  size_t m_max_size = 0;
+  size_t m_size = 0;
+
+  // Texture data and records in the file, including evicted textures and hits.
+  size_t m_file_data_size = 0;
+  size_t m_file_records = 0;
+
+  // Least recently used entries first.
+  EntryList m_lru;
+  Common::FlatHashMap<u64, EntryList::iterator> m_entries;
+
+  LinearDiskCache<Key, u8> m_file;
+};
@@ -456,7 +456,8 @@ void VertexLoaderARM64::GenerateVertexLoader()
     s32 offset = -1;
     for (int i = 0; i < (m_VtxAttr.NormalElements ? 3 : 1); i++)
     {
-      if (!i || m_VtxAttr.NormalIndex3)
+      // Direct normals are always read in sequence, the index3 bit only affects indexed ones.
+      if (!i || (m_VtxAttr.NormalIndex3 && (m_VtxDesc.Normal & MASK_INDEXED)))
       {
         int elem_size = 1 << (m_VtxAttr.NormalFormat / 2);
 
@@ -545,6 +546,7 @@ void VertexLoaderARM64::GenerateVertexLoader()
       m_native_vtx_decl.texcoords[i].integer = false;
 
       LDRB(INDEX_UNSIGNED, scratch2_reg, src_reg, texmatidx_ofs[i]);
+      AND(scratch2_reg, scratch2_reg, 0, 5);
       m_float_emit.UCVTF(S31, scratch2_reg);
 
       if (tc[i])
@@ -241,6 +241,13 @@ std::unique_ptr<VertexLoaderBase> VertexLoaderBase::CreateVertexLoader(const TVt
     return loader;
 #endif
 
+  // The generic loader is several times slower, so make it visible when a JIT gave up.
+  if (loader)
+  {
+    WARN_LOG(VIDEO, "Vertex loader JIT failed, falling back to the generic loader for %s",
+             loader->ToString().c_str());
+  }
+
   // last try: The old VertexLoader
   loader = std::make_unique<VertexLoader>(vtx_desc, vtx_attr);
   if (loader->IsInitialized())
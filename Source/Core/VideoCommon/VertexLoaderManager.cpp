@@ -5,6 +5,8 @@
 #include "VideoCommon/VertexLoaderManager.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <iterator>
 #include <memory>
 #include <mutex>
@@ -23,6 +25,7 @@
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/StageProfiler.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexManagerBase.h"
@@ -43,7 +46,32 @@ u32 g_current_components;
 typedef std::unordered_map<VertexLoaderUID, std::unique_ptr<VertexLoaderBase>> VertexLoaderMap;
 static std::mutex s_vertex_loader_map_lock;
 static VertexLoaderMap s_vertex_loader_map;
-// TODO - change into array of pointers. Keep a map of all seen so far.
+
+namespace
+{
+struct LoaderSlot
+{
+  VertexLoaderUID uid;
+  VertexLoaderBase* loader = nullptr;
+};
+
+// The loaders recently used by each VAT group, indexed by the hash of their UID. Games reconfigure
+// the vertex format between most draws, so this avoids going through the map and its lock for
+// formats which have been seen recently. Each CP state has its own cache, which is only accessed by
+// the thread processing that state.
+constexpr size_t LOADER_SLOTS_PER_GROUP = 8;
+struct LoaderCache
+{
+  std::array<std::array<LoaderSlot, LOADER_SLOTS_PER_GROUP>, 8> groups;
+  // The caches are dropped lazily when their epoch doesn't match s_vertex_loader_epoch, as they
+  // can't be reset from the thread which clears the map.
+  u32 epoch = 0;
+};
+}  // namespace
+
+static std::atomic<u32> s_vertex_loader_epoch{1};
+static LoaderCache s_main_loader_cache;
+static LoaderCache s_preprocess_loader_cache;
 
 u8* cached_arraybases[12];
 
@@ -62,6 +90,7 @@ void Clear()
   std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
   s_vertex_loader_map.clear();
   s_native_vertex_map.clear();
+  s_vertex_loader_epoch++;
 }
 
 void UpdateVertexArrayPointers()
@@ -198,6 +227,19 @@ NativeVertexFormat* GetUberVertexFormat(const PortableVertexDeclaration& decl)
   return GetOrCreateMatchingFormat(new_decl);
 }
 
+static VertexLoaderBase* GetOrCreateLoader(const VertexLoaderUID& uid, const TVtxDesc& vtx_desc,
+                                           const VAT& vtx_attr)
+{
+  std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
+  std::unique_ptr<VertexLoaderBase>& loader = s_vertex_loader_map[uid];
+  if (!loader)
+  {
+    loader = VertexLoaderBase::CreateVertexLoader(vtx_desc, vtx_attr);
+    INCSTAT(g_stats.num_vertex_loaders);
+  }
+  return loader.get();
+}
+
 static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = false)
 {
   CPState* state = preprocess ? &g_preprocess_cp_state : &g_main_cp_state;
@@ -206,26 +248,30 @@ static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = fal
   VertexLoaderBase* loader;
   if (state->attr_dirty[vtx_attr_group])
   {
-    // We are not allowed to create a native vertex format on preprocessing as this is on the wrong
-    // thread
-    bool check_for_native_format = !preprocess;
+    LoaderCache& cache = preprocess ? s_preprocess_loader_cache : s_main_loader_cache;
+    const u32 epoch = s_vertex_loader_epoch.load(std::memory_order_acquire);
+    if (cache.epoch != epoch)
+    {
+      cache = {};
+      cache.epoch = epoch;
+    }
 
-    VertexLoaderUID uid(state->vtx_desc, state->vtx_attr[vtx_attr_group]);
-    std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
-    VertexLoaderMap::iterator iter = s_vertex_loader_map.find(uid);
-    if (iter != s_vertex_loader_map.end())
+    const VertexLoaderUID uid(state->vtx_desc, state->vtx_attr[vtx_attr_group]);
+    LoaderSlot& slot = cache.groups[vtx_attr_group][uid.GetHash() % LOADER_SLOTS_PER_GROUP];
+    if (slot.loader && slot.uid == uid)
     {
-      loader = iter->second.get();
-      check_for_native_format &= !loader->m_native_vertex_format;
+      loader = slot.loader;
     }
     else
     {
-      s_vertex_loader_map[uid] =
-          VertexLoaderBase::CreateVertexLoader(state->vtx_desc, state->vtx_attr[vtx_attr_group]);
-      loader = s_vertex_loader_map[uid].get();
-      INCSTAT(g_stats.num_vertex_loaders);
+      loader = GetOrCreateLoader(uid, state->vtx_desc, state->vtx_attr[vtx_attr_group]);
+      slot.uid = uid;
+      slot.loader = loader;
     }
-    if (check_for_native_format)
+
+    // We are not allowed to create a native vertex format on preprocessing as this is on the wrong
+    // thread
+    if (!preprocess && !loader->m_native_vertex_format)
     {
       // search for a cached native vertex format
       const PortableVertexDeclaration& format = loader->m_native_vtx_decl;
@@ -263,6 +309,8 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   if (is_preprocess)
     return size;
 
+  StageProfiler::Scope profile_scope(StageProfiler::Stage::VertexLoad);
+
   // If the native vertex format changed, force a flush.
   if (loader->m_native_vertex_format != s_current_vtx_fmt ||
       loader->m_native_components != g_current_components)
@@ -314,36 +362,59 @@ void LoadCPReg(u32 sub_cmd, u32 value, bool is_preprocess)
       VertexShaderManager::SetTexMatrixChangedB(value);
     break;
 
+  // Games often write the same vertex format again before each draw, so only changes need the
+  // loaders to be looked up again.
   case 0x50:
-    state->vtx_desc.Hex &= ~0x1FFFF;  // keep the Upper bits
-    state->vtx_desc.Hex |= value;
-    state->attr_dirty = BitSet32::AllTrue(8);
-    state->bases_dirty = true;
+  {
+    // keep the Upper bits
+    const u64 vtx_desc = (state->vtx_desc.Hex & ~0x1FFFF) | value;
+    if (vtx_desc != state->vtx_desc.Hex)
+    {
+      state->vtx_desc.Hex = vtx_desc;
+      state->attr_dirty = BitSet32::AllTrue(8);
+      state->bases_dirty = true;
+    }
     break;
+  }
 
   case 0x60:
-    state->vtx_desc.Hex &= 0x1FFFF;  // keep the lower 17Bits
-    state->vtx_desc.Hex |= (u64)value << 17;
-    state->attr_dirty = BitSet32::AllTrue(8);
-    state->bases_dirty = true;
+  {
+    // keep the lower 17Bits
+    const u64 vtx_desc = (state->vtx_desc.Hex & 0x1FFFF) | (u64)value << 17;
+    if (vtx_desc != state->vtx_desc.Hex)
+    {
+      state->vtx_desc.Hex = vtx_desc;
+      state->attr_dirty = BitSet32::AllTrue(8);
+      state->bases_dirty = true;
+    }
     break;
+  }
 
   case 0x70:
     ASSERT((sub_cmd & 0x0F) < 8);
-    state->vtx_attr[sub_cmd & 7].g0.Hex = value;
-    state->attr_dirty[sub_cmd & 7] = true;
+    if (state->vtx_attr[sub_cmd & 7].g0.Hex != value)
+    {
+      state->vtx_attr[sub_cmd & 7].g0.Hex = value;
+      state->attr_dirty[sub_cmd & 7] = true;
+    }
     break;
 
   case 0x80:
     ASSERT((sub_cmd & 0x0F) < 8);
-    state->vtx_attr[sub_cmd & 7].g1.Hex = value;
-    state->attr_dirty[sub_cmd & 7] = true;
+    if (state->vtx_attr[sub_cmd & 7].g1.Hex != value)
+    {
+      state->vtx_attr[sub_cmd & 7].g1.Hex = value;
+      state->attr_dirty[sub_cmd & 7] = true;
+    }
     break;
 
   case 0x90:
     ASSERT((sub_cmd & 0x0F) < 8);
-    state->vtx_attr[sub_cmd & 7].g2.Hex = value;
-    state->attr_dirty[sub_cmd & 7] = true;
+    if (state->vtx_attr[sub_cmd & 7].g2.Hex != value)
+    {
+      state->vtx_attr[sub_cmd & 7].g2.Hex = value;
+      state->attr_dirty[sub_cmd & 7] = true;
+    }
     break;
 
   // Pointers to vertex arrays in GC RAM
@@ -40,6 +40,50 @@ static OpArg MPIC(const void* ptr)
   return MDisp(base_reg, PtrOffset(ptr, memory_base_ptr));
 }
 
+// The packed color formats are expanded with a table per source byte, which holds that byte's
+// share of the RGBA8 output. This is used without a fast PDEP, and always for RGB565.
+struct ColorTables
+{
+  u32 rgb565[2][256];
+  u32 rgba4444[2][256];
+  u32 rgba6666[3][256];
+};
+
+static constexpr u32 Expand4(u32 value)
+{
+  return (value << 4) | value;
+}
+
+static constexpr ColorTables MakeColorTables()
+{
+  ColorTables tables{};
+  for (u32 b = 0; b < 256; ++b)
+  {
+    // RRRRRGGG GGGBBBBB
+    const u32 r5 = b >> 3;
+    const u32 g3 = b & 7;
+    tables.rgb565[0][b] = ((r5 << 3) | (r5 >> 2)) | (((g3 << 5) | (g3 >> 1)) << 8) | 0xFF000000;
+    const u32 b5 = b & 31;
+    tables.rgb565[1][b] = (((b >> 5) << 2) << 8) | (((b5 << 3) | (b5 >> 2)) << 16);
+
+    // RRRRGGGG BBBBAAAA
+    tables.rgba4444[0][b] = Expand4(b >> 4) | (Expand4(b & 15) << 8);
+    tables.rgba4444[1][b] = (Expand4(b >> 4) << 16) | (Expand4(b & 15) << 24);
+
+    // RRRRRRGG GGGGBBBB BBAAAAAA
+    const u32 r6 = b >> 2;
+    const u32 g2 = b & 3;
+    tables.rgba6666[0][b] = ((r6 << 2) | (r6 >> 4)) | (((g2 << 6) | g2) << 8);
+    const u32 b4 = b & 15;
+    tables.rgba6666[1][b] = (((b >> 4) << 2) << 8) | (((b4 << 4) | (b4 >> 2)) << 16);
+    const u32 a6 = b & 63;
+    tables.rgba6666[2][b] = (((b >> 6) << 2) << 16) | (((a6 << 2) | (a6 >> 4)) << 24);
+  }
+  return tables;
+}
+
+alignas(64) static constexpr ColorTables color_tables = MakeColorTables();
+
 VertexLoaderX64::VertexLoaderX64(const TVtxDesc& vtx_desc, const VAT& vtx_att)
     : VertexLoaderBase(vtx_desc, vtx_att)
 {
@@ -283,100 +327,69 @@ void VertexLoaderX64::ReadColor(OpArg data, u64 attribute, int format)
   case FORMAT_16B_565:
     //                   RRRRRGGG GGGBBBBB
     // AAAAAAAA BBBBBBBB GGGGGGGG RRRRRRRR
-    LoadAndSwap(16, scratch1, data);
-    if (cpu_info.bBMI1 && cpu_info.bFastBMI2)
-    {
-      MOV(32, R(scratch2), Imm32(0x07C3F7C0));
-      PDEP(32, scratch3, scratch1, R(scratch2));
-
-      MOV(32, R(scratch2), Imm32(0xF8FCF800));
-      PDEP(32, scratch1, scratch1, R(scratch2));
-      ANDN(32, scratch2, scratch2, R(scratch3));
-
-      OR(32, R(scratch1), R(scratch2));
-    }
-    else
-    {
-      SHL(32, R(scratch1), Imm8(11));
-      LEA(32, scratch2, MScaled(scratch1, SCALE_4, 0));
-      LEA(32, scratch3, MScaled(scratch2, SCALE_8, 0));
-      AND(32, R(scratch1), Imm32(0x0000F800));
-      AND(32, R(scratch2), Imm32(0x00FC0000));
-      AND(32, R(scratch3), Imm32(0xF8000000));
-      OR(32, R(scratch1), R(scratch2));
-      OR(32, R(scratch1), R(scratch3));
-
-      MOV(32, R(scratch2), R(scratch1));
-      SHR(32, R(scratch1), Imm8(5));
-      AND(32, R(scratch1), Imm32(0x07000700));
-      OR(32, R(scratch1), R(scratch2));
-
-      SHR(32, R(scratch2), Imm8(6));
-      AND(32, R(scratch2), Imm32(0x00030000));
-      OR(32, R(scratch1), R(scratch2));
-    }
-    OR(32, R(scratch1), Imm32(0x000000FF));
-    SwapAndStore(32, MDisp(dst_reg, m_dst_ofs), scratch1);
+    // The table is faster than PDEP here, as two lookups replace two deposits and the fixups.
+    MOVZX(32, 16, scratch1, data);
+    MOVZX(32, 8, scratch2, R(scratch1));
+    SHR(32, R(scratch1), Imm8(8));
+    MOV(32, R(scratch3), MPIC(color_tables.rgb565[0], scratch2, SCALE_4));
+    OR(32, R(scratch3), MPIC(color_tables.rgb565[1], scratch1, SCALE_4));
+    MOV(32, MDisp(dst_reg, m_dst_ofs), R(scratch3));
     load_bytes = 2;
     break;
 
   case FORMAT_16B_4444:
     //                   RRRRGGGG BBBBAAAA
     // AAAAAAAA BBBBBBBB GGGGGGGG RRRRRRRR
-    LoadAndSwap(16, scratch1, data);
     if (cpu_info.bFastBMI2)
     {
+      LoadAndSwap(16, scratch1, data);
       MOV(32, R(scratch2), Imm32(0x0F0F0F0F));
       PDEP(32, scratch1, scratch1, R(scratch2));
-    }
-    else
-    {
-      MOV(32, R(scratch2), R(scratch1));
-      SHL(32, R(scratch1), Imm8(8));
-      OR(32, R(scratch1), R(scratch2));
-      AND(32, R(scratch1), Imm32(0x00FF00FF));
-
       MOV(32, R(scratch2), R(scratch1));
       SHL(32, R(scratch1), Imm8(4));
       OR(32, R(scratch1), R(scratch2));
-      AND(32, R(scratch1), Imm32(0x0F0F0F0F));
+      SwapAndStore(32, MDisp(dst_reg, m_dst_ofs), scratch1);
+    }
+    else
+    {
+      MOVZX(32, 16, scratch1, data);
+      MOVZX(32, 8, scratch2, R(scratch1));
+      SHR(32, R(scratch1), Imm8(8));
+      MOV(32, R(scratch3), MPIC(color_tables.rgba4444[0], scratch2, SCALE_4));
+      OR(32, R(scratch3), MPIC(color_tables.rgba4444[1], scratch1, SCALE_4));
+      MOV(32, MDisp(dst_reg, m_dst_ofs), R(scratch3));
     }
-    MOV(32, R(scratch2), R(scratch1));
-    SHL(32, R(scratch1), Imm8(4));
-    OR(32, R(scratch1), R(scratch2));
-    SwapAndStore(32, MDisp(dst_reg, m_dst_ofs), scratch1);
     load_bytes = 2;
     break;
 
   case FORMAT_24B_6666:
     //          RRRRRRGG GGGGBBBB BBAAAAAA
     // AAAAAAAA BBBBBBBB GGGGGGGG RRRRRRRR
-    data.AddMemOffset(-1);  // subtract one from address so we can use a 32bit load and bswap
-    LoadAndSwap(32, scratch1, data);
+    data.AddMemOffset(-1);  // subtract one from address so we can use a 32bit load
     if (cpu_info.bFastBMI2)
     {
+      LoadAndSwap(32, scratch1, data);
       MOV(32, R(scratch2), Imm32(0xFCFCFCFC));
       PDEP(32, scratch1, scratch1, R(scratch2));
       MOV(32, R(scratch2), R(scratch1));
+      SHR(32, R(scratch1), Imm8(6));
+      AND(32, R(scratch1), Imm32(0x03030303));
+      OR(32, R(scratch1), R(scratch2));
+      SwapAndStore(32, MDisp(dst_reg, m_dst_ofs), scratch1);
     }
     else
     {
-      LEA(32, scratch2, MScaled(scratch1, SCALE_4, 0));  // ______RR RRRRGGGG GGBBBBBB AAAAAA__
-      AND(32, R(scratch2), Imm32(0x00003FFC));           // ________ ________ __BBBBBB AAAAAA__
-      SHL(32, R(scratch1), Imm8(6));                     // __RRRRRR GGGGGGBB BBBBAAAA AA______
-      AND(32, R(scratch1), Imm32(0x3FFC0000));           // __RRRRRR GGGGGG__ ________ ________
-      OR(32, R(scratch1), R(scratch2));                  // __RRRRRR GGGGGG__ __BBBBBB AAAAAA__
-
-      LEA(32, scratch2, MScaled(scratch1, SCALE_4, 0));  // RRRRRRGG GGGG____ BBBBBBAA AAAA____
-      AND(32, R(scratch2), Imm32(0xFC00FC00));           // RRRRRR__ ________ BBBBBB__ ________
-      AND(32, R(scratch1), Imm32(0x00FC00FC));           // ________ GGGGGG__ ________ AAAAAA__
-      OR(32, R(scratch1), R(scratch2));                  // RRRRRR__ GGGGGG__ BBBBBB__ AAAAAA__
-      MOV(32, R(scratch2), R(scratch1));
+      MOV(32, R(scratch1), data);
+      SHR(32, R(scratch1), Imm8(8));
+      MOVZX(32, 8, scratch2, R(scratch1));
+      MOV(32, R(scratch3), MPIC(color_tables.rgba6666[0], scratch2, SCALE_4));
+      SHR(32, R(scratch1), Imm8(8));
+      MOVZX(32, 8, scratch2, R(scratch1));
+      OR(32, R(scratch3), MPIC(color_tables.rgba6666[1], scratch2, SCALE_4));
+      SHR(32, R(scratch1), Imm8(8));
+      OR(32, R(scratch3), MPIC(color_tables.rgba6666[2], scratch1, SCALE_4));
+      MOV(32, MDisp(dst_reg, m_dst_ofs), R(scratch3));
     }
-    SHR(32, R(scratch1), Imm8(6));
-    AND(32, R(scratch1), Imm32(0x03030303));
-    OR(32, R(scratch1), R(scratch2));
-    SwapAndStore(32, MDisp(dst_reg, m_dst_ofs), scratch1);
     load_bytes = 3;
     break;
   }
@@ -451,7 +464,8 @@ void VertexLoaderX64::GenerateVertexLoader()
 
     for (int i = 0; i < (m_VtxAttr.NormalElements ? 3 : 1); i++)
     {
-      if (!i || m_VtxAttr.NormalIndex3)
+      // Direct normals are always read in sequence, the index3 bit only affects indexed ones.
+      if (!i || (m_VtxAttr.NormalIndex3 && (m_VtxDesc.Normal & MASK_INDEXED)))
       {
         data = GetVertexAddr(ARRAY_NORMAL, m_VtxDesc.Normal);
         int elem_size = 1 << (m_VtxAttr.NormalFormat / 2);
@@ -506,6 +520,7 @@ void VertexLoaderX64::GenerateVertexLoader()
       m_native_vtx_decl.texcoords[i].type = VAR_FLOAT;
       m_native_vtx_decl.texcoords[i].integer = false;
       MOVZX(64, 8, scratch1, MDisp(src_reg, texmatidx_ofs[i]));
+      AND(32, R(scratch1), Imm8(0x3F));
       if (tc[i])
       {
         CVTSI2SS(XMM0, R(scratch1));
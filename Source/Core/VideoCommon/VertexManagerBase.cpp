@@ -29,6 +29,7 @@
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/SamplerCommon.h"
+#include "VideoCommon/StageProfiler.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
@@ -332,6 +333,8 @@ bool VertexManagerBase::UploadTexelBuffer(const void* data, u32 data_size, Texel
 
 void VertexManagerBase::LoadTextures()
 {
+  StageProfiler::Scope profile_scope(StageProfiler::Stage::TextureLoad);
+
   BitSet32 usedtextures;
   for (u32 i = 0; i < bpmem.genMode.numtevstages + 1u; ++i)
     if (bpmem.tevorders[i / 2].getEnable(i & 1))
@@ -355,6 +358,8 @@ void VertexManagerBase::Flush()
 
   m_is_flushed = true;
 
+  StageProfiler::Scope profile_scope(StageProfiler::Stage::Draw);
+
   if (xfmem.numTexGen.numTexGens != bpmem.genMode.numtexgens ||
       xfmem.numChan.numColorChans != bpmem.genMode.numcolchans)
   {
@@ -589,6 +594,8 @@ void VertexManagerBase::CalculateZSlope(NativeVertexFormat* format)
 
 void VertexManagerBase::UpdatePipelineConfig()
 {
+  StageProfiler::Scope profile_scope(StageProfiler::Stage::ShaderUid);
+
   NativeVertexFormat* vertex_format = VertexLoaderManager::GetCurrentVertexFormat();
   if (vertex_format != m_current_pipeline_config.vertex_format)
   {
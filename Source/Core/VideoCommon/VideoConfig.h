@@ -166,6 +166,9 @@ struct VideoConfig final
   bool bDumpObjects;
   bool bDumpTevStages;
   bool bDumpTevTextureFetches;
+  // Number of threads rasterizing in addition to the GPU thread.
+  // -1 uses an automatic number based on the CPU threads.
+  int iSWRasterizerThreads;
 
   // Enable API validation layers, currently only supported with Vulkan.
   bool bEnableValidationLayer;
@@ -187,6 +190,15 @@ struct VideoConfig final
   int iShaderCompilerThreads;
   int iShaderPrecompilerThreads;
 
+  // Number of threads decoding textures in addition to the GPU thread.
+  // -1 uses an automatic number based on the CPU threads.
+  int iTextureDecodingThreads;
+
+  // Keep textures decoded on the CPU in a per-game cache on disk, holding up to the given number
+  // of MiB of decoded data.
+  bool bTextureDiskCache;
+  int iTextureDiskCacheSize;
+
   // Static config per API
   // TODO: Move this out of VideoConfig
   struct
@@ -251,6 +263,8 @@ struct VideoConfig final
   bool UsingUberShaders() const;
   u32 GetShaderCompilerThreads() const;
   u32 GetShaderPrecompilerThreads() const;
+  u32 GetTextureDecodingThreads() const;
+  u32 GetSWRasterizerThreads() const;
 };
 
 extern VideoConfig g_Config;
@@ -0,0 +1,100 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <vector>
+
+#include "Common/FlatHashMap.h"
+
+TEST(FlatHashMap, Simple)
+{
+  Common::FlatHashMap<u32, int> map;
+
+  EXPECT_TRUE(map.Empty());
+  EXPECT_EQ(nullptr, map.Find(0x80003100));
+
+  map[0x80003100] = 1;
+  map[0x80003104] = 2;
+  EXPECT_EQ(2u, map.Size());
+  ASSERT_NE(nullptr, map.Find(0x80003100));
+  EXPECT_EQ(1, *map.Find(0x80003100));
+  EXPECT_EQ(2, *map.Find(0x80003104));
+
+  map[0x80003100] = 3;
+  EXPECT_EQ(2u, map.Size());
+  EXPECT_EQ(3, *map.Find(0x80003100));
+
+  EXPECT_TRUE(map.Erase(0x80003100));
+  EXPECT_FALSE(map.Erase(0x80003100));
+  EXPECT_FALSE(map.Contains(0x80003100));
+  EXPECT_TRUE(map.Contains(0x80003104));
+  EXPECT_EQ(1u, map.Size());
+
+  map.Clear();
+  EXPECT_TRUE(map.Empty());
+  EXPECT_FALSE(map.Contains(0x80003104));
+}
+
+TEST(FlatHashMap, NonTrivialValues)
+{
+  Common::FlatHashMap<u32, std::vector<int>> map;
+
+  for (u32 i = 0; i < 1000; ++i)
+    map[i * 0x100].push_back(static_cast<int>(i));
+  for (u32 i = 0; i < 1000; i += 2)
+    EXPECT_TRUE(map.Erase(i * 0x100));
+
+  EXPECT_EQ(500u, map.Size());
+  for (u32 i = 1; i < 1000; i += 2)
+  {
+    const std::vector<int>* value = map.Find(i * 0x100);
+    ASSERT_NE(nullptr, value);
+    ASSERT_EQ(1u, value->size());
+    EXPECT_EQ(static_cast<int>(i), (*value)[0]);
+  }
+
+  // Reinserting an erased key must not resurrect the old value.
+  EXPECT_TRUE(map[0].empty());
+}
+
+TEST(FlatHashMap, MatchesStdMap)
+{
+  Common::FlatHashMap<u32, u32> map;
+  std::map<u32, u32> reference;
+
+  // A small key space makes collisions and backward-shift deletions frequent.
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<u32> key_dist(0, 0x3FFF);
+  for (int i = 0; i < 100000; ++i)
+  {
+    const u32 key = key_dist(rng) * 4;
+    if (rng() % 3 == 0)
+    {
+      EXPECT_EQ(reference.erase(key) != 0, map.Erase(key));
+    }
+    else
+    {
+      reference[key] = static_cast<u32>(i);
+      map[key] = static_cast<u32>(i);
+    }
+  }
+
+  EXPECT_EQ(reference.size(), map.Size());
+  for (const auto& [key, value] : reference)
+  {
+    const u32* found = map.Find(key);
+    ASSERT_NE(nullptr, found);
+    EXPECT_EQ(value, *found);
+  }
+
+  size_t visited = 0;
+  map.ForEach([&](u32 key, u32 value) {
+    EXPECT_EQ(reference[key], value);
+    ++visited;
+  });
+  EXPECT_EQ(reference.size(), visited);
+}
@@ -0,0 +1,111 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Hash.h"
+
+namespace
+{
+std::vector<u8> RandomBytes(size_t size, u32 seed)
+{
+  std::mt19937 rng(seed);
+  std::vector<u8> data(size);
+  for (u8& byte : data)
+    byte = static_cast<u8>(rng());
+  return data;
+}
+}  // namespace
+
+TEST(Hash64, MatchesGeneric)
+{
+  Common::SetHash64Function();
+  const std::vector<u8> data = RandomBytes(0x40000, 1);
+
+  for (u32 samples : {0, 1, 3, 128})
+  {
+    for (u32 len = 0; len < 600; ++len)
+    {
+      EXPECT_EQ(Common::GetHash64Generic(data.data() + 1, len, samples),
+                Common::GetHash64(data.data() + 1, len, samples))
+          << "length " << len << ", samples " << samples;
+    }
+    for (u32 len : {0x1000, 0x10000, 0x3FFF9})
+    {
+      EXPECT_EQ(Common::GetHash64Generic(data.data(), len, samples),
+                Common::GetHash64(data.data(), len, samples))
+          << "length " << len << ", samples " << samples;
+    }
+  }
+}
+
+TEST(Hash64, EveryByteMatters)
+{
+  Common::SetHash64Function();
+  std::vector<u8> data = RandomBytes(1000, 2);
+  std::set<u64> hashes;
+
+  for (u32 len : {0, 1, 8, 63, 64, 65, 1000})
+    EXPECT_TRUE(hashes.insert(Common::GetHash64(data.data(), len, 0)).second) << "length " << len;
+
+  for (u32 len : {3, 7, 12, 33, 1000})
+  {
+    for (size_t i = 0; i < len; ++i)
+    {
+      data[i] ^= 0x10;
+      EXPECT_TRUE(hashes.insert(Common::GetHash64(data.data(), len, 0)).second)
+          << "length " << len << ", byte " << i;
+      data[i] ^= 0x10;
+    }
+  }
+}
+
+TEST(Hash64, SamplingCoversEnds)
+{
+  Common::SetHash64Function();
+  std::vector<u8> data = RandomBytes(0x10000, 3);
+  const u64 hash = Common::GetHash64(data.data(), 0x10000, 16);
+
+  // The first and last stripe are always sampled in full.
+  for (size_t i : {0, 63, 0xFFC0, 0xFFFF})
+  {
+    data[i] ^= 1;
+    EXPECT_NE(hash, Common::GetHash64(data.data(), 0x10000, 16)) << "byte " << i;
+    data[i] ^= 1;
+  }
+  EXPECT_EQ(hash, Common::GetHash64(data.data(), 0x10000, 16));
+}
+
+// Not run by default. Prints the hashing throughput for typical texture sizes.
+TEST(Hash64, DISABLED_Benchmark)
+{
+  Common::SetHash64Function();
+  constexpr size_t target_bytes = 1024 * 1024 * 1024;
+  const std::vector<u8> data = RandomBytes(4 * 1024 * 1024, 4);
+
+  for (u32 len : {32, 512, 8 * 1024, 128 * 1024, 1024 * 1024})
+  {
+    for (u32 samples : {0, 128})
+    {
+      const size_t iterations = target_bytes / len;
+      u64 sum = 0;
+      const auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < iterations; ++i)
+        sum += Common::GetHash64(data.data() + (i * len) % (data.size() - len + 1), len, samples);
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+      std::printf("%8u bytes, %3u samples: %8.1f MB/s (%016llx)\n", len, samples,
+                  iterations * len / elapsed.count() / (1024 * 1024),
+                  static_cast<unsigned long long>(sum));
+    }
+  }
+}
@@ -0,0 +1,78 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "Common/MPSCQueue.h"
+
+TEST(MPSCQueue, Simple)
+{
+  Common::MPSCQueue<u32, 4> q;
+
+  EXPECT_TRUE(q.Empty());
+  u32 v;
+  EXPECT_FALSE(q.Pop(v));
+
+  EXPECT_TRUE(q.Push(1));
+  EXPECT_FALSE(q.Empty());
+  EXPECT_TRUE(q.Pop(v));
+  EXPECT_EQ(1u, v);
+  EXPECT_TRUE(q.Empty());
+
+  // Fill the queue a few times over to go around the ring.
+  for (u32 round = 0; round < 3; ++round)
+  {
+    for (u32 i = 0; i < 4; ++i)
+      EXPECT_TRUE(q.Push(round * 4 + i));
+    EXPECT_FALSE(q.Push(100));
+    for (u32 i = 0; i < 4; ++i)
+    {
+      EXPECT_TRUE(q.Pop(v));
+      EXPECT_EQ(round * 4 + i, v);
+    }
+    EXPECT_TRUE(q.Empty());
+  }
+}
+
+TEST(MPSCQueue, MultiThreaded)
+{
+  constexpr u32 PRODUCERS = 8;
+  constexpr u32 PUSHES_PER_PRODUCER = 20000;
+  Common::MPSCQueue<u64, 256> q;
+
+  std::vector<std::thread> producers;
+  for (u32 id = 0; id < PRODUCERS; ++id)
+  {
+    producers.emplace_back([&q, id] {
+      for (u32 i = 0; i < PUSHES_PER_PRODUCER; ++i)
+      {
+        while (!q.Push((u64{id} << 32) | i))
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  // Values from one producer have to arrive in order.
+  std::vector<u32> next(PRODUCERS, 0);
+  for (u64 popped = 0; popped < PRODUCERS * PUSHES_PER_PRODUCER;)
+  {
+    u64 v;
+    if (!q.Pop(v))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    const u32 id = static_cast<u32>(v >> 32);
+    ASSERT_LT(id, PRODUCERS);
+    EXPECT_EQ(next[id], static_cast<u32>(v));
+    next[id] = static_cast<u32>(v) + 1;
+    ++popped;
+  }
+
+  for (std::thread& producer : producers)
+    producer.join();
+  EXPECT_TRUE(q.Empty());
+}
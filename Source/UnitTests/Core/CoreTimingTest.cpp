@@ -5,8 +5,13 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <cstdio>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Common/Config/Config.h"
 #include "Common/FileUtil.h"
@@ -347,3 +352,133 @@ TEST(CoreTiming, Overclocking)
   SConfig::GetInstance().m_OCFactor = 1.0;
   AdvanceAndCheck(4, MAX_SLICE_LENGTH);
 }
+
+namespace ThreadsafeStressTest
+{
+constexpr u32 PRODUCERS = 8;
+// Enough to fill up the lockless ring while the CPU thread is busy.
+constexpr u32 EVENTS_PER_PRODUCER = 4000;
+
+static std::array<u32, PRODUCERS> s_next_event;
+static u32 s_events_received;
+
+static void Callback(u64 userdata, s64 lateness)
+{
+  const u32 producer = static_cast<u32>(userdata >> 32);
+  const u32 index = static_cast<u32>(userdata);
+  ASSERT_LT(producer, PRODUCERS);
+  // Events from one thread have to run in the order they were scheduled in.
+  EXPECT_EQ(s_next_event[producer], index);
+  s_next_event[producer] = index + 1;
+  ++s_events_received;
+}
+}  // namespace ThreadsafeStressTest
+
+TEST(CoreTiming, ThreadsafeStress)
+{
+  using namespace ThreadsafeStressTest;
+
+  ScopeInit guard;
+
+  CoreTiming::EventType* cb = CoreTiming::RegisterEvent("callbackStress", Callback);
+  s_next_event.fill(0);
+  s_events_received = 0;
+
+  // Enter slice 0
+  CoreTiming::Advance();
+
+  std::atomic<u32> producers_done{0};
+  std::vector<std::thread> producers;
+  for (u32 producer = 0; producer < PRODUCERS; ++producer)
+  {
+    producers.emplace_back([cb, producer, &producers_done] {
+      for (u32 i = 0; i < EVENTS_PER_PRODUCER; ++i)
+      {
+        CoreTiming::ScheduleEvent(0, cb, (u64{producer} << 32) | i,
+                                  CoreTiming::FromThread::NON_CPU);
+      }
+      ++producers_done;
+    });
+  }
+
+  while (producers_done < PRODUCERS)
+  {
+    PowerPC::ppcState.downcount = 0;
+    CoreTiming::Advance();
+    std::this_thread::yield();
+  }
+  for (std::thread& producer : producers)
+    producer.join();
+
+  // Events which overflowed the ring are moved once the ring has been emptied.
+  PowerPC::ppcState.downcount = 0;
+  CoreTiming::Advance();
+
+  EXPECT_EQ(PRODUCERS * EVENTS_PER_PRODUCER, s_events_received);
+  for (u32 next_event : s_next_event)
+    EXPECT_EQ(EVENTS_PER_PRODUCER, next_event);
+}
+
+namespace ScheduleAdvanceBenchmark
+{
+// Periods roughly like VI, audio DMA, SI polling and the decrementer at 486 MHz.
+static constexpr std::array<s64, 4> PERIODS{{1620000, 32000, 270000, 4000}};
+static std::array<CoreTiming::EventType*, PERIODS.size()> s_types;
+static u64 s_events_run = 0;
+
+template <unsigned int IDX>
+static void Callback(u64 userdata, s64 lateness)
+{
+  ++s_events_run;
+  CoreTiming::ScheduleEvent(PERIODS[IDX] - lateness, s_types[IDX], userdata);
+}
+
+static void CancelledCallback(u64, s64)
+{
+  ++s_events_run;
+}
+}  // namespace ScheduleAdvanceBenchmark
+
+// Run with --gtest_also_run_disabled_tests to get timings.
+TEST(CoreTiming, DISABLED_ScheduleAdvanceBenchmark)
+{
+  using namespace ScheduleAdvanceBenchmark;
+
+  constexpr int SLICES = 2000000;
+  constexpr int EVENTS_PER_TYPE = 16;
+
+  ScopeInit guard;
+
+  s_types = {{CoreTiming::RegisterEvent("bench0", Callback<0>),
+              CoreTiming::RegisterEvent("bench1", Callback<1>),
+              CoreTiming::RegisterEvent("bench2", Callback<2>),
+              CoreTiming::RegisterEvent("bench3", Callback<3>)}};
+  CoreTiming::EventType* cancelled = CoreTiming::RegisterEvent("benchCancelled", CancelledCallback);
+  s_events_run = 0;
+
+  CoreTiming::Advance();
+  for (size_t i = 0; i < s_types.size(); ++i)
+  {
+    for (int j = 0; j < EVENTS_PER_TYPE; ++j)
+      CoreTiming::ScheduleEvent(PERIODS[i] * j / EVENTS_PER_TYPE, s_types[i], j);
+  }
+
+  const auto start_time = std::chrono::steady_clock::now();
+  for (int slice = 0; slice < SLICES; ++slice)
+  {
+    // Timeouts which usually get cancelled before they fire, like the DVD and SI ones.
+    if (slice % 8 == 0)
+    {
+      CoreTiming::RemoveEvent(cancelled);
+      CoreTiming::ScheduleEvent(10000, cancelled);
+    }
+
+    PowerPC::ppcState.downcount = 0;
+    CoreTiming::Advance();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start_time;
+
+  std::printf("%d slices, %llu events: %.2f ms\n", SLICES,
+              static_cast<unsigned long long>(s_events_run),
+              std::chrono::duration<double, std::milli>(elapsed).count());
+}
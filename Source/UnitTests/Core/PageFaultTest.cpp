@@ -3,12 +3,22 @@
 // Refer to the license.txt file included.
 
 #include <chrono>
+#include <string>
+#include <vector>
 
+#include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
 #include "Common/Timer.h"
+#include "Core/ConfigLoaders/BaseConfigLoader.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/HW/Memmap.h"
 #include "Core/MemTools.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/JitInterface.h"
+#include "UICommon/UICommon.h"
 
 // include order is important
 #include <gtest/gtest.h>  // NOLINT
@@ -77,3 +87,121 @@ TEST(PageFault, PageFault)
   printf("HandleFault->end       %llu ns\n", AS_NS(end - pfjit.m_post_unprotect_time));
   printf("total                  %llu ns\n", AS_NS(end - start));
 }
+
+class MemoryScope final
+{
+public:
+  MemoryScope() : m_profile_path(File::CreateTempDir())
+  {
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    Config::AddLayer(ConfigLoaders::GenerateBaseConfigLoader());
+    SConfig::Init();
+    SConfig::GetInstance().bFastmem = true;
+    EMM::InstallExceptionHandler();
+    Memory::Init();
+  }
+  ~MemoryScope()
+  {
+    Memory::Shutdown();
+    EMM::UninstallExceptionHandler();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+private:
+  std::string m_profile_path;
+};
+
+TEST(PageFault, DirtyPageTracking)
+{
+  MemoryScope scope;
+
+  ASSERT_TRUE(Memory::EnableDirtyPageTracking());
+  const u32 page_size = static_cast<u32>(Memory::GetDirtyPageSize());
+
+  // Everything is dirty until the first epoch starts. Without MMU on GameCube, this includes the
+  // L1 cache and fake VMEM.
+  u32 memory_size = Memory::GetRamSize() + Memory::GetL1CacheSize();
+  if (Memory::m_pFakeVMEM)
+    memory_size += Memory::GetFakeVMemSize();
+  EXPECT_EQ(memory_size / page_size, Memory::GetPagesDirtiedSince(0).size());
+
+  const u64 first_epoch = Memory::StartDirtyPageEpoch();
+  EXPECT_TRUE(Memory::GetPagesDirtiedSince(first_epoch).empty());
+
+  Memory::m_pRAM[page_size * 5 + 3] = 1;
+  Memory::m_pRAM[page_size * 5 + 4] = 2;
+  EXPECT_EQ(std::vector<u32>{page_size * 5}, Memory::GetPagesDirtiedSince(first_epoch));
+
+  const u64 second_epoch = Memory::StartDirtyPageEpoch();
+  EXPECT_EQ(1u, Memory::m_pRAM[page_size * 5 + 3]);
+  Memory::m_pRAM[page_size * 9] = 3;
+  EXPECT_EQ(std::vector<u32>{page_size * 9}, Memory::GetPagesDirtiedSince(second_epoch));
+  EXPECT_EQ((std::vector<u32>{page_size * 5, page_size * 9}),
+            Memory::GetPagesDirtiedSince(first_epoch));
+
+  Memory::DisableDirtyPageTracking();
+  Memory::m_pRAM[page_size * 7] = 4;
+}
+
+TEST(PageFault, RAMSnapshot)
+{
+  MemoryScope scope;
+
+  Memory::m_pRAM[0x1234] = 1;
+  Memory::m_pRAM[0x5678] = 2;
+
+  u8* ptr = nullptr;
+  PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+  Memory::DoState(p);
+  std::vector<u8> state(reinterpret_cast<size_t>(ptr));
+
+  ASSERT_TRUE(Memory::StartRAMSnapshot());
+  ptr = state.data();
+  p.SetMode(PointerWrap::MODE_WRITE);
+  Memory::DoState(p);
+
+  // Writes after the snapshot don't end up in the state.
+  Memory::m_pRAM[0x1234] = 3;
+  Memory::FinishRAMSnapshot();
+  EXPECT_FALSE(Memory::IsRAMSnapshotActive());
+  EXPECT_EQ(3u, Memory::m_pRAM[0x1234]);
+  Memory::m_pRAM[0x5678] = 4;
+
+  ptr = state.data();
+  p.SetMode(PointerWrap::MODE_READ);
+  Memory::DoState(p);
+  EXPECT_EQ(1u, Memory::m_pRAM[0x1234]);
+  EXPECT_EQ(2u, Memory::m_pRAM[0x5678]);
+}
+
+TEST(PageFault, ReserveRAMInState)
+{
+  MemoryScope scope;
+
+  u8* ptr = nullptr;
+  PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+  Memory::DoState(p);
+  std::vector<u8> state(reinterpret_cast<size_t>(ptr), 0xAA);
+
+  Memory::m_pRAM[0x1234] = 1;
+  Memory::ReserveRAMInNextState();
+  ptr = state.data();
+  p.SetMode(PointerWrap::MODE_WRITE);
+  Memory::DoState(p);
+
+  // RAM is left for the caller to fill in.
+  const std::vector<Memory::StateRAMRegion> regions = Memory::TakeReservedRAMRegions();
+  ASSERT_FALSE(regions.empty());
+  EXPECT_EQ(0u, regions[0].physical_address);
+  EXPECT_EQ(Memory::GetRamSize(), regions[0].size);
+  EXPECT_EQ(Memory::m_pRAM, regions[0].memory);
+  EXPECT_EQ(0xAAu, regions[0].state_pointer[0x1234]);
+
+  // Only the next state is affected.
+  ptr = state.data();
+  Memory::DoState(p);
+  EXPECT_EQ(1u, regions[0].state_pointer[0x1234]);
+}
@@ -0,0 +1,170 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigLoaders/BaseConfigLoader.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/HW/SystemTimers.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr u32 TIER_UP_THRESHOLD = 3;
+constexpr u32 TIER_UP_BUDGET = 1;
+
+// Both blocks count their executions in a register and branch back to themselves through LR.
+constexpr u32 BLOCK_A = 0x00003000;
+constexpr u32 BLOCK_B = 0x00003100;
+
+constexpr u32 ADDI_R3_1 = 0x38630001;  // addi r3, r3, 1
+constexpr u32 ADDI_R3_2 = 0x38630002;  // addi r3, r3, 2
+constexpr u32 ADDI_R4_1 = 0x38840001;  // addi r4, r4, 1
+constexpr u32 BLR = 0x4E800020;
+
+class TieredCompilationTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    Config::AddLayer(ConfigLoaders::GenerateBaseConfigLoader());
+    SConfig::Init();
+    Config::SetCurrent(Config::MAIN_JIT_TIERED_COMPILATION, true);
+    Config::SetCurrent(Config::MAIN_JIT_TIER_UP_THRESHOLD, TIER_UP_THRESHOLD);
+    Config::SetCurrent(Config::MAIN_JIT_TIER_UP_BUDGET, TIER_UP_BUDGET);
+    Memory::Init();
+    PowerPC::Init(PowerPC::CPUCore::JIT64);
+    CoreTiming::Init();
+
+    Memory::Write_U32(ADDI_R3_1, BLOCK_A);
+    Memory::Write_U32(BLR, BLOCK_A + 4);
+    Memory::Write_U32(ADDI_R4_1, BLOCK_B);
+    Memory::Write_U32(BLR, BLOCK_B + 4);
+  }
+
+  void TearDown() override
+  {
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    Memory::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  static JitBase* GetJit() { return static_cast<JitBase*>(JitInterface::GetCore()); }
+
+  // Does what the dispatcher does when it finds no compiled block for the address.
+  static void Dispatch(u32 address)
+  {
+    PC = address;
+    LR = address;
+    GetJit()->Jit(address);
+  }
+
+  static bool IsCompiled(u32 address)
+  {
+    return GetJit()->GetBlockCache()->GetBlockFromStartAddress(address, MSR.Hex) != nullptr;
+  }
+
+  static void AdvanceMilliseconds(u32 milliseconds)
+  {
+    PowerPC::ppcState.downcount -= SystemTimers::GetTicksPerSecond() / 1000 * milliseconds;
+    CoreTiming::Advance();
+  }
+
+  std::string m_profile_path;
+};
+}  // namespace
+
+TEST_F(TieredCompilationTest, TierUpThreshold)
+{
+  // Every execution below the threshold runs in the cold tier, including the first one.
+  for (u32 i = 1; i < TIER_UP_THRESHOLD; ++i)
+  {
+    Dispatch(BLOCK_A);
+    EXPECT_EQ(i, GPR(3));
+    EXPECT_EQ(BLOCK_A, PC);
+    EXPECT_FALSE(IsCompiled(BLOCK_A));
+  }
+
+  // Reaching the threshold only compiles the block, the dispatcher runs it afterwards.
+  Dispatch(BLOCK_A);
+  EXPECT_EQ(TIER_UP_THRESHOLD - 1, GPR(3));
+  EXPECT_TRUE(IsCompiled(BLOCK_A));
+}
+
+TEST_F(TieredCompilationTest, TierUpBudget)
+{
+  for (u32 i = 1; i < TIER_UP_THRESHOLD; ++i)
+  {
+    Dispatch(BLOCK_A);
+    Dispatch(BLOCK_B);
+  }
+
+  Dispatch(BLOCK_A);
+  EXPECT_TRUE(IsCompiled(BLOCK_A));
+
+  // The budget of this millisecond is used up, so the equally hot block B keeps running in the
+  // cold tier.
+  Dispatch(BLOCK_B);
+  EXPECT_EQ(TIER_UP_THRESHOLD, GPR(4));
+  EXPECT_FALSE(IsCompiled(BLOCK_B));
+
+  AdvanceMilliseconds(2);
+  Dispatch(BLOCK_B);
+  EXPECT_EQ(TIER_UP_THRESHOLD, GPR(4));
+  EXPECT_TRUE(IsCompiled(BLOCK_B));
+}
+
+TEST_F(TieredCompilationTest, InvalidateICache)
+{
+  Dispatch(BLOCK_A);
+  EXPECT_EQ(1u, GPR(3));
+
+  // The cold tier has to pick up the new code.
+  Memory::Write_U32(ADDI_R3_2, BLOCK_A);
+  JitInterface::InvalidateICache(BLOCK_A, 4, true);
+  Dispatch(BLOCK_A);
+  EXPECT_EQ(3u, GPR(3));
+
+  Dispatch(BLOCK_A);
+  ASSERT_TRUE(IsCompiled(BLOCK_A));
+  JitInterface::InvalidateICache(BLOCK_A, 4, true);
+  EXPECT_FALSE(IsCompiled(BLOCK_A));
+}
+
+TEST_F(TieredCompilationTest, ClearSafe)
+{
+  Dispatch(BLOCK_A);
+  EXPECT_EQ(1u, GPR(3));
+
+  Memory::Write_U32(ADDI_R3_2, BLOCK_A);
+  JitInterface::ClearSafe();
+  Dispatch(BLOCK_A);
+  EXPECT_EQ(3u, GPR(3));
+
+  Dispatch(BLOCK_A);
+  ASSERT_TRUE(IsCompiled(BLOCK_A));
+  JitInterface::ClearSafe();
+  EXPECT_FALSE(IsCompiled(BLOCK_A));
+}
@@ -0,0 +1,179 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+class TestBlockCache final : public JitBaseBlockCache
+{
+public:
+  using JitBaseBlockCache::JitBaseBlockCache;
+
+  size_t links = 0;
+  size_t unlinks = 0;
+
+private:
+  void WriteLinkBlock(const JitBlock::LinkData& source, const JitBlock* dest) override
+  {
+    if (dest)
+      ++links;
+    else
+      ++unlinks;
+  }
+};
+
+// Emulates what a JIT does when compiling a block: one instruction per word starting at
+// address, with a link exit for every entry in exits.
+JitBlock* AddBlock(TestBlockCache& cache, u32 address, u32 instructions,
+                   const std::vector<u32>& exits)
+{
+  JitBlock* block = cache.AllocateBlock(address);
+  block->checkedEntry = nullptr;
+  block->normalEntry = nullptr;
+  block->codeSize = 0;
+  block->originalSize = instructions;
+  for (u32 exit : exits)
+  {
+    JitBlock::LinkData link;
+    link.exitAddress = exit;
+    link.exitPtrs = nullptr;
+    link.linkStatus = false;
+    link.call = false;
+    block->linkData.push_back(link);
+  }
+
+  std::set<u32> physical_addresses;
+  for (u32 i = 0; i < instructions; ++i)
+    physical_addresses.insert(address + i * 4);
+  cache.FinalizeBlock(*block, true, physical_addresses);
+  return block;
+}
+}  // namespace
+
+TEST(JitBlockCache, LinkAndInvalidate)
+{
+  CachedInterpreter jit;
+  TestBlockCache cache(jit);
+  cache.Clear();
+
+  JitBlock* a = AddBlock(cache, 0x1000, 4, {0x2000});
+  EXPECT_EQ(0u, cache.links);
+
+  // Compiling the destination links the pending exit of a.
+  JitBlock* b = AddBlock(cache, 0x2000, 4, {0x1000, 0x2000});
+  EXPECT_EQ(3u, cache.links);
+  EXPECT_TRUE(a->linkData[0].linkStatus);
+  EXPECT_EQ(a, cache.GetBlockFromStartAddress(0x1000, 0));
+  EXPECT_EQ(b, cache.GetBlockFromStartAddress(0x2000, 0));
+  EXPECT_EQ(nullptr, cache.GetBlockFromStartAddress(0x3000, 0));
+
+  // Invalidating b unlinks everything pointing to it, including itself.
+  cache.InvalidateICache(0x2000, 32, false);
+  EXPECT_EQ(nullptr, cache.GetBlockFromStartAddress(0x2000, 0));
+  EXPECT_EQ(a, cache.GetBlockFromStartAddress(0x1000, 0));
+  EXPECT_FALSE(a->linkData[0].linkStatus);
+
+  // Recompiling b links a again.
+  cache.links = 0;
+  b = AddBlock(cache, 0x2000, 4, {});
+  EXPECT_EQ(1u, cache.links);
+  EXPECT_TRUE(a->linkData[0].linkStatus);
+
+  size_t count = 0;
+  cache.RunOnBlocks([&count](const JitBlock&) { ++count; });
+  EXPECT_EQ(2u, count);
+
+  cache.InvalidateICache(0, 0xffffffff, true);
+  count = 0;
+  cache.RunOnBlocks([&count](const JitBlock&) { ++count; });
+  EXPECT_EQ(0u, count);
+}
+
+TEST(JitBlockCache, BlocksSpanningMacroBlocks)
+{
+  CachedInterpreter jit;
+  TestBlockCache cache(jit);
+  cache.Clear();
+
+  // 0x40 instructions cover 0x100 bytes, so both blocks touch two macro blocks.
+  AddBlock(cache, 0x80, 0x40, {});
+  AddBlock(cache, 0x100, 0x40, {});
+
+  // Only touches the first block.
+  cache.ErasePhysicalRange(0x80, 4);
+  EXPECT_EQ(nullptr, cache.GetBlockFromStartAddress(0x80, 0));
+  EXPECT_NE(nullptr, cache.GetBlockFromStartAddress(0x100, 0));
+
+  // Overlaps the tail of the second block only.
+  cache.ErasePhysicalRange(0x1FC, 4);
+  EXPECT_EQ(nullptr, cache.GetBlockFromStartAddress(0x100, 0));
+
+  // Blocks can be reallocated after everything has been freed.
+  AddBlock(cache, 0x80, 0x40, {});
+  EXPECT_NE(nullptr, cache.GetBlockFromStartAddress(0x80, 0));
+}
+
+// Replays the invalidation pattern of a game which keeps streaming code overlays into the same
+// memory region: compile a few thousand linked blocks, then repeatedly throw away one overlay
+// with dcbi-style 32 byte invalidations or one big DMA invalidation and recompile it.
+//
+// Run with --gtest_also_run_disabled_tests to get timings.
+TEST(JitBlockCache, DISABLED_OverlayInvalidationBenchmark)
+{
+  constexpr u32 OVERLAY_BASE = 0x00400000;
+  constexpr u32 OVERLAY_SIZE = 0x20000;
+  constexpr u32 OVERLAY_COUNT = 8;
+  constexpr u32 BLOCK_INSTRUCTIONS = 12;
+  constexpr u32 BLOCK_SIZE = BLOCK_INSTRUCTIONS * 4;
+  constexpr int ROUNDS = 200;
+
+  CachedInterpreter jit;
+  TestBlockCache cache(jit);
+  cache.Clear();
+
+  std::mt19937 rng(42);
+  const auto compile_overlay = [&](u32 overlay) {
+    const u32 start = OVERLAY_BASE + overlay * OVERLAY_SIZE;
+    for (u32 address = start; address < start + OVERLAY_SIZE; address += BLOCK_SIZE)
+    {
+      const u32 branch_target = start + (rng() % (OVERLAY_SIZE / BLOCK_SIZE)) * BLOCK_SIZE;
+      AddBlock(cache, address, BLOCK_INSTRUCTIONS, {address + BLOCK_SIZE, branch_target});
+    }
+  };
+
+  for (u32 overlay = 0; overlay < OVERLAY_COUNT; ++overlay)
+    compile_overlay(overlay);
+
+  const auto start_time = std::chrono::steady_clock::now();
+  for (int round = 0; round < ROUNDS; ++round)
+  {
+    const u32 overlay = rng() % OVERLAY_COUNT;
+    const u32 start = OVERLAY_BASE + overlay * OVERLAY_SIZE;
+    if (round % 2 == 0)
+    {
+      for (u32 address = start; address < start + OVERLAY_SIZE; address += 32)
+        cache.InvalidateICache(address, 32, false);
+    }
+    else
+    {
+      cache.InvalidateICache(start, OVERLAY_SIZE, false);
+    }
+    compile_overlay(overlay);
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start_time;
+
+  std::printf("%d overlay reloads of %u blocks: %.2f ms\n", ROUNDS, OVERLAY_SIZE / BLOCK_SIZE,
+              std::chrono::duration<double, std::milli>(elapsed).count());
+}
@@ -0,0 +1,254 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigLoaders/BaseConfigLoader.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "Core/MemTools.h"
+#include "Core/PowerPC/BreakPoints.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr u32 HW_PAGE_SIZE = 0x1000;
+constexpr u32 PAGE_TABLE_BASE = 0x00100000;
+constexpr u32 SEGMENT = 1;
+constexpr u32 VSID = 0x123;
+constexpr u32 VIRTUAL_BASE = SEGMENT << 28;
+constexpr u32 PHYSICAL_BASE = 0x00200000;
+// Pages this far apart share a set of the TLB.
+constexpr u32 TLB_SET_STRIDE = 64 * HW_PAGE_SIZE;
+
+constexpr u32 PTE2_C = 1 << 7;
+constexpr u32 PTE2_R = 1 << 8;
+constexpr u32 PTE2_PP_READ_WRITE = 2;
+
+class MMUTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    Config::AddLayer(ConfigLoaders::GenerateBaseConfigLoader());
+    SConfig::Init();
+    SConfig::GetInstance().bMMU = true;
+    SConfig::GetInstance().bFastmem = true;
+    EMM::InstallExceptionHandler();
+    Memory::Init();
+    PowerPC::InitHostPageTable();
+
+    PowerPC::ppcState.tlb = {};
+    std::fill(std::begin(PowerPC::ppcState.spr), std::end(PowerPC::ppcState.spr), 0U);
+    PowerPC::DBATUpdated();
+    PowerPC::ppcState.SetSR(SEGMENT, VSID);
+    SetSDR1(PAGE_TABLE_BASE);
+    MSR.DR = 1;
+  }
+
+  void TearDown() override
+  {
+    MSR.DR = 0;
+    PowerPC::memchecks.Clear();
+    PowerPC::ShutdownHostPageTable();
+    Memory::Shutdown();
+    EMM::UninstallExceptionHandler();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  static void SetSDR1(u32 page_table_base)
+  {
+    // The smallest page table, 64 KiB.
+    PowerPC::ppcState.spr[SPR_SDR] = page_table_base;
+    PowerPC::SDRUpdated();
+  }
+
+  // Adds a PTE to the primary PTEG of the page, and returns the physical address of its second
+  // word.
+  static u32 MapPage(u32 effective_address, u32 physical_address, u32 vsid = VSID,
+                     u32 page_table_base = PAGE_TABLE_BASE)
+  {
+    const u32 page_index = (effective_address >> 12) & 0xffff;
+    const u32 api = (effective_address >> 22) & 0x3f;
+    u32 pteg_address = (((vsid ^ page_index) & 0x3ff) << 6) | page_table_base;
+    while (Memory::Read_U32(pteg_address) != 0)
+      pteg_address += 8;
+
+    Memory::Write_U32((1U << 31) | (vsid << 7) | api, pteg_address);
+    Memory::Write_U32(physical_address | PTE2_PP_READ_WRITE, pteg_address + 4);
+    return pteg_address + 4;
+  }
+
+  static bool IsMappedForRead(u32 effective_address)
+  {
+    return PowerPC::ppcState.host_page_table[effective_address >> PowerPC::HOST_PAGE_TABLE_SHIFT]
+               .read != 0;
+  }
+
+  static bool IsMappedForWrite(u32 effective_address)
+  {
+    return PowerPC::ppcState.host_page_table[effective_address >> PowerPC::HOST_PAGE_TABLE_SHIFT]
+               .write != 0;
+  }
+
+  std::string m_profile_path;
+};
+}  // namespace
+
+TEST_F(MMUTest, ReferencedAndChangedBits)
+{
+  const u32 pte2_address = MapPage(VIRTUAL_BASE, PHYSICAL_BASE);
+  Memory::Write_U32(0x12345678, PHYSICAL_BASE + 0x10);
+
+  EXPECT_EQ(0x12345678u, PowerPC::Read_U32(VIRTUAL_BASE + 0x10));
+  EXPECT_EQ(PTE2_R, Memory::Read_U32(pte2_address) & (PTE2_R | PTE2_C));
+  EXPECT_TRUE(IsMappedForRead(VIRTUAL_BASE));
+  EXPECT_FALSE(IsMappedForWrite(VIRTUAL_BASE));
+
+  // The first write must take the slow path to set the C bit.
+  PowerPC::Write_U32(0xCAFEBABE, VIRTUAL_BASE + 0x20);
+  EXPECT_EQ(PTE2_R | PTE2_C, Memory::Read_U32(pte2_address) & (PTE2_R | PTE2_C));
+  EXPECT_TRUE(IsMappedForWrite(VIRTUAL_BASE));
+
+  PowerPC::Write_U32(0xDEADBEEF, VIRTUAL_BASE + 0x24);
+  EXPECT_EQ(0xCAFEBABEu, Memory::Read_U32(PHYSICAL_BASE + 0x20));
+  EXPECT_EQ(0xDEADBEEFu, Memory::Read_U32(PHYSICAL_BASE + 0x24));
+  EXPECT_EQ(0xDEADBEEFu, PowerPC::Read_U32(VIRTUAL_BASE + 0x24));
+}
+
+TEST_F(MMUTest, UnalignedAccessAcrossPages)
+{
+  MapPage(VIRTUAL_BASE, PHYSICAL_BASE);
+  MapPage(VIRTUAL_BASE + HW_PAGE_SIZE, PHYSICAL_BASE + 0x10 * HW_PAGE_SIZE);
+  Memory::Write_U32(0x11223344, PHYSICAL_BASE + HW_PAGE_SIZE - 4);
+  Memory::Write_U32(0x55667788, PHYSICAL_BASE + 0x10 * HW_PAGE_SIZE);
+
+  PowerPC::Read_U32(VIRTUAL_BASE);
+  PowerPC::Read_U32(VIRTUAL_BASE + HW_PAGE_SIZE);
+  EXPECT_EQ(0x33445566u, PowerPC::Read_U32(VIRTUAL_BASE + HW_PAGE_SIZE - 2));
+}
+
+TEST_F(MMUTest, TLBInvalidateEntry)
+{
+  const u32 pte2_address = MapPage(VIRTUAL_BASE, PHYSICAL_BASE);
+  Memory::Write_U32(1, PHYSICAL_BASE);
+  Memory::Write_U32(2, PHYSICAL_BASE + HW_PAGE_SIZE);
+  EXPECT_EQ(1u, PowerPC::Read_U32(VIRTUAL_BASE));
+
+  // Remapping the page is only visible after tlbie.
+  Memory::Write_U32((PHYSICAL_BASE + HW_PAGE_SIZE) | PTE2_PP_READ_WRITE, pte2_address);
+  EXPECT_EQ(1u, PowerPC::Read_U32(VIRTUAL_BASE));
+  PowerPC::InvalidateTLBEntry(VIRTUAL_BASE);
+  EXPECT_FALSE(IsMappedForRead(VIRTUAL_BASE));
+  EXPECT_EQ(2u, PowerPC::Read_U32(VIRTUAL_BASE));
+}
+
+TEST_F(MMUTest, SegmentRegisterChange)
+{
+  MapPage(VIRTUAL_BASE, PHYSICAL_BASE);
+  MapPage(VIRTUAL_BASE, PHYSICAL_BASE + HW_PAGE_SIZE, VSID + 1);
+  Memory::Write_U32(1, PHYSICAL_BASE);
+  Memory::Write_U32(2, PHYSICAL_BASE + HW_PAGE_SIZE);
+  EXPECT_EQ(1u, PowerPC::Read_U32(VIRTUAL_BASE));
+
+  PowerPC::ppcState.SetSR(SEGMENT, VSID + 1);
+  EXPECT_FALSE(IsMappedForRead(VIRTUAL_BASE));
+  // The TLB is not tagged with the VSID, so software has to flush it after changing an SR.
+  PowerPC::InvalidateTLBEntry(VIRTUAL_BASE);
+  EXPECT_EQ(2u, PowerPC::Read_U32(VIRTUAL_BASE));
+}
+
+TEST_F(MMUTest, PageTableChange)
+{
+  constexpr u32 other_page_table = PAGE_TABLE_BASE + 0x10000;
+  MapPage(VIRTUAL_BASE, PHYSICAL_BASE);
+  MapPage(VIRTUAL_BASE, PHYSICAL_BASE + HW_PAGE_SIZE, VSID, other_page_table);
+  Memory::Write_U32(1, PHYSICAL_BASE);
+  Memory::Write_U32(2, PHYSICAL_BASE + HW_PAGE_SIZE);
+  EXPECT_EQ(1u, PowerPC::Read_U32(VIRTUAL_BASE));
+
+  SetSDR1(other_page_table);
+  EXPECT_FALSE(IsMappedForRead(VIRTUAL_BASE));
+  PowerPC::InvalidateTLBEntry(VIRTUAL_BASE);
+  EXPECT_EQ(2u, PowerPC::Read_U32(VIRTUAL_BASE));
+}
+
+TEST_F(MMUTest, BATTakesPrecedence)
+{
+  MapPage(VIRTUAL_BASE, PHYSICAL_BASE);
+  Memory::Write_U32(1, PHYSICAL_BASE);
+  Memory::Write_U32(2, PHYSICAL_BASE + 0x100000);
+  EXPECT_EQ(1u, PowerPC::Read_U32(VIRTUAL_BASE));
+
+  // A 128 KiB BAT which is valid in supervisor and user mode.
+  PowerPC::ppcState.spr[SPR_DBAT0U] = VIRTUAL_BASE | 3;
+  PowerPC::ppcState.spr[SPR_DBAT0L] = (PHYSICAL_BASE + 0x100000) | PTE2_PP_READ_WRITE;
+  PowerPC::DBATUpdated();
+  EXPECT_FALSE(IsMappedForRead(VIRTUAL_BASE));
+  EXPECT_EQ(2u, PowerPC::Read_U32(VIRTUAL_BASE));
+  EXPECT_FALSE(IsMappedForRead(VIRTUAL_BASE));
+}
+
+TEST_F(MMUTest, Memchecks)
+{
+  MapPage(VIRTUAL_BASE, PHYSICAL_BASE);
+  PowerPC::Read_U32(VIRTUAL_BASE);
+  EXPECT_TRUE(IsMappedForRead(VIRTUAL_BASE));
+
+  TMemCheck memcheck;
+  memcheck.start_address = VIRTUAL_BASE + 0x40;
+  memcheck.end_address = VIRTUAL_BASE + 0x43;
+  memcheck.is_break_on_read = true;
+  memcheck.is_break_on_write = true;
+  PowerPC::memchecks.Add(memcheck);
+  EXPECT_FALSE(IsMappedForRead(VIRTUAL_BASE));
+
+  PowerPC::Read_U32(VIRTUAL_BASE + 0x40);
+  PowerPC::Write_U32(0, VIRTUAL_BASE + 0x40);
+  EXPECT_FALSE(IsMappedForRead(VIRTUAL_BASE));
+  EXPECT_FALSE(IsMappedForWrite(VIRTUAL_BASE));
+  EXPECT_EQ(2u, PowerPC::memchecks.GetMemCheck(VIRTUAL_BASE + 0x40)->num_hits);
+
+  PowerPC::memchecks.Remove(VIRTUAL_BASE + 0x40);
+  PowerPC::Read_U32(VIRTUAL_BASE);
+  EXPECT_TRUE(IsMappedForRead(VIRTUAL_BASE));
+}
+
+TEST_F(MMUTest, FastPathKeepsPagesInTLB)
+{
+  const u32 hot = VIRTUAL_BASE;
+  const u32 cold = VIRTUAL_BASE + TLB_SET_STRIDE;
+  const u32 incoming = VIRTUAL_BASE + 2 * TLB_SET_STRIDE;
+  MapPage(hot, PHYSICAL_BASE);
+  MapPage(cold, PHYSICAL_BASE + HW_PAGE_SIZE);
+  MapPage(incoming, PHYSICAL_BASE + 2 * HW_PAGE_SIZE);
+
+  PowerPC::Read_U32(hot);
+  PowerPC::Read_U32(cold);
+  ASSERT_TRUE(IsMappedForRead(hot));
+  ASSERT_TRUE(IsMappedForRead(cold));
+
+  // Only goes through the host page table, but still makes the hot page the most recently used
+  // one in its TLB set.
+  PowerPC::Read_U32(hot + 4);
+
+  PowerPC::Read_U32(incoming);
+  EXPECT_TRUE(IsMappedForRead(hot));
+  EXPECT_FALSE(IsMappedForRead(cold));
+  EXPECT_TRUE(IsMappedForRead(incoming));
+}
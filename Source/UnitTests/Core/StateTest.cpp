@@ -0,0 +1,162 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Core/State.h"
+
+namespace
+{
+// Mirrors the layout at the end of a chunked state.
+constexpr size_t INDEX_ENTRY_SIZE = 16;
+constexpr size_t FOOTER_SIZE = 16;
+constexpr size_t DATA_START = sizeof(State::StateHeader) + sizeof(u32);
+
+class StateTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_dir = File::CreateTempDir();
+    m_filename = m_dir + DIR_SEP "test.sav";
+
+    // A bit more than two chunks, compressible but not trivially so.
+    m_data.resize(2 * 1024 * 1024 + 12345);
+    u32 value = 1;
+    for (size_t i = 0; i < m_data.size(); ++i)
+    {
+      value = value * 1103515245 + 12345;
+      m_data[i] = static_cast<u8>((value >> 16) & 0x0F);
+    }
+
+    File::IOFile f(m_filename, "wb");
+    const State::StateHeader header{};
+    ASSERT_TRUE(f.WriteArray(&header, 1));
+    ASSERT_TRUE(State::WriteChunkedState(f, m_data.data(), m_data.size()));
+    f.Close();
+
+    ASSERT_TRUE(File::ReadFileToString(m_filename, m_file));
+  }
+
+  void TearDown() override { File::DeleteDirRecursively(m_dir); }
+
+  // Writes contents to the state file and reads it back the same way LoadFileStateData does.
+  bool Load(const std::string& contents, std::vector<u8>* buffer)
+  {
+    EXPECT_TRUE(File::WriteStringToFile(m_filename, contents));
+    File::IOFile f(m_filename, "rb");
+    u32 magic = 0;
+    if (!f.Seek(sizeof(State::StateHeader), SEEK_SET) || !f.ReadArray(&magic, 1))
+      return false;
+    return State::ReadChunkedState(f, static_cast<u32>(m_data.size()), *buffer);
+  }
+
+  template <typename T>
+  void Patch(std::string* contents, size_t offset, T value)
+  {
+    std::memcpy(contents->data() + offset, &value, sizeof(value));
+  }
+
+  size_t FooterOffset() const { return m_file.size() - FOOTER_SIZE; }
+  size_t IndexEntryOffset(size_t i) const
+  {
+    u64 index_offset;
+    std::memcpy(&index_offset, m_file.data() + FooterOffset(), sizeof(index_offset));
+    return index_offset + i * INDEX_ENTRY_SIZE;
+  }
+
+  std::string m_dir;
+  std::string m_filename;
+  std::vector<u8> m_data;
+  std::string m_file;
+};
+}  // namespace
+
+TEST_F(StateTest, RoundTrip)
+{
+  std::vector<u8> buffer;
+  ASSERT_TRUE(Load(m_file, &buffer));
+  EXPECT_EQ(m_data, buffer);
+}
+
+TEST_F(StateTest, Truncated)
+{
+  for (size_t size : {m_file.size() - 1, m_file.size() - FOOTER_SIZE, m_file.size() / 2,
+                      DATA_START + FOOTER_SIZE, DATA_START})
+  {
+    std::vector<u8> buffer;
+    EXPECT_FALSE(Load(m_file.substr(0, size), &buffer)) << size;
+    EXPECT_TRUE(buffer.empty()) << size;
+  }
+}
+
+TEST_F(StateTest, WrongUncompressedSize)
+{
+  std::vector<u8> buffer;
+  ASSERT_TRUE(File::WriteStringToFile(m_filename, m_file));
+  File::IOFile f(m_filename, "rb");
+  ASSERT_TRUE(f.Seek(DATA_START, SEEK_SET));
+  EXPECT_FALSE(State::ReadChunkedState(f, static_cast<u32>(m_data.size() - 1), buffer));
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST_F(StateTest, CorruptedFooter)
+{
+  std::string contents = m_file;
+  Patch<u32>(&contents, FooterOffset() + 8, std::numeric_limits<u32>::max());
+  std::vector<u8> buffer;
+  EXPECT_FALSE(Load(contents, &buffer));
+  EXPECT_TRUE(buffer.empty());
+
+  contents = m_file;
+  Patch<u64>(&contents, FooterOffset(), std::numeric_limits<u64>::max() - 8);
+  EXPECT_FALSE(Load(contents, &buffer));
+  EXPECT_TRUE(buffer.empty());
+
+  contents = m_file;
+  Patch<u64>(&contents, FooterOffset(), DATA_START - 1);
+  EXPECT_FALSE(Load(contents, &buffer));
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST_F(StateTest, CorruptedIndex)
+{
+  // Offsets and sizes which would overflow when added together.
+  std::string contents = m_file;
+  Patch<u64>(&contents, IndexEntryOffset(1), std::numeric_limits<u64>::max() - 4);
+  std::vector<u8> buffer;
+  EXPECT_FALSE(Load(contents, &buffer));
+  EXPECT_TRUE(buffer.empty());
+
+  contents = m_file;
+  Patch<u32>(&contents, IndexEntryOffset(1) + 8, std::numeric_limits<u32>::max());
+  EXPECT_FALSE(Load(contents, &buffer));
+  EXPECT_TRUE(buffer.empty());
+
+  contents = m_file;
+  Patch<u32>(&contents, IndexEntryOffset(2) + 12, std::numeric_limits<u32>::max());
+  EXPECT_FALSE(Load(contents, &buffer));
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST_F(StateTest, CorruptedChunk)
+{
+  u64 chunk_offset;
+  std::memcpy(&chunk_offset, m_file.data() + IndexEntryOffset(1), sizeof(chunk_offset));
+
+  // Break the zstd frame magic of the second chunk.
+  std::string contents = m_file;
+  Patch<u32>(&contents, chunk_offset, 0);
+  std::vector<u8> buffer;
+  EXPECT_FALSE(Load(contents, &buffer));
+}
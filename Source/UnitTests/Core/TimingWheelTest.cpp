@@ -0,0 +1,153 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include "Core/TimingWheel.h"
+
+using CoreTiming::Event;
+using CoreTiming::EventType;
+using CoreTiming::TimingWheel;
+
+// Only the addresses are used as keys.
+static std::array<char, 4> s_types;
+
+static EventType* GetType(u32 index)
+{
+  return reinterpret_cast<EventType*>(&s_types[index]);
+}
+
+static void ExpectSameEvent(const Event& expected, const Event& actual)
+{
+  EXPECT_EQ(expected.time, actual.time);
+  EXPECT_EQ(expected.fifo_order, actual.fifo_order);
+  EXPECT_EQ(expected.userdata, actual.userdata);
+  EXPECT_EQ(expected.type, actual.type);
+}
+
+TEST(TimingWheel, FifoOrderForSameTime)
+{
+  TimingWheel wheel;
+  wheel.Clear(0);
+
+  wheel.Insert(Event{100, 0, 0, GetType(0)});
+  wheel.Insert(Event{50, 1, 1, GetType(0)});
+  wheel.Insert(Event{100, 2, 2, GetType(1)});
+  wheel.Insert(Event{50, 3, 3, GetType(1)});
+  EXPECT_EQ(4u, wheel.Size());
+
+  for (u64 userdata : {1, 3, 0, 2})
+  {
+    ASSERT_FALSE(wheel.Empty());
+    EXPECT_EQ(userdata, wheel.Front().userdata);
+    wheel.PopFront();
+  }
+  EXPECT_TRUE(wheel.Empty());
+}
+
+TEST(TimingWheel, Remove)
+{
+  TimingWheel wheel;
+  wheel.Clear(1000);
+
+  wheel.Insert(Event{2000, 0, 0, GetType(0)});
+  wheel.Insert(Event{1500, 1, 1, GetType(1)});
+  wheel.Insert(Event{1 << 20, 2, 2, GetType(0)});
+  EXPECT_EQ(1u, wheel.Front().userdata);
+
+  wheel.Remove(GetType(1));
+  EXPECT_EQ(2u, wheel.Size());
+  EXPECT_EQ(0u, wheel.Front().userdata);
+
+  wheel.Remove(GetType(0));
+  EXPECT_TRUE(wheel.Empty());
+
+  // Removing a type without events does nothing.
+  wheel.Remove(GetType(2));
+  EXPECT_TRUE(wheel.Empty());
+}
+
+TEST(TimingWheel, ScheduleIntoPast)
+{
+  TimingWheel wheel;
+  wheel.Clear(0);
+
+  wheel.Insert(Event{5000, 0, 0, GetType(0)});
+  wheel.Insert(Event{6000, 1, 1, GetType(0)});
+  wheel.PopFront();
+
+  // Events which were late when they got scheduled still come out in order.
+  wheel.Insert(Event{4000, 2, 2, GetType(1)});
+  wheel.Insert(Event{-10, 3, 3, GetType(1)});
+  wheel.Insert(Event{4000, 4, 4, GetType(1)});
+  for (u64 userdata : {3, 2, 4, 1})
+  {
+    EXPECT_EQ(userdata, wheel.Front().userdata);
+    wheel.PopFront();
+  }
+  EXPECT_TRUE(wheel.Empty());
+}
+
+// Runs a random mix of operations against a sorted vector.
+TEST(TimingWheel, MatchesSortedReference)
+{
+  std::mt19937_64 rng(1234);
+  TimingWheel wheel;
+  wheel.Clear(0);
+  std::vector<Event> reference;
+
+  s64 now = 0;
+  u64 fifo_order = 0;
+  for (int i = 0; i < 200000; ++i)
+  {
+    const u32 op = rng() % 16;
+    if (op < 8)
+    {
+      // Mostly short delays like real events, with the occasional far away or late one.
+      s64 delay;
+      if (op < 5)
+        delay = rng() % 2000;
+      else if (op < 7)
+        delay = rng() % (s64{1} << (rng() % 40));
+      else
+        delay = -static_cast<s64>(rng() % 500);
+
+      const Event event{now + delay, fifo_order++, rng(), GetType(rng() % s_types.size())};
+      wheel.Insert(event);
+      reference.push_back(event);
+    }
+    else if (op < 15)
+    {
+      if (reference.empty())
+        continue;
+
+      const auto front = std::min_element(reference.begin(), reference.end());
+      ExpectSameEvent(*front, wheel.Front());
+      now = std::max(now, front->time);
+      reference.erase(front);
+      wheel.PopFront();
+    }
+    else
+    {
+      EventType* type = GetType(rng() % s_types.size());
+      wheel.Remove(type);
+      reference.erase(std::remove_if(reference.begin(), reference.end(),
+                                     [type](const Event& e) { return e.type == type; }),
+                      reference.end());
+    }
+
+    ASSERT_EQ(reference.size(), wheel.Size());
+  }
+
+  std::sort(reference.begin(), reference.end());
+  const std::vector<Event> sorted = wheel.GetSortedEvents();
+  ASSERT_EQ(reference.size(), sorted.size());
+  for (size_t i = 0; i < sorted.size(); ++i)
+    ExpectSameEvent(reference[i], sorted[i]);
+}
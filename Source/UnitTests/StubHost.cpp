@@ -49,3 +49,6 @@ void Host_YieldToUI()
 void Host_TitleChanged()
 {
 }
+void Host_TargetRectangleWasUpdated()
+{
+}
@@ -0,0 +1,381 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/EfbInterface.h"
+#include "VideoBackends/Software/NativeVertexFormat.h"
+#include "VideoBackends/Software/Rasterizer.h"
+#include "VideoBackends/Software/Tev.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/BoundingBox.h"
+#include "VideoCommon/PerfQueryBase.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace
+{
+constexpr u32 WORKER_THREADS = 3;
+
+// Everything the rasterizer threads write to.
+struct RenderResult
+{
+  std::vector<u32> color;
+  std::vector<u32> depth;
+  std::array<u32, PQ_NUM_MEMBERS> perf_values{};
+  std::array<u16, 4> bbox{};
+  int rasterized_pixels = 0;
+  int tev_pixels_in = 0;
+  int tev_pixels_out = 0;
+};
+
+class RasterizerTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_saved_config = g_ActiveConfig;
+
+    g_ActiveConfig.bZFreeze = true;
+    g_ActiveConfig.bZComploc = true;
+    g_ActiveConfig.bDumpTevStages = false;
+    g_ActiveConfig.bDumpTevTextureFetches = false;
+
+    Rasterizer::Init();
+  }
+
+  void TearDown() override
+  {
+    g_ActiveConfig.iSWRasterizerThreads = 0;
+    Rasterizer::Flush();
+    Rasterizer::Shutdown();
+
+    std::memset(static_cast<void*>(&bpmem), 0, sizeof(bpmem));
+    g_ActiveConfig = m_saved_config;
+  }
+
+  // Untextured triangles with a single stage passing the rasterized color through.
+  static void SetUpBPMemory()
+  {
+    std::memset(static_cast<void*>(&bpmem), 0, sizeof(bpmem));
+    bpmem.genMode.numcolchans = 1;
+
+    // Scissor covering the whole EFB.
+    bpmem.scissorTL.x = 342;
+    bpmem.scissorTL.y = 342;
+    bpmem.scissorBR.x = 342 + EFB_WIDTH - 1;
+    bpmem.scissorBR.y = 342 + EFB_HEIGHT - 1;
+    bpmem.scissorOffset.x = 342 / 2;
+    bpmem.scissorOffset.y = 342 / 2;
+
+    // Identity swap tables.
+    bpmem.tevksel[0].swap1 = 0;
+    bpmem.tevksel[0].swap2 = 1;
+    bpmem.tevksel[1].swap1 = 2;
+    bpmem.tevksel[1].swap2 = 3;
+
+    TevStageCombiner& stage = bpmem.combiners[0];
+    stage.colorC.a = TEVCOLORARG_ZERO;
+    stage.colorC.b = TEVCOLORARG_ZERO;
+    stage.colorC.c = TEVCOLORARG_ZERO;
+    stage.colorC.d = TEVCOLORARG_RASC;
+    stage.colorC.clamp = 1;
+    stage.alphaC.a = TEVALPHAARG_ZERO;
+    stage.alphaC.b = TEVALPHAARG_ZERO;
+    stage.alphaC.c = TEVALPHAARG_ZERO;
+    stage.alphaC.d = TEVALPHAARG_RASA;
+    stage.alphaC.clamp = 1;
+
+    bpmem.alpha_test.comp0 = AlphaTest::ALWAYS;
+    bpmem.alpha_test.comp1 = AlphaTest::ALWAYS;
+    bpmem.zmode.testenable = 1;
+    bpmem.zmode.func = ZMode::LEQUAL;
+    bpmem.zmode.updateenable = 1;
+    bpmem.blendmode.colorupdate = 1;
+    bpmem.blendmode.alphaupdate = 1;
+    bpmem.zcontrol.pixel_format = PEControl::RGBA6_Z24;
+  }
+
+  // Samples an intensity texture through an indirect stage offset by a color texture, and
+  // combines it with both color channels over three stages, using the konst colors, comparisons
+  // and fog.
+  static void SetUpTexturedShading()
+  {
+    bpmem.genMode.numcolchans = 2;
+    bpmem.genMode.numtexgens = 1;
+    bpmem.genMode.numindstages = 1;
+    bpmem.genMode.numtevstages = 2;
+
+    // Texture 0 is a 64x64 I8 texture, texture 1 a 32x32 RGB565 texture, both preloaded.
+    FourTexUnits& units = bpmem.tex[0];
+    for (int i = 0; i < 2; i++)
+    {
+      units.texMode0[i].wrap_s = 1;
+      units.texMode0[i].wrap_t = 2;
+      units.texMode0[i].mag_filter = 1;
+      units.texMode0[i].min_filter = 4;
+      units.texImage1[i].image_type = 1;
+    }
+    units.texImage0[0].width = 63;
+    units.texImage0[0].height = 63;
+    units.texImage0[0].format = static_cast<u32>(TextureFormat::I8);
+    units.texImage0[1].width = 31;
+    units.texImage0[1].height = 31;
+    units.texImage0[1].format = static_cast<u32>(TextureFormat::RGB565);
+    units.texImage1[1].tmem_even = 64 * 64 / TMEM_LINE_SIZE;
+
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<int> byte_dist(0, 255);
+    for (u32 i = 0; i < 64 * 64 + 32 * 32 * 2; i++)
+      texMem[i] = static_cast<u8>(byte_dist(generator));
+
+    bpmem.tevindref.bi0 = 1;
+    bpmem.tevindref.bc0 = 0;
+    TevStageIndirect& indirect = bpmem.tevind[0];
+    indirect.bt = 0;
+    indirect.fmt = ITF_8;
+    indirect.bias = 3;
+    indirect.bs = ITBA_S;
+    indirect.mid = 1;
+    bpmem.indmtx[0].col0.ma = 200;
+    bpmem.indmtx[0].col0.mb = -100;
+    bpmem.indmtx[0].col1.mc = 50;
+    bpmem.indmtx[0].col1.md = 300;
+    bpmem.indmtx[0].col0.s0 = 1;
+
+    // Stage 0: tex * (1 - konst) + ras * konst, scaled by 2.
+    bpmem.tevorders[0].texmap0 = 0;
+    bpmem.tevorders[0].texcoord0 = 0;
+    bpmem.tevorders[0].enable0 = 1;
+    bpmem.tevorders[0].colorchan0 = 0;
+    bpmem.tevksel[0].kcsel0 = 12;
+    bpmem.tevksel[0].kasel0 = 28;
+    TevStageCombiner& stage0 = bpmem.combiners[0];
+    stage0.colorC.hex = 0;
+    stage0.colorC.a = TEVCOLORARG_TEXC;
+    stage0.colorC.b = TEVCOLORARG_RASC;
+    stage0.colorC.c = TEVCOLORARG_KONST;
+    stage0.colorC.d = TEVCOLORARG_ZERO;
+    stage0.colorC.shift = 1;
+    stage0.colorC.clamp = 1;
+    stage0.alphaC.hex = 0;
+    stage0.alphaC.a = TEVALPHAARG_TEXA;
+    stage0.alphaC.b = TEVALPHAARG_RASA;
+    stage0.alphaC.c = TEVALPHAARG_KONST;
+    stage0.alphaC.d = TEVALPHAARG_ZERO;
+    stage0.alphaC.clamp = 1;
+
+    // Stage 1: compares prev against the alpha bump for the color, subtracts for the alpha.
+    bpmem.tevorders[0].colorchan1 = 5;
+    TevStageCombiner& stage1 = bpmem.combiners[1];
+    stage1.colorC.hex = 0;
+    stage1.colorC.a = TEVCOLORARG_CPREV;
+    stage1.colorC.b = TEVCOLORARG_RASC;
+    stage1.colorC.c = TEVCOLORARG_HALF;
+    stage1.colorC.d = TEVCOLORARG_CPREV;
+    stage1.colorC.bias = 3;
+    stage1.colorC.dest = 1;
+    stage1.alphaC.hex = 0;
+    stage1.alphaC.a = TEVALPHAARG_APREV;
+    stage1.alphaC.b = TEVALPHAARG_RASA;
+    stage1.alphaC.c = TEVALPHAARG_TEXA;
+    stage1.alphaC.d = TEVALPHAARG_APREV;
+    stage1.alphaC.bias = 1;
+    stage1.alphaC.op = 1;
+
+    // Stage 2: modulates with the second color channel and the texture again.
+    bpmem.tevorders[1].texmap0 = 0;
+    bpmem.tevorders[1].texcoord0 = 0;
+    bpmem.tevorders[1].enable0 = 1;
+    bpmem.tevorders[1].colorchan0 = 1;
+    TevStageCombiner& stage2 = bpmem.combiners[2];
+    stage2.colorC.hex = 0;
+    stage2.colorC.a = TEVCOLORARG_ZERO;
+    stage2.colorC.b = TEVCOLORARG_C0;
+    stage2.colorC.c = TEVCOLORARG_RASA;
+    stage2.colorC.d = TEVCOLORARG_TEXC;
+    stage2.colorC.bias = 2;
+    stage2.colorC.clamp = 1;
+    stage2.alphaC.hex = 0;
+    stage2.alphaC.a = TEVALPHAARG_APREV;
+    stage2.alphaC.b = TEVALPHAARG_RASA;
+    stage2.alphaC.c = TEVALPHAARG_TEXA;
+    stage2.alphaC.d = TEVALPHAARG_APREV;
+    stage2.alphaC.bias = 3;
+    stage2.alphaC.shift = 3;
+    stage2.alphaC.op = 1;
+    stage2.alphaC.clamp = 1;
+
+    Rasterizer::SetTevReg(0, Tev::RED_C, 40);
+    Rasterizer::SetTevReg(0, Tev::GRN_C, 130);
+    Rasterizer::SetTevReg(0, Tev::BLU_C, 220);
+    Rasterizer::SetTevReg(0, Tev::ALP_C, 90);
+
+    // Linear orthographic fog.
+    bpmem.fog.a.exp = 126;
+    bpmem.fog.c_proj_fsel.proj = 1;
+    bpmem.fog.c_proj_fsel.fsel = 2;
+    bpmem.fog.color.r = 200;
+    bpmem.fog.color.g = 100;
+    bpmem.fog.color.b = 50;
+  }
+
+  // Draws random triangles which are large enough for the batch to be handed to the workers, and
+  // which overlap each other and the tile edges.
+  static void DrawTriangles(u32 seed, u32 count)
+  {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> x_dist(-40.0f, EFB_WIDTH + 40.0f);
+    std::uniform_real_distribution<float> y_dist(-40.0f, EFB_HEIGHT + 40.0f);
+    std::uniform_real_distribution<float> offset_dist(-160.0f, 160.0f);
+    std::uniform_real_distribution<float> z_dist(0.0f, 16777215.0f);
+    std::uniform_real_distribution<float> w_dist(0.5f, 2.0f);
+    std::uniform_real_distribution<float> tex_dist(-64.0f, 192.0f);
+    std::uniform_int_distribution<int> color_dist(0, 255);
+
+    for (u32 i = 0; i < count; ++i)
+    {
+      std::array<OutputVertexData, 3> vertices;
+      const float center_x = x_dist(generator);
+      const float center_y = y_dist(generator);
+      for (OutputVertexData& vertex : vertices)
+      {
+        // Clipping happens before the rasterizer, so keep the vertices on screen.
+        vertex.screenPosition.x =
+            std::clamp(center_x + offset_dist(generator), 0.0f, EFB_WIDTH - 1.0f);
+        vertex.screenPosition.y =
+            std::clamp(center_y + offset_dist(generator), 0.0f, EFB_HEIGHT - 1.0f);
+        vertex.screenPosition.z = z_dist(generator);
+        vertex.projectedPosition.w = w_dist(generator);
+        for (auto& color : vertex.color)
+        {
+          for (u8& component : color)
+            component = static_cast<u8>(color_dist(generator));
+        }
+        vertex.texCoords[0] = {tex_dist(generator), tex_dist(generator), 1.0f};
+      }
+
+      // Culling also happens before the rasterizer, which only draws one winding.
+      const Vec3& p0 = vertices[0].screenPosition;
+      const Vec3& p1 = vertices[1].screenPosition;
+      const Vec3& p2 = vertices[2].screenPosition;
+      if ((p1.x - p0.x) * (p2.y - p0.y) - (p1.y - p0.y) * (p2.x - p0.x) > 0.0f)
+        std::swap(vertices[1], vertices[2]);
+
+      Rasterizer::DrawTriangleFrontFace(&vertices[0], &vertices[1], &vertices[2]);
+    }
+  }
+
+  // Draws the same scene with the given number of worker threads and reads back the results.
+  static RenderResult Render(u32 worker_threads)
+  {
+    // The worker count takes effect when flushing.
+    g_ActiveConfig.iSWRasterizerThreads = static_cast<int>(worker_threads);
+    Rasterizer::Flush();
+    SetUpBPMemory();
+
+    for (u16 y = 0; y < EFB_HEIGHT; ++y)
+    {
+      for (u16 x = 0; x < EFB_WIDTH; ++x)
+      {
+        u8 color[4] = {};
+        EfbInterface::SetColor(x, y, color);
+        EfbInterface::SetDepth(x, y, 0xFFFFFF);
+      }
+    }
+    EfbInterface::ResetPerfQuery();
+    BoundingBox::SetCoordinate(BoundingBox::Coordinate::Left, EFB_WIDTH);
+    BoundingBox::SetCoordinate(BoundingBox::Coordinate::Right, 0);
+    BoundingBox::SetCoordinate(BoundingBox::Coordinate::Top, EFB_HEIGHT);
+    BoundingBox::SetCoordinate(BoundingBox::Coordinate::Bottom, 0);
+    g_stats.ResetFrame();
+
+    // Late depth test. The state only changes between flushes, like in the video backend.
+    DrawTriangles(1, 64);
+    Rasterizer::Flush();
+
+    // zfreeze keeps the depth slope of the last triangle drawn before.
+    bpmem.genMode.zfreeze = 1;
+    DrawTriangles(2, 64);
+    Rasterizer::Flush();
+    bpmem.genMode.zfreeze = 0;
+
+    // Early depth test.
+    bpmem.zcontrol.early_ztest = 1;
+    DrawTriangles(3, 64);
+    Rasterizer::Flush();
+    bpmem.zcontrol.early_ztest = 0;
+
+    // Alpha test, so that pixels are discarded between the two depth tests.
+    bpmem.alpha_test.comp0 = AlphaTest::GREATER;
+    bpmem.alpha_test.ref0 = 128;
+    DrawTriangles(4, 64);
+    Rasterizer::Flush();
+    bpmem.alpha_test.comp0 = AlphaTest::ALWAYS;
+
+    SetUpTexturedShading();
+    DrawTriangles(5, 64);
+    Rasterizer::Flush();
+
+    RenderResult result;
+    result.color.reserve(EFB_WIDTH * EFB_HEIGHT);
+    result.depth.reserve(EFB_WIDTH * EFB_HEIGHT);
+    for (u16 y = 0; y < EFB_HEIGHT; ++y)
+    {
+      for (u16 x = 0; x < EFB_WIDTH; ++x)
+      {
+        result.color.push_back(EfbInterface::GetColor(x, y));
+        result.depth.push_back(EfbInterface::GetDepth(x, y));
+      }
+    }
+    for (u32 i = 0; i < PQ_NUM_MEMBERS; ++i)
+      result.perf_values[i] = EfbInterface::GetPerfQueryResult(static_cast<PerfQueryType>(i));
+    result.bbox = {BoundingBox::GetCoordinate(BoundingBox::Coordinate::Left),
+                   BoundingBox::GetCoordinate(BoundingBox::Coordinate::Right),
+                   BoundingBox::GetCoordinate(BoundingBox::Coordinate::Top),
+                   BoundingBox::GetCoordinate(BoundingBox::Coordinate::Bottom)};
+    result.rasterized_pixels = g_stats.this_frame.rasterized_pixels;
+    result.tev_pixels_in = g_stats.this_frame.tev_pixels_in;
+    result.tev_pixels_out = g_stats.this_frame.tev_pixels_out;
+    return result;
+  }
+
+private:
+  VideoConfig m_saved_config;
+};
+}  // namespace
+
+TEST_F(RasterizerTest, ThreadedMatchesSerial)
+{
+  const RenderResult serial = Render(0);
+  const RenderResult threaded = Render(WORKER_THREADS);
+
+  // Make sure that the scene exercises everything compared below.
+  ASSERT_GT(serial.rasterized_pixels, 0);
+  EXPECT_GT(serial.tev_pixels_out, 0);
+  EXPECT_LT(serial.tev_pixels_out, serial.tev_pixels_in);
+  for (u32 i = 0; i < PQ_EFB_COPY_CLOCKS; ++i)
+    EXPECT_GT(serial.perf_values[i], 0u) << i;
+
+  EXPECT_EQ(serial.color, threaded.color);
+  EXPECT_EQ(serial.depth, threaded.depth);
+  EXPECT_EQ(serial.perf_values, threaded.perf_values);
+  EXPECT_EQ(serial.bbox, threaded.bbox);
+  EXPECT_EQ(serial.rasterized_pixels, threaded.rasterized_pixels);
+  EXPECT_EQ(serial.tev_pixels_in, threaded.tev_pixels_in);
+  EXPECT_EQ(serial.tev_pixels_out, threaded.tev_pixels_out);
+
+  // Switching back to a single thread draws the same again.
+  EXPECT_EQ(serial.color, Render(0).color);
+}
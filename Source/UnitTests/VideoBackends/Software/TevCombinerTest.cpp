@@ -0,0 +1,202 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/TevCombiner.h"
+#include "VideoCommon/BPMemory.h"
+
+namespace
+{
+using ColorCombiner = TevStageCombiner::ColorCombiner;
+using AlphaCombiner = TevStageCombiner::AlphaCombiner;
+
+// Every setting of the regular combiners that affects the arithmetic, for both combiners.
+std::vector<std::pair<ColorCombiner, AlphaCombiner>> GenerateCombiners()
+{
+  std::vector<std::pair<ColorCombiner, AlphaCombiner>> combiners;
+  for (u32 color = 0; color < 48; color++)
+  {
+    for (u32 alpha = 0; alpha < 48; alpha++)
+    {
+      ColorCombiner cc;
+      cc.hex = 0;
+      cc.bias = color % 3;
+      cc.op = (color / 3) % 2;
+      cc.clamp = (color / 6) % 2;
+      cc.shift = color / 12;
+
+      AlphaCombiner ac;
+      ac.hex = 0;
+      ac.bias = alpha % 3;
+      ac.op = (alpha / 3) % 2;
+      ac.clamp = (alpha / 6) % 2;
+      ac.shift = alpha / 12;
+
+      combiners.emplace_back(cc, ac);
+    }
+  }
+  return combiners;
+}
+
+std::vector<TevCombiner::Inputs> GenerateInputs(size_t count)
+{
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> abc(0, 255);
+  std::uniform_int_distribution<int> d_dist(-1024, 1023);
+
+  std::vector<TevCombiner::Inputs> inputs(count);
+  for (TevCombiner::Inputs& input : inputs)
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      input.a[i] = abc(generator);
+      input.b[i] = abc(generator);
+      input.c[i] = abc(generator);
+      input.d[i] = d_dist(generator);
+    }
+  }
+
+  // The extremes of every input.
+  for (s16 a : {0, 255})
+  {
+    for (s16 b : {0, 255})
+    {
+      for (s16 c : {0, 127, 128, 255})
+      {
+        for (s16 d : {-1024, 0, 1023})
+          inputs.push_back({{a, a, a, a}, {b, b, b, b}, {c, c, c, c}, {d, d, d, d}});
+      }
+    }
+  }
+  return inputs;
+}
+
+// Groups the inputs into quads, filling up the last one with the first inputs.
+std::vector<TevCombiner::QuadInputs> GenerateQuadInputs(size_t count)
+{
+  const std::vector<TevCombiner::Inputs> inputs = GenerateInputs(count);
+  std::vector<TevCombiner::QuadInputs> quads((inputs.size() + TevCombiner::QUAD_SIZE - 1) /
+                                             TevCombiner::QUAD_SIZE);
+  for (size_t i = 0; i < quads.size() * TevCombiner::QUAD_SIZE; i++)
+  {
+    const TevCombiner::Inputs& input = inputs[i % inputs.size()];
+    TevCombiner::QuadInputs& quad = quads[i / TevCombiner::QUAD_SIZE];
+    const size_t pixel = i % TevCombiner::QUAD_SIZE;
+    quad.a[pixel] = input.a;
+    quad.b[pixel] = input.b;
+    quad.c[pixel] = input.c;
+    quad.d[pixel] = input.d;
+  }
+  return quads;
+}
+
+TevCombiner::Inputs GetPixelInputs(const TevCombiner::QuadInputs& quad, int pixel)
+{
+  return {quad.a[pixel], quad.b[pixel], quad.c[pixel], quad.d[pixel]};
+}
+
+using CombineFunction = TevCombiner::QuadComponents (*)(const TevCombiner::Params&,
+                                                        const TevCombiner::QuadInputs&);
+
+// Every implementation of CombineRegular this CPU can run, not just the one it picks.
+std::vector<std::pair<std::string, CombineFunction>> GetImplementations()
+{
+  std::vector<std::pair<std::string, CombineFunction>> implementations;
+#ifdef _M_X86
+  implementations.emplace_back("sse2", TevCombiner::CombineRegularSSE2);
+  if (cpu_info.bAVX2)
+    implementations.emplace_back("avx2", TevCombiner::CombineRegularAVX2);
+#else
+  implementations.emplace_back("default", TevCombiner::CombineRegular);
+#endif
+  return implementations;
+}
+}  // namespace
+
+TEST(TevCombiner, MatchesGeneric)
+{
+  const std::vector<TevCombiner::QuadInputs> quads = GenerateQuadInputs(1000);
+  for (const auto& [name, combine] : GetImplementations())
+  {
+    for (const auto& [cc, ac] : GenerateCombiners())
+    {
+      const TevCombiner::Params params(cc, ac);
+      for (const TevCombiner::QuadInputs& quad : quads)
+      {
+        const TevCombiner::QuadComponents result = combine(params, quad);
+        for (int pixel = 0; pixel < TevCombiner::QUAD_SIZE; pixel++)
+        {
+          ASSERT_EQ(TevCombiner::CombineRegularGeneric(cc, ac, GetPixelInputs(quad, pixel)),
+                    result[pixel])
+              << name << ", color combiner " << cc.hex << ", alpha combiner " << ac.hex
+              << ", pixel " << pixel;
+        }
+      }
+    }
+  }
+}
+
+TEST(TevCombiner, DISABLED_Benchmark)
+{
+  constexpr int iterations = 1000;
+  const std::vector<TevCombiner::QuadInputs> quads = GenerateQuadInputs(10000);
+  const auto implementations = GetImplementations();
+
+  // Returns the rate in pixels per second, so that the implementations can be compared.
+  const auto measure = [&](const auto& combine_quad) {
+    s32 checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+      for (const TevCombiner::QuadInputs& quad : quads)
+        checksum += combine_quad(quad);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    // Keep the results alive.
+    EXPECT_NE(checksum, 0x12345678);
+    return quads.size() * TevCombiner::QUAD_SIZE * iterations / elapsed.count() / 1e6;
+  };
+
+  std::printf("%8s", "generic");
+  for (const auto& implementation : implementations)
+    std::printf(" %8s", implementation.first.c_str());
+  std::printf("  (Mpixel stages/s)\n");
+
+  for (const auto& [cc, ac] : GenerateCombiners())
+  {
+    // Only time the color and alpha combiners with the same settings.
+    if ((cc.hex ^ ac.hex) & 0xff0000)
+      continue;
+
+    const TevCombiner::Params params(cc, ac);
+    std::printf("%8.1f", measure([&](const TevCombiner::QuadInputs& quad) {
+                  s32 sum = 0;
+                  for (int pixel = 0; pixel < TevCombiner::QUAD_SIZE; pixel++)
+                  {
+                    sum += TevCombiner::CombineRegularGeneric(cc, ac,
+                                                              GetPixelInputs(quad, pixel))[0];
+                  }
+                  return sum;
+                }));
+    for (const auto& implementation : implementations)
+    {
+      const CombineFunction combine = implementation.second;
+      std::printf(" %8.1f", measure([&](const TevCombiner::QuadInputs& quad) {
+                    return combine(params, quad)[0][0];
+                  }));
+    }
+    std::printf("  bias %u op %u clamp %u shift %u\n", cc.bias.Value(), cc.op.Value(),
+                cc.clamp.Value(), cc.shift.Value());
+  }
+}
@@ -0,0 +1,209 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/AddressRangeIndex.h"
+
+namespace
+{
+struct Range
+{
+  u32 address;
+  u32 size;
+};
+
+bool Overlaps(const Range& a, const Range& b)
+{
+  return a.address < b.address + b.size && b.address < a.address + a.size;
+}
+
+enum class OpType
+{
+  Add,
+  Remove,
+  Lookup,
+};
+
+struct Op
+{
+  OpType type;
+  Range range;
+  // Index into the list of ranges for Add and Remove.
+  u32 id;
+};
+
+// Generates an access pattern like the one of the texture cache in games which do a lot of EFB
+// copies: A few thousand small copies packed into a few MiB of memory next to larger textures,
+// with most operations looking for copies overlapping a new copy or texture.
+std::vector<Op> GenerateTrace(u32 live_ranges, size_t op_count, u32 seed)
+{
+  std::mt19937 rng(seed);
+  const auto random_range = [&rng] {
+    const bool is_texture = rng() % 8 == 0;
+    const u32 size = is_texture ? 0x1000u << (rng() % 8) : 0x200u << (rng() % 5);
+    const u32 address = 0x800000 + (rng() % (0x600000 / 32)) * 32;
+    return Range{address, size};
+  };
+
+  std::vector<Op> ops;
+  std::vector<Range> ranges;
+  for (u32 id = 0; id < live_ranges; ++id)
+  {
+    ranges.push_back(random_range());
+    ops.push_back({OpType::Add, ranges.back(), id});
+  }
+
+  while (ops.size() < op_count)
+  {
+    if (rng() % 4 != 0)
+    {
+      ops.push_back({OpType::Lookup, random_range(), 0});
+      continue;
+    }
+
+    // Replace a range with a new one, like an EFB copy invalidating an older one.
+    const u32 id = rng() % live_ranges;
+    ops.push_back({OpType::Remove, ranges[id], id});
+    ranges[id] = random_range();
+    ops.push_back({OpType::Add, ranges[id], id});
+  }
+
+  return ops;
+}
+}  // namespace
+
+TEST(AddressRangeIndex, MatchesBruteForce)
+{
+  constexpr u32 live_ranges = 500;
+  const std::vector<Op> trace = GenerateTrace(live_ranges, 20000, 1);
+
+  AddressRangeIndex<u32> index;
+  std::vector<Range> ranges(live_ranges);
+  std::vector<bool> live(live_ranges);
+  for (const Op& op : trace)
+  {
+    switch (op.type)
+    {
+    case OpType::Add:
+      index.Add(op.range.address, op.range.size, op.id);
+      ranges[op.id] = op.range;
+      live[op.id] = true;
+      break;
+    case OpType::Remove:
+      index.Remove(op.range.address, op.range.size, op.id);
+      live[op.id] = false;
+      break;
+    case OpType::Lookup:
+    {
+      std::vector<u32> found;
+      index.ForEachOverlapping(op.range.address, op.range.size,
+                               [&found](u32 id) { found.push_back(id); });
+      std::sort(found.begin(), found.end());
+
+      std::vector<u32> expected;
+      for (u32 id = 0; id < live_ranges; ++id)
+      {
+        if (live[id] && Overlaps(ranges[id], op.range))
+          expected.push_back(id);
+      }
+      ASSERT_EQ(expected, found);
+      break;
+    }
+    }
+  }
+}
+
+TEST(AddressRangeIndex, EdgeCases)
+{
+  AddressRangeIndex<int> index;
+  const u32 page_size = 1u << AddressRangeIndex<int>::PAGE_BITS;
+  index.Add(page_size - 4, 8, 1);
+  index.Add(page_size, 3 * page_size, 2);
+
+  const auto lookup = [&index](u32 address, u32 size) {
+    std::vector<int> found;
+    index.ForEachOverlapping(address, size, [&found](int value) { found.push_back(value); });
+    std::sort(found.begin(), found.end());
+    return found;
+  };
+
+  EXPECT_EQ(std::vector<int>{}, lookup(0, page_size - 4));
+  EXPECT_EQ(std::vector<int>{1}, lookup(0, page_size - 3));
+  EXPECT_EQ((std::vector<int>{1, 2}), lookup(0, 4 * page_size));
+  EXPECT_EQ(std::vector<int>{2}, lookup(3 * page_size, 1));
+  EXPECT_EQ(std::vector<int>{}, lookup(4 * page_size, page_size));
+  EXPECT_EQ((std::vector<int>{1, 2}), lookup(page_size, 1));
+
+  index.Remove(page_size - 4, 8, 1);
+  EXPECT_EQ(std::vector<int>{2}, lookup(0, 4 * page_size));
+}
+
+// Not run by default. Replays a synthetic texture cache trace with the index and with the lookup
+// the texture cache used before, which scanned all textures starting up to 4 MiB before the
+// looked up address.
+TEST(AddressRangeIndex, DISABLED_Benchmark)
+{
+  for (u32 live_ranges : {100, 1000, 5000})
+  {
+    const std::vector<Op> trace = GenerateTrace(live_ranges, 1000000, 2);
+    size_t found_index = 0;
+    size_t found_scan = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    AddressRangeIndex<u32> index;
+    for (const Op& op : trace)
+    {
+      if (op.type == OpType::Add)
+        index.Add(op.range.address, op.range.size, op.id);
+      else if (op.type == OpType::Remove)
+        index.Remove(op.range.address, op.range.size, op.id);
+      else
+        index.ForEachOverlapping(op.range.address, op.range.size, [&](u32) { ++found_index; });
+    }
+    const std::chrono::duration<double> index_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    std::multimap<u32, std::pair<u32, u32>> by_address;
+    for (const Op& op : trace)
+    {
+      if (op.type == OpType::Add)
+      {
+        by_address.emplace(op.range.address, std::make_pair(op.range.size, op.id));
+      }
+      else if (op.type == OpType::Remove)
+      {
+        auto range = by_address.equal_range(op.range.address);
+        by_address.erase(std::find_if(range.first, range.second,
+                                      [&op](const auto& it) { return it.second.second == op.id; }));
+      }
+      else
+      {
+        constexpr u32 max_texture_size = 1024 * 1024 * 4;
+        const u32 lower = op.range.address > max_texture_size ?
+                              op.range.address - max_texture_size :
+                              0;
+        const auto end = by_address.upper_bound(op.range.address + op.range.size);
+        for (auto it = by_address.lower_bound(lower); it != end; ++it)
+        {
+          if (Overlaps({it->first, it->second.first}, op.range))
+            ++found_scan;
+        }
+      }
+    }
+    const std::chrono::duration<double> scan_time = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(found_scan, found_index);
+    std::printf("%5u ranges: index %7.1f ns/op, multimap scan %7.1f ns/op\n", live_ranges,
+                index_time.count() * 1e9 / trace.size(), scan_time.count() * 1e9 / trace.size());
+  }
+}
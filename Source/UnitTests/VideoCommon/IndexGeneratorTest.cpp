@@ -0,0 +1,123 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "VideoCommon/IndexGenerator.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace
+{
+constexpr const char* PRIMITIVE_NAMES[] = {"quads",      "quads_2", "triangles", "strip",
+                                           "fan",        "lines",   "line strip", "points"};
+
+// Strips and fans without primitive restart need the most, with a triangle per vertex.
+constexpr u32 MaxIndices(u32 num_vertices)
+{
+  return num_vertices * 3 + 1;
+}
+
+class IndexGeneratorTest : public testing::TestWithParam<bool>
+{
+protected:
+  void SetUp() override
+  {
+    m_old_primitive_restart = g_Config.backend_info.bSupportsPrimitiveRestart;
+    m_old_avx2 = cpu_info.bAVX2;
+    g_Config.backend_info.bSupportsPrimitiveRestart = GetParam();
+  }
+
+  void TearDown() override
+  {
+    g_Config.backend_info.bSupportsPrimitiveRestart = m_old_primitive_restart;
+    cpu_info.bAVX2 = m_old_avx2;
+  }
+
+  // Generates the indices for a primitive following `base` points, which shifts its indices.
+  static std::vector<u16> Generate(IndexGenerator* generator, int primitive, u32 base,
+                                   u32 num_vertices)
+  {
+    std::vector<u16> indices(MaxIndices(base) + MaxIndices(num_vertices));
+    generator->Start(indices.data());
+    generator->AddIndices(OpcodeDecoder::GX_DRAW_POINTS, base);
+    generator->AddIndices(primitive, num_vertices);
+    indices.resize(generator->GetIndexLen());
+    return indices;
+  }
+
+  bool m_old_primitive_restart;
+  bool m_old_avx2;
+};
+}  // namespace
+
+TEST_P(IndexGeneratorTest, MatchesGeneric)
+{
+  const bool has_avx2 = cpu_info.bAVX2;
+  for (bool avx2 : {false, true})
+  {
+    if (avx2 && !has_avx2)
+      continue;
+    cpu_info.bAVX2 = avx2;
+
+    IndexGenerator generic;
+    generic.InitGeneric();
+    IndexGenerator vectorized;
+    vectorized.Init();
+
+    for (int primitive = 0; primitive < 8; ++primitive)
+    {
+      for (u32 base : {0u, 1u, 65000u})
+      {
+        for (u32 num_vertices = 0; num_vertices < 200; ++num_vertices)
+        {
+          ASSERT_EQ(Generate(&generic, primitive, base, num_vertices),
+                    Generate(&vectorized, primitive, base, num_vertices))
+              << PRIMITIVE_NAMES[primitive] << ", " << num_vertices << " vertices after " << base
+              << (avx2 ? ", AVX2" : ", SSE2");
+        }
+      }
+    }
+  }
+}
+
+TEST_P(IndexGeneratorTest, DISABLED_Benchmark)
+{
+  constexpr u32 num_vertices = 60000;
+  constexpr int iterations = 2000;
+  std::vector<u16> indices(MaxIndices(num_vertices));
+
+  const auto measure = [&](IndexGenerator* generator, int primitive) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+      generator->Start(indices.data());
+      generator->AddIndices(primitive, num_vertices);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return double(generator->GetIndexLen()) * iterations / elapsed.count() / 1e6;
+  };
+
+  IndexGenerator generic;
+  generic.InitGeneric();
+  IndexGenerator vectorized;
+  vectorized.Init();
+
+  std::printf("%8s %8s  %s\n", "generic", "simd", GetParam() ? "(Mindices/s, restart)" :
+                                                                "(Mindices/s)");
+  for (int primitive = 0; primitive < 8; ++primitive)
+  {
+    const double generic_rate = measure(&generic, primitive);
+    const double vectorized_rate = measure(&vectorized, primitive);
+    std::printf("%8.1f %8.1f  %s\n", generic_rate, vectorized_rate, PRIMITIVE_NAMES[primitive]);
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(PrimitiveRestart, IndexGeneratorTest, testing::Bool());
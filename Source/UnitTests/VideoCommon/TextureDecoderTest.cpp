@@ -0,0 +1,183 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecodePool.h"
+#include "VideoCommon/TextureDecoder.h"
+
+namespace
+{
+constexpr TextureFormat TEXTURE_FORMATS[] = {
+    TextureFormat::I4,     TextureFormat::I8,     TextureFormat::IA4,   TextureFormat::IA8,
+    TextureFormat::RGB565, TextureFormat::RGB5A3, TextureFormat::RGBA8, TextureFormat::C4,
+    TextureFormat::C8,     TextureFormat::C14X2,  TextureFormat::CMPR,
+};
+
+constexpr TLUTFormat TLUT_FORMATS[] = {TLUTFormat::IA8, TLUTFormat::RGB565, TLUTFormat::RGB5A3};
+
+std::vector<u8> RandomBytes(size_t size, u32 seed)
+{
+  std::mt19937 rng(seed);
+  std::vector<u8> data(size);
+  for (u8& byte : data)
+    byte = static_cast<u8>(rng());
+  return data;
+}
+
+// The palette for C14X2 can have up to 16384 entries.
+constexpr size_t TLUT_SIZE = 0x4000 * sizeof(u16);
+}  // namespace
+
+TEST(TextureDecoder, MatchesTexelDecoder)
+{
+  constexpr int width = 64;
+  constexpr int height = 32;
+  const std::vector<u8> tlut = RandomBytes(TLUT_SIZE, 1);
+  std::vector<u32> decoded(width * height);
+
+  // The decoders are picked at every decode, so this covers each path the host can run.
+  const bool has_avx2 = cpu_info.bAVX2;
+  const bool has_ssse3 = cpu_info.bSSSE3;
+  for (const auto& [avx2, ssse3] : {std::pair(false, false), std::pair(false, true),
+                                    std::pair(true, true)})
+  {
+    if ((avx2 && !has_avx2) || (ssse3 && !has_ssse3))
+      continue;
+    cpu_info.bAVX2 = avx2;
+    cpu_info.bSSSE3 = ssse3;
+
+    for (TextureFormat format : TEXTURE_FORMATS)
+    {
+      const std::vector<u8> src =
+          RandomBytes(TexDecoder_GetTextureSizeInBytes(width, height, format), 2);
+      for (TLUTFormat tlut_format : TLUT_FORMATS)
+      {
+        if (!IsColorIndexed(format) && tlut_format != TLUTFormat::IA8)
+          continue;
+
+        SCOPED_TRACE(testing::Message()
+                     << "format " << static_cast<int>(format) << ", tlut format "
+                     << static_cast<int>(tlut_format) << (avx2 ? ", AVX2" : "")
+                     << (ssse3 ? ", SSSE3" : ""));
+        TexDecoder_Decode(reinterpret_cast<u8*>(decoded.data()), src.data(), width, height,
+                          format, tlut.data(), tlut_format);
+
+        int mismatches = 0;
+        for (int t = 0; t < height; ++t)
+        {
+          for (int s = 0; s < width; ++s)
+          {
+            u32 texel;
+            TexDecoder_DecodeTexel(reinterpret_cast<u8*>(&texel), src.data(), s, t, width - 1,
+                                   format, tlut.data(), tlut_format);
+            if (decoded[t * width + s] != texel && mismatches++ < 4)
+            {
+              ADD_FAILURE() << "texel (" << s << ", " << t << "): " << std::hex
+                            << decoded[t * width + s] << " != " << texel;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  cpu_info.bAVX2 = has_avx2;
+  cpu_info.bSSSE3 = has_ssse3;
+}
+
+TEST(TextureDecoder, DecodePoolMatchesSerialDecode)
+{
+  // Large enough to be split into several bands, with a few small mip levels behind it.
+  constexpr u32 levels[][2] = {{512, 512}, {256, 256}, {128, 128}, {8, 8}};
+  const std::vector<u8> tlut = RandomBytes(TLUT_SIZE, 1);
+
+  TextureDecodePool pool;
+  for (u32 workers : {0, 1, 3})
+  {
+    pool.SetWorkerCount(workers);
+    for (TextureFormat format : {TextureFormat::I4, TextureFormat::RGBA8, TextureFormat::CMPR})
+    {
+      SCOPED_TRACE(testing::Message() << workers << " workers, format "
+                                      << static_cast<int>(format));
+      std::vector<std::vector<u8>> sources;
+      std::vector<std::vector<u32>> decoded;
+      for (const auto& level : levels)
+      {
+        sources.push_back(RandomBytes(
+            TexDecoder_GetTextureSizeInBytes(level[0], level[1], format), sources.size() + 2));
+        decoded.emplace_back(level[0] * level[1]);
+        pool.QueueLevel(reinterpret_cast<u8*>(decoded.back().data()), sources.back().data(),
+                        level[0], level[1], format, tlut.data(), TLUTFormat::IA8);
+      }
+      pool.Flush();
+
+      for (size_t i = 0; i < std::size(levels); ++i)
+      {
+        std::vector<u32> expected(levels[i][0] * levels[i][1]);
+        TexDecoder_Decode(reinterpret_cast<u8*>(expected.data()), sources[i].data(), levels[i][0],
+                          levels[i][1], format, tlut.data(), TLUTFormat::IA8);
+        EXPECT_EQ(expected, decoded[i]) << "level " << i;
+      }
+    }
+  }
+}
+
+// Not run by default. Decodes every format at typical texture sizes and prints the throughput
+// in terms of decoded data.
+TEST(TextureDecoder, DISABLED_Benchmark)
+{
+  constexpr int sizes[][2] = {{64, 64}, {256, 256}, {1024, 1024}};
+  constexpr size_t target_bytes = 256 * 1024 * 1024;
+  const std::vector<u8> tlut = RandomBytes(TLUT_SIZE, 1);
+
+  for (const auto& size : sizes)
+  {
+    const int width = size[0];
+    const int height = size[1];
+    const size_t decoded_size = static_cast<size_t>(width) * height * sizeof(u32);
+    std::vector<u8> decoded(decoded_size);
+
+    for (TextureFormat format : TEXTURE_FORMATS)
+    {
+      const std::vector<u8> src =
+          RandomBytes(TexDecoder_GetTextureSizeInBytes(width, height, format), 2);
+      for (TLUTFormat tlut_format : TLUT_FORMATS)
+      {
+        if (!IsColorIndexed(format) && tlut_format != TLUTFormat::IA8)
+          continue;
+
+        const size_t iterations = std::max<size_t>(target_bytes / decoded_size, 1);
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+          TexDecoder_Decode(decoded.data(), src.data(), width, height, format, tlut.data(),
+                            tlut_format);
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        const double mb_per_s = iterations * decoded_size / elapsed.count() / (1024 * 1024);
+        if (IsColorIndexed(format))
+        {
+          std::printf("%4dx%-4d format 0x%X tlut %d: %8.1f MB/s\n", width, height,
+                      static_cast<int>(format), static_cast<int>(tlut_format), mb_per_s);
+        }
+        else
+        {
+          std::printf("%4dx%-4d format 0x%X:        %8.1f MB/s\n", width, height,
+                      static_cast<int>(format), mb_per_s);
+        }
+      }
+    }
+  }
+}
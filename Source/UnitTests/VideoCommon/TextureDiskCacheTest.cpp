@@ -0,0 +1,141 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "VideoCommon/TextureDiskCache.h"
+
+namespace
+{
+TextureDiskCache::Key MakeKey(u64 hash)
+{
+  return {hash, 0, 14, 0, 64, 64, 1};
+}
+
+std::vector<u8> MakeData(u8 value, size_t size = 100)
+{
+  return std::vector<u8>(size, value);
+}
+
+class TextureDiskCacheTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_dir = File::CreateTempDir();
+    m_filename = m_dir + DIR_SEP "test.texcache";
+  }
+
+  void TearDown() override
+  {
+    m_cache.Close();
+    File::DeleteDirRecursively(m_dir);
+  }
+
+  void Insert(u64 hash, const std::vector<u8>& data)
+  {
+    m_cache.Insert(MakeKey(hash), data.data(), data.size());
+  }
+
+  bool Contains(u64 hash) { return m_cache.Lookup(MakeKey(hash)) != nullptr; }
+
+  std::string m_dir;
+  std::string m_filename;
+  TextureDiskCache m_cache;
+};
+}  // namespace
+
+TEST_F(TextureDiskCacheTest, PersistsAcrossSessions)
+{
+  m_cache.Open(m_filename, 1000);
+  Insert(1, MakeData(1));
+  Insert(2, MakeData(2, 50));
+  m_cache.Close();
+
+  m_cache.Open(m_filename, 1000);
+  EXPECT_EQ(2u, m_cache.GetCount());
+  EXPECT_EQ(150u, m_cache.GetSize());
+
+  const std::vector<u8>* data = m_cache.Lookup(MakeKey(2));
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(MakeData(2, 50), *data);
+
+  // Any part of the key has to match.
+  TextureDiskCache::Key other_format = MakeKey(2);
+  other_format.format = 8;
+  EXPECT_EQ(nullptr, m_cache.Lookup(other_format));
+  EXPECT_FALSE(Contains(3));
+}
+
+TEST_F(TextureDiskCacheTest, EvictsLeastRecentlyUsed)
+{
+  m_cache.Open(m_filename, 300);
+  Insert(1, MakeData(1));
+  Insert(2, MakeData(2));
+  Insert(3, MakeData(3));
+  EXPECT_TRUE(Contains(1));
+  Insert(4, MakeData(4));
+
+  EXPECT_FALSE(Contains(2));
+  EXPECT_EQ(300u, m_cache.GetSize());
+
+  // Too large to be cached at all.
+  Insert(5, MakeData(5, 301));
+  EXPECT_FALSE(Contains(5));
+  EXPECT_EQ(3u, m_cache.GetCount());
+  m_cache.Close();
+
+  // The hit on 1 was recorded, so 3 is the least recently used texture in the next session too.
+  m_cache.Open(m_filename, 300);
+  EXPECT_EQ(3u, m_cache.GetCount());
+  Insert(6, MakeData(6));
+  EXPECT_FALSE(Contains(3));
+  EXPECT_TRUE(Contains(1));
+  EXPECT_TRUE(Contains(4));
+  EXPECT_TRUE(Contains(6));
+}
+
+TEST_F(TextureDiskCacheTest, RewritesStaleFile)
+{
+  // The file is only bounded by the size limit of the session which wrote it, so reopening it with
+  // a smaller limit leaves most of it stale.
+  m_cache.Open(m_filename, 2000);
+  for (u64 hash = 0; hash < 20; ++hash)
+    Insert(hash, MakeData(static_cast<u8>(hash)));
+  m_cache.Close();
+  const u64 stale_size = File::GetSize(m_filename);
+
+  m_cache.Open(m_filename, 200);
+  EXPECT_EQ(2u, m_cache.GetCount());
+  m_cache.Close();
+  EXPECT_LT(File::GetSize(m_filename) * 5, stale_size);
+
+  m_cache.Open(m_filename, 200);
+  const std::vector<u8>* data = m_cache.Lookup(MakeKey(19));
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(MakeData(19), *data);
+  EXPECT_TRUE(Contains(18));
+}
+
+TEST_F(TextureDiskCacheTest, BoundsFileDuringSession)
+{
+  m_cache.Open(m_filename, 200);
+  for (u64 hash = 0; hash < 100; ++hash)
+    Insert(hash, MakeData(static_cast<u8>(hash)));
+  EXPECT_EQ(2u, m_cache.GetCount());
+  m_cache.Close();
+
+  // Without compacting while running, this would be 100 textures.
+  EXPECT_LT(File::GetSize(m_filename), 1000u);
+
+  m_cache.Open(m_filename, 200);
+  EXPECT_TRUE(Contains(98));
+  EXPECT_TRUE(Contains(99));
+}
@@ -2,19 +2,28 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <random>
+#include <string>
 #include <tuple>
 #include <type_traits>
 #include <unordered_set>
+#include <vector>
 
 #include <gtest/gtest.h>  // NOLINT
 
 #include "Common/BitUtils.h"
+#include "Common/CPUDetect.h"
 #include "Common/Common.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/VertexLoader.h"
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
 
@@ -354,3 +363,300 @@ TEST_F(VertexLoaderTest, LargeFloatVertexSpeed)
   for (int i = 0; i < 100; ++i)
     RunVertices(100000);
 }
+
+namespace
+{
+struct LoaderConfig
+{
+  TVtxDesc desc;
+  VAT vat;
+};
+
+// Every format of every attribute next to a float position, and a few combinations of attributes
+// which are common in games.
+std::vector<LoaderConfig> GenerateLoaderConfigs()
+{
+  std::vector<LoaderConfig> configs;
+  const auto add = [&configs](const auto& setup) {
+    LoaderConfig config;
+    std::memset(&config, 0, sizeof(config));
+    config.desc.Position = DIRECT;
+    config.vat.g0.PosFormat = FORMAT_FLOAT;
+    config.vat.g0.PosElements = 1;
+    config.vat.g0.ByteDequant = true;
+    setup(config.desc, config.vat);
+    configs.push_back(config);
+  };
+
+  const int addressing[] = {DIRECT, INDEX8, INDEX16};
+  const int formats[] = {FORMAT_UBYTE, FORMAT_BYTE, FORMAT_USHORT, FORMAT_SHORT, FORMAT_FLOAT};
+  const int color_formats[] = {FORMAT_16B_565,  FORMAT_24B_888,  FORMAT_32B_888x,
+                               FORMAT_16B_4444, FORMAT_24B_6666, FORMAT_32B_8888};
+
+  for (int addr : addressing)
+  {
+    for (int format : formats)
+    {
+      for (int elements : {0, 1})
+      {
+        for (int frac : {0, 5})
+        {
+          add([&](TVtxDesc& desc, VAT& vat) {
+            desc.Position = addr;
+            vat.g0.PosFormat = format;
+            vat.g0.PosElements = elements;
+            vat.g0.PosFrac = frac;
+          });
+          add([&](TVtxDesc& desc, VAT& vat) {
+            desc.Tex0Coord = addr;
+            vat.g0.Tex0CoordFormat = format;
+            vat.g0.Tex0CoordElements = elements;
+            vat.g0.Tex0Frac = frac;
+          });
+        }
+      }
+
+      // Normals only, normals with binormal and tangent, and the same with three indices.
+      for (int normals : {0, 1, 2})
+      {
+        add([&](TVtxDesc& desc, VAT& vat) {
+          desc.Normal = addr;
+          vat.g0.NormalFormat = format;
+          vat.g0.NormalElements = normals != 0;
+          vat.g0.NormalIndex3 = normals == 2;
+        });
+      }
+    }
+
+    for (int format : color_formats)
+    {
+      add([&](TVtxDesc& desc, VAT& vat) {
+        desc.Color0 = addr;
+        vat.g0.Color0Comp = format;
+        vat.g0.Color0Elements = 1;
+      });
+      add([&](TVtxDesc& desc, VAT& vat) {
+        desc.Color0 = DIRECT;
+        vat.g0.Color0Comp = FORMAT_24B_888;
+        desc.Color1 = addr;
+        vat.g0.Color1Comp = format;
+        vat.g0.Color1Elements = 1;
+      });
+    }
+  }
+
+  // Matrix indices, with and without the matching texture coordinates.
+  add([](TVtxDesc& desc, VAT& vat) {
+    desc.PosMatIdx = 1;
+    desc.Tex0MatIdx = 1;
+    desc.Tex1MatIdx = 1;
+    desc.Tex1Coord = DIRECT;
+    vat.g1.Tex1CoordFormat = FORMAT_SHORT;
+    vat.g1.Tex1CoordElements = 1;
+    vat.g1.Tex1Frac = 8;
+  });
+
+  // A typical lit and textured model.
+  add([](TVtxDesc& desc, VAT& vat) {
+    desc.PosMatIdx = 1;
+    desc.Position = INDEX16;
+    vat.g0.PosFormat = FORMAT_SHORT;
+    vat.g0.PosFrac = 6;
+    desc.Normal = INDEX16;
+    vat.g0.NormalFormat = FORMAT_BYTE;
+    desc.Color0 = INDEX8;
+    vat.g0.Color0Comp = FORMAT_32B_8888;
+    desc.Tex0Coord = INDEX16;
+    vat.g0.Tex0CoordFormat = FORMAT_SHORT;
+    vat.g0.Tex0CoordElements = 1;
+    vat.g0.Tex0Frac = 10;
+  });
+
+  // Every attribute as indexed floats.
+  add([](TVtxDesc& desc, VAT& vat) {
+    desc.Hex = 0x1FF;  // All matrix indices
+    desc.Position = INDEX16;
+    desc.Normal = INDEX16;
+    vat.g0.NormalFormat = FORMAT_FLOAT;
+    vat.g0.NormalElements = 1;
+    desc.Color0 = INDEX16;
+    vat.g0.Color0Comp = FORMAT_32B_8888;
+    desc.Color1 = INDEX16;
+    vat.g0.Color1Comp = FORMAT_32B_8888;
+    desc.Tex0Coord = desc.Tex1Coord = desc.Tex2Coord = desc.Tex3Coord = INDEX16;
+    desc.Tex4Coord = desc.Tex5Coord = desc.Tex6Coord = desc.Tex7Coord = INDEX16;
+    vat.g0.Tex0CoordFormat = vat.g1.Tex1CoordFormat = vat.g1.Tex2CoordFormat = FORMAT_FLOAT;
+    vat.g1.Tex3CoordFormat = vat.g1.Tex4CoordFormat = vat.g2.Tex5CoordFormat = FORMAT_FLOAT;
+    vat.g2.Tex6CoordFormat = vat.g2.Tex7CoordFormat = FORMAT_FLOAT;
+  });
+
+  return configs;
+}
+
+// The JIT checks the CPU features while generating code, so this selects which code paths the
+// loaders created in its scope use.
+class ScopedCPUFeatures
+{
+public:
+  enum class Level
+  {
+    Native,
+    NoBMI,
+    // Without BMI and SSE beyond SSE3, which are optional for the JIT.
+    Baseline,
+  };
+  static constexpr Level LEVELS[] = {Level::Native, Level::NoBMI, Level::Baseline};
+
+  explicit ScopedCPUFeatures(Level level) : m_saved(cpu_info)
+  {
+    if (level != Level::Native)
+    {
+      cpu_info.bBMI1 = false;
+      cpu_info.bBMI2 = false;
+      cpu_info.bFastBMI2 = false;
+    }
+    if (level == Level::Baseline)
+    {
+      cpu_info.bSSSE3 = false;
+      cpu_info.bSSE4_1 = false;
+    }
+  }
+  ~ScopedCPUFeatures() { cpu_info = m_saved; }
+
+private:
+  CPUInfo m_saved;
+};
+
+const char* GetLevelName(ScopedCPUFeatures::Level level)
+{
+  static constexpr const char* names[] = {"native", "no BMI", "baseline"};
+  return names[static_cast<int>(level)];
+}
+}  // namespace
+
+// Runs the JIT and the generic loader over random vertices for every vertex format.
+class VertexLoaderSweepTest : public VertexLoaderTest
+{
+protected:
+  // The vertex stream comes first in the input, followed by the arrays, which all share the same
+  // random data. The stride is large enough for three float normals.
+  static constexpr size_t STREAM_SIZE = 8 * 1024 * 1024;
+  static constexpr u32 ARRAY_STRIDE = 36;
+
+  void SetUp() override
+  {
+    VertexLoaderTest::SetUp();
+
+    std::mt19937 rng(1);
+    for (u8& byte : input_memory)
+      byte = static_cast<u8>(rng());
+
+    // Keep floats finite, so that outputs can be compared bitwise.
+    for (size_t i = 0; i < sizeof(input_memory); ++i)
+    {
+      if ((input_memory[i] & 0x7F) == 0x7F)
+        input_memory[i] ^= 0x01;
+    }
+
+    for (int i = 0; i < 12; ++i)
+    {
+      VertexLoaderManager::cached_arraybases[i] = input_memory + STREAM_SIZE;
+      g_main_cp_state.array_strides[i] = ARRAY_STRIDE;
+    }
+  }
+
+  // Returns the number of vertices which have not been skipped.
+  static int Run(VertexLoaderBase* loader, std::vector<u8>* output, int count)
+  {
+    output->resize(count * loader->m_native_vtx_decl.stride + 16);
+    return loader->RunVertices(DataReader(input_memory, input_memory + STREAM_SIZE),
+                               DataReader(output->data(), output->data() + output->size()),
+                               count);
+  }
+
+  static std::unique_ptr<VertexLoaderBase> CreateJitLoader(const LoaderConfig& config)
+  {
+    std::unique_ptr<VertexLoaderBase> loader =
+        VertexLoaderBase::CreateVertexLoader(config.desc, config.vat);
+#if defined(_M_X86_64) || defined(_M_ARM_64)
+    const VertexLoader generic(config.desc, config.vat);
+    if (loader->GetName() == generic.GetName())
+    {
+      ADD_FAILURE() << "The JIT falls back to the generic loader for " << loader->ToString();
+      return nullptr;
+    }
+#endif
+    return loader;
+  }
+};
+
+TEST_F(VertexLoaderSweepTest, JitMatchesGeneric)
+{
+  constexpr int count = 1000;
+  std::vector<u8> generic_output;
+  std::vector<u8> jit_output;
+
+  for (const LoaderConfig& config : GenerateLoaderConfigs())
+  {
+    VertexLoader generic(config.desc, config.vat);
+    const int generic_count = Run(&generic, &generic_output, count);
+
+    for (auto level : ScopedCPUFeatures::LEVELS)
+    {
+      ScopedCPUFeatures features(level);
+      const std::unique_ptr<VertexLoaderBase> jit = CreateJitLoader(config);
+      if (!jit)
+        continue;
+
+      ASSERT_EQ(generic.m_VertexSize, jit->m_VertexSize) << jit->ToString();
+      ASSERT_EQ(generic.m_native_vtx_decl.stride, jit->m_native_vtx_decl.stride)
+          << jit->ToString();
+
+      const int jit_count = Run(jit.get(), &jit_output, count);
+      ASSERT_EQ(generic_count, jit_count) << jit->ToString();
+      EXPECT_EQ(0, std::memcmp(generic_output.data(), jit_output.data(),
+                               generic_count * generic.m_native_vtx_decl.stride))
+          << jit->ToString() << " (" << GetLevelName(level) << ")";
+    }
+  }
+}
+
+// Not run by default. Prints how many vertices per second each loader processes for every vertex
+// format, with the JIT generating code for each set of CPU features.
+TEST_F(VertexLoaderSweepTest, DISABLED_Benchmark)
+{
+  constexpr int count = 10000;
+  constexpr int iterations = 500;
+  std::vector<u8> output;
+
+  const auto measure = [&](VertexLoaderBase* loader) {
+    Run(loader, &output, count);
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+      Run(loader, &output, count);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return count * iterations / elapsed.count() / 1e6;
+  };
+
+  std::printf("%8s %8s %8s %8s  %s\n", "generic", GetLevelName(ScopedCPUFeatures::Level::Native),
+              GetLevelName(ScopedCPUFeatures::Level::NoBMI),
+              GetLevelName(ScopedCPUFeatures::Level::Baseline), "(Mvertices/s)");
+  for (const LoaderConfig& config : GenerateLoaderConfigs())
+  {
+    VertexLoader generic(config.desc, config.vat);
+    const std::string name = generic.ToString();
+    const double generic_rate = measure(&generic);
+
+    double jit_rates[std::size(ScopedCPUFeatures::LEVELS)] = {};
+    for (auto level : ScopedCPUFeatures::LEVELS)
+    {
+      ScopedCPUFeatures features(level);
+      const std::unique_ptr<VertexLoaderBase> jit = CreateJitLoader(config);
+      if (jit)
+        jit_rates[static_cast<int>(level)] = measure(jit.get());
+    }
+
+    std::printf("%8.1f %8.1f %8.1f %8.1f  %s\n", generic_rate, jit_rates[0], jit_rates[1],
+                jit_rates[2], name.c_str());
+  }
+}